@@ -10,9 +10,12 @@
 
 #include <bgfx.h>
 #include <bx/timer.h>
+#include <bx/uint32_t.h>
 #include <bx/readerwriter.h>
 #include "entry/entry.h"
 #include "fpumath.h"
+#include "cull.h"
+#include "meshloader.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -85,196 +88,142 @@ static bgfx::ProgramHandle loadProgram(const char* _vsName, const char* _fsName)
 	return program;
 }
 
-struct Aabb
-{
-	float m_min[3];
-	float m_max[3];
-};
-
-struct Obb
+struct Mesh
 {
-	float m_mtx[16];
-};
+	void load(const char* _filePath)
+	{
+		meshLoad(m_groups, m_decl, _filePath);
 
-struct Sphere
-{
-	float m_center[3];
-	float m_radius;
-};
+		// Primitive bounds for frustum culling, in submit order.
+		uint32_t numPrims = 0;
+		for (MeshGroupArray::const_iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it)
+		{
+			numPrims += 0 == it->m_lod ? uint32_t(it->m_prims.size() ) : 0;
+		}
 
-struct Primitive
-{
-	uint32_t m_startIndex;
-	uint32_t m_numIndices;
-	uint32_t m_startVertex;
-	uint32_t m_numVertices;
-
-	Sphere m_sphere;
-	Aabb m_aabb;
-	Obb m_obb;
-};
+		cullSpheresAlloc(m_primSpheres, numPrims);
+		m_primVisible.resize(bx::uint32_max(numPrims, 1) );
 
-typedef std::vector<Primitive> PrimitiveArray;
+		numPrims = 0;
+		for (MeshGroupArray::const_iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it)
+		{
+			if (0 == it->m_lod)
+			{
+				for (MeshPrimitiveArray::const_iterator primIt = it->m_prims.begin(), primItEnd = it->m_prims.end(); primIt != primItEnd; ++primIt)
+				{
+					cullSpheresSet(m_primSpheres, numPrims++, primIt->m_sphere);
+				}
+			}
+		}
+	}
 
-struct Group
-{
-	Group()
+	void unload()
 	{
-		reset();
+		cullSpheresFree(m_primSpheres);
+
+		meshUnload(m_groups);
 	}
 
-	void reset()
+	void submit(bgfx::ProgramHandle _program, float* _mtx, const float* _viewProj, const float* _eye)
 	{
-		m_vbh.idx = bgfx::invalidHandle;
-		m_ibh.idx = bgfx::invalidHandle;
-		m_prims.clear();
-	}
+		float mvp[16];
+		mtxMul(mvp, _mtx, _viewProj);
 
-	bgfx::VertexBufferHandle m_vbh;
-	bgfx::IndexBufferHandle m_ibh;
-	Sphere m_sphere;
-	Aabb m_aabb;
-	Obb m_obb;
-	PrimitiveArray m_prims;
-};
+		// Eye in model space for normal cone test.
+		float invMtx[16];
+		mtxInverse(invMtx, _mtx);
+		float eye[3];
+		vec3MulMtx(eye, _eye, invMtx);
 
-struct Mesh
-{
-	void load(const char* _filePath)
-	{
-#define BGFX_CHUNK_MAGIC_VB BX_MAKEFOURCC('V', 'B', ' ', 0x0)
-#define BGFX_CHUNK_MAGIC_IB BX_MAKEFOURCC('I', 'B', ' ', 0x0)
-#define BGFX_CHUNK_MAGIC_PRI BX_MAKEFOURCC('P', 'R', 'I', 0x0)
+		m_numClusters = 0;
+		m_numVisibleClusters = 0;
 
-		bx::CrtFileReader reader;
-		reader.open(_filePath);
+		// Primitive spheres are in model space, cull against model space
+		// frustum.
+		Frustum frustum;
+		frustumFromMtx(frustum, mvp);
+		m_numVisiblePrims = cullSpheres(&m_primVisible[0], m_primSpheres, frustum);
 
-		Group group;
+		const uint32_t* visible = &m_primVisible[0];
+		const uint32_t* visibleEnd = visible + m_numVisiblePrims;
+		uint32_t primIndex = 0;
 
-		uint32_t chunk;
-		while (4 == bx::read(&reader, chunk) )
+		for (MeshGroupArray::const_iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it)
 		{
-			switch (chunk)
+			const MeshGroup& group = *it;
+			if (0 != group.m_lod)
+			{
+				continue;
+			}
+
+			for (MeshPrimitiveArray::const_iterator primIt = group.m_prims.begin(), primItEnd = group.m_prims.end(); primIt != primItEnd; ++primIt)
 			{
-			case BGFX_CHUNK_MAGIC_VB:
+				// Visible indices are sorted, skip primitives not in the list.
+				const uint32_t index = primIndex++;
+				if (visible == visibleEnd
+				||  *visible != index)
 				{
-					bx::read(&reader, group.m_sphere);
-					bx::read(&reader, group.m_aabb);
-					bx::read(&reader, group.m_obb);
+					continue;
+				}
 
-					bx::read(&reader, m_decl);
-					uint16_t stride = m_decl.getStride();
+				++visible;
 
-					uint16_t numVertices;
-					bx::read(&reader, numVertices);
-					const bgfx::Memory* mem = bgfx::alloc(numVertices*stride);
-					bx::read(&reader, mem->data, mem->size);
+				const MeshPrimitive& prim = *primIt;
+				const MeshClusters& clusters = prim.m_clusters;
 
-					group.m_vbh = bgfx::createVertexBuffer(mem, m_decl);
-				}
-				break;
+				uint32_t numRanges = 1;
+				m_rangeStart.resize(bx::uint32_max(clusters.m_num, 1) );
+				m_rangeNum.resize(bx::uint32_max(clusters.m_num, 1) );
+				m_rangeStart[0] = prim.m_startIndex;
+				m_rangeNum[0] = prim.m_numIndices;
 
-			case BGFX_CHUNK_MAGIC_IB:
+				if (0 < clusters.m_num)
 				{
-					uint32_t numIndices;
-					bx::read(&reader, numIndices);
-					const bgfx::Memory* mem = bgfx::alloc(numIndices*2);
-					bx::read(&reader, mem->data, mem->size);
-					group.m_ibh = bgfx::createIndexBuffer(mem);
+					m_visible.resize(clusters.m_num);
+					uint32_t numVisible = meshClustersCull(&m_visible[0], clusters, mvp, eye);
+					numRanges = meshClustersRanges(&m_rangeStart[0], &m_rangeNum[0], clusters, &m_visible[0], numVisible);
+
+					m_numClusters += clusters.m_num;
+					m_numVisibleClusters += numVisible;
 				}
-				break;
 
-			case BGFX_CHUNK_MAGIC_PRI:
+				for (uint32_t ii = 0; ii < numRanges; ++ii)
 				{
-					uint16_t len;
-					bx::read(&reader, len);
-
-					std::string material;
-					material.resize(len);
-					bx::read(&reader, const_cast<char*>(material.c_str() ), len);
-
-					uint16_t num;
-					bx::read(&reader, num);
-
-					for (uint32_t ii = 0; ii < num; ++ii)
-					{
-						bx::read(&reader, len);
-
-						std::string name;
-						name.resize(len);
-						bx::read(&reader, const_cast<char*>(name.c_str() ), len);
-
-						Primitive prim;
-						bx::read(&reader, prim.m_startIndex);
-						bx::read(&reader, prim.m_numIndices);
-						bx::read(&reader, prim.m_startVertex);
-						bx::read(&reader, prim.m_numVertices);
-						bx::read(&reader, prim.m_sphere);
-						bx::read(&reader, prim.m_aabb);
-						bx::read(&reader, prim.m_obb);
-
-						group.m_prims.push_back(prim);
-					}
-
-					m_groups.push_back(group);
-					group.reset();
+					// Set model matrix for rendering.
+					bgfx::setTransform(_mtx);
+					bgfx::setProgram(_program);
+					bgfx::setIndexBuffer(group.m_ibh, m_rangeStart[ii], m_rangeNum[ii]);
+					bgfx::setVertexBuffer(group.m_vbh);
+
+					// Set render states.
+					bgfx::setState(0
+						|BGFX_STATE_RGB_WRITE
+						|BGFX_STATE_ALPHA_WRITE
+						|BGFX_STATE_DEPTH_WRITE
+						|BGFX_STATE_DEPTH_TEST_LESS
+						|BGFX_STATE_CULL_CCW
+						|BGFX_STATE_MSAA
+						);
+
+					// Submit primitive for rendering to view 0.
+					bgfx::submit(0);
 				}
-				break;
-
-			default:
-				DBG("%08x at %d", chunk, reader.seek() );
-				break;
 			}
 		}
-
-		reader.close();
 	}
 
-	void unload()
-	{
-		for (GroupArray::const_iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it)
-		{
-			const Group& group = *it;
-			bgfx::destroyVertexBuffer(group.m_vbh);
-
-			if (bgfx::isValid(group.m_ibh) )
-			{
-				bgfx::destroyIndexBuffer(group.m_ibh);
-			}
-		}
-		m_groups.clear();
-	}
+	bgfx::VertexDecl m_decl;
+	MeshGroupArray m_groups;
 
-	void submit(bgfx::ProgramHandle _program, float* _mtx)
-	{
-		for (GroupArray::const_iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it)
-		{
-			const Group& group = *it;
-
-			// Set model matrix for rendering.
-			bgfx::setTransform(_mtx);
-			bgfx::setProgram(_program);
-			bgfx::setIndexBuffer(group.m_ibh);
-			bgfx::setVertexBuffer(group.m_vbh);
-
-			// Set render states.
-			bgfx::setState(0
-				|BGFX_STATE_RGB_WRITE
-				|BGFX_STATE_ALPHA_WRITE
-				|BGFX_STATE_DEPTH_WRITE
-				|BGFX_STATE_DEPTH_TEST_LESS
-				|BGFX_STATE_CULL_CCW
-				|BGFX_STATE_MSAA
-				);
-
-			// Submit primitive for rendering to view 0.
-			bgfx::submit(0);
-		}
-	}
+	CullSpheres m_primSpheres;
+	std::vector<uint32_t> m_primVisible;
+	uint32_t m_numVisiblePrims;
 
-	bgfx::VertexDecl m_decl;
-	typedef std::vector<Group> GroupArray;
-	GroupArray m_groups;
+	std::vector<uint32_t> m_visible;
+	std::vector<uint32_t> m_rangeStart;
+	std::vector<uint32_t> m_rangeNum;
+	uint32_t m_numClusters;
+	uint32_t m_numVisibleClusters;
 };
 
 int _main_(int /*_argc*/, char** /*_argv*/)
@@ -366,13 +315,23 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 		// Set view and projection matrix for view 0.
 		bgfx::setViewTransform(0, view, proj);
 
+		float viewProj[16];
+		mtxMul(viewProj, view, proj);
+
 		float mtx[16];
 		mtxRotateXY(mtx
 			, 0.0f
 			, time*0.37f
 			); 
 
-		mesh.submit(program, mtx);
+		mesh.submit(program, mtx, viewProj, eye);
+
+		bgfx::dbgTextPrintf(0, 4, 0x0f, "Primitives: %d / %d", mesh.m_numVisiblePrims, mesh.m_primSpheres.m_num);
+
+		if (0 < mesh.m_numClusters)
+		{
+			bgfx::dbgTextPrintf(0, 5, 0x0f, "Clusters: %d / %d", mesh.m_numVisibleClusters, mesh.m_numClusters);
+		}
 
 		// Advance to next frame. Rendering thread will be kicked to 
 		// process submitted rendering primitives.
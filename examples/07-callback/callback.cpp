@@ -309,6 +309,14 @@ struct BgfxCallback : public bgfx::CallbackI
 		}
 	}
 
+	virtual void textureMipResident(bgfx::TextureHandle /*_handle*/, uint8_t /*_mip*/) BX_OVERRIDE
+	{
+	}
+
+	virtual void textureRestream(bgfx::TextureHandle /*_handle*/, uint8_t /*_mip*/) BX_OVERRIDE
+	{
+	}
+
 	AviWriter* m_writer;
 };
 
@@ -12,6 +12,9 @@
 #include <bx/timer.h>
 #include <bx/readerwriter.h>
 #include "fpumath.h"
+#include "meshloader.h"
+#include "cull.h"
+#include "lodselect.h"
 #include "imgui/imgui.h"
 
 #include <stdio.h>
@@ -107,171 +110,48 @@ static bgfx::ProgramHandle loadProgram(const char* _vsName, const char* _fsName)
 	return program;
 }
 
-struct Aabb
-{
-	float m_min[3];
-	float m_max[3];
-};
-
-struct Obb
-{
-	float m_mtx[16];
-};
-
-struct Sphere
-{
-	float m_center[3];
-	float m_radius;
-};
-
-struct Primitive
-{
-	uint32_t m_startIndex;
-	uint32_t m_numIndices;
-	uint32_t m_startVertex;
-	uint32_t m_numVertices;
-
-	Sphere m_sphere;
-	Aabb m_aabb;
-	Obb m_obb;
-};
-
-typedef std::vector<Primitive> PrimitiveArray;
-
-struct Group
-{
-	Group()
-	{
-		reset();
-	}
-
-	void reset()
-	{
-		m_vbh.idx = bgfx::invalidHandle;
-		m_ibh.idx = bgfx::invalidHandle;
-		m_prims.clear();
-	}
-
-	bgfx::VertexBufferHandle m_vbh;
-	bgfx::IndexBufferHandle m_ibh;
-	Sphere m_sphere;
-	Aabb m_aabb;
-	Obb m_obb;
-	PrimitiveArray m_prims;
-};
-
 struct Mesh
 {
 	void load(const char* _filePath)
 	{
-#define BGFX_CHUNK_MAGIC_VB BX_MAKEFOURCC('V', 'B', ' ', 0x0)
-#define BGFX_CHUNK_MAGIC_IB BX_MAKEFOURCC('I', 'B', ' ', 0x0)
-#define BGFX_CHUNK_MAGIC_PRI BX_MAKEFOURCC('P', 'R', 'I', 0x0)
-
-		bx::CrtFileReader reader;
-		reader.open(_filePath);
+		meshLoad(m_groups, m_decl, _filePath);
 
-		Group group;
-
-		uint32_t chunk;
-		while (4 == bx::read(&reader, chunk) )
+		cullSpheresAlloc(m_groupSpheres, uint32_t(m_groups.size() ) );
+		m_groupVisible.resize(m_groups.size() + 1);
+		for (uint32_t ii = 0, num = uint32_t(m_groups.size() ); ii < num; ++ii)
 		{
-			switch (chunk)
-			{
-			case BGFX_CHUNK_MAGIC_VB:
-				{
-					bx::read(&reader, group.m_sphere);
-					bx::read(&reader, group.m_aabb);
-					bx::read(&reader, group.m_obb);
-
-					bx::read(&reader, m_decl);
-					uint16_t stride = m_decl.getStride();
-
-					uint16_t numVertices;
-					bx::read(&reader, numVertices);
-					const bgfx::Memory* mem = bgfx::alloc(numVertices*stride);
-					bx::read(&reader, mem->data, mem->size);
-
-					group.m_vbh = bgfx::createVertexBuffer(mem, m_decl);
-				}
-				break;
-
-			case BGFX_CHUNK_MAGIC_IB:
-				{
-					uint32_t numIndices;
-					bx::read(&reader, numIndices);
-					const bgfx::Memory* mem = bgfx::alloc(numIndices*2);
-					bx::read(&reader, mem->data, mem->size);
-					group.m_ibh = bgfx::createIndexBuffer(mem);
-				}
-				break;
-
-			case BGFX_CHUNK_MAGIC_PRI:
-				{
-					uint16_t len;
-					bx::read(&reader, len);
-
-					std::string material;
-					material.resize(len);
-					bx::read(&reader, const_cast<char*>(material.c_str() ), len);
-
-					uint16_t num;
-					bx::read(&reader, num);
-
-					for (uint32_t ii = 0; ii < num; ++ii)
-					{
-						bx::read(&reader, len);
-
-						std::string name;
-						name.resize(len);
-						bx::read(&reader, const_cast<char*>(name.c_str() ), len);
-
-						Primitive prim;
-						bx::read(&reader, prim.m_startIndex);
-						bx::read(&reader, prim.m_numIndices);
-						bx::read(&reader, prim.m_startVertex);
-						bx::read(&reader, prim.m_numVertices);
-						bx::read(&reader, prim.m_sphere);
-						bx::read(&reader, prim.m_aabb);
-						bx::read(&reader, prim.m_obb);
-
-						group.m_prims.push_back(prim);
-					}
-
-					m_groups.push_back(group);
-					group.reset();
-				}
-				break;
-
-			default:
-				DBG("%08x at %d", chunk, reader.seek() );
-				break;
-			}
+			cullSpheresSet(m_groupSpheres, ii, m_groups[ii].m_sphere);
 		}
-
-		reader.close();
 	}
 
 	void unload()
 	{
-		for (GroupArray::const_iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it)
-		{
-			const Group& group = *it;
-			bgfx::destroyVertexBuffer(group.m_vbh);
+		cullSpheresFree(m_groupSpheres);
 
-			if (bgfx::isValid(group.m_ibh) )
-			{
-				bgfx::destroyIndexBuffer(group.m_ibh);
-			}
-		}
-		m_groups.clear();
+		meshUnload(m_groups);
 	}
 
-	void submit(bgfx::ProgramHandle _program, float* _mtx, bool _blend)
+	void submit(bgfx::ProgramHandle _program, float* _mtx, const float* _viewProj, bool _blend)
 	{
-		for (GroupArray::const_iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it)
+		float mvp[16];
+		mtxMul(mvp, _mtx, _viewProj);
+
+		// Group spheres are in model space, cull against model space
+		// frustum.
+		Frustum frustum;
+		frustumFromMtx(frustum, mvp);
+		const uint32_t numVisible = cullSpheres(&m_groupVisible[0], m_groupSpheres, frustum);
+
+		if (0 == numVisible)
 		{
-			const Group& group = *it;
+			// Drop textures and uniforms set for this mesh.
+			bgfx::discard();
+			return;
+		}
+
+		for (uint32_t ii = 0; ii < numVisible; ++ii)
+		{
+			const MeshGroup& group = m_groups[m_groupVisible[ii] ];
 
 			// Set model matrix for rendering.
 			bgfx::setTransform(_mtx);
@@ -295,9 +175,25 @@ struct Mesh
 		}
 	}
 
+	uint32_t getNumTriangles() const
+	{
+		uint32_t numTriangles = 0;
+		for (MeshGroupArray::const_iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it)
+		{
+			for (MeshPrimitiveArray::const_iterator prim = it->m_prims.begin(), primEnd = it->m_prims.end(); prim != primEnd; ++prim)
+			{
+				numTriangles += prim->m_numIndices/3;
+			}
+		}
+
+		return numTriangles;
+	}
+
 	bgfx::VertexDecl m_decl;
-	typedef std::vector<Group> GroupArray;
-	GroupArray m_groups;
+	MeshGroupArray m_groups;
+
+	CullSpheres m_groupSpheres;
+	std::vector<uint32_t> m_groupVisible;
 };
 
 int _main_(int /*_argc*/, char** /*_argv*/)
@@ -391,12 +287,78 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 
 	free(data);
 
+	// Sphere around top and trunk groups of most detailed LOD.
+	Sphere treeSphere;
+	{
+		Aabb aabb;
+		uint32_t num = 0;
+		const Mesh* meshes[2] = { &mesh_top[0], &mesh_trunk[0] };
+		for (uint32_t ii = 0; ii < 2; ++ii)
+		{
+			for (MeshGroupArray::const_iterator it = meshes[ii]->m_groups.begin(), itEnd = meshes[ii]->m_groups.end(); it != itEnd; ++it, ++num)
+			{
+				const Sphere& sphere = it->m_sphere;
+				for (uint32_t jj = 0; jj < 3; ++jj)
+				{
+					const float min = sphere.m_center[jj] - sphere.m_radius;
+					const float max = sphere.m_center[jj] + sphere.m_radius;
+					aabb.m_min[jj] = 0 == num ? min : fminf(aabb.m_min[jj], min);
+					aabb.m_max[jj] = 0 == num ? max : fmaxf(aabb.m_max[jj], max);
+				}
+			}
+		}
+
+		treeSphere.m_radius = 0.0f;
+		for (uint32_t ii = 0; ii < 3; ++ii)
+		{
+			treeSphere.m_center[ii] = (aabb.m_min[ii] + aabb.m_max[ii])*0.5f;
+		}
+
+		for (uint32_t ii = 0; ii < 2; ++ii)
+		{
+			for (MeshGroupArray::const_iterator it = meshes[ii]->m_groups.begin(), itEnd = meshes[ii]->m_groups.end(); it != itEnd; ++it)
+			{
+				const Sphere& sphere = it->m_sphere;
+				const float dist[3] =
+				{
+					sphere.m_center[0] - treeSphere.m_center[0],
+					sphere.m_center[1] - treeSphere.m_center[1],
+					sphere.m_center[2] - treeSphere.m_center[2],
+				};
+				treeSphere.m_radius = fmaxf(treeSphere.m_radius, sqrtf(vec3Dot(dist, dist) ) + sphere.m_radius);
+			}
+		}
+	}
+
+	// Tree LOD meshes are hand made and don't have LOD chunks with errors.
+	// Errors are picked so that at 720p and 1 pixel threshold LODs switch
+	// at 2.5 and 5.0 units from the tree, as they used to when LODs were
+	// picked by eye distance.
+	const float projScale720p = 360.0f/tanf(toRad(30.0f) );
+	const float switchDistance[3] = { 0.0f, 2.5f, 5.0f };
+
+	LodChain treeChain;
+	treeChain.m_num = 3;
+	for (uint32_t ii = 0; ii < 3; ++ii)
+	{
+		const float distance = fmaxf(switchDistance[ii] - treeSphere.m_radius, 0.01f);
+		treeChain.m_error[ii] = 0 == ii ? 0.0f : distance/projScale720p;
+		treeChain.m_numTriangles[ii] = mesh_top[ii].getNumTriangles() + mesh_trunk[ii].getNumTriangles();
+	}
+
+	CullSpheres treeSpheres;
+	cullSpheresAlloc(treeSpheres, 1);
+	cullSpheresSet(treeSpheres, 0, treeSphere);
+	uint32_t treeVisible[1];
+
+	LodSelector lodSelector(1);
+	lodSelector.setObject(0, &treeChain);
+
 	int32_t scrollArea = 0;
 
 	bool transitions = true;
-	int transitionFrame = 0;
-	int currLOD = 0;
-	int targetLOD = 0;
+	float threshold = 1.0f;
+	float triangleBudget = 0.0f;
 
 	float at[3] = { 0.0f, 1.0f, 0.0f };
 	float eye[3] = { 0.0f, 1.0f, -2.0f };
@@ -413,7 +375,7 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 			, height
 			);
 
-		imguiBeginScrollArea("Toggle transitions", width - width / 5 - 10, 10, width / 5, height / 6, &scrollArea);
+		imguiBeginScrollArea("Toggle transitions", width - width / 5 - 10, 10, width / 5, height / 3, &scrollArea);
 		imguiSeparatorLine();
 
 		if (imguiButton(transitions ? "ON" : "OFF") )
@@ -423,6 +385,8 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 
 		static float distance = 2.0f;
 		imguiSlider("Distance", &distance, 2.0f, 6.0f, .01f);
+		imguiSlider("Error threshold [px]", &threshold, 0.25f, 8.0f, 0.25f);
+		imguiSlider("Triangle budget (0 = off)", &triangleBudget, 0.0f, float(treeChain.m_numTriangles[0]), 100.0f);
 
 		imguiEndScrollArea();
 		imguiEndFrame();
@@ -447,6 +411,7 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 		bgfx::dbgTextPrintf(0, 2, 0x6f, "Description: Mesh LOD transitions.");
 		bgfx::dbgTextPrintf(0, 3, 0x0f, "Frame: % 7.3f[ms]", double(frameTime)*toMs);
 		bgfx::dbgTextPrintf(0, 4, transitions ? 0x2f : 0x1f, transitions ? "Transitions on" : "Transitions off");
+		bgfx::dbgTextPrintf(0, 5, 0x0f, "Triangles: %d, error scale: %.2f", lodSelector.getNumTriangles(), lodSelector.getErrorScale() );
 
 		eye[2] = -distance;
 				
@@ -458,75 +423,52 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 		// Set view and projection matrix for view 0.
 		bgfx::setViewTransform(0, view, proj);
 
+		float viewProj[16];
+		mtxMul(viewProj, view, proj);
+
 		float mtx[16];
 		mtxIdentity(mtx); 
 
-		float stipple[3];
-		float stippleInv[3];
+		Frustum frustum;
+		frustumFromMtx(frustum, viewProj);
+		const uint32_t numVisible = cullSpheres(treeVisible, treeSpheres, frustum);
 
-		const int currentLODframe = transitions ? 32-transitionFrame : 32;
-		const int mainLOD = transitions ? currLOD : targetLOD;
-		
-		stipple[0] = 0.0f;
-		stipple[1] = -1.0f;
-		stipple[2] = (float(currentLODframe)*4.0f/255.0f) - (1.0f/255.0f);
-	
-		stippleInv[0] = (float(31)*4.0f/255.0f);
-		stippleInv[1] = 1.0f;
-		stippleInv[2] = (float(transitionFrame)*4.0f/255.0f) - (1.0f/255.0f);
-
-		bgfx::setTexture(0, u_texColor, textureBark);
-		bgfx::setTexture(1, u_texStipple, textureStipple);
-		bgfx::setUniform(u_stipple, stipple);
-		mesh_trunk[mainLOD].submit(program, mtx, false);
-
-		bgfx::setTexture(0, u_texColor, textureLeafs);
-		bgfx::setTexture(1, u_texStipple, textureStipple);
-		bgfx::setUniform(u_stipple, stipple);
-		mesh_top[mainLOD].submit(program, mtx, true);
-
-		if (transitions 
-		&& (transitionFrame != 0) )
-		{
-			bgfx::setTexture(0, u_texColor, textureBark);
-			bgfx::setTexture(1, u_texStipple, textureStipple);
-			bgfx::setUniform(u_stipple, stippleInv);
-			mesh_trunk[targetLOD].submit(program, mtx, false);
-
-			bgfx::setTexture(0, u_texColor, textureLeafs);
-			bgfx::setTexture(1, u_texStipple, textureStipple);
-			bgfx::setUniform(u_stipple, stippleInv);
-			mesh_top[targetLOD].submit(program, mtx, true);
-		}
-	
-		int lod = 0;
-		if (eye[2] < -2.5f)
-		{
-			lod = 1;
-		}
+		lodSelector.setThreshold(threshold);
+		lodSelector.setTriangleBudget(uint32_t(triangleBudget) );
+		lodSelector.setTransitionFrames(transitions ? 32 : 0);
+		const float projScale = proj[5]*float(height)*0.5f;
+		const uint32_t numDraws = lodSelector.select(treeSpheres, treeVisible, numVisible, eye, projScale);
+		const LodDraw* draws = lodSelector.getDraws();
 
-		if (eye[2] < -5.0f)
+		for (uint32_t ii = 0; ii < numDraws; ++ii)
 		{
-			lod = 2;
-		}
+			const LodDraw& draw = draws[ii];
 
-		if (targetLOD!=lod)
-		{
-			if (targetLOD==currLOD)
+			// Outgoing LOD fades out while incoming LOD fades in, with
+			// complementary stipple patterns.
+			float stipple[3];
+			if (draw.m_incoming)
 			{
-				targetLOD = lod;
+				stipple[0] = (float(31)*4.0f/255.0f);
+				stipple[1] = 1.0f;
+				stipple[2] = (float(draw.m_transition)*4.0f/255.0f) - (1.0f/255.0f);
+			}
+			else
+			{
+				stipple[0] = 0.0f;
+				stipple[1] = -1.0f;
+				stipple[2] = (float(32-draw.m_transition)*4.0f/255.0f) - (1.0f/255.0f);
 			}
-		}
-		
-		if (currLOD != targetLOD)
-		{
-			transitionFrame++;
-		}
 
-		if (transitionFrame>32)
-		{
-			currLOD = targetLOD;
-			transitionFrame = 0;
+			bgfx::setTexture(0, u_texColor, textureBark);
+			bgfx::setTexture(1, u_texStipple, textureStipple);
+			bgfx::setUniform(u_stipple, stipple);
+			mesh_trunk[draw.m_lod].submit(program, mtx, viewProj, false);
+
+			bgfx::setTexture(0, u_texColor, textureLeafs);
+			bgfx::setTexture(1, u_texStipple, textureStipple);
+			bgfx::setUniform(u_stipple, stipple);
+			mesh_top[draw.m_lod].submit(program, mtx, viewProj, true);
 		}
 
 		// Advance to next frame. Rendering thread will be kicked to 
@@ -536,6 +478,8 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 
 	imguiDestroy();
 
+	cullSpheresFree(treeSpheres);
+
 	for (uint32_t ii = 0; ii < 3; ++ii)
 	{
 		mesh_top[ii].unload();
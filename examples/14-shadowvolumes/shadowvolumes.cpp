@@ -8,11 +8,6 @@
 
 #include <string>
 #include <vector>
-#include <unordered_map>
-#include <map>
-
-namespace std { namespace tr1 {} }
-using namespace std::tr1;
 
 #include "common.h"
 
@@ -20,14 +15,13 @@ using namespace std::tr1;
 #include <bx/timer.h>
 #include <bx/readerwriter.h>
 #include <bx/allocator.h>
-#include <bx/hash.h>
-#include <bx/float4_t.h>
 #include "entry/entry.h"
 #include "camera.h"
 #include "fpumath.h"
+#include "meshloader.h"
 #include "imgui/imgui.h"
+#include "shadowvolume.h"
 
-#define SV_USE_SIMD 1
 #define MAX_INSTANCE_COUNT 25
 #define MAX_LIGHTS_COUNT 5
 
@@ -238,29 +232,6 @@ void mtxBillboard(float* __restrict _result
 	_result[15] = 1.0f;
 }
 
-void planeNormal(float* __restrict _result
-				 , const float* __restrict _v0
-				 , const float* __restrict _v1
-				 , const float* __restrict _v2
-				 )
-{
-	float vec0[3], vec1[3];
-	float cross[3];
-
-	vec0[0] = _v1[0] - _v0[0];
-	vec0[1] = _v1[1] - _v0[1];
-	vec0[2] = _v1[2] - _v0[2];
-
-	vec1[0] = _v2[0] - _v1[0];
-	vec1[1] = _v2[1] - _v1[1];
-	vec1[2] = _v2[2] - _v1[2];
-
-	vec3Cross(cross, vec0, vec1);
-	vec3Norm(_result, cross);
-
-	_result[3] = -vec3Dot(_result, _v0);
-}
-
 struct Uniforms
 {
 	void init()
@@ -660,417 +631,32 @@ void submitMask(uint32_t _viewMask, int32_t _depth = 0)
 	s_viewMask |= _viewMask;
 }
 
-struct Aabb
-{
-	float m_min[3];
-	float m_max[3];
-};
-
-struct Obb
-{
-	float m_mtx[16];
-};
-
-struct Sphere
-{
-	float m_center[3];
-	float m_radius;
-};
-
-struct Primitive
-{
-	uint32_t m_startIndex;
-	uint32_t m_numIndices;
-	uint32_t m_startVertex;
-	uint32_t m_numVertices;
-
-	Sphere m_sphere;
-	Aabb m_aabb;
-	Obb m_obb;
-};
-
-typedef std::vector<Primitive> PrimitiveArray;
-
-struct Face
-{
-	uint16_t m_i[3];
-	float m_plane[4];
-};
-typedef std::vector<Face> FaceArray;
-
-struct Edge
-{
-	bool m_faceReverseOrder[2];
-	uint8_t m_faceIndex;
-	uint16_t m_i0, m_i1;
-};
-
-struct Plane
-{
-	float m_plane[4];
-};
-
-struct HalfEdge
+// Shadow volume adjacency from ADJ chunk (geometryc --adjacency).
+static bool readAdjacency(bx::ReaderSeekerI* _reader, uint32_t _chunk, uint32_t _groupIndex, const MeshGroup& _group, const bgfx::VertexDecl& _decl, void* _userData)
 {
-#define INVALID_EDGE_INDEX UINT16_MAX
-	uint16_t m_secondIndex;
-	bool m_marked;
-};
-
-struct HalfEdges
-{
-	HalfEdges()
-		: m_data()
-		, m_offsets()
-		, m_endPtr()
+	if (MESH_CHUNK_MAGIC_ADJ != _chunk)
 	{
+		return false;
 	}
 
-	void init(uint16_t* _indices, uint32_t _numIndices)
-	{
-		m_data = (HalfEdge*)malloc(2 * _numIndices * sizeof(HalfEdge) );
-
-		std::unordered_map<uint16_t, std::vector<uint16_t> > edges;
-		for (uint32_t ii = 0; ii < _numIndices; ii+=3)
-		{
-			uint16_t idx0 = _indices[ii];
-			uint16_t idx1 = _indices[ii+1];
-			uint16_t idx2 = _indices[ii+2];
-
-			edges[idx0].push_back(idx1);
-			edges[idx1].push_back(idx2);
-			edges[idx2].push_back(idx0);
-		}
+	std::vector<SvMesh>& svMeshes = *(std::vector<SvMesh>*)_userData;
+	SvMesh svMesh;
+	memset(&svMesh, 0, sizeof(SvMesh) );
+	svMeshes.resize(_groupIndex+1, svMesh);
 
-		uint32_t numRows = (uint32_t)edges.size();
-		m_offsets = (uint32_t*)malloc(numRows * sizeof(uint32_t) );
-
-		HalfEdge* he = m_data;
-		for (uint32_t ii = 0; ii < numRows; ++ii)
-		{
-			m_offsets[ii] = uint32_t(he - m_data);
-
-			std::vector<uint16_t>& row = edges[ii];
-			for (uint32_t jj = 0, end = (uint32_t)row.size(); jj < end; ++jj)
-			{
-				he->m_secondIndex = row[jj];
-				he->m_marked = false;
-				++he;
-			}
-			he->m_secondIndex = INVALID_EDGE_INDEX;
-			++he;
-		}
-		he->m_secondIndex = 0;
-		m_endPtr = he;
-	}
-
-	void destroy()
-	{
-		free(m_data);
-		m_data = NULL;
-		free(m_offsets);
-		m_offsets = NULL;
-	}
-
-	void mark(uint16_t _firstIndex, uint16_t _secondIndex)
-	{
-		HalfEdge* ptr = &m_data[m_offsets[_firstIndex]];
-		while (INVALID_EDGE_INDEX != ptr->m_secondIndex)
-		{
-			if (ptr->m_secondIndex == _secondIndex)
-			{
-				ptr->m_marked = true;
-				break;
-			}
-			++ptr;
-		}
-	}
-
-	bool unmark(uint16_t _firstIndex, uint16_t _secondIndex)
-	{
-		bool ret = false;
-		HalfEdge* ptr = &m_data[m_offsets[_firstIndex]];
-		while (INVALID_EDGE_INDEX != ptr->m_secondIndex)
-		{
-			if (ptr->m_secondIndex == _secondIndex && ptr->m_marked)
-			{
-				ptr->m_marked = false;
-				ret = true;
-				break;
-			}
-			++ptr;
-		}
-		return ret;
-	}
-
-	inline HalfEdge* begin() const
+	if (!svMeshRead(_reader, svMeshes[_groupIndex], _decl, _group.m_vertices, _group.m_numVertices, _group.m_indices, _group.m_numIndices) )
 	{
-		return m_data;
-	}
-
-	inline HalfEdge* end() const
-	{
-		return m_endPtr;
-	}
-
-	HalfEdge* m_data;
-	uint32_t* m_offsets;
-	HalfEdge* m_endPtr;
-};
-
-struct WeldedVertex
-{
-	uint16_t m_v;
-	bool m_welded;
-};
-
-inline float sqLength(const float _a[3], const float _b[3])
-{
-	const float xx = _a[0] - _b[0];
-	const float yy = _a[1] - _b[1];
-	const float zz = _a[2] - _b[2];
-	return xx*xx + yy*yy + zz*zz;
-}
-
-uint16_t weldVertices(WeldedVertex* _output, const bgfx::VertexDecl& _decl, const void* _data, uint16_t _num, float _epsilon)
-{
-	const uint32_t hashSize = bx::uint32_nextpow2(_num);
-	const uint32_t hashMask = hashSize-1;
-	const float epsilonSq = _epsilon*_epsilon;
-
-	uint32_t numVertices = 0;
-
-	const uint32_t size = sizeof(uint16_t)*(hashSize + _num);
-	uint16_t* hashTable = (uint16_t*)alloca(size);
-	memset(hashTable, 0xff, size);
-
-	uint16_t* next = hashTable + hashSize;
-
-	for (uint32_t ii = 0; ii < _num; ++ii)
-	{
-		float pos[4];
-		vertexUnpack(pos, bgfx::Attrib::Position, _decl, _data, ii);
-		uint32_t hashValue = bx::hashMurmur2A(pos, 3*sizeof(float) ) & hashMask;
-
-		uint16_t offset = hashTable[hashValue];
-		for (; UINT16_MAX != offset; offset = next[offset])
-		{
-			float test[4];
-			vertexUnpack(test, bgfx::Attrib::Position, _decl, _data, _output[offset].m_v);
-
-			if (sqLength(test, pos) < epsilonSq)
-			{
-				_output[ii].m_v = _output[offset].m_v;
-				_output[ii].m_welded = true;
-				break;
-			}
-		}
-
-		if (UINT16_MAX == offset)
-		{
-			_output[ii].m_v = ii;
-			_output[ii].m_welded = false;
-			next[ii] = hashTable[hashValue];
-			hashTable[hashValue] = ii;
-			numVertices++;
-		}
+		DBG("Invalid adjacency chunk at %d", _reader->seek() );
 	}
 
-	return numVertices;
+	return true;
 }
 
-struct Group
-{
-	Group()
-	{
-		reset();
-	}
-
-	void reset()
-	{
-		m_vbh.idx = bgfx::invalidHandle;
-		m_ibh.idx = bgfx::invalidHandle;
-		m_numVertices = 0;
-		m_vertices = NULL;
-		m_numIndices = 0;
-		m_indices = NULL;
-		m_numEdges = 0;
-		m_edges = NULL;
-		m_edgePlanesUnalignedPtr = NULL;
-		m_prims.clear();
-	}
-
-	typedef struct { float f[6]; } f6_t;
-
-	struct EdgeAndPlane
-	{
-		EdgeAndPlane(uint16_t _i0, uint16_t _i1)
-			: m_faceIndex(0)
-			, m_i0(_i0)
-			, m_i1(_i1)
-		{
-		}
-
-		bool m_faceReverseOrder[2];
-		uint8_t m_faceIndex;
-		uint16_t m_i0, m_i1;
-		Plane m_plane[2];
-	};
-
-	void fillStructures(const bgfx::VertexDecl& _decl)
-	{
-		uint16_t stride = _decl.getStride();
-		m_faces.clear();
-		m_halfEdges.destroy();
-
-		//Init halfedges.
-		m_halfEdges.init(m_indices, m_numIndices);
-
-		//Init faces and edges.
-		m_faces.reserve(m_numIndices/3); //1 face = 3 indices
-		m_edges = (Edge*)malloc(m_numIndices * sizeof(Edge)); //1 triangle = 3 indices = 3 edges.
-		m_edgePlanesUnalignedPtr = (Plane*)malloc(m_numIndices * sizeof(Plane) + 15);
-		m_edgePlanes = (Plane*)bx::alignPtr(m_edgePlanesUnalignedPtr, 0, 16);
-
-		typedef std::map<std::pair<uint16_t, uint16_t>, EdgeAndPlane> EdgeMap;
-		EdgeMap edgeMap;
-
-		//Get unique indices.
-		WeldedVertex* uniqueVertices = (WeldedVertex*)malloc(m_numVertices*sizeof(WeldedVertex) );
-		::weldVertices(uniqueVertices, _decl, m_vertices, m_numVertices, 0.0001f);
-		uint16_t* uniqueIndices = (uint16_t*)malloc(m_numIndices*sizeof(uint16_t) );
-		for (uint32_t ii = 0; ii < m_numIndices; ++ii)
-		{
-			uint16_t index = m_indices[ii];
-			if (uniqueVertices[index].m_welded)
-			{
-				uniqueIndices[ii] = uniqueVertices[index].m_v;
-			}
-			else
-			{
-				uniqueIndices[ii] = index;
-			}
-		}
-		free(uniqueVertices);
-
-		for (uint32_t ii = 0, size = m_numIndices/3; ii < size; ++ii)
-		{
-			const uint16_t* indices = &m_indices[ii*3];
-			const uint16_t i0 = indices[0];
-			const uint16_t i1 = indices[1];
-			const uint16_t i2 = indices[2];
-			const float* v0 = (float*)&m_vertices[i0*stride];
-			const float* v1 = (float*)&m_vertices[i1*stride];
-			const float* v2 = (float*)&m_vertices[i2*stride];
-
-			float plane[4];
-			planeNormal(plane, v0, v2, v1);
-
-			Face face;
-			face.m_i[0] = i0;
-			face.m_i[1] = i1;
-			face.m_i[2] = i2;
-			memcpy(face.m_plane, plane, 4*sizeof(float) );
-			m_faces.push_back(face);
-
-			//Use unique indices for EdgeMap.
-			const uint16_t* uindices = &uniqueIndices[ii*3];
-			const uint16_t ui0 = uindices[0];
-			const uint16_t ui1 = uindices[1];
-			const uint16_t ui2 = uindices[2];
-
-			const uint16_t triangleEdge[3][2] =
-			{
-				{ui0, ui1},
-				{ui1, ui2},
-				{ui2, ui0},
-			};
-
-			for (uint8_t jj = 0; jj < 3; ++jj)
-			{
-				const uint16_t ui0 = triangleEdge[jj][0];
-				const uint16_t ui1 = triangleEdge[jj][1];
-
-				std::pair<uint16_t, uint16_t> key    = std::make_pair(ui0, ui1);
-				std::pair<uint16_t, uint16_t> keyInv = std::make_pair(ui1, ui0);
-
-				EdgeMap::iterator iter = edgeMap.find(keyInv);
-				if (iter != edgeMap.end())
-				{
-					EdgeAndPlane& ep = iter->second;
-					memcpy(ep.m_plane[ep.m_faceIndex].m_plane, plane, 4*sizeof(float) );
-					ep.m_faceReverseOrder[ep.m_faceIndex] = true;
-				}
-				else
-				{
-					std::pair<EdgeMap::iterator, bool> result = edgeMap.insert(std::make_pair(key, EdgeAndPlane(ui0, ui1) ) );
-					EdgeAndPlane& ep = result.first->second;
-					memcpy(ep.m_plane[ep.m_faceIndex].m_plane, plane, 4*sizeof(float) );
-					ep.m_faceReverseOrder[ep.m_faceIndex] = false;
-					ep.m_faceIndex++;
-				}
-			}
-		}
-
-		free(uniqueIndices);
-
-		uint32_t index = 0;
-		for (EdgeMap::const_iterator iter = edgeMap.begin(), end = edgeMap.end(); iter != end; ++iter)
-		{
-			Edge* edge = &m_edges[m_numEdges];
-			Plane* plane = &m_edgePlanes[index];
-
-			memcpy(edge, iter->second.m_faceReverseOrder, sizeof(Edge));
-			memcpy(plane, iter->second.m_plane, 2 * sizeof(Plane));
-
-			m_numEdges++;
-			index += 2;
-		}
-	}
-
-	void unload()
-	{
-		bgfx::destroyVertexBuffer(m_vbh);
-		if (bgfx::invalidHandle != m_ibh.idx)
-		{
-			bgfx::destroyIndexBuffer(m_ibh);
-		}
-		free(m_vertices);
-		m_vertices = NULL;
-		free(m_indices);
-		m_indices = NULL;
-		free(m_edges);
-		m_edges = NULL;
-		free(m_edgePlanesUnalignedPtr);
-		m_edgePlanesUnalignedPtr = NULL;
-		m_halfEdges.destroy();
-	}
-
-	bgfx::VertexBufferHandle m_vbh;
-	bgfx::IndexBufferHandle m_ibh;
-	uint16_t m_numVertices;
-	uint8_t* m_vertices;
-	uint32_t m_numIndices;
-	uint16_t* m_indices;
-	Sphere m_sphere;
-	Aabb m_aabb;
-	Obb m_obb;
-	PrimitiveArray m_prims;
-	uint32_t m_numEdges;
-	Edge* m_edges;
-	Plane* m_edgePlanesUnalignedPtr;
-	Plane* m_edgePlanes;
-	FaceArray m_faces;
-	HalfEdges m_halfEdges;
-};
-
-typedef std::vector<Group> GroupArray;
-
 struct Mesh
 {
 	void load(const void* _vertices, uint32_t _numVertices, const bgfx::VertexDecl _decl, const uint16_t* _indices, uint32_t _numIndices)
 	{
-		Group group;
+		MeshGroup group;
 		const bgfx::Memory* mem;
 		uint32_t size;
 
@@ -1094,118 +680,53 @@ struct Mesh
 		mem = bgfx::makeRef(group.m_indices, size);
 		group.m_ibh = bgfx::createIndexBuffer(mem);
 
+		SvMesh svMesh;
+		svMeshBuild(svMesh, _decl, group.m_vertices, uint16_t(_numVertices), group.m_indices, _numIndices);
+
 		m_groups.push_back(group);
+		m_svMeshes.push_back(svMesh);
 	}
 
 	void load(const char* _filePath)
 	{
-#define BGFX_CHUNK_MAGIC_VB BX_MAKEFOURCC('V', 'B', ' ', 0x0)
-#define BGFX_CHUNK_MAGIC_IB BX_MAKEFOURCC('I', 'B', ' ', 0x0)
-#define BGFX_CHUNK_MAGIC_PRI BX_MAKEFOURCC('P', 'R', 'I', 0x0)
-
-		bx::CrtFileReader reader;
-		reader.open(_filePath);
-
-		Group group;
-
-		uint32_t chunk;
-		while (4 == bx::read(&reader, chunk) )
+		if (!meshLoad(m_groups, m_decl, _filePath, MESH_LOAD_KEEP_DATA, readAdjacency, &m_svMeshes) )
 		{
-			switch (chunk)
+			// Adjacency might be read for groups released on failure.
+			for (uint32_t ii = uint32_t(m_groups.size() ), num = uint32_t(m_svMeshes.size() ); ii < num; ++ii)
 			{
-			case BGFX_CHUNK_MAGIC_VB:
-				{
-					bx::read(&reader, group.m_sphere);
-					bx::read(&reader, group.m_aabb);
-					bx::read(&reader, group.m_obb);
-
-					bx::read(&reader, m_decl);
-					uint16_t stride = m_decl.getStride();
-
-					bx::read(&reader, group.m_numVertices);
-					const uint32_t size = group.m_numVertices*stride;
-					group.m_vertices = (uint8_t*)malloc(size);
-					bx::read(&reader, group.m_vertices, size);
-
-					const bgfx::Memory* mem = bgfx::makeRef(group.m_vertices, size);
-					group.m_vbh = bgfx::createVertexBuffer(mem, m_decl);
-				}
-				break;
-
-			case BGFX_CHUNK_MAGIC_IB:
-				{
-					bx::read(&reader, group.m_numIndices);
-					const uint32_t size = group.m_numIndices*2;
-					group.m_indices = (uint16_t*)malloc(size);
-					bx::read(&reader, group.m_indices, size);
-
-					const bgfx::Memory* mem = bgfx::makeRef(group.m_indices, size);
-					group.m_ibh = bgfx::createIndexBuffer(mem);
-				}
-				break;
-
-			case BGFX_CHUNK_MAGIC_PRI:
-				{
-					uint16_t len;
-					bx::read(&reader, len);
-
-					std::string material;
-					material.resize(len);
-					bx::read(&reader, const_cast<char*>(material.c_str() ), len);
-
-					uint16_t num;
-					bx::read(&reader, num);
-
-					for (uint32_t ii = 0; ii < num; ++ii)
-					{
-						bx::read(&reader, len);
-
-						std::string name;
-						name.resize(len);
-						bx::read(&reader, const_cast<char*>(name.c_str() ), len);
-
-						Primitive prim;
-						bx::read(&reader, prim.m_startIndex);
-						bx::read(&reader, prim.m_numIndices);
-						bx::read(&reader, prim.m_startVertex);
-						bx::read(&reader, prim.m_numVertices);
-						bx::read(&reader, prim.m_sphere);
-						bx::read(&reader, prim.m_aabb);
-						bx::read(&reader, prim.m_obb);
-
-						group.m_prims.push_back(prim);
-					}
-
-					m_groups.push_back(group);
-					group.reset();
-				}
-				break;
-
-			default:
-				DBG("%08x at %d", chunk, reader.seek() );
-				break;
+				svMeshFree(m_svMeshes[ii]);
 			}
 		}
 
-		reader.close();
+		// Build adjacency of groups without ADJ chunk.
+		SvMesh svMesh;
+		memset(&svMesh, 0, sizeof(SvMesh) );
+		m_svMeshes.resize(m_groups.size(), svMesh);
 
-		for (GroupArray::iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it)
+		for (uint32_t ii = 0, num = uint32_t(m_groups.size() ); ii < num; ++ii)
 		{
-			it->fillStructures(m_decl);
+			const MeshGroup& group = m_groups[ii];
+			if (NULL == m_svMeshes[ii].m_data)
+			{
+				svMeshBuild(m_svMeshes[ii], m_decl, group.m_vertices, group.m_numVertices, group.m_indices, group.m_numIndices);
+			}
 		}
 	}
 
 	void unload()
 	{
-		for (GroupArray::iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it)
+		for (std::vector<SvMesh>::iterator it = m_svMeshes.begin(), itEnd = m_svMeshes.end(); it != itEnd; ++it)
 		{
-			it->unload();
+			svMeshFree(*it);
 		}
-		m_groups.clear();
+		m_svMeshes.clear();
+
+		meshUnload(m_groups);
 	}
 
 	bgfx::VertexDecl m_decl;
-	GroupArray m_groups;
+	MeshGroupArray m_groups;
+	std::vector<SvMesh> m_svMeshes; //!< Adjacency of each group.
 };
 
 struct Model
@@ -1233,9 +754,9 @@ struct Model
 
 	void submit(uint8_t _viewId, float* _mtx, const RenderState& _renderState)
 	{
-		for (GroupArray::const_iterator it = m_mesh.m_groups.begin(), itEnd = m_mesh.m_groups.end(); it != itEnd; ++it)
+		for (MeshGroupArray::const_iterator it = m_mesh.m_groups.begin(), itEnd = m_mesh.m_groups.end(); it != itEnd; ++it)
 		{
-			const Group& group = *it;
+			const MeshGroup& group = *it;
 
 			// Set uniforms
 			s_uniforms.submitPerDrawUniforms();
@@ -1312,44 +833,6 @@ struct Instance
 	Model* m_model;
 };
 
-#define SV_INSTANCE_MEM_SIZE (1500 << 10)
-#define SV_INSTANCE_COUNT ( (25 > MAX_INSTANCE_COUNT) ? 25 : MAX_INSTANCE_COUNT)
-#define SV_PAGE_SIZE (SV_INSTANCE_MEM_SIZE * SV_INSTANCE_COUNT * MAX_LIGHTS_COUNT)
-
-struct ShadowVolumeAllocator
-{
-	ShadowVolumeAllocator()
-	{
-		m_mem = (uint8_t*)malloc(SV_PAGE_SIZE*2);
-		m_ptr = m_mem;
-		m_firstPage = true;
-	}
-
-	~ShadowVolumeAllocator()
-	{
-		free(m_mem);
-	}
-
-	void* alloc(uint32_t _size)
-	{
-		void* ret = (void*)m_ptr;
-		m_ptr += _size;
-		BX_CHECK(m_ptr - m_mem < (m_firstPage ? SV_PAGE_SIZE : 2 * SV_PAGE_SIZE), "Buffer overflow!");
-		return ret;
-	}
-
-	void swap()
-	{
-		m_ptr = m_firstPage ? m_mem + SV_PAGE_SIZE : m_mem;
-		m_firstPage = !m_firstPage;
-	}
-
-	uint8_t* m_mem;
-	uint8_t* m_ptr;
-	bool m_firstPage;
-};
-static ShadowVolumeAllocator s_svAllocator;
-
 struct ShadowVolumeImpl
 {
 	enum Enum
@@ -1384,24 +867,23 @@ struct ShadowVolume
 	bool m_cap;
 };
 
-void shadowVolumeLightTransform(float* __restrict _outLightPos
-							  , const float* __restrict _scale
-							  , const float* __restrict _rotate
-							  , const float* __restrict _translate
-							  , const float* __restrict _lightPos // world pos
-							  )
+void shadowVolumeLightTransformMtx(float* __restrict _result
+								 , const float* __restrict _scale
+								 , const float* __restrict _rotate
+								 , const float* __restrict _translate
+								 )
 {
 	/**
 	 * Instead of transforming all the vertices, transform light instead:
-	 * mtx = pivotTranslate -> rotateZYX -> invScale
-	 * light = mtx * origin
+	 * mtx = invTranslate -> rotateZYX -> invScale
+	 * light = lightPos * mtx
 	 */
 
-	float pivot[16];
-	mtxTranslate(pivot
-		, _lightPos[0] - _translate[0]
-		, _lightPos[1] - _translate[1]
-		, _lightPos[2] - _translate[2]
+	float invTranslate[16];
+	mtxTranslate(invTranslate
+		, -_translate[0]
+		, -_translate[1]
+		, -_translate[2]
 		);
 
 	float mzyx[16];
@@ -1419,345 +901,44 @@ void shadowVolumeLightTransform(float* __restrict _outLightPos
 		);
 
 	float tmp0[16];
-	mtxMul(tmp0, pivot, mzyx);
-
-	float mtx[16];
-	mtxMul(mtx, tmp0, invScale);
-
-	float origin[3] = { 0.0f, 0.0f, 0.0f };
-	vec3MulMtx(_outLightPos, origin, mtx);
+	mtxMul(tmp0, invTranslate, mzyx);
+	mtxMul(_result, tmp0, invScale);
 }
 
 void shadowVolumeCreate(ShadowVolume& _shadowVolume
-					  , Group& _group
-					  , uint16_t _stride
+					  , const SvVolume& _volume
 					  , const float* _mtx
 					  , const float* _light // in model space
-					  , ShadowVolumeImpl::Enum _impl = ShadowVolumeImpl::DepthPass
-					  , ShadowVolumeAlgorithm::Enum _algo = ShadowVolumeAlgorithm::FaceBased
-					  , bool _textureAsStencil = false
+					  , bool _cap
 					  )
 {
-	const uint8_t*    vertices   = _group.m_vertices;
-	const FaceArray&  faces      = _group.m_faces;
-	const Edge*       edges      = _group.m_edges;
-	const Plane*      edgePlanes = _group.m_edgePlanes;
-	const uint32_t    numEdges   = _group.m_numEdges;
-	HalfEdges&        halfEdges  = _group.m_halfEdges;
-
-	struct VertexData
-	{
-		VertexData()
-		{
-		}
-
-		VertexData(const float* _v3, float _extrude = 0.0f, float _k = 1.0f)
-		{
-			memcpy(m_v, _v3, 3*sizeof(float) );
-			m_extrude = _extrude;
-			m_k = _k;
-		}
-
-		float m_v[3];
-		float m_extrude;
-		float m_k;
-	};
-
-	bool cap = (ShadowVolumeImpl::DepthFail == _impl);
-
-	VertexData* verticesSide    = (VertexData*) s_svAllocator.alloc(20000 * sizeof(VertexData) );
-	uint16_t*   indicesSide     = (uint16_t*)   s_svAllocator.alloc(20000 * 3*sizeof(uint16_t) );
-	uint16_t*   indicesFrontCap = 0;
-	uint16_t*   indicesBackCap  = 0;
-
-	if (cap)
-	{
-		indicesFrontCap = (uint16_t*)s_svAllocator.alloc(80000 * 3*sizeof(uint16_t) );
-		indicesBackCap  = (uint16_t*)s_svAllocator.alloc(80000 * 3*sizeof(uint16_t) );
-	}
-
-	uint32_t vsideI    = 0;
-	uint32_t sideI     = 0;
-	uint32_t frontCapI = 0;
-	uint32_t backCapI  = 0;
-
-	uint16_t indexSide = 0;
-
-	if (ShadowVolumeAlgorithm::FaceBased == _algo)
-	{
-		for (FaceArray::const_iterator iter = faces.begin(), end = faces.end(); iter != end; ++iter)
-		{
-			const Face& face = *iter;
-
-			bool frontFacing = false;
-			float f = vec3Dot(face.m_plane, _light) + face.m_plane[3];
-			if (f > 0.0f)
-			{
-				frontFacing = true;
-				uint16_t triangleEdges[3][2] =
-				{
-					{ face.m_i[0], face.m_i[1] },
-					{ face.m_i[1], face.m_i[2] },
-					{ face.m_i[2], face.m_i[0] },
-				};
-
-				for (uint8_t ii = 0; ii < 3; ++ii)
-				{
-					uint16_t first  = triangleEdges[ii][0];
-					uint16_t second = triangleEdges[ii][1];
-
-					if (!halfEdges.unmark(second, first) )
-					{
-						halfEdges.mark(first, second);
-					}
-				}
-			}
-
-			if (cap)
-			{
-				if (frontFacing)
-				{
-					indicesFrontCap[frontCapI++] = face.m_i[0];
-					indicesFrontCap[frontCapI++] = face.m_i[1];
-					indicesFrontCap[frontCapI++] = face.m_i[2];
-				}
-				else
-				{
-					indicesBackCap[backCapI++] = face.m_i[0];
-					indicesBackCap[backCapI++] = face.m_i[1];
-					indicesBackCap[backCapI++] = face.m_i[2];
-				}
-
-				/**
-				 * if '_useFrontFacingFacesAsBackCap' is needed, implement it as such:
-				 *
-				 * bool condition0 = frontFacing && _useFrontFacingFacesAsBackCap;
-				 * bool condition1 = !frontFacing && !_useFrontFacingFacesAsBackCap;
-				 * if (condition0 || condition1)
-				 * {
-				 *      indicesBackCap[backCapI++] = face.m_i[0];
-				 *      indicesBackCap[backCapI++] = face.m_i[1+condition0];
-				 *      indicesBackCap[backCapI++] = face.m_i[2-condition0];
-				 * }
-				 */
-			}
-		}
-
-		// Fill side arrays.
-		uint16_t firstIndex = 0;
-		HalfEdge* he = halfEdges.begin();
-		while (halfEdges.end() != he)
-		{
-			if (he->m_marked)
-			{
-				he->m_marked = false;
-
-				const float* v0 = (float*)&vertices[firstIndex*_stride];
-				const float* v1 = (float*)&vertices[he->m_secondIndex*_stride];
-
-				verticesSide[vsideI++] = VertexData(v0, 0.0f);
-				verticesSide[vsideI++] = VertexData(v0, 1.0f);
-				verticesSide[vsideI++] = VertexData(v1, 0.0f);
-				verticesSide[vsideI++] = VertexData(v1, 1.0f);
-
-				indicesSide[sideI++] = indexSide+0;
-				indicesSide[sideI++] = indexSide+1;
-				indicesSide[sideI++] = indexSide+2;
-
-				indicesSide[sideI++] = indexSide+2;
-				indicesSide[sideI++] = indexSide+1;
-				indicesSide[sideI++] = indexSide+3;
-
-				indexSide += 4;
-			}
-
-			++he;
-			if (INVALID_EDGE_INDEX == he->m_secondIndex)
-			{
-				++he;
-				++firstIndex;
-			}
-		}
-	}
-	else // ShadowVolumeAlgorithm::EdgeBased:
-	{
-		uint32_t ii = 0;
-
-#if SV_USE_SIMD
-		uint32_t numEdgesRounded = numEdges & (~0x1);
-
-		using namespace bx;
-
-		const float4_t lx = float4_splat(_light[0]);
-		const float4_t ly = float4_splat(_light[1]);
-		const float4_t lz = float4_splat(_light[2]);
-
-		for (; ii < numEdgesRounded; ii+=2)
-		{
-			const Edge& edge0 = edges[ii];
-			const Edge& edge1 = edges[ii+1];
-			const Plane* edgePlane0 = &edgePlanes[ii*2];
-			const Plane* edgePlane1 = &edgePlanes[ii*2 + 2];
-
-			const float4_t reverse = float4_ild(edge0.m_faceReverseOrder[0]
-						 , edge1.m_faceReverseOrder[0]
-						 , edge0.m_faceReverseOrder[1]
-						 , edge1.m_faceReverseOrder[1]
-						 );
-
-			const float4_t v0 = float4_ld(edgePlane0[0].m_plane);
-			const float4_t v1 = float4_ld(edgePlane1[0].m_plane);
-			const float4_t v2 = float4_ld(edgePlane0[1].m_plane);
-			const float4_t v3 = float4_ld(edgePlane1[1].m_plane);
-
-			const float4_t xxyy0 = float4_shuf_xAyB(v0, v2);
-			const float4_t zzww0 = float4_shuf_zCwD(v0, v2);
-			const float4_t xxyy1 = float4_shuf_xAyB(v1, v3);
-			const float4_t zzww1 = float4_shuf_zCwD(v1, v3);
-
-			const float4_t vX = float4_shuf_xAyB(xxyy0, xxyy1);
-			const float4_t vY = float4_shuf_zCwD(xxyy0, xxyy1);
-			const float4_t vZ = float4_shuf_xAyB(zzww0, zzww1);
-			const float4_t vW = float4_shuf_zCwD(zzww0, zzww1);
-
-			const float4_t r0 = float4_mul(vX, lx);
-			const float4_t r1 = float4_mul(vY, ly);
-			const float4_t r2 = float4_mul(vZ, lz);
-
-			const float4_t dot = float4_add(r0, float4_add(r1, r2));
-			const float4_t f = float4_add(dot, vW);
-
-			const float4_t zero = float4_zero();
-			const float4_t mask = float4_cmpgt(f, zero);
-			const float4_t onef = float4_splat(1.0f);
-			const float4_t tmp0 = float4_and(mask, onef);
-			const float4_t tmp1 = float4_ftoi(tmp0);
-			const float4_t tmp2 = float4_xor(tmp1, reverse);
-			const float4_t tmp3 = float4_sll(tmp2, 1);
-			const float4_t onei = float4_isplat(1);
-			const float4_t tmp4 = float4_isub(tmp3, onei);
-
-			BX_ALIGN_STRUCT_16(int32_t res[4]);
-			float4_st(&res, tmp4);
-
-			for (uint16_t jj = 0; jj < 2; ++jj)
-			{
-				int16_t k = res[jj] + res[jj+2];
-				if (k != 0)
-				{
-					float* v0 = (float*)&vertices[edges[ii+jj].m_i0*_stride];
-					float* v1 = (float*)&vertices[edges[ii+jj].m_i1*_stride];
-					verticesSide[vsideI++] = VertexData(v0, 0.0f, float(k));
-					verticesSide[vsideI++] = VertexData(v0, 1.0f, float(k));
-					verticesSide[vsideI++] = VertexData(v1, 0.0f, float(k));
-					verticesSide[vsideI++] = VertexData(v1, 1.0f, float(k));
-
-					k = _textureAsStencil ? 1 : k;
-					uint16_t winding = uint16_t(k > 0);
-					for (uint8_t ii = 0, end = abs(k); ii < end; ++ii)
-					{
-						indicesSide[sideI++] = indexSide;
-						indicesSide[sideI++] = indexSide + 2 - winding;
-						indicesSide[sideI++] = indexSide + 1 + winding;
-
-						indicesSide[sideI++] = indexSide + 2;
-						indicesSide[sideI++] = indexSide + 3 - winding*2;
-						indicesSide[sideI++] = indexSide + 1 + winding*2;
-					}
-
-					indexSide += 4;
-				}
-			}
-		}
-#endif
-
-		for (; ii < numEdges; ++ii)
-		{
-			const Edge& edge = edges[ii];
-			const Plane* edgePlane = &edgePlanes[ii*2];
-
-			int16_t s0 = ( (vec3Dot(edgePlane[0].m_plane, _light) + edgePlane[0].m_plane[3]) > 0.0f) ^ edge.m_faceReverseOrder[0];
-			int16_t s1 = ( (vec3Dot(edgePlane[1].m_plane, _light) + edgePlane[1].m_plane[3]) > 0.0f) ^ edge.m_faceReverseOrder[1];
-			int16_t k = ( (s0 + s1) << 1) - 2;
-
-			if (k != 0)
-			{
-				float* v0 = (float*)&vertices[edge.m_i0*_stride];
-				float* v1 = (float*)&vertices[edge.m_i1*_stride];
-				verticesSide[vsideI++] = VertexData(v0, 0.0f, k);
-				verticesSide[vsideI++] = VertexData(v0, 1.0f, k);
-				verticesSide[vsideI++] = VertexData(v1, 0.0f, k);
-				verticesSide[vsideI++] = VertexData(v1, 1.0f, k);
-
-				k = _textureAsStencil ? 1 : k;
-				uint16_t winding = uint16_t(k > 0);
-				for (uint8_t ii = 0, end = abs(k); ii < end; ++ii)
-				{
-					indicesSide[sideI++] = indexSide;
-					indicesSide[sideI++] = indexSide + 2 - winding;
-					indicesSide[sideI++] = indexSide + 1 + winding;
-
-					indicesSide[sideI++] = indexSide + 2;
-					indicesSide[sideI++] = indexSide + 3 - winding*2;
-					indicesSide[sideI++] = indexSide + 1 + winding*2;
-				}
-
-				indexSide += 4;
-			}
-		}
-
-		if (cap)
-		{
-			// This could/should be done on GPU!
-			for (FaceArray::const_iterator iter = faces.begin(), end = faces.end(); iter != end; ++iter)
-			{
-				const Face& face = *iter;
-
-				float f = vec3Dot(face.m_plane, _light) + face.m_plane[3];
-				bool frontFacing = (f > 0.0f);
-
-				for (uint8_t ii = 0, end = 1 + uint8_t(!_textureAsStencil); ii < end; ++ii)
-				{
-					if (frontFacing)
-					{
-						indicesFrontCap[frontCapI++] = face.m_i[0];
-						indicesFrontCap[frontCapI++] = face.m_i[1];
-						indicesFrontCap[frontCapI++] = face.m_i[2];
-					}
-					else
-					{
-						indicesBackCap[backCapI++] = face.m_i[0];
-						indicesBackCap[backCapI++] = face.m_i[1];
-						indicesBackCap[backCapI++] = face.m_i[2];
-					}
-				}
-			}
-		}
-	}
-
 	bgfx::VertexDecl decl;
 	decl.begin();
 	decl.add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float);
 	decl.add(bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Float);
 	decl.end();
 
+	const uint32_t numVertices = uint32_t(_volume.m_vertices.size() );
+	const uint32_t numSide     = uint32_t(_volume.m_indices.size() );
+	const uint32_t numFrontCap = uint32_t(_volume.m_frontCap.size() );
+	const uint32_t numBackCap  = uint32_t(_volume.m_backCap.size() );
+
 	//fill the structure
-	_shadowVolume.m_numVertices = vsideI;
-	_shadowVolume.m_numIndices  = sideI + frontCapI + backCapI;
+	_shadowVolume.m_numVertices = numVertices;
+	_shadowVolume.m_numIndices  = numSide + numFrontCap + numBackCap;
 	_shadowVolume.m_mtx         = _mtx;
 	_shadowVolume.m_lightPos    = _light;
-	_shadowVolume.m_cap         = cap;
+	_shadowVolume.m_cap         = _cap;
 
+	// Volume memory stays valid until the end of next frame, see
+	// ShadowVolumeBatch.
 	const bgfx::Memory* mem;
 
 	//sides
-	uint32_t vsize = vsideI * 5*sizeof(float);
-	uint32_t isize = sideI * sizeof(uint16_t);
-
-	mem = bgfx::makeRef(verticesSide, vsize);
+	mem = bgfx::makeRef(0 == numVertices ? NULL : &_volume.m_vertices[0], numVertices*sizeof(SvVertex) );
 	_shadowVolume.m_vbSides = bgfx::createVertexBuffer(mem, decl);
 
-	mem = bgfx::makeRef(indicesSide, isize);
+	mem = bgfx::makeRef(0 == numSide ? NULL : &_volume.m_indices[0], numSide*sizeof(uint16_t) );
 	_shadowVolume.m_ibSides = bgfx::createIndexBuffer(mem);
 
 	// bgfx::destroy*Buffer doesn't actually destroy buffers now.
@@ -1765,19 +946,17 @@ void shadowVolumeCreate(ShadowVolume& _shadowVolume
 	bgfx::destroyVertexBuffer(_shadowVolume.m_vbSides);
 	bgfx::destroyIndexBuffer(_shadowVolume.m_ibSides);
 
-	if (cap)
+	if (_cap)
 	{
 		//front cap
-		isize = frontCapI * sizeof(uint16_t);
-		mem = bgfx::makeRef(indicesFrontCap, isize);
+		mem = bgfx::makeRef(0 == numFrontCap ? NULL : &_volume.m_frontCap[0], numFrontCap*sizeof(uint16_t) );
 		_shadowVolume.m_ibFrontCap = bgfx::createIndexBuffer(mem);
 
 		//gets destroyed after the end of the next frame
 		bgfx::destroyIndexBuffer(_shadowVolume.m_ibFrontCap);
 
 		//back cap
-		isize = backCapI * sizeof(uint16_t);
-		mem = bgfx::makeRef(indicesBackCap, isize);
+		mem = bgfx::makeRef(0 == numBackCap ? NULL : &_volume.m_backCap[0], numBackCap*sizeof(uint16_t) );
 		_shadowVolume.m_ibBackCap = bgfx::createIndexBuffer(mem);
 
 		//gets destroyed after the end of the next frame
@@ -1828,10 +1007,7 @@ void createNearClipVolume(float* __restrict _outPlanes24f
 	};
 
 	float corners[4][3];
-	vec3MulMtx(corners[0], cornersV[0], mtxViewInv);
-	vec3MulMtx(corners[1], cornersV[1], mtxViewInv);
-	vec3MulMtx(corners[2], cornersV[2], mtxViewInv);
-	vec3MulMtx(corners[3], cornersV[3], mtxViewInv);
+	vec3MulMtxBatch( (float*)corners, (float*)cornersV, mtxViewInv, 4);
 
 	float planeNormals[4][3];
 	for (uint8_t ii = 0; ii < 4; ++ii)
@@ -1889,10 +1065,10 @@ bool clipTest(const float* _planes, uint8_t _planeNum, const Mesh& _mesh, const
 	float (*volumePlanes)[4] = (float(*)[4])_planes;
 	float scale = fmaxf(fmaxf(_scale[0], _scale[1]), _scale[2]);
 
-	const GroupArray& groups = _mesh.m_groups;
-	for (GroupArray::const_iterator it = groups.begin(), itEnd = groups.end(); it != itEnd; ++it)
+	const MeshGroupArray& groups = _mesh.m_groups;
+	for (MeshGroupArray::const_iterator it = groups.begin(), itEnd = groups.end(); it != itEnd; ++it)
 	{
-		const Group& group = *it;
+		const MeshGroup& group = *it;
 
 		Sphere sphere = group.m_sphere;
 		sphere.m_center[0] = sphere.m_center[0] * scale + _translate[0];
@@ -2121,6 +1297,8 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 	uint32_t numShadowVolumeVertices = 0;
 	uint32_t numShadowVolumeIndices  = 0;
 
+	ShadowVolumeBatch svBatch(4);
+
 	uint32_t oldWidth = 0;
 	uint32_t oldHeight = 0;
 
@@ -2665,11 +1843,87 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 
 		profTime = bx::getHPCounter();
 
+		/**
+		 * Extract shadow volumes of all lights and shadow casters in
+		 * parallel, before any of them is submitted.
+		 */
+		ShadowVolumeImpl::Enum shadowVolumeImpls[MAX_LIGHTS_COUNT][60];
+
+		// Compute virtual light positions for shadow volume generation,
+		// all lights are transformed to model space of instance at once.
+		const uint32_t numLights = uint32_t(settings_numLights);
+		float lightPos3[MAX_LIGHTS_COUNT][3];
+		for (uint32_t ii = 0; ii < numLights; ++ii)
+		{
+			memcpy(lightPos3[ii], lightPosRadius[ii], 3*sizeof(float) );
+		}
+
+		float transformedLightPos[60][MAX_LIGHTS_COUNT][3];
+		for (uint8_t jj = 0; jj < shadowCastersCount[currentScene]; ++jj)
+		{
+			const Instance& instance = shadowCasters[currentScene][jj];
+
+			float mtx[16];
+			shadowVolumeLightTransformMtx(mtx
+				, instance.m_scale
+				, instance.m_rotation
+				, instance.m_pos
+				);
+			vec3MulMtxBatch( (float*)transformedLightPos[jj], (float*)lightPos3, mtx, numLights);
+		}
+
+		svBatch.begin();
+		for (uint8_t ii = 0; ii < settings_numLights; ++ii)
+		{
+			const float* lightPos = lightPosRadius[ii];
+
+			// Create near clip volume for current light.
+			float nearClipVolume[6 * 4] = {};
+			float pointLight[4];
+			if (settings_mixedSvImpl)
+			{
+				pointLight[0] = lightPos[0];
+				pointLight[1] = lightPos[1];
+				pointLight[2] = lightPos[2];
+				pointLight[3] = 1.0f;
+				createNearClipVolume(nearClipVolume, pointLight, viewState.m_view, fov, aspect, nearPlane);
+			}
+
+			for (uint8_t jj = 0; jj < shadowCastersCount[currentScene]; ++jj)
+			{
+				const Instance& instance = shadowCasters[currentScene][jj];
+				Model* model = instance.m_model;
+
+				ShadowVolumeImpl::Enum shadowVolumeImpl = settings_shadowVolumeImpl;
+				if (settings_mixedSvImpl)
+				{
+					// If instance is inside near clip volume, depth fail must be used, else depth pass is fine.
+					bool isInsideVolume = clipTest(nearClipVolume, 6, model->m_mesh, instance.m_scale, instance.m_pos);
+					shadowVolumeImpl = (isInsideVolume ? ShadowVolumeImpl::DepthFail : ShadowVolumeImpl::DepthPass);
+				}
+				shadowVolumeImpls[ii][jj] = shadowVolumeImpl;
+
+				const uint8_t flags = 0
+					| (ShadowVolumeImpl::DepthFail == shadowVolumeImpl ? SV_FLAGS_DEPTH_FAIL : 0)
+					| (ShadowVolumeAlgorithm::FaceBased == settings_shadowVolumeAlgorithm ? SV_FLAGS_FACE_BASED : 0)
+					| (settings_useStencilTexture ? SV_FLAGS_TEXTURE_AS_STENCIL : 0)
+					;
+
+				const std::vector<SvMesh>& svMeshes = model->m_mesh.m_svMeshes;
+				for (std::vector<SvMesh>::const_iterator it = svMeshes.begin(), itEnd = svMeshes.end(); it != itEnd; ++it)
+				{
+					svBatch.add(*it, transformedLightPos[jj][ii], flags);
+				}
+			}
+		}
+		svBatch.run();
+
 		/**
 		 * For each light:
 		 * 1. Compute and draw shadow volume to stencil buffer
 		 * 2. Draw diffuse with stencil test
 		 */
+		uint32_t svJob = 0;
 		for (uint8_t ii = 0, viewId = VIEWID_RANGE15_PASS2; ii < settings_numLights; ++ii, ++viewId)
 		{
 			const float* lightPos = lightPosRadius[ii];
@@ -2702,43 +1956,16 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 						);
 			}
 
-			// Create near clip volume for current light.
-			float nearClipVolume[6 * 4] = {};
-			float pointLight[4];
-			if (settings_mixedSvImpl)
-			{
-				pointLight[0] = lightPos[0];
-				pointLight[1] = lightPos[1];
-				pointLight[2] = lightPos[2];
-				pointLight[3] = 1.0f;
-				createNearClipVolume(nearClipVolume, pointLight, viewState.m_view, fov, aspect, nearPlane);
-			}
-
 			for (uint8_t jj = 0; jj < shadowCastersCount[currentScene]; ++jj)
 			{
 				const Instance& instance = shadowCasters[currentScene][jj];
 				Model* model = instance.m_model;
 
-				ShadowVolumeImpl::Enum shadowVolumeImpl = settings_shadowVolumeImpl;
-				if (settings_mixedSvImpl)
-				{
-					// If instance is inside near clip volume, depth fail must be used, else depth pass is fine.
-					bool isInsideVolume = clipTest(nearClipVolume, 6, model->m_mesh, instance.m_scale, instance.m_pos);
-					shadowVolumeImpl = (isInsideVolume ? ShadowVolumeImpl::DepthFail : ShadowVolumeImpl::DepthPass);
-				}
+				const ShadowVolumeImpl::Enum shadowVolumeImpl = shadowVolumeImpls[ii][jj];
 				s_uniforms.m_svparams.m_dfail = float(ShadowVolumeImpl::DepthFail == shadowVolumeImpl);
 
-				// Compute virtual light position for shadow volume generation.
-				float transformedLightPos[3];
-				shadowVolumeLightTransform(transformedLightPos
-					, instance.m_scale
-					, instance.m_rotation
-					, instance.m_pos
-					, lightPos
-					);
-
 				// Set virtual light pos.
-				memcpy(s_uniforms.m_virtualLightPos_extrusionDist, transformedLightPos, 3*sizeof(float) );
+				memcpy(s_uniforms.m_virtualLightPos_extrusionDist, transformedLightPos[jj][ii], 3*sizeof(float) );
 				s_uniforms.m_virtualLightPos_extrusionDist[3] = instance.m_svExtrusionDistance;
 
 				// Compute transform for shadow volume.
@@ -2755,22 +1982,18 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 						, instance.m_pos[2]
 						);
 
-				GroupArray& groups = model->m_mesh.m_groups;
-				const uint16_t stride = model->m_mesh.m_decl.getStride();
-				for (GroupArray::iterator it = groups.begin(), itEnd = groups.end(); it != itEnd; ++it)
+				const MeshGroupArray& groups = model->m_mesh.m_groups;
+				for (MeshGroupArray::const_iterator it = groups.begin(), itEnd = groups.end(); it != itEnd; ++it)
 				{
-					Group& group = *it;
+					const MeshGroup& group = *it;
 
-					// Create shadow volume.
+					// Create shadow volume from extracted geometry.
 					ShadowVolume shadowVolume;
 					shadowVolumeCreate(shadowVolume
-						, group
-						, stride
+						, svBatch.getVolume(svJob++)
 						, shadowVolumeMtx
-						, transformedLightPos
-						, shadowVolumeImpl
-						, settings_shadowVolumeAlgorithm
-						, settings_useStencilTexture
+						, transformedLightPos[jj][ii]
+						, ShadowVolumeImpl::DepthFail == shadowVolumeImpl
 						);
 
 					numShadowVolumeVertices += shadowVolume.m_numVertices;
@@ -2908,9 +2131,6 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 		// process submitted rendering primitives.
 		bgfx::frame();
 
-		// Swap memory pages.
-		s_svAllocator.swap();
-
 		// Reset clear values.
 		bgfx::setViewClearMask(UINT32_MAX
 			, BGFX_CLEAR_NONE
@@ -15,6 +15,9 @@
 #include "entry/entry.h"
 #include "camera.h"
 #include "fpumath.h"
+#include "meshloader.h"
+#include "cull.h"
+#include "occlusion.h"
 #include "imgui/imgui.h"
 
 #define RENDERVIEW_SHADOWMAP_0_ID 1
@@ -934,64 +937,11 @@ struct ClearValues
 	uint8_t  m_clearStencil;
 };
 
-struct Aabb
-{
-	float m_min[3];
-	float m_max[3];
-};
-
-struct Obb
-{
-	float m_mtx[16];
-};
-
-struct Sphere
-{
-	float m_center[3];
-	float m_radius;
-};
-
-struct Primitive
-{
-	uint32_t m_startIndex;
-	uint32_t m_numIndices;
-	uint32_t m_startVertex;
-	uint32_t m_numVertices;
-
-	Sphere m_sphere;
-	Aabb m_aabb;
-	Obb m_obb;
-};
-
-typedef std::vector<Primitive> PrimitiveArray;
-
-struct Group
-{
-	Group()
-	{
-		reset();
-	}
-
-	void reset()
-	{
-		m_vbh.idx = bgfx::invalidHandle;
-		m_ibh.idx = bgfx::invalidHandle;
-		m_prims.clear();
-	}
-
-	bgfx::VertexBufferHandle m_vbh;
-	bgfx::IndexBufferHandle m_ibh;
-	Sphere m_sphere;
-	Aabb m_aabb;
-	Obb m_obb;
-	PrimitiveArray m_prims;
-};
-
 struct Mesh
 {
 	void load(const void* _vertices, uint32_t _numVertices, const bgfx::VertexDecl _decl, const uint16_t* _indices, uint32_t _numIndices)
 	{
-		Group group;
+		MeshGroup group;
 		const bgfx::Memory* mem;
 		uint32_t size;
 
@@ -1003,118 +953,89 @@ struct Mesh
 		mem = bgfx::makeRef(_indices, size);
 		group.m_ibh = bgfx::createIndexBuffer(mem);
 
+		// Bounding sphere around position aabb.
+		const uint32_t stride = _decl.getStride();
+		const uint8_t* vertices = (const uint8_t*)_vertices + _decl.getOffset(bgfx::Attrib::Position);
+		Aabb& aabb = group.m_aabb;
+		memcpy(aabb.m_min, vertices, 3*sizeof(float) );
+		memcpy(aabb.m_max, vertices, 3*sizeof(float) );
+		for (uint32_t ii = 1; ii < _numVertices; ++ii)
+		{
+			const float* position = (const float*)(vertices + ii*stride);
+			aabb.m_min[0] = fminf(aabb.m_min[0], position[0]);
+			aabb.m_min[1] = fminf(aabb.m_min[1], position[1]);
+			aabb.m_min[2] = fminf(aabb.m_min[2], position[2]);
+			aabb.m_max[0] = fmaxf(aabb.m_max[0], position[0]);
+			aabb.m_max[1] = fmaxf(aabb.m_max[1], position[1]);
+			aabb.m_max[2] = fmaxf(aabb.m_max[2], position[2]);
+		}
+
+		Sphere& sphere = group.m_sphere;
+		sphere.m_center[0] = (aabb.m_min[0] + aabb.m_max[0])*0.5f;
+		sphere.m_center[1] = (aabb.m_min[1] + aabb.m_max[1])*0.5f;
+		sphere.m_center[2] = (aabb.m_min[2] + aabb.m_max[2])*0.5f;
+		sphere.m_radius = 0.0f;
+		for (uint32_t ii = 0; ii < _numVertices; ++ii)
+		{
+			const float* position = (const float*)(vertices + ii*stride);
+			float dist[3];
+			vec3Sub(dist, position, sphere.m_center);
+			sphere.m_radius = fmaxf(sphere.m_radius, vec3Length(dist) );
+		}
+
 		//TODO:
-		// group.m_sphere = ...
-		// group.m_aabb = ...
 		// group.m_obb = ...
 		// group.m_prims = ...
 
 		m_groups.push_back(group);
+
+		calcSphere();
 	}
 
-	void load(const char* _filePath)
+	void load(const char* _filePath, bool _occluder = false)
 	{
-#define BGFX_CHUNK_MAGIC_VB BX_MAKEFOURCC('V', 'B', ' ', 0x0)
-#define BGFX_CHUNK_MAGIC_IB BX_MAKEFOURCC('I', 'B', ' ', 0x0)
-#define BGFX_CHUNK_MAGIC_PRI BX_MAKEFOURCC('P', 'R', 'I', 0x0)
+		// Occluders keep positions and indices for CPU occlusion culling.
+		meshLoad(m_groups, m_decl, _filePath, _occluder ? MESH_LOAD_KEEP_DATA : 0);
 
-		bx::CrtFileReader reader;
-		reader.open(_filePath);
+		calcSphere();
+	}
 
-		Group group;
+	// Sphere around all group spheres, for culling mesh instances.
+	void calcSphere()
+	{
+		Aabb aabb;
+		memset(&aabb, 0, sizeof(Aabb) );
 
-		uint32_t chunk;
-		while (4 == bx::read(&reader, chunk) )
+		for (MeshGroupArray::const_iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it)
 		{
-			switch (chunk)
+			const Sphere& sphere = it->m_sphere;
+			const bool first = it == m_groups.begin();
+			for (uint32_t ii = 0; ii < 3; ++ii)
 			{
-			case BGFX_CHUNK_MAGIC_VB:
-				{
-					bx::read(&reader, group.m_sphere);
-					bx::read(&reader, group.m_aabb);
-					bx::read(&reader, group.m_obb);
-
-					bx::read(&reader, m_decl);
-					uint16_t stride = m_decl.getStride();
-
-					uint16_t numVertices;
-					bx::read(&reader, numVertices);
-					const bgfx::Memory* mem = bgfx::alloc(numVertices*stride);
-					bx::read(&reader, mem->data, mem->size);
-
-					group.m_vbh = bgfx::createVertexBuffer(mem, m_decl);
-				}
-				break;
-
-			case BGFX_CHUNK_MAGIC_IB:
-				{
-					uint32_t numIndices;
-					bx::read(&reader, numIndices);
-					const bgfx::Memory* mem = bgfx::alloc(numIndices*2);
-					bx::read(&reader, mem->data, mem->size);
-					group.m_ibh = bgfx::createIndexBuffer(mem);
-				}
-				break;
-
-			case BGFX_CHUNK_MAGIC_PRI:
-				{
-					uint16_t len;
-					bx::read(&reader, len);
-
-					std::string material;
-					material.resize(len);
-					bx::read(&reader, const_cast<char*>(material.c_str() ), len);
-
-					uint16_t num;
-					bx::read(&reader, num);
-
-					for (uint32_t ii = 0; ii < num; ++ii)
-					{
-						bx::read(&reader, len);
-
-						std::string name;
-						name.resize(len);
-						bx::read(&reader, const_cast<char*>(name.c_str() ), len);
-
-						Primitive prim;
-						bx::read(&reader, prim.m_startIndex);
-						bx::read(&reader, prim.m_numIndices);
-						bx::read(&reader, prim.m_startVertex);
-						bx::read(&reader, prim.m_numVertices);
-						bx::read(&reader, prim.m_sphere);
-						bx::read(&reader, prim.m_aabb);
-						bx::read(&reader, prim.m_obb);
-
-						group.m_prims.push_back(prim);
-					}
-
-					m_groups.push_back(group);
-					group.reset();
-				}
-				break;
-
-			default:
-				DBG("%08x at %d", chunk, reader.seek() );
-				break;
+				const float min = sphere.m_center[ii] - sphere.m_radius;
+				const float max = sphere.m_center[ii] + sphere.m_radius;
+				aabb.m_min[ii] = first ? min : fminf(aabb.m_min[ii], min);
+				aabb.m_max[ii] = first ? max : fmaxf(aabb.m_max[ii], max);
 			}
 		}
 
-		reader.close();
+		m_sphere.m_center[0] = (aabb.m_min[0] + aabb.m_max[0])*0.5f;
+		m_sphere.m_center[1] = (aabb.m_min[1] + aabb.m_max[1])*0.5f;
+		m_sphere.m_center[2] = (aabb.m_min[2] + aabb.m_max[2])*0.5f;
+		m_sphere.m_radius = 0.0f;
+
+		for (MeshGroupArray::const_iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it)
+		{
+			const Sphere& sphere = it->m_sphere;
+			float dist[3];
+			vec3Sub(dist, sphere.m_center, m_sphere.m_center);
+			m_sphere.m_radius = fmaxf(m_sphere.m_radius, vec3Length(dist) + sphere.m_radius);
+		}
 	}
 
 	void unload()
 	{
-		for (GroupArray::const_iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it)
-		{
-			const Group& group = *it;
-			bgfx::destroyVertexBuffer(group.m_vbh);
-
-			if (bgfx::invalidHandle != group.m_ibh.idx)
-			{
-				bgfx::destroyIndexBuffer(group.m_ibh);
-			}
-		}
-		m_groups.clear();
+		meshUnload(m_groups);
 	}
 
 	void submit(uint8_t _viewId, float* _mtx, bgfx::ProgramHandle _program, const RenderState& _renderState)
@@ -1125,9 +1046,9 @@ struct Mesh
 
 	void submit(uint8_t _viewId, float* _mtx, bgfx::ProgramHandle _program, const RenderState& _renderState, bgfx::TextureHandle _texture)
 	{
-		for (GroupArray::const_iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it)
+		for (MeshGroupArray::const_iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it)
 		{
-			const Group& group = *it;
+			const MeshGroup& group = *it;
 
 			// Set uniforms.
 			s_uniforms.submitPerDrawUniforms();
@@ -1158,9 +1079,61 @@ struct Mesh
 		}
 	}
 
+	void submitOccluder(OcclusionCulling& _occlusion, const float* _mtx)
+	{
+		for (MeshGroupArray::const_iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it)
+		{
+			const MeshGroup& group = *it;
+			if (NULL != group.m_indices)
+			{
+				_occlusion.addOccluder(_mtx
+					, group.m_vertices + m_decl.getOffset(bgfx::Attrib::Position)
+					, group.m_numVertices
+					, m_decl.getStride()
+					, group.m_indices
+					, group.m_numIndices
+					);
+			}
+		}
+	}
+
+	void submitShadow(uint8_t _viewId, float* _mtx, bgfx::ProgramHandle _program, const RenderState& _renderState)
+	{
+		for (MeshGroupArray::const_iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it)
+		{
+			const MeshGroup& group = *it;
+
+			// Set uniforms.
+			s_uniforms.submitPerDrawUniforms();
+
+			// Set model matrix for rendering.
+			bgfx::setTransform(_mtx);
+			bgfx::setProgram(_program);
+
+			// Use position only variant when mesh has one.
+			if (bgfx::invalidHandle != group.m_shadowVbh.idx)
+			{
+				bgfx::setIndexBuffer(group.m_shadowIbh);
+				bgfx::setVertexBuffer(group.m_shadowVbh);
+			}
+			else
+			{
+				bgfx::setIndexBuffer(group.m_ibh);
+				bgfx::setVertexBuffer(group.m_vbh);
+			}
+
+			// Apply render state.
+			bgfx::setStencil(_renderState.m_fstencil, _renderState.m_bstencil);
+			bgfx::setState(_renderState.m_state, _renderState.m_blendFactorRgba);
+
+			// Submit.
+			bgfx::submit(_viewId);
+		}
+	}
+
 	bgfx::VertexDecl m_decl;
-	typedef std::vector<Group> GroupArray;
-	GroupArray m_groups;
+	MeshGroupArray m_groups;
+	Sphere m_sphere;
 };
 
 struct PosColorTexCoord0Vertex
@@ -1269,11 +1242,7 @@ void worldSpaceFrustumCorners(float* _corners24f
 	};
 
 	// Convert them to world space.
-	float (*out)[3] = (float(*)[3])_corners24f;
-	for (uint8_t ii = 0; ii < numCorners; ++ii)
-	{
-		vec3MulMtx( (float*)&out[ii], (float*)&corners[ii], _invViewMtx);
-	}
+	vec3MulMtxBatch(_corners24f, (const float*)corners, _invViewMtx, numCorners);
 }
 
 /**
@@ -1537,13 +1506,24 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 	Mesh hollowcubeMesh;
 	Mesh hplaneMesh;
 	Mesh vplaneMesh;
-	bunnyMesh.load("meshes/bunny.bin");
+	bunnyMesh.load("meshes/bunny.bin", true);
 	treeMesh.load("meshes/tree.bin");
-	cubeMesh.load("meshes/cube.bin");
-	hollowcubeMesh.load("meshes/hollowcube.bin");
+	cubeMesh.load("meshes/cube.bin", true);
+	hollowcubeMesh.load("meshes/hollowcube.bin", true);
 	hplaneMesh.load(s_hplaneVertices, s_numHPlaneVertices, PosNormalTexcoordDecl, s_planeIndices, s_numPlaneIndices);
 	vplaneMesh.load(s_vplaneVertices, s_numVPlaneVertices, PosNormalTexcoordDecl, s_planeIndices, s_numPlaneIndices);
 
+	// Instance bounds for culling: floor, bunny, hollow cube, cube and trees.
+	const uint8_t numTrees = 10;
+	const uint32_t numInstances = 4 + numTrees;
+	CullSpheres instanceSpheres;
+	cullSpheresAlloc(instanceSpheres, numInstances);
+	uint8_t instanceMask[numInstances];
+	uint32_t instanceVisible[numInstances];
+
+	// Bunny and cubes occlude instances behind them in camera view.
+	OcclusionCulling occlusion(256, 128, 4);
+
 	// Materials.
 	Material defaultMaterial =
 	{
@@ -1579,12 +1559,12 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 
 	// Setup uniforms.
 	float color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
-	float lightMtx[16];
+	float lightMtxInstances[numInstances][16];
 	float shadowMapMtx[ShadowMapRenderTargets::Count][16];
 	s_uniforms.setPtrs(&defaultMaterial
 					 , &pointLight
 					 , color
-					 , lightMtx
+					 , lightMtxInstances[0]
 					 , &shadowMapMtx[ShadowMapRenderTargets::First][0]
 					 , &shadowMapMtx[ShadowMapRenderTargets::Second][0]
 					 , &shadowMapMtx[ShadowMapRenderTargets::Third][0]
@@ -2327,8 +2307,15 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 		directionalLight.m_position.m_y = -1.0f;
 		directionalLight.m_position.m_z = -sin(timeAccumulatorLight);
 
-		// Setup instance matrices.
-		float mtxFloor[16];
+		// Setup instance matrices. They are stored one after another, so
+		// light matrices of all instances are computed in one batch.
+		float mtxInstances[numInstances][16];
+		float* mtxFloor      = mtxInstances[0];
+		float* mtxBunny      = mtxInstances[1];
+		float* mtxHollowcube = mtxInstances[2];
+		float* mtxCube       = mtxInstances[3];
+		float (*mtxTrees)[16] = &mtxInstances[4];
+
 		const float floorScale = 550.0f;
 		mtxScaleRotateTranslate(mtxFloor
 			, floorScale //scaleX
@@ -2342,7 +2329,6 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 			, 0.0f //translateZ
 			);
 
-		float mtxBunny[16];
 		mtxScaleRotateTranslate(mtxBunny
 			, 5.0f
 			, 5.0f
@@ -2355,7 +2341,6 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 			, 0.0f
 			);
 
-		float mtxHollowcube[16];
 		mtxScaleRotateTranslate(mtxHollowcube
 			, 2.5f
 			, 2.5f
@@ -2368,7 +2353,6 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 			, 0.0f
 			);
 
-		float mtxCube[16];
 		mtxScaleRotateTranslate(mtxCube
 			, 2.5f
 			, 2.5f
@@ -2381,8 +2365,6 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 			, 0.0f
 			);
 
-		const uint8_t numTrees = 10;
-		float mtxTrees[numTrees][16];
 		for (uint8_t ii = 0; ii < numTrees; ++ii)
 		{
 			mtxScaleRotateTranslate(mtxTrees[ii]
@@ -2541,11 +2523,13 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 				float min[3] = {  9000.0f,  9000.0f,  9000.0f };
 				float max[3] = { -9000.0f, -9000.0f, -9000.0f };
 
+				// Transform to light space.
+				float lightSpaceFrustumCorners[numCorners][3];
+				vec3MulMtxBatch( (float*)lightSpaceFrustumCorners, (float*)frustumCorners[ii], lightView[0], numCorners);
+
 				for (uint8_t jj = 0; jj < numCorners; ++jj)
 				{
-					// Transform to light space.
-					float lightSpaceFrustumCorner[3];
-					vec3MulMtx(lightSpaceFrustumCorner, frustumCorners[ii][jj], lightView[0]);
+					const float* lightSpaceFrustumCorner = lightSpaceFrustumCorners[jj];
 
 					// Update bounding box.
 					min[0] = fminf(min[0], lightSpaceFrustumCorner[0]);
@@ -2829,6 +2813,87 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 			bgfx::submit(RENDERVIEW_SHADOWMAP_1_ID+ii);
 		}
 
+		// Cull instances against shadow map views and camera. Bit ii of
+		// instance mask is set when instance is inside shadow map view ii,
+		// cameraBit when it's inside camera view.
+		{
+			cullSpheresSet(instanceSpheres, 0, hplaneMesh.m_sphere, mtxFloor);
+			cullSpheresSet(instanceSpheres, 1, bunnyMesh.m_sphere, mtxBunny);
+			cullSpheresSet(instanceSpheres, 2, hollowcubeMesh.m_sphere, mtxHollowcube);
+			cullSpheresSet(instanceSpheres, 3, cubeMesh.m_sphere, mtxCube);
+			for (uint8_t ii = 0; ii < numTrees; ++ii)
+			{
+				cullSpheresSet(instanceSpheres, 4 + ii, treeMesh.m_sphere, mtxTrees[ii]);
+			}
+		}
+
+		Frustum frustums[ShadowMapRenderTargets::Count + 1];
+		uint8_t numShadowViews;
+		float mtxViewProj[16];
+		if (LightType::SpotLight == settings.m_lightType)
+		{
+			numShadowViews = 1;
+			mtxMul(mtxViewProj, lightView[0], lightProj[ProjType::Horizontal]);
+			frustumFromMtx(frustums[0], mtxViewProj);
+		}
+		else if (LightType::PointLight == settings.m_lightType)
+		{
+			numShadowViews = TetrahedronFaces::Count;
+			for (uint8_t ii = 0; ii < numShadowViews; ++ii)
+			{
+				ProjType::Enum projType = (settings.m_stencilPack) ? ProjType::Enum(ii>1) : ProjType::Horizontal;
+				mtxMul(mtxViewProj, lightView[ii], lightProj[projType]);
+				frustumFromMtx(frustums[ii], mtxViewProj);
+			}
+		}
+		else //LightType::DirectionalLight == settings.m_lightType)
+		{
+			numShadowViews = settings.m_numSplits;
+			for (uint8_t ii = 0; ii < numShadowViews; ++ii)
+			{
+				mtxMul(mtxViewProj, lightView[0], lightProj[ii]);
+				frustumFromMtx(frustums[ii], mtxViewProj);
+			}
+		}
+
+		mtxMul(mtxViewProj, viewState.m_view, viewState.m_proj);
+		frustumFromMtx(frustums[numShadowViews], mtxViewProj);
+
+		cullSpheresCascades(instanceMask, instanceSpheres, frustums, numShadowViews + 1);
+		const uint8_t cameraBit = uint8_t(1<<numShadowViews);
+
+		// Occlusion cull instances inside camera frustum.
+		{
+			occlusion.begin(mtxViewProj);
+			bunnyMesh.submitOccluder(occlusion, mtxBunny);
+			hollowcubeMesh.submitOccluder(occlusion, mtxHollowcube);
+			cubeMesh.submitOccluder(occlusion, mtxCube);
+			occlusion.rasterize();
+
+			uint32_t numCandidates = 0;
+			for (uint32_t ii = 0; ii < numInstances; ++ii)
+			{
+				instanceVisible[numCandidates] = ii;
+				numCandidates += 0 != (instanceMask[ii] & cameraBit);
+				instanceMask[ii] &= uint8_t(~cameraBit);
+			}
+
+			const uint32_t numVisible = occlusion.testSpheres(instanceVisible, instanceSpheres, instanceVisible, numCandidates);
+			for (uint32_t ii = 0; ii < numVisible; ++ii)
+			{
+				instanceMask[instanceVisible[ii] ] |= cameraBit;
+			}
+
+			const OcclusionStats& stats = occlusion.getStats();
+			const double toMs = 1000.0/double(bx::getHPFrequency() );
+			bgfx::dbgTextPrintf(0, 4, 0x0f, "Occlusion: %d / %d culled, raster % 7.3f[ms], test % 7.3f[ms]"
+				, stats.m_numCulled
+				, stats.m_numTested
+				, double(stats.m_rasterizeTime)*toMs
+				, double(stats.m_testTime)*toMs
+				);
+		}
+
 		// Render.
 
 		// Craft shadow map.
@@ -2915,43 +2980,60 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 					renderStateIndex = (ii < 2) ? RenderState::ShadowMap_PackDepthHoriz : RenderState::ShadowMap_PackDepthVert;
 				}
 
+				const uint8_t viewBit = uint8_t(1<<ii);
+
 				// Floor.
-				hplaneMesh.submit(viewId
-						, mtxFloor
-						, *currentSmSettings->m_progPack
-						, s_renderStates[renderStateIndex]
-						);
+				if (0 != (instanceMask[0] & viewBit) )
+				{
+					hplaneMesh.submitShadow(viewId
+							, mtxFloor
+							, *currentSmSettings->m_progPack
+							, s_renderStates[renderStateIndex]
+							);
+				}
 
 				// Bunny.
-				bunnyMesh.submit(viewId
-						, mtxBunny
-						, *currentSmSettings->m_progPack
-						, s_renderStates[renderStateIndex]
-						);
+				if (0 != (instanceMask[1] & viewBit) )
+				{
+					bunnyMesh.submitShadow(viewId
+							, mtxBunny
+							, *currentSmSettings->m_progPack
+							, s_renderStates[renderStateIndex]
+							);
+				}
 
 				// Hollow cube.
-				hollowcubeMesh.submit(viewId
-						, mtxHollowcube
-						, *currentSmSettings->m_progPack
-						, s_renderStates[renderStateIndex]
-						);
+				if (0 != (instanceMask[2] & viewBit) )
+				{
+					hollowcubeMesh.submitShadow(viewId
+							, mtxHollowcube
+							, *currentSmSettings->m_progPack
+							, s_renderStates[renderStateIndex]
+							);
+				}
 
 				// Cube.
-				cubeMesh.submit(viewId
-						, mtxCube
-						, *currentSmSettings->m_progPack
-						, s_renderStates[renderStateIndex]
-						);
-
-				// Trees.
-				for (uint8_t ii = 0; ii < numTrees; ++ii)
+				if (0 != (instanceMask[3] & viewBit) )
 				{
-					treeMesh.submit(viewId
-							, mtxTrees[ii]
+					cubeMesh.submitShadow(viewId
+							, mtxCube
 							, *currentSmSettings->m_progPack
 							, s_renderStates[renderStateIndex]
 							);
 				}
+
+				// Trees.
+				for (uint8_t jj = 0; jj < numTrees; ++jj)
+				{
+					if (0 != (instanceMask[4 + jj] & viewBit) )
+					{
+						treeMesh.submitShadow(viewId
+								, mtxTrees[jj]
+								, *currentSmSettings->m_progPack
+								, s_renderStates[renderStateIndex]
+								);
+					}
+				}
 			}
 		}
 
@@ -3110,71 +3192,77 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 			}
 			else //LightType::DirectionalLight == settings.m_lightType
 			{
+				float mtxProjBias[shadowMapPasses][16];
+				mtxMulBatch( (float*)mtxProjBias, (float*)lightProj, mtxBias, settings.m_numSplits);
+
 				for (uint8_t ii = 0; ii < settings.m_numSplits; ++ii)
 				{
-					float mtxTmp[16];
-
-					mtxMul(mtxTmp, lightProj[ii], mtxBias);
-					mtxMul(shadowMapMtx[ii], lightView[0], mtxTmp); //lViewProjCropBias
+					mtxMul(shadowMapMtx[ii], lightView[0], mtxProjBias[ii]); //lViewProjCropBias
 				}
 			}
 
-			// Floor.
+			// Light matrices are not needed for directional light.
 			if (LightType::DirectionalLight != settings.m_lightType)
 			{
-				mtxMul(lightMtx, mtxFloor, mtxShadow); //not needed for directional light
+				mtxMulBatch( (float*)lightMtxInstances, (float*)mtxInstances, mtxShadow, numInstances);
+			}
+
+			// Floor.
+			s_uniforms.m_lightMtxPtr = lightMtxInstances[0];
+			if (0 != (instanceMask[0] & cameraBit) )
+			{
+				hplaneMesh.submit(RENDERVIEW_DRAWSCENE_0_ID
+						, mtxFloor
+						, *currentSmSettings->m_progDraw
+						, s_renderStates[RenderState::Default]
+						);
 			}
-			hplaneMesh.submit(RENDERVIEW_DRAWSCENE_0_ID
-					, mtxFloor
-					, *currentSmSettings->m_progDraw
-					, s_renderStates[RenderState::Default]
-					);
 
 			// Bunny.
-			if (LightType::DirectionalLight != settings.m_lightType)
+			s_uniforms.m_lightMtxPtr = lightMtxInstances[1];
+			if (0 != (instanceMask[1] & cameraBit) )
 			{
-				mtxMul(lightMtx, mtxBunny, mtxShadow);
+				bunnyMesh.submit(RENDERVIEW_DRAWSCENE_0_ID
+						, mtxBunny
+						, *currentSmSettings->m_progDraw
+						, s_renderStates[RenderState::Default]
+						);
 			}
-			bunnyMesh.submit(RENDERVIEW_DRAWSCENE_0_ID
-					, mtxBunny
-					, *currentSmSettings->m_progDraw
-					, s_renderStates[RenderState::Default]
-					);
 
 			// Hollow cube.
-			if (LightType::DirectionalLight != settings.m_lightType)
+			s_uniforms.m_lightMtxPtr = lightMtxInstances[2];
+			if (0 != (instanceMask[2] & cameraBit) )
 			{
-				mtxMul(lightMtx, mtxHollowcube, mtxShadow);
+				hollowcubeMesh.submit(RENDERVIEW_DRAWSCENE_0_ID
+						, mtxHollowcube
+						, *currentSmSettings->m_progDraw
+						, s_renderStates[RenderState::Default]
+						);
 			}
-			hollowcubeMesh.submit(RENDERVIEW_DRAWSCENE_0_ID
-					, mtxHollowcube
-					, *currentSmSettings->m_progDraw
-					, s_renderStates[RenderState::Default]
-					);
 
 			// Cube.
-			if (LightType::DirectionalLight != settings.m_lightType)
+			s_uniforms.m_lightMtxPtr = lightMtxInstances[3];
+			if (0 != (instanceMask[3] & cameraBit) )
 			{
-				mtxMul(lightMtx, mtxCube, mtxShadow);
+				cubeMesh.submit(RENDERVIEW_DRAWSCENE_0_ID
+						, mtxCube
+						, *currentSmSettings->m_progDraw
+						, s_renderStates[RenderState::Default]
+						);
 			}
-			cubeMesh.submit(RENDERVIEW_DRAWSCENE_0_ID
-					, mtxCube
-					, *currentSmSettings->m_progDraw
-					, s_renderStates[RenderState::Default]
-					);
 
 			// Trees.
 			for (uint8_t ii = 0; ii < numTrees; ++ii)
 			{
-				if (LightType::DirectionalLight != settings.m_lightType)
+				s_uniforms.m_lightMtxPtr = lightMtxInstances[4 + ii];
+				if (0 != (instanceMask[4 + ii] & cameraBit) )
 				{
-					mtxMul(lightMtx, mtxTrees[ii], mtxShadow);
+					treeMesh.submit(RENDERVIEW_DRAWSCENE_0_ID
+							, mtxTrees[ii]
+							, *currentSmSettings->m_progDraw
+							, s_renderStates[RenderState::Default]
+							);
 				}
-				treeMesh.submit(RENDERVIEW_DRAWSCENE_0_ID
-						, mtxTrees[ii]
-						, *currentSmSettings->m_progDraw
-						, s_renderStates[RenderState::Default]
-						);
 			}
 
 			// Lights.
@@ -3288,6 +3376,8 @@ int _main_(int /*_argc*/, char** /*_argv*/)
 	hplaneMesh.unload();
 	vplaneMesh.unload();
 
+	cullSpheresFree(instanceSpheres);
+
 	bgfx::destroyTexture(texFigure);
 	bgfx::destroyTexture(texFieldstone);
 	bgfx::destroyTexture(texFlare);
@@ -0,0 +1,27 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#ifndef BOUNDS_H_HEADER_GUARD
+#define BOUNDS_H_HEADER_GUARD
+
+/// Bounding volumes, layout must match tools/geometryc/bounds.h.
+struct Aabb
+{
+	float m_min[3];
+	float m_max[3];
+};
+
+struct Obb
+{
+	float m_mtx[16];
+};
+
+struct Sphere
+{
+	float m_center[3];
+	float m_radius;
+};
+
+#endif // BOUNDS_H_HEADER_GUARD
@@ -0,0 +1,531 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <bx/debug.h>
+#include <bx/float4_t.h>
+#include "cull.h"
+
+// Don't wake worker threads for less than this many objects per thread.
+#define CULL_MIN_BATCH_PER_THREAD 256
+
+#define CULL_SPHERES          0
+#define CULL_AABBS            1
+#define CULL_SPHERES_CASCADES 2
+#define CULL_AABBS_CASCADES   3
+
+using namespace bx;
+
+void frustumFromMtx(Frustum& _frustum, const float* _mtx)
+{
+	// Gribb/Hartmann, planes from columns of row-major matrix.
+	float (*planes)[4] = _frustum.m_planes;
+	for (uint32_t ii = 0; ii < 4; ++ii)
+	{
+		const float col0 = _mtx[ii*4+0];
+		const float col1 = _mtx[ii*4+1];
+		const float col2 = _mtx[ii*4+2];
+		const float col3 = _mtx[ii*4+3];
+		planes[0][ii] = col3 + col0;
+		planes[1][ii] = col3 - col0;
+		planes[2][ii] = col3 + col1;
+		planes[3][ii] = col3 - col1;
+		planes[4][ii] = col2;
+		planes[5][ii] = col3 - col2;
+	}
+
+	for (uint32_t ii = 0; ii < 6; ++ii)
+	{
+		float* plane = planes[ii];
+		const float invLen = 1.0f/sqrtf(plane[0]*plane[0] + plane[1]*plane[1] + plane[2]*plane[2]);
+		plane[0] *= invLen;
+		plane[1] *= invLen;
+		plane[2] *= invLen;
+		plane[3] *= invLen;
+	}
+}
+
+static float* allocArrays(void*& _data, uint32_t _num, uint32_t _numArrays)
+{
+	const uint32_t stride = (_num+7) & ~7;
+	uint8_t* data = (uint8_t*)malloc(stride*_numArrays*sizeof(float) + 15);
+	float* aligned = (float*)( ( (uintptr_t)data + 15) & ~uintptr_t(15) );
+	memset(aligned, 0, stride*_numArrays*sizeof(float) );
+
+	_data = data;
+	return aligned;
+}
+
+void cullSpheresAlloc(CullSpheres& _spheres, uint32_t _num)
+{
+	const uint32_t stride = (_num+7) & ~7;
+	float* data = allocArrays(_spheres.m_data, _num, 4);
+
+	_spheres.m_num = _num;
+	_spheres.m_centerX = data;
+	_spheres.m_centerY = &data[stride*1];
+	_spheres.m_centerZ = &data[stride*2];
+	_spheres.m_radius  = &data[stride*3];
+}
+
+void cullSpheresFree(CullSpheres& _spheres)
+{
+	free(_spheres.m_data);
+	memset(&_spheres, 0, sizeof(CullSpheres) );
+}
+
+void cullSpheresSet(CullSpheres& _spheres, uint32_t _index, const Sphere& _sphere, const float* _mtx)
+{
+	const float* center = _sphere.m_center;
+	float radius = _sphere.m_radius;
+
+	if (NULL != _mtx)
+	{
+		float scale = 0.0f;
+		for (uint32_t ii = 0; ii < 3; ++ii)
+		{
+			const float* axis = &_mtx[ii*4];
+			const float len = axis[0]*axis[0] + axis[1]*axis[1] + axis[2]*axis[2];
+			scale = len > scale ? len : scale;
+		}
+
+		_spheres.m_centerX[_index] = center[0]*_mtx[0] + center[1]*_mtx[4] + center[2]*_mtx[ 8] + _mtx[12];
+		_spheres.m_centerY[_index] = center[0]*_mtx[1] + center[1]*_mtx[5] + center[2]*_mtx[ 9] + _mtx[13];
+		_spheres.m_centerZ[_index] = center[0]*_mtx[2] + center[1]*_mtx[6] + center[2]*_mtx[10] + _mtx[14];
+		_spheres.m_radius[_index]  = radius*sqrtf(scale);
+		return;
+	}
+
+	_spheres.m_centerX[_index] = center[0];
+	_spheres.m_centerY[_index] = center[1];
+	_spheres.m_centerZ[_index] = center[2];
+	_spheres.m_radius[_index]  = radius;
+}
+
+void cullAabbsAlloc(CullAabbs& _aabbs, uint32_t _num)
+{
+	const uint32_t stride = (_num+7) & ~7;
+	float* data = allocArrays(_aabbs.m_data, _num, 6);
+
+	_aabbs.m_num = _num;
+	_aabbs.m_centerX = data;
+	_aabbs.m_centerY = &data[stride*1];
+	_aabbs.m_centerZ = &data[stride*2];
+	_aabbs.m_extentX = &data[stride*3];
+	_aabbs.m_extentY = &data[stride*4];
+	_aabbs.m_extentZ = &data[stride*5];
+}
+
+void cullAabbsFree(CullAabbs& _aabbs)
+{
+	free(_aabbs.m_data);
+	memset(&_aabbs, 0, sizeof(CullAabbs) );
+}
+
+void cullAabbsSet(CullAabbs& _aabbs, uint32_t _index, const Aabb& _aabb, const float* _mtx)
+{
+	float center[3];
+	float extent[3];
+	for (uint32_t ii = 0; ii < 3; ++ii)
+	{
+		center[ii] = (_aabb.m_min[ii] + _aabb.m_max[ii])*0.5f;
+		extent[ii] = (_aabb.m_max[ii] - _aabb.m_min[ii])*0.5f;
+	}
+
+	if (NULL != _mtx)
+	{
+		float tmpCenter[3];
+		float tmpExtent[3];
+		for (uint32_t ii = 0; ii < 3; ++ii)
+		{
+			tmpCenter[ii] = center[0]*_mtx[ii] + center[1]*_mtx[4+ii] + center[2]*_mtx[8+ii] + _mtx[12+ii];
+			tmpExtent[ii] = extent[0]*fabsf(_mtx[ii]) + extent[1]*fabsf(_mtx[4+ii]) + extent[2]*fabsf(_mtx[8+ii]);
+		}
+
+		memcpy(center, tmpCenter, sizeof(center) );
+		memcpy(extent, tmpExtent, sizeof(extent) );
+	}
+
+	_aabbs.m_centerX[_index] = center[0];
+	_aabbs.m_centerY[_index] = center[1];
+	_aabbs.m_centerZ[_index] = center[2];
+	_aabbs.m_extentX[_index] = extent[0];
+	_aabbs.m_extentY[_index] = extent[1];
+	_aabbs.m_extentZ[_index] = extent[2];
+}
+
+struct FrustumSimd
+{
+	void init(const Frustum& _frustum)
+	{
+		for (uint32_t ii = 0; ii < 6; ++ii)
+		{
+			const float* plane = _frustum.m_planes[ii];
+			m_x[ii] = float4_splat(plane[0]);
+			m_y[ii] = float4_splat(plane[1]);
+			m_z[ii] = float4_splat(plane[2]);
+			m_w[ii] = float4_splat(plane[3]);
+			m_absX[ii] = float4_splat(fabsf(plane[0]) );
+			m_absY[ii] = float4_splat(fabsf(plane[1]) );
+			m_absZ[ii] = float4_splat(fabsf(plane[2]) );
+		}
+	}
+
+	float4_t m_x[6];
+	float4_t m_y[6];
+	float4_t m_z[6];
+	float4_t m_w[6];
+	float4_t m_absX[6];
+	float4_t m_absY[6];
+	float4_t m_absZ[6];
+};
+
+// Sphere is outside when it's fully behind any plane.
+static BX_FORCE_INLINE float4_t sphereVisible(const FrustumSimd& _frustum, const CullSpheres& _spheres, uint32_t _index)
+{
+	const float4_t cx     = float4_ld(&_spheres.m_centerX[_index]);
+	const float4_t cy     = float4_ld(&_spheres.m_centerY[_index]);
+	const float4_t cz     = float4_ld(&_spheres.m_centerZ[_index]);
+	const float4_t radius = float4_ld(&_spheres.m_radius[_index]);
+	const float4_t zero   = float4_zero();
+
+	float4_t visible = float4_isplat(UINT32_C(0xffffffff) );
+	for (uint32_t ii = 0; ii < 6; ++ii)
+	{
+		const float4_t dist = float4_madd(cx, _frustum.m_x[ii]
+							, float4_madd(cy, _frustum.m_y[ii]
+							, float4_madd(cz, _frustum.m_z[ii]
+							, float4_add(_frustum.m_w[ii], radius) ) ) );
+		visible = float4_and(visible, float4_cmpge(dist, zero) );
+	}
+
+	return visible;
+}
+
+// Box is outside when its corner nearest to plane normal direction is
+// behind any plane, projected radius of box on plane normal is
+// dot(extent, abs(normal) ).
+static BX_FORCE_INLINE float4_t aabbVisible(const FrustumSimd& _frustum, const CullAabbs& _aabbs, uint32_t _index)
+{
+	const float4_t cx   = float4_ld(&_aabbs.m_centerX[_index]);
+	const float4_t cy   = float4_ld(&_aabbs.m_centerY[_index]);
+	const float4_t cz   = float4_ld(&_aabbs.m_centerZ[_index]);
+	const float4_t ex   = float4_ld(&_aabbs.m_extentX[_index]);
+	const float4_t ey   = float4_ld(&_aabbs.m_extentY[_index]);
+	const float4_t ez   = float4_ld(&_aabbs.m_extentZ[_index]);
+	const float4_t zero = float4_zero();
+
+	float4_t visible = float4_isplat(UINT32_C(0xffffffff) );
+	for (uint32_t ii = 0; ii < 6; ++ii)
+	{
+		const float4_t radius = float4_madd(ex, _frustum.m_absX[ii]
+							  , float4_madd(ey, _frustum.m_absY[ii]
+							  , float4_mul(ez, _frustum.m_absZ[ii]) ) );
+		const float4_t dist = float4_madd(cx, _frustum.m_x[ii]
+							, float4_madd(cy, _frustum.m_y[ii]
+							, float4_madd(cz, _frustum.m_z[ii]
+							, float4_add(_frustum.m_w[ii], radius) ) ) );
+		visible = float4_and(visible, float4_cmpge(dist, zero) );
+	}
+
+	return visible;
+}
+
+static BX_FORCE_INLINE uint32_t compact(uint32_t* _visible, uint32_t _numVisible, const uint32_t* _mask, uint32_t _index, uint32_t _end)
+{
+	for (uint32_t ii = 0, num = _end - _index < 8 ? _end - _index : 8; ii < num; ++ii)
+	{
+		_visible[_numVisible] = _index + ii;
+		_numVisible += 0 != _mask[ii];
+	}
+
+	return _numVisible;
+}
+
+static void store(uint8_t* _mask, const uint32_t* _bits, uint32_t _index, uint32_t _end)
+{
+	for (uint32_t ii = 0, num = _end - _index < 8 ? _end - _index : 8; ii < num; ++ii)
+	{
+		_mask[_index + ii] = uint8_t(_bits[ii]);
+	}
+}
+
+// Range functions, _begin must be multiple of 8. Two float4 are tested per
+// iteration, to hide latency of dependent multiply-add chain.
+static uint32_t cullSpheresRange(uint32_t* _visible, const CullSpheres& _spheres, const Frustum& _frustum, uint32_t _begin, uint32_t _end)
+{
+	FrustumSimd frustum;
+	frustum.init(_frustum);
+
+	BX_ALIGN_STRUCT_16(uint32_t mask[8]);
+	uint32_t numVisible = 0;
+
+	for (uint32_t ii = _begin; ii < _end; ii += 8)
+	{
+		const float4_t visible0 = sphereVisible(frustum, _spheres, ii);
+		const float4_t visible1 = sphereVisible(frustum, _spheres, ii+4);
+		float4_st(&mask[0], visible0);
+		float4_st(&mask[4], visible1);
+		numVisible = compact(_visible, numVisible, mask, ii, _end);
+	}
+
+	return numVisible;
+}
+
+static uint32_t cullAabbsRange(uint32_t* _visible, const CullAabbs& _aabbs, const Frustum& _frustum, uint32_t _begin, uint32_t _end)
+{
+	FrustumSimd frustum;
+	frustum.init(_frustum);
+
+	BX_ALIGN_STRUCT_16(uint32_t mask[8]);
+	uint32_t numVisible = 0;
+
+	for (uint32_t ii = _begin; ii < _end; ii += 8)
+	{
+		const float4_t visible0 = aabbVisible(frustum, _aabbs, ii);
+		const float4_t visible1 = aabbVisible(frustum, _aabbs, ii+4);
+		float4_st(&mask[0], visible0);
+		float4_st(&mask[4], visible1);
+		numVisible = compact(_visible, numVisible, mask, ii, _end);
+	}
+
+	return numVisible;
+}
+
+static void cullSpheresCascadesRange(uint8_t* _mask, const CullSpheres& _spheres, const Frustum* _frustums, uint32_t _numFrustums, uint32_t _begin, uint32_t _end)
+{
+	FrustumSimd frustums[CULL_MAX_CASCADES];
+	float4_t bit[CULL_MAX_CASCADES];
+	for (uint32_t ii = 0; ii < _numFrustums; ++ii)
+	{
+		frustums[ii].init(_frustums[ii]);
+		bit[ii] = float4_isplat(1<<ii);
+	}
+
+	BX_ALIGN_STRUCT_16(uint32_t bits[8]);
+
+	for (uint32_t ii = _begin; ii < _end; ii += 8)
+	{
+		float4_t bits0 = float4_zero();
+		float4_t bits1 = float4_zero();
+		for (uint32_t jj = 0; jj < _numFrustums; ++jj)
+		{
+			bits0 = float4_or(bits0, float4_and(bit[jj], sphereVisible(frustums[jj], _spheres, ii) ) );
+			bits1 = float4_or(bits1, float4_and(bit[jj], sphereVisible(frustums[jj], _spheres, ii+4) ) );
+		}
+
+		float4_st(&bits[0], bits0);
+		float4_st(&bits[4], bits1);
+		store(_mask, bits, ii, _end);
+	}
+}
+
+static void cullAabbsCascadesRange(uint8_t* _mask, const CullAabbs& _aabbs, const Frustum* _frustums, uint32_t _numFrustums, uint32_t _begin, uint32_t _end)
+{
+	FrustumSimd frustums[CULL_MAX_CASCADES];
+	float4_t bit[CULL_MAX_CASCADES];
+	for (uint32_t ii = 0; ii < _numFrustums; ++ii)
+	{
+		frustums[ii].init(_frustums[ii]);
+		bit[ii] = float4_isplat(1<<ii);
+	}
+
+	BX_ALIGN_STRUCT_16(uint32_t bits[8]);
+
+	for (uint32_t ii = _begin; ii < _end; ii += 8)
+	{
+		float4_t bits0 = float4_zero();
+		float4_t bits1 = float4_zero();
+		for (uint32_t jj = 0; jj < _numFrustums; ++jj)
+		{
+			bits0 = float4_or(bits0, float4_and(bit[jj], aabbVisible(frustums[jj], _aabbs, ii) ) );
+			bits1 = float4_or(bits1, float4_and(bit[jj], aabbVisible(frustums[jj], _aabbs, ii+4) ) );
+		}
+
+		float4_st(&bits[0], bits0);
+		float4_st(&bits[4], bits1);
+		store(_mask, bits, ii, _end);
+	}
+}
+
+uint32_t cullSpheres(uint32_t* _visible, const CullSpheres& _spheres, const Frustum& _frustum)
+{
+	return cullSpheresRange(_visible, _spheres, _frustum, 0, _spheres.m_num);
+}
+
+uint32_t cullAabbs(uint32_t* _visible, const CullAabbs& _aabbs, const Frustum& _frustum)
+{
+	return cullAabbsRange(_visible, _aabbs, _frustum, 0, _aabbs.m_num);
+}
+
+void cullSpheresCascades(uint8_t* _mask, const CullSpheres& _spheres, const Frustum* _frustums, uint32_t _numFrustums)
+{
+	BX_CHECK(CULL_MAX_CASCADES >= _numFrustums, "Too many frustums.");
+	cullSpheresCascadesRange(_mask, _spheres, _frustums, _numFrustums, 0, _spheres.m_num);
+}
+
+void cullAabbsCascades(uint8_t* _mask, const CullAabbs& _aabbs, const Frustum* _frustums, uint32_t _numFrustums)
+{
+	BX_CHECK(CULL_MAX_CASCADES >= _numFrustums, "Too many frustums.");
+	cullAabbsCascadesRange(_mask, _aabbs, _frustums, _numFrustums, 0, _aabbs.m_num);
+}
+
+CullBatch::CullBatch(uint32_t _numThreads)
+	: m_numThreads(_numThreads < 1 ? 1 : _numThreads > CULL_MAX_THREADS ? CULL_MAX_THREADS : _numThreads)
+	, m_exit(false)
+{
+	// Worker 0 is calling thread.
+	for (uint32_t ii = 1; ii < m_numThreads; ++ii)
+	{
+		Worker& worker = m_worker[ii];
+		worker.m_batch = this;
+		worker.m_index = ii;
+		worker.m_thread.init(workerFunc, &worker);
+	}
+}
+
+CullBatch::~CullBatch()
+{
+	m_exit = true;
+	for (uint32_t ii = 1; ii < m_numThreads; ++ii)
+	{
+		m_worker[ii].m_start.post();
+		m_worker[ii].m_thread.shutdown();
+	}
+}
+
+int32_t CullBatch::workerFunc(void* _userData)
+{
+	Worker* worker = (Worker*)_userData;
+	CullBatch* batch = worker->m_batch;
+
+	for (;;)
+	{
+		worker->m_start.wait();
+		if (batch->m_exit)
+		{
+			break;
+		}
+
+		batch->execute(worker->m_index);
+		batch->m_done.post();
+	}
+
+	return 0;
+}
+
+void CullBatch::execute(uint32_t _index)
+{
+	const uint32_t begin = _index*m_chunk;
+	const uint32_t end = begin + m_chunk < m_num ? begin + m_chunk : m_num;
+
+	m_numVisible[_index] = 0;
+	if (begin >= end)
+	{
+		return;
+	}
+
+	// Each range writes visible indices at its own offset, they are
+	// compacted after all ranges are done.
+	switch (m_type)
+	{
+	case CULL_SPHERES:
+		m_numVisible[_index] = cullSpheresRange(&m_visible[begin], *(const CullSpheres*)m_bounds, *m_frustums, begin, end);
+		break;
+
+	case CULL_AABBS:
+		m_numVisible[_index] = cullAabbsRange(&m_visible[begin], *(const CullAabbs*)m_bounds, *m_frustums, begin, end);
+		break;
+
+	case CULL_SPHERES_CASCADES:
+		cullSpheresCascadesRange(m_mask, *(const CullSpheres*)m_bounds, m_frustums, m_numFrustums, begin, end);
+		break;
+
+	case CULL_AABBS_CASCADES:
+		cullAabbsCascadesRange(m_mask, *(const CullAabbs*)m_bounds, m_frustums, m_numFrustums, begin, end);
+		break;
+
+	default:
+		break;
+	}
+}
+
+uint32_t CullBatch::run(uint8_t _type, uint32_t _num)
+{
+	uint32_t numThreads = _num/CULL_MIN_BATCH_PER_THREAD;
+	numThreads = numThreads < 1 ? 1 : numThreads > m_numThreads ? m_numThreads : numThreads;
+
+	m_type = _type;
+	m_num = _num;
+	m_chunk = ( (_num + numThreads - 1)/numThreads + 7) & ~7;
+
+	for (uint32_t ii = 1; ii < numThreads; ++ii)
+	{
+		m_worker[ii].m_start.post();
+	}
+
+	execute(0);
+
+	for (uint32_t ii = 1; ii < numThreads; ++ii)
+	{
+		m_done.wait();
+	}
+
+	uint32_t numVisible = m_numVisible[0];
+	if (NULL != m_visible)
+	{
+		for (uint32_t ii = 1; ii < numThreads; ++ii)
+		{
+			memmove(&m_visible[numVisible], &m_visible[ii*m_chunk], m_numVisible[ii]*sizeof(uint32_t) );
+			numVisible += m_numVisible[ii];
+		}
+	}
+
+	return numVisible;
+}
+
+uint32_t CullBatch::cullSpheres(uint32_t* _visible, const CullSpheres& _spheres, const Frustum& _frustum)
+{
+	m_bounds = &_spheres;
+	m_frustums = &_frustum;
+	m_numFrustums = 1;
+	m_visible = _visible;
+	m_mask = NULL;
+	return run(CULL_SPHERES, _spheres.m_num);
+}
+
+uint32_t CullBatch::cullAabbs(uint32_t* _visible, const CullAabbs& _aabbs, const Frustum& _frustum)
+{
+	m_bounds = &_aabbs;
+	m_frustums = &_frustum;
+	m_numFrustums = 1;
+	m_visible = _visible;
+	m_mask = NULL;
+	return run(CULL_AABBS, _aabbs.m_num);
+}
+
+void CullBatch::cullSpheresCascades(uint8_t* _mask, const CullSpheres& _spheres, const Frustum* _frustums, uint32_t _numFrustums)
+{
+	BX_CHECK(CULL_MAX_CASCADES >= _numFrustums, "Too many frustums.");
+	m_bounds = &_spheres;
+	m_frustums = _frustums;
+	m_numFrustums = _numFrustums;
+	m_visible = NULL;
+	m_mask = _mask;
+	run(CULL_SPHERES_CASCADES, _spheres.m_num);
+}
+
+void CullBatch::cullAabbsCascades(uint8_t* _mask, const CullAabbs& _aabbs, const Frustum* _frustums, uint32_t _numFrustums)
+{
+	BX_CHECK(CULL_MAX_CASCADES >= _numFrustums, "Too many frustums.");
+	m_bounds = &_aabbs;
+	m_frustums = _frustums;
+	m_numFrustums = _numFrustums;
+	m_visible = NULL;
+	m_mask = _mask;
+	run(CULL_AABBS_CASCADES, _aabbs.m_num);
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#ifndef CULL_H_HEADER_GUARD
+#define CULL_H_HEADER_GUARD
+
+#include <bx/bx.h>
+#include <bx/sem.h>
+#include <bx/thread.h>
+
+#include "bounds.h"
+
+#define CULL_MAX_THREADS  16
+#define CULL_MAX_CASCADES 8
+
+/// View frustum planes, normalized, inside is dot(normal, pos) + dist >= 0.
+struct Frustum
+{
+	float m_planes[6][4];
+};
+
+/// Extract frustum planes from view projection matrix.
+///
+/// When _mtx is model view projection matrix, planes are in model space.
+///
+void frustumFromMtx(Frustum& _frustum, const float* _mtx);
+
+/// Bounding spheres as structure of arrays, 16 byte aligned and padded
+/// to multiple of 8.
+struct CullSpheres
+{
+	uint32_t m_num;
+	float* m_centerX;
+	float* m_centerY;
+	float* m_centerZ;
+	float* m_radius;
+	void* m_data;
+};
+
+/// Axis aligned bounding boxes as structure of arrays, stored as center
+/// and half extent, 16 byte aligned and padded to multiple of 8.
+struct CullAabbs
+{
+	uint32_t m_num;
+	float* m_centerX;
+	float* m_centerY;
+	float* m_centerZ;
+	float* m_extentX;
+	float* m_extentY;
+	float* m_extentZ;
+	void* m_data;
+};
+
+/// Allocate arrays for _num spheres.
+void cullSpheresAlloc(CullSpheres& _spheres, uint32_t _num);
+
+/// Free sphere arrays.
+void cullSpheresFree(CullSpheres& _spheres);
+
+/// Set sphere, optionally transformed by _mtx. Radius is scaled by the
+/// largest axis scale of _mtx.
+void cullSpheresSet(CullSpheres& _spheres, uint32_t _index, const Sphere& _sphere, const float* _mtx = NULL);
+
+/// Allocate arrays for _num boxes.
+void cullAabbsAlloc(CullAabbs& _aabbs, uint32_t _num);
+
+/// Free box arrays.
+void cullAabbsFree(CullAabbs& _aabbs);
+
+/// Set box, optionally transformed by _mtx. Transformed box is box
+/// around transformed _aabb.
+void cullAabbsSet(CullAabbs& _aabbs, uint32_t _index, const Aabb& _aabb, const float* _mtx = NULL);
+
+/// Cull spheres against frustum, eight spheres at the time.
+///
+/// @param _visible Indices of visible spheres in ascending order, must
+///   hold m_num entries.
+/// @returns Number of visible spheres.
+///
+uint32_t cullSpheres(uint32_t* _visible, const CullSpheres& _spheres, const Frustum& _frustum);
+
+/// Cull boxes against frustum, eight boxes at the time.
+///
+/// @param _visible Indices of visible boxes in ascending order, must hold
+///   m_num entries.
+/// @returns Number of visible boxes.
+///
+uint32_t cullAabbs(uint32_t* _visible, const CullAabbs& _aabbs, const Frustum& _frustum);
+
+/// Cull spheres against multiple frustums (f.e. shadow map cascades).
+///
+/// @param _mask Per sphere bit mask, bit ii is set when sphere is inside
+///   _frustums[ii]. Must hold m_num entries.
+/// @param _numFrustums Number of frustums, up to CULL_MAX_CASCADES.
+///
+void cullSpheresCascades(uint8_t* _mask, const CullSpheres& _spheres, const Frustum* _frustums, uint32_t _numFrustums);
+
+/// Cull boxes against multiple frustums (f.e. shadow map cascades).
+///
+/// @param _mask Per box bit mask, bit ii is set when box is inside
+///   _frustums[ii]. Must hold m_num entries.
+/// @param _numFrustums Number of frustums, up to CULL_MAX_CASCADES.
+///
+void cullAabbsCascades(uint8_t* _mask, const CullAabbs& _aabbs, const Frustum* _frustums, uint32_t _numFrustums);
+
+/// Culls large batches on worker threads. Batch is split into ranges,
+/// calling thread culls first range, and worker threads the rest. Small
+/// batches are culled on calling thread only.
+///
+/// Results are identical to single threaded functions above.
+///
+class CullBatch
+{
+public:
+	/// @param _numThreads Total number of threads including calling
+	///   thread, up to CULL_MAX_THREADS.
+	CullBatch(uint32_t _numThreads);
+	~CullBatch();
+
+	uint32_t cullSpheres(uint32_t* _visible, const CullSpheres& _spheres, const Frustum& _frustum);
+	uint32_t cullAabbs(uint32_t* _visible, const CullAabbs& _aabbs, const Frustum& _frustum);
+	void cullSpheresCascades(uint8_t* _mask, const CullSpheres& _spheres, const Frustum* _frustums, uint32_t _numFrustums);
+	void cullAabbsCascades(uint8_t* _mask, const CullAabbs& _aabbs, const Frustum* _frustums, uint32_t _numFrustums);
+
+private:
+	struct Worker
+	{
+		CullBatch* m_batch;
+		uint32_t m_index;
+		bx::Thread m_thread;
+		bx::Semaphore m_start;
+	};
+
+	static int32_t workerFunc(void* _userData);
+
+	uint32_t run(uint8_t _type, uint32_t _num);
+	void execute(uint32_t _index);
+
+	Worker m_worker[CULL_MAX_THREADS];
+	bx::Semaphore m_done;
+	uint32_t m_numThreads;
+	bool m_exit;
+
+	uint8_t m_type;
+	uint32_t m_num;
+	uint32_t m_chunk;
+	const void* m_bounds;
+	const Frustum* m_frustums;
+	uint32_t m_numFrustums;
+	uint32_t* m_visible;
+	uint8_t* m_mask;
+	uint32_t m_numVisible[CULL_MAX_THREADS];
+};
+
+#endif // CULL_H_HEADER_GUARD
@@ -12,6 +12,14 @@
 #include <math.h>
 #include <string.h>
 
+#include <bx/float4_t.h>
+
+// Matrix multiply, transform and inverse use bx::float4_t. Set to 0 to
+// use scalar code.
+#ifndef FPU_MATH_SIMD
+#	define FPU_MATH_SIMD 1
+#endif // FPU_MATH_SIMD
+
 #if BX_COMPILER_MSVC
 inline float fminf(float _a, float _b)
 {
@@ -352,24 +360,129 @@ inline void vec3MulMtxH(float* __restrict _result, const float* __restrict _vec,
 	_result[2] = zz*invW;
 }
 
+#if FPU_MATH_SIMD
+// Matrices and vectors are not required to be 16 byte aligned.
+inline bx::float4_t vec4Ld(const float* _ptr)
+{
+	return bx::float4_ld(_ptr[0], _ptr[1], _ptr[2], _ptr[3]);
+}
+
+inline void vec4St(float* _ptr, bx::float4_t _a)
+{
+	BX_ALIGN_STRUCT_16(float tmp[4]);
+	bx::float4_st(tmp, _a);
+	memcpy(_ptr, tmp, 4*sizeof(float) );
+}
+
+inline bx::float4_t vec4MulMtx(bx::float4_t _vec, bx::float4_t _row0, bx::float4_t _row1, bx::float4_t _row2, bx::float4_t _row3)
+{
+	using namespace bx;
+	return float4_madd(float4_swiz_xxxx(_vec), _row0
+		, float4_madd(float4_swiz_yyyy(_vec), _row1
+		, float4_madd(float4_swiz_zzzz(_vec), _row2
+		, float4_mul(float4_swiz_wwww(_vec), _row3) ) ) );
+}
+#endif // FPU_MATH_SIMD
+
 inline void vec4MulMtx(float* __restrict _result, const float* __restrict _vec, const float* __restrict _mat)
 {
+#if FPU_MATH_SIMD
+	vec4St(_result, vec4MulMtx(vec4Ld(_vec), vec4Ld(&_mat[0]), vec4Ld(&_mat[4]), vec4Ld(&_mat[8]), vec4Ld(&_mat[12]) ) );
+#else
 	_result[0] = _vec[0] * _mat[ 0] + _vec[1] * _mat[4] + _vec[2] * _mat[ 8] + _vec[3] * _mat[12];
 	_result[1] = _vec[0] * _mat[ 1] + _vec[1] * _mat[5] + _vec[2] * _mat[ 9] + _vec[3] * _mat[13];
 	_result[2] = _vec[0] * _mat[ 2] + _vec[1] * _mat[6] + _vec[2] * _mat[10] + _vec[3] * _mat[14];
 	_result[3] = _vec[0] * _mat[ 3] + _vec[1] * _mat[7] + _vec[2] * _mat[11] + _vec[3] * _mat[15];
+#endif // FPU_MATH_SIMD
 }
 
 inline void mtxMul(float* __restrict _result, const float* __restrict _a, const float* __restrict _b)
 {
+#if FPU_MATH_SIMD
+	const bx::float4_t row0 = vec4Ld(&_b[ 0]);
+	const bx::float4_t row1 = vec4Ld(&_b[ 4]);
+	const bx::float4_t row2 = vec4Ld(&_b[ 8]);
+	const bx::float4_t row3 = vec4Ld(&_b[12]);
+	vec4St(&_result[ 0], vec4MulMtx(vec4Ld(&_a[ 0]), row0, row1, row2, row3) );
+	vec4St(&_result[ 4], vec4MulMtx(vec4Ld(&_a[ 4]), row0, row1, row2, row3) );
+	vec4St(&_result[ 8], vec4MulMtx(vec4Ld(&_a[ 8]), row0, row1, row2, row3) );
+	vec4St(&_result[12], vec4MulMtx(vec4Ld(&_a[12]), row0, row1, row2, row3) );
+#else
 	vec4MulMtx(&_result[ 0], &_a[ 0], _b);
 	vec4MulMtx(&_result[ 4], &_a[ 4], _b);
 	vec4MulMtx(&_result[ 8], &_a[ 8], _b);
 	vec4MulMtx(&_result[12], &_a[12], _b);
+#endif // FPU_MATH_SIMD
+}
+
+/// Multiply array of matrices by the same matrix, _result[ii] = _a[ii]*_b.
+/// Use it for model matrices of many objects and shared view projection.
+inline void mtxMulBatch(float* __restrict _result, const float* __restrict _a, const float* __restrict _b, uint32_t _num)
+{
+#if FPU_MATH_SIMD
+	const bx::float4_t row0 = vec4Ld(&_b[ 0]);
+	const bx::float4_t row1 = vec4Ld(&_b[ 4]);
+	const bx::float4_t row2 = vec4Ld(&_b[ 8]);
+	const bx::float4_t row3 = vec4Ld(&_b[12]);
+	for (uint32_t ii = 0, num = _num*4; ii < num; ++ii)
+	{
+		vec4St(&_result[ii*4], vec4MulMtx(vec4Ld(&_a[ii*4]), row0, row1, row2, row3) );
+	}
+#else
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		mtxMul(&_result[ii*16], &_a[ii*16], _b);
+	}
+#endif // FPU_MATH_SIMD
+}
+
+/// Transform array of points, _result[ii] = _vec[ii]*_mat, with w = 1.
+/// Arrays are tightly packed float[3].
+inline void vec3MulMtxBatch(float* __restrict _result, const float* __restrict _vec, const float* __restrict _mat, uint32_t _num)
+{
+#if FPU_MATH_SIMD
+	using namespace bx;
+	const float4_t row0 = vec4Ld(&_mat[ 0]);
+	const float4_t row1 = vec4Ld(&_mat[ 4]);
+	const float4_t row2 = vec4Ld(&_mat[ 8]);
+	const float4_t row3 = vec4Ld(&_mat[12]);
+
+	BX_ALIGN_STRUCT_16(float tmp[4]);
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		const float* vec = &_vec[ii*3];
+		const float4_t result = float4_madd(float4_splat(vec[0]), row0
+			, float4_madd(float4_splat(vec[1]), row1
+			, float4_madd(float4_splat(vec[2]), row2
+			, row3) ) );
+		float4_st(tmp, result);
+		memcpy(&_result[ii*3], tmp, 3*sizeof(float) );
+	}
+#else
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		vec3MulMtx(&_result[ii*3], &_vec[ii*3], _mat);
+	}
+#endif // FPU_MATH_SIMD
 }
 
 inline void mtxTranspose(float* __restrict _result, const float* __restrict _a)
 {
+#if FPU_MATH_SIMD
+	using namespace bx;
+	const float4_t row0 = vec4Ld(&_a[ 0]);
+	const float4_t row1 = vec4Ld(&_a[ 4]);
+	const float4_t row2 = vec4Ld(&_a[ 8]);
+	const float4_t row3 = vec4Ld(&_a[12]);
+	const float4_t tmp0 = float4_shuf_xAyB(row0, row1);
+	const float4_t tmp1 = float4_shuf_xAyB(row2, row3);
+	const float4_t tmp2 = float4_shuf_zCwD(row0, row1);
+	const float4_t tmp3 = float4_shuf_zCwD(row2, row3);
+	vec4St(&_result[ 0], float4_shuf_xyAB(tmp0, tmp1) );
+	vec4St(&_result[ 4], float4_shuf_zwCD(tmp0, tmp1) );
+	vec4St(&_result[ 8], float4_shuf_xyAB(tmp2, tmp3) );
+	vec4St(&_result[12], float4_shuf_zwCD(tmp2, tmp3) );
+#else
 	_result[ 0] = _a[ 0];
 	_result[ 4] = _a[ 1];
 	_result[ 8] = _a[ 2];
@@ -386,6 +499,7 @@ inline void mtxTranspose(float* __restrict _result, const float* __restrict _a)
 	_result[ 7] = _a[13];
 	_result[11] = _a[14];
 	_result[15] = _a[15];
+#endif // FPU_MATH_SIMD
 }
 
 inline void mtx3Inverse(float* __restrict _result, const float* __restrict _a)
@@ -420,8 +534,81 @@ inline void mtx3Inverse(float* __restrict _result, const float* __restrict _a)
 	_result[8] = +(xx*yy - xy*yx) * invDet;
 }
 
+#if FPU_MATH_SIMD
+// 2x2 matrices packed in float4_t as x y / z w, used by mtxInverse.
+inline bx::float4_t mtx2Mul(bx::float4_t _a, bx::float4_t _b)
+{
+	using namespace bx;
+	return float4_madd(_a, float4_swiz_xwxw(_b), float4_mul(float4_swiz_yxwz(_a), float4_swiz_zyzy(_b) ) );
+}
+
+// Adjugate of _a times _b.
+inline bx::float4_t mtx2AdjMul(bx::float4_t _a, bx::float4_t _b)
+{
+	using namespace bx;
+	return float4_sub(float4_mul(float4_swiz_wwxx(_a), _b), float4_mul(float4_swiz_yyzz(_a), float4_swiz_zwxy(_b) ) );
+}
+
+// _a times adjugate of _b.
+inline bx::float4_t mtx2MulAdj(bx::float4_t _a, bx::float4_t _b)
+{
+	using namespace bx;
+	return float4_sub(float4_mul(_a, float4_swiz_wxwx(_b) ), float4_mul(float4_swiz_yxwz(_a), float4_swiz_zyzy(_b) ) );
+}
+#endif // FPU_MATH_SIMD
+
 inline void mtxInverse(float* __restrict _result, const float* __restrict _a)
 {
+#if FPU_MATH_SIMD
+	// Blockwise inversion of 2x2 blocks:
+	//   | A B |
+	//   | C D |
+	using namespace bx;
+	const float4_t row0 = vec4Ld(&_a[ 0]);
+	const float4_t row1 = vec4Ld(&_a[ 4]);
+	const float4_t row2 = vec4Ld(&_a[ 8]);
+	const float4_t row3 = vec4Ld(&_a[12]);
+
+	const float4_t aa = float4_shuf_xyAB(row0, row1);
+	const float4_t bb = float4_shuf_zwCD(row0, row1);
+	const float4_t cc = float4_shuf_xyAB(row2, row3);
+	const float4_t dd = float4_shuf_zwCD(row2, row3);
+
+	// Determinants of A, B, C and D.
+	const float4_t det = float4_sub(
+		  float4_mul(float4_shuf_xyAB(float4_swiz_xzxz(row0), float4_swiz_xzxz(row2) ), float4_shuf_xyAB(float4_swiz_ywyw(row1), float4_swiz_ywyw(row3) ) )
+		, float4_mul(float4_shuf_xyAB(float4_swiz_ywyw(row0), float4_swiz_ywyw(row2) ), float4_shuf_xyAB(float4_swiz_xzxz(row1), float4_swiz_xzxz(row3) ) )
+		);
+	const float4_t detA = float4_swiz_xxxx(det);
+	const float4_t detB = float4_swiz_yyyy(det);
+	const float4_t detC = float4_swiz_zzzz(det);
+	const float4_t detD = float4_swiz_wwww(det);
+
+	const float4_t dc = mtx2AdjMul(dd, cc);
+	const float4_t ab = mtx2AdjMul(aa, bb);
+
+	const float4_t xx = float4_sub(float4_mul(detD, aa), mtx2Mul(bb, dc) );
+	const float4_t ww = float4_sub(float4_mul(detA, dd), mtx2Mul(cc, ab) );
+	const float4_t yy = float4_sub(float4_mul(detB, cc), mtx2MulAdj(dd, ab) );
+	const float4_t zz = float4_sub(float4_mul(detC, bb), mtx2MulAdj(aa, dc) );
+
+	float4_t tr = float4_mul(ab, float4_swiz_xzyw(dc) );
+	tr = float4_add(tr, float4_swiz_yxwz(tr) );
+	tr = float4_add(tr, float4_swiz_zwxy(tr) );
+
+	const float4_t detM = float4_sub(float4_madd(detA, detD, float4_mul(detB, detC) ), tr);
+	const float4_t invDet = float4_div(float4_ld(1.0f, -1.0f, -1.0f, 1.0f), detM);
+
+	const float4_t rx = float4_mul(xx, invDet);
+	const float4_t ry = float4_mul(yy, invDet);
+	const float4_t rz = float4_mul(zz, invDet);
+	const float4_t rw = float4_mul(ww, invDet);
+
+	vec4St(&_result[ 0], float4_shuf_xyAB(float4_swiz_wywy(rx), float4_swiz_wywy(ry) ) );
+	vec4St(&_result[ 4], float4_shuf_xyAB(float4_swiz_zxzx(rx), float4_swiz_zxzx(ry) ) );
+	vec4St(&_result[ 8], float4_shuf_xyAB(float4_swiz_wywy(rz), float4_swiz_wywy(rw) ) );
+	vec4St(&_result[12], float4_shuf_xyAB(float4_swiz_zxzx(rz), float4_swiz_zxzx(rw) ) );
+#else
 	float xx = _a[ 0];
 	float xy = _a[ 1];
 	float xz = _a[ 2];
@@ -466,6 +653,7 @@ inline void mtxInverse(float* __restrict _result, const float* __restrict _a)
 	_result[13] = +(xx*(zy*wz - wy*zz) - xy*(zx*wz - wx*zz) + xz*(zx*wy - wx*zy) ) * invDet;
 	_result[14] = -(xx*(yy*wz - wy*yz) - xy*(yx*wz - wx*yz) + xz*(yx*wy - wx*yy) ) * invDet;
 	_result[15] = +(xx*(yy*zz - zy*yz) - xy*(yx*zz - zx*yz) + xz*(yx*zy - zx*yy) ) * invDet;
+#endif // FPU_MATH_SIMD
 }
 
 /// Convert LH to RH projection matrix and vice versa.
@@ -0,0 +1,186 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <bx/debug.h>
+#include <bx/float4_t.h>
+#include "lodselect.h"
+
+// Objects closer than this are treated as at this distance.
+#define LOD_MIN_DISTANCE 0.01f
+
+#define LOD_MAX_ERROR_SCALE 64.0f
+
+using namespace bx;
+
+LodSelector::LodSelector(uint32_t _maxObjects)
+	: m_maxObjects(_maxObjects)
+	, m_threshold(1.0f)
+	, m_hysteresis(0.25f)
+	, m_errorScale(1.0f)
+	, m_triangleBudget(0)
+	, m_numTriangles(0)
+	, m_transitionFrames(32)
+{
+	// Float arrays are 16 byte aligned and padded to multiple of 8, to
+	// match CullSpheres.
+	const uint32_t stride = (_maxObjects+7) & ~7;
+	const uint32_t size = 0
+		+ stride*2*sizeof(float)
+		+ stride*sizeof(LodChain*)
+		+ stride*3
+		;
+	m_data = malloc(size + 15);
+	uint8_t* data = (uint8_t*)( ( (uintptr_t)m_data + 15) & ~uintptr_t(15) );
+	memset(data, 0, size);
+
+	m_scale    = (float*)data;
+	m_maxError = &m_scale[stride];
+	m_chain    = (const LodChain**)&m_maxError[stride];
+	m_lod      = (uint8_t*)&m_chain[stride];
+	m_target   = &m_lod[stride];
+	m_frame    = &m_target[stride];
+
+	for (uint32_t ii = 0; ii < stride; ++ii)
+	{
+		m_scale[ii] = 1.0f;
+	}
+}
+
+LodSelector::~LodSelector()
+{
+	free(m_data);
+}
+
+void LodSelector::setObject(uint32_t _index, const LodChain* _chain, float _scale)
+{
+	BX_CHECK(_index < m_maxObjects, "Invalid object index %d.", _index);
+	m_chain[_index]  = _chain;
+	m_scale[_index]  = _scale;
+	m_lod[_index]    = 0;
+	m_target[_index] = 0;
+	m_frame[_index]  = 0;
+}
+
+uint32_t LodSelector::select(const CullSpheres& _spheres, const uint32_t* _visible, uint32_t _numVisible, const float* _eye, float _projScale)
+{
+	// Largest model space error allowed for object, at distance from eye to
+	// sphere:
+	//   error*scale*projScale/distance <= threshold
+	const uint32_t num = _spheres.m_num < m_maxObjects ? _spheres.m_num : m_maxObjects;
+	const float4_t eyeX = float4_splat(_eye[0]);
+	const float4_t eyeY = float4_splat(_eye[1]);
+	const float4_t eyeZ = float4_splat(_eye[2]);
+	const float4_t minDistance = float4_splat(LOD_MIN_DISTANCE);
+	const float4_t threshold = float4_splat(m_threshold*m_errorScale/_projScale);
+
+	for (uint32_t ii = 0; ii < num; ii += 4)
+	{
+		const float4_t dx = float4_sub(float4_ld(&_spheres.m_centerX[ii]), eyeX);
+		const float4_t dy = float4_sub(float4_ld(&_spheres.m_centerY[ii]), eyeY);
+		const float4_t dz = float4_sub(float4_ld(&_spheres.m_centerZ[ii]), eyeZ);
+		const float4_t len = float4_sqrt(float4_madd(dx, dx, float4_madd(dy, dy, float4_mul(dz, dz) ) ) );
+		const float4_t distance = float4_max(float4_sub(len, float4_ld(&_spheres.m_radius[ii]) ), minDistance);
+		float4_st(&m_maxError[ii], float4_div(float4_mul(distance, threshold), float4_ld(&m_scale[ii]) ) );
+	}
+
+	m_draws.clear();
+	m_numTriangles = 0;
+
+	const float coarsen = 1.0f - m_hysteresis;
+
+	for (uint32_t ii = 0; ii < _numVisible; ++ii)
+	{
+		const uint32_t object = _visible[ii];
+		const LodChain* chain = m_chain[object];
+		if (NULL == chain
+		||  0 == chain->m_num)
+		{
+			continue;
+		}
+
+		uint8_t lod = m_lod[object];
+		uint8_t target = m_target[object];
+
+		// New target is picked only when previous transition is done.
+		if (lod == target)
+		{
+			const float maxError = m_maxError[object];
+			target = uint8_t(lod < chain->m_num ? lod : chain->m_num-1);
+
+			if (chain->m_error[target] > maxError)
+			{
+				while (0 < target
+				&&     chain->m_error[target] > maxError)
+				{
+					--target;
+				}
+			}
+			else
+			{
+				while (uint32_t(target+1) < chain->m_num
+				&&     chain->m_error[target+1] <= maxError*coarsen)
+				{
+					++target;
+				}
+			}
+
+			if (0 == m_transitionFrames)
+			{
+				lod = target;
+			}
+		}
+
+		if (lod != target)
+		{
+			++m_frame[object];
+			if (m_frame[object] > m_transitionFrames)
+			{
+				lod = target;
+				m_frame[object] = 0;
+			}
+		}
+
+		m_lod[object] = lod;
+		m_target[object] = target;
+
+		LodDraw draw;
+		draw.m_object = object;
+		draw.m_lod = lod;
+		draw.m_transition = m_frame[object];
+		draw.m_incoming = false;
+		m_draws.push_back(draw);
+		m_numTriangles += chain->m_numTriangles[lod];
+
+		if (lod != target)
+		{
+			draw.m_lod = target;
+			draw.m_incoming = true;
+			m_draws.push_back(draw);
+			m_numTriangles += chain->m_numTriangles[target];
+		}
+	}
+
+	if (0 != m_triangleBudget)
+	{
+		if (m_numTriangles > m_triangleBudget)
+		{
+			m_errorScale *= 1.25f;
+			m_errorScale  = m_errorScale < LOD_MAX_ERROR_SCALE ? m_errorScale : LOD_MAX_ERROR_SCALE;
+		}
+		else if (m_numTriangles < m_triangleBudget*4/5)
+		{
+			m_errorScale *= 0.95f;
+			m_errorScale  = m_errorScale > 1.0f ? m_errorScale : 1.0f;
+		}
+	}
+	else
+	{
+		m_errorScale = 1.0f;
+	}
+
+	return uint32_t(m_draws.size() );
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#ifndef LODSELECT_H_HEADER_GUARD
+#define LODSELECT_H_HEADER_GUARD
+
+#include <vector>
+
+#include "cull.h"
+
+#define LOD_MAX_LEVELS 8
+
+/// LOD levels of one mesh, level 0 is most detailed.
+struct LodChain
+{
+	uint32_t m_num;
+	float m_error[LOD_MAX_LEVELS];           //!< Model space error (geometryc LOD chunk).
+	uint32_t m_numTriangles[LOD_MAX_LEVELS];
+};
+
+struct LodDraw
+{
+	uint32_t m_object;
+	uint8_t m_lod;
+	uint8_t m_transition; //!< Number of transition frames done, 0 when not in transition.
+	bool m_incoming;      //!< LOD is target of transition.
+};
+
+/// Screen space error LOD selection.
+///
+/// Model space error of each LOD is projected to screen at the distance
+/// of object bounding sphere, and most coarse LOD with projected error
+/// under threshold is selected. Projected errors are computed four
+/// objects at the time.
+///
+/// Switching to coarser LOD requires projected error to be under
+/// threshold by hysteresis margin, to avoid LOD flipping at the boundary.
+/// LOD changes are cross faded over number of transition frames, while
+/// object is in transition both LODs are in draw list.
+///
+/// With triangle budget, threshold is scaled up when selected triangles
+/// exceed the budget, and scaled back down when there is headroom. Scale
+/// is adjusted once per select call and applies from next call, so that
+/// detail changes gradually.
+///
+class LodSelector
+{
+public:
+	LodSelector(uint32_t _maxObjects);
+	~LodSelector();
+
+	/// @param _index Object index, same as index of object sphere.
+	/// @param _chain LOD chain, must stay valid while selector is in use.
+	/// @param _scale Scale of model matrix, used to scale LOD errors.
+	void setObject(uint32_t _index, const LodChain* _chain, float _scale = 1.0f);
+
+	/// Projected error threshold in pixels.
+	void setThreshold(float _pixels)
+	{
+		m_threshold = _pixels;
+	}
+
+	/// Relative margin for switching to coarser LOD.
+	void setHysteresis(float _hysteresis)
+	{
+		m_hysteresis = _hysteresis;
+	}
+
+	/// Number of frames of LOD transition, 0 switches LOD immediately.
+	void setTransitionFrames(uint8_t _frames)
+	{
+		m_transitionFrames = _frames;
+	}
+
+	/// Maximal number of triangles, 0 for no limit.
+	void setTriangleBudget(uint32_t _numTriangles)
+	{
+		m_triangleBudget = _numTriangles;
+	}
+
+	/// Select LODs and build draw list.
+	///
+	/// @param _spheres World space bounding spheres of objects.
+	/// @param _visible Indices of objects to draw, f.e. output of
+	///   cullSpheres. Objects not in the list keep their LOD state.
+	/// @param _numVisible Number of objects to draw.
+	/// @param _eye World space eye position.
+	/// @param _projScale Projection scale in pixels, proj[5]*height/2
+	///   for mtxProj projection.
+	/// @returns Number of draws.
+	///
+	uint32_t select(const CullSpheres& _spheres, const uint32_t* _visible, uint32_t _numVisible, const float* _eye, float _projScale);
+
+	const LodDraw* getDraws() const
+	{
+		return m_draws.empty() ? NULL : &m_draws[0];
+	}
+
+	/// Triangles in last draw list.
+	uint32_t getNumTriangles() const
+	{
+		return m_numTriangles;
+	}
+
+	/// Threshold scale applied by triangle budget.
+	float getErrorScale() const
+	{
+		return m_errorScale;
+	}
+
+private:
+	uint32_t m_maxObjects;
+	const LodChain** m_chain;
+	float* m_scale;
+	float* m_maxError;
+	uint8_t* m_lod;
+	uint8_t* m_target;
+	uint8_t* m_frame;
+	void* m_data;
+
+	std::vector<LodDraw> m_draws;
+
+	float m_threshold;
+	float m_hysteresis;
+	float m_errorScale;
+	uint32_t m_triangleBudget;
+	uint32_t m_numTriangles;
+	uint8_t m_transitionFrames;
+};
+
+#endif // LODSELECT_H_HEADER_GUARD
@@ -0,0 +1,976 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <bx/debug.h>
+#include <bx/float4_t.h>
+#include <bx/timer.h>
+#include "marchingcubes.h"
+
+using namespace bx;
+
+// Triangulation tables taken from:
+// http://paulbourke.net/geometry/polygonise/
+
+static const int8_t s_indices[256][16] =
+{
+	{  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  8,  3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  1,  9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  8,  3,  9,  8,  1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  2, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  8,  3,  1,  2, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  2, 10,  0,  2,  9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   2,  8,  3,  2, 10,  8, 10,  9,  8, -1, -1, -1, -1, -1, -1, -1 },
+	{   3, 11,  2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0, 11,  2,  8, 11,  0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  9,  0,  2,  3, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1, 11,  2,  1,  9, 11,  9,  8, 11, -1, -1, -1, -1, -1, -1, -1 },
+	{   3, 10,  1, 11, 10,  3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0, 10,  1,  0,  8, 10,  8, 11, 10, -1, -1, -1, -1, -1, -1, -1 },
+	{   3,  9,  0,  3, 11,  9, 11, 10,  9, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  8, 10, 10,  8, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   4,  7,  8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   4,  3,  0,  7,  3,  4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  1,  9,  8,  4,  7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   4,  1,  9,  4,  7,  1,  7,  3,  1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  2, 10,  8,  4,  7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   3,  4,  7,  3,  0,  4,  1,  2, 10, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  2, 10,  9,  0,  2,  8,  4,  7, -1, -1, -1, -1, -1, -1, -1 },
+	{   2, 10,  9,  2,  9,  7,  2,  7,  3,  7,  9,  4, -1, -1, -1, -1 },
+	{   8,  4,  7,  3, 11,  2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{  11,  4,  7, 11,  2,  4,  2,  0,  4, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  0,  1,  8,  4,  7,  2,  3, 11, -1, -1, -1, -1, -1, -1, -1 },
+	{   4,  7, 11,  9,  4, 11,  9, 11,  2,  9,  2,  1, -1, -1, -1, -1 },
+	{   3, 10,  1,  3, 11, 10,  7,  8,  4, -1, -1, -1, -1, -1, -1, -1 },
+	{   1, 11, 10,  1,  4, 11,  1,  0,  4,  7, 11,  4, -1, -1, -1, -1 },
+	{   4,  7,  8,  9,  0, 11,  9, 11, 10, 11,  0,  3, -1, -1, -1, -1 },
+	{   4,  7, 11,  4, 11,  9,  9, 11, 10, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  5,  4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  5,  4,  0,  8,  3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  5,  4,  1,  5,  0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   8,  5,  4,  8,  3,  5,  3,  1,  5, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  2, 10,  9,  5,  4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   3,  0,  8,  1,  2, 10,  4,  9,  5, -1, -1, -1, -1, -1, -1, -1 },
+	{   5,  2, 10,  5,  4,  2,  4,  0,  2, -1, -1, -1, -1, -1, -1, -1 },
+	{   2, 10,  5,  3,  2,  5,  3,  5,  4,  3,  4,  8, -1, -1, -1, -1 },
+	{   9,  5,  4,  2,  3, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0, 11,  2,  0,  8, 11,  4,  9,  5, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  5,  4,  0,  1,  5,  2,  3, 11, -1, -1, -1, -1, -1, -1, -1 },
+	{   2,  1,  5,  2,  5,  8,  2,  8, 11,  4,  8,  5, -1, -1, -1, -1 },
+	{  10,  3, 11, 10,  1,  3,  9,  5,  4, -1, -1, -1, -1, -1, -1, -1 },
+	{   4,  9,  5,  0,  8,  1,  8, 10,  1,  8, 11, 10, -1, -1, -1, -1 },
+	{   5,  4,  0,  5,  0, 11,  5, 11, 10, 11,  0,  3, -1, -1, -1, -1 },
+	{   5,  4,  8,  5,  8, 10, 10,  8, 11, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  7,  8,  5,  7,  9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  3,  0,  9,  5,  3,  5,  7,  3, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  7,  8,  0,  1,  7,  1,  5,  7, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  5,  3,  3,  5,  7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  7,  8,  9,  5,  7, 10,  1,  2, -1, -1, -1, -1, -1, -1, -1 },
+	{  10,  1,  2,  9,  5,  0,  5,  3,  0,  5,  7,  3, -1, -1, -1, -1 },
+	{   8,  0,  2,  8,  2,  5,  8,  5,  7, 10,  5,  2, -1, -1, -1, -1 },
+	{   2, 10,  5,  2,  5,  3,  3,  5,  7, -1, -1, -1, -1, -1, -1, -1 },
+	{   7,  9,  5,  7,  8,  9,  3, 11,  2, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  5,  7,  9,  7,  2,  9,  2,  0,  2,  7, 11, -1, -1, -1, -1 },
+	{   2,  3, 11,  0,  1,  8,  1,  7,  8,  1,  5,  7, -1, -1, -1, -1 },
+	{  11,  2,  1, 11,  1,  7,  7,  1,  5, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  5,  8,  8,  5,  7, 10,  1,  3, 10,  3, 11, -1, -1, -1, -1 },
+	{   5,  7,  0,  5,  0,  9,  7, 11,  0,  1,  0, 10, 11, 10,  0, -1 },
+	{  11, 10,  0, 11,  0,  3, 10,  5,  0,  8,  0,  7,  5,  7,  0, -1 },
+	{  11, 10,  5,  7, 11,  5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{  10,  6,  5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  8,  3,  5, 10,  6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  0,  1,  5, 10,  6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  8,  3,  1,  9,  8,  5, 10,  6, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  6,  5,  2,  6,  1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  6,  5,  1,  2,  6,  3,  0,  8, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  6,  5,  9,  0,  6,  0,  2,  6, -1, -1, -1, -1, -1, -1, -1 },
+	{   5,  9,  8,  5,  8,  2,  5,  2,  6,  3,  2,  8, -1, -1, -1, -1 },
+	{   2,  3, 11, 10,  6,  5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{  11,  0,  8, 11,  2,  0, 10,  6,  5, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  1,  9,  2,  3, 11,  5, 10,  6, -1, -1, -1, -1, -1, -1, -1 },
+	{   5, 10,  6,  1,  9,  2,  9, 11,  2,  9,  8, 11, -1, -1, -1, -1 },
+	{   6,  3, 11,  6,  5,  3,  5,  1,  3, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  8, 11,  0, 11,  5,  0,  5,  1,  5, 11,  6, -1, -1, -1, -1 },
+	{   3, 11,  6,  0,  3,  6,  0,  6,  5,  0,  5,  9, -1, -1, -1, -1 },
+	{   6,  5,  9,  6,  9, 11, 11,  9,  8, -1, -1, -1, -1, -1, -1, -1 },
+	{   5, 10,  6,  4,  7,  8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   4,  3,  0,  4,  7,  3,  6,  5, 10, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  9,  0,  5, 10,  6,  8,  4,  7, -1, -1, -1, -1, -1, -1, -1 },
+	{  10,  6,  5,  1,  9,  7,  1,  7,  3,  7,  9,  4, -1, -1, -1, -1 },
+	{   6,  1,  2,  6,  5,  1,  4,  7,  8, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  2,  5,  5,  2,  6,  3,  0,  4,  3,  4,  7, -1, -1, -1, -1 },
+	{   8,  4,  7,  9,  0,  5,  0,  6,  5,  0,  2,  6, -1, -1, -1, -1 },
+	{   7,  3,  9,  7,  9,  4,  3,  2,  9,  5,  9,  6,  2,  6,  9, -1 },
+	{   3, 11,  2,  7,  8,  4, 10,  6,  5, -1, -1, -1, -1, -1, -1, -1 },
+	{   5, 10,  6,  4,  7,  2,  4,  2,  0,  2,  7, 11, -1, -1, -1, -1 },
+	{   0,  1,  9,  4,  7,  8,  2,  3, 11,  5, 10,  6, -1, -1, -1, -1 },
+	{   9,  2,  1,  9, 11,  2,  9,  4, 11,  7, 11,  4,  5, 10,  6, -1 },
+	{   8,  4,  7,  3, 11,  5,  3,  5,  1,  5, 11,  6, -1, -1, -1, -1 },
+	{   5,  1, 11,  5, 11,  6,  1,  0, 11,  7, 11,  4,  0,  4, 11, -1 },
+	{   0,  5,  9,  0,  6,  5,  0,  3,  6, 11,  6,  3,  8,  4,  7, -1 },
+	{   6,  5,  9,  6,  9, 11,  4,  7,  9,  7, 11,  9, -1, -1, -1, -1 },
+	{  10,  4,  9,  6,  4, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   4, 10,  6,  4,  9, 10,  0,  8,  3, -1, -1, -1, -1, -1, -1, -1 },
+	{  10,  0,  1, 10,  6,  0,  6,  4,  0, -1, -1, -1, -1, -1, -1, -1 },
+	{   8,  3,  1,  8,  1,  6,  8,  6,  4,  6,  1, 10, -1, -1, -1, -1 },
+	{   1,  4,  9,  1,  2,  4,  2,  6,  4, -1, -1, -1, -1, -1, -1, -1 },
+	{   3,  0,  8,  1,  2,  9,  2,  4,  9,  2,  6,  4, -1, -1, -1, -1 },
+	{   0,  2,  4,  4,  2,  6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   8,  3,  2,  8,  2,  4,  4,  2,  6, -1, -1, -1, -1, -1, -1, -1 },
+	{  10,  4,  9, 10,  6,  4, 11,  2,  3, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  8,  2,  2,  8, 11,  4,  9, 10,  4, 10,  6, -1, -1, -1, -1 },
+	{   3, 11,  2,  0,  1,  6,  0,  6,  4,  6,  1, 10, -1, -1, -1, -1 },
+	{   6,  4,  1,  6,  1, 10,  4,  8,  1,  2,  1, 11,  8, 11,  1, -1 },
+	{   9,  6,  4,  9,  3,  6,  9,  1,  3, 11,  6,  3, -1, -1, -1, -1 },
+	{   8, 11,  1,  8,  1,  0, 11,  6,  1,  9,  1,  4,  6,  4,  1, -1 },
+	{   3, 11,  6,  3,  6,  0,  0,  6,  4, -1, -1, -1, -1, -1, -1, -1 },
+	{   6,  4,  8, 11,  6,  8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   7, 10,  6,  7,  8, 10,  8,  9, 10, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  7,  3,  0, 10,  7,  0,  9, 10,  6,  7, 10, -1, -1, -1, -1 },
+	{  10,  6,  7,  1, 10,  7,  1,  7,  8,  1,  8,  0, -1, -1, -1, -1 },
+	{  10,  6,  7, 10,  7,  1,  1,  7,  3, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  2,  6,  1,  6,  8,  1,  8,  9,  8,  6,  7, -1, -1, -1, -1 },
+	{   2,  6,  9,  2,  9,  1,  6,  7,  9,  0,  9,  3,  7,  3,  9, -1 },
+	{   7,  8,  0,  7,  0,  6,  6,  0,  2, -1, -1, -1, -1, -1, -1, -1 },
+	{   7,  3,  2,  6,  7,  2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   2,  3, 11, 10,  6,  8, 10,  8,  9,  8,  6,  7, -1, -1, -1, -1 },
+	{   2,  0,  7,  2,  7, 11,  0,  9,  7,  6,  7, 10,  9, 10,  7, -1 },
+	{   1,  8,  0,  1,  7,  8,  1, 10,  7,  6,  7, 10,  2,  3, 11, -1 },
+	{  11,  2,  1, 11,  1,  7, 10,  6,  1,  6,  7,  1, -1, -1, -1, -1 },
+	{   8,  9,  6,  8,  6,  7,  9,  1,  6, 11,  6,  3,  1,  3,  6, -1 },
+	{   0,  9,  1, 11,  6,  7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   7,  8,  0,  7,  0,  6,  3, 11,  0, 11,  6,  0, -1, -1, -1, -1 },
+	{   7, 11,  6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   7,  6, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   3,  0,  8, 11,  7,  6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  1,  9, 11,  7,  6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   8,  1,  9,  8,  3,  1, 11,  7,  6, -1, -1, -1, -1, -1, -1, -1 },
+	{  10,  1,  2,  6, 11,  7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  2, 10,  3,  0,  8,  6, 11,  7, -1, -1, -1, -1, -1, -1, -1 },
+	{   2,  9,  0,  2, 10,  9,  6, 11,  7, -1, -1, -1, -1, -1, -1, -1 },
+	{   6, 11,  7,  2, 10,  3, 10,  8,  3, 10,  9,  8, -1, -1, -1, -1 },
+	{   7,  2,  3,  6,  2,  7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   7,  0,  8,  7,  6,  0,  6,  2,  0, -1, -1, -1, -1, -1, -1, -1 },
+	{   2,  7,  6,  2,  3,  7,  0,  1,  9, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  6,  2,  1,  8,  6,  1,  9,  8,  8,  7,  6, -1, -1, -1, -1 },
+	{  10,  7,  6, 10,  1,  7,  1,  3,  7, -1, -1, -1, -1, -1, -1, -1 },
+	{  10,  7,  6,  1,  7, 10,  1,  8,  7,  1,  0,  8, -1, -1, -1, -1 },
+	{   0,  3,  7,  0,  7, 10,  0, 10,  9,  6, 10,  7, -1, -1, -1, -1 },
+	{   7,  6, 10,  7, 10,  8,  8, 10,  9, -1, -1, -1, -1, -1, -1, -1 },
+	{   6,  8,  4, 11,  8,  6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   3,  6, 11,  3,  0,  6,  0,  4,  6, -1, -1, -1, -1, -1, -1, -1 },
+	{   8,  6, 11,  8,  4,  6,  9,  0,  1, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  4,  6,  9,  6,  3,  9,  3,  1, 11,  3,  6, -1, -1, -1, -1 },
+	{   6,  8,  4,  6, 11,  8,  2, 10,  1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  2, 10,  3,  0, 11,  0,  6, 11,  0,  4,  6, -1, -1, -1, -1 },
+	{   4, 11,  8,  4,  6, 11,  0,  2,  9,  2, 10,  9, -1, -1, -1, -1 },
+	{  10,  9,  3, 10,  3,  2,  9,  4,  3, 11,  3,  6,  4,  6,  3, -1 },
+	{   8,  2,  3,  8,  4,  2,  4,  6,  2, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  4,  2,  4,  6,  2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  9,  0,  2,  3,  4,  2,  4,  6,  4,  3,  8, -1, -1, -1, -1 },
+	{   1,  9,  4,  1,  4,  2,  2,  4,  6, -1, -1, -1, -1, -1, -1, -1 },
+	{   8,  1,  3,  8,  6,  1,  8,  4,  6,  6, 10,  1, -1, -1, -1, -1 },
+	{  10,  1,  0, 10,  0,  6,  6,  0,  4, -1, -1, -1, -1, -1, -1, -1 },
+	{   4,  6,  3,  4,  3,  8,  6, 10,  3,  0,  3,  9, 10,  9,  3, -1 },
+	{  10,  9,  4,  6, 10,  4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   4,  9,  5,  7,  6, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  8,  3,  4,  9,  5, 11,  7,  6, -1, -1, -1, -1, -1, -1, -1 },
+	{   5,  0,  1,  5,  4,  0,  7,  6, 11, -1, -1, -1, -1, -1, -1, -1 },
+	{  11,  7,  6,  8,  3,  4,  3,  5,  4,  3,  1,  5, -1, -1, -1, -1 },
+	{   9,  5,  4, 10,  1,  2,  7,  6, 11, -1, -1, -1, -1, -1, -1, -1 },
+	{   6, 11,  7,  1,  2, 10,  0,  8,  3,  4,  9,  5, -1, -1, -1, -1 },
+	{   7,  6, 11,  5,  4, 10,  4,  2, 10,  4,  0,  2, -1, -1, -1, -1 },
+	{   3,  4,  8,  3,  5,  4,  3,  2,  5, 10,  5,  2, 11,  7,  6, -1 },
+	{   7,  2,  3,  7,  6,  2,  5,  4,  9, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  5,  4,  0,  8,  6,  0,  6,  2,  6,  8,  7, -1, -1, -1, -1 },
+	{   3,  6,  2,  3,  7,  6,  1,  5,  0,  5,  4,  0, -1, -1, -1, -1 },
+	{   6,  2,  8,  6,  8,  7,  2,  1,  8,  4,  8,  5,  1,  5,  8, -1 },
+	{   9,  5,  4, 10,  1,  6,  1,  7,  6,  1,  3,  7, -1, -1, -1, -1 },
+	{   1,  6, 10,  1,  7,  6,  1,  0,  7,  8,  7,  0,  9,  5,  4, -1 },
+	{   4,  0, 10,  4, 10,  5,  0,  3, 10,  6, 10,  7,  3,  7, 10, -1 },
+	{   7,  6, 10,  7, 10,  8,  5,  4, 10,  4,  8, 10, -1, -1, -1, -1 },
+	{   6,  9,  5,  6, 11,  9, 11,  8,  9, -1, -1, -1, -1, -1, -1, -1 },
+	{   3,  6, 11,  0,  6,  3,  0,  5,  6,  0,  9,  5, -1, -1, -1, -1 },
+	{   0, 11,  8,  0,  5, 11,  0,  1,  5,  5,  6, 11, -1, -1, -1, -1 },
+	{   6, 11,  3,  6,  3,  5,  5,  3,  1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  2, 10,  9,  5, 11,  9, 11,  8, 11,  5,  6, -1, -1, -1, -1 },
+	{   0, 11,  3,  0,  6, 11,  0,  9,  6,  5,  6,  9,  1,  2, 10, -1 },
+	{  11,  8,  5, 11,  5,  6,  8,  0,  5, 10,  5,  2,  0,  2,  5, -1 },
+	{   6, 11,  3,  6,  3,  5,  2, 10,  3, 10,  5,  3, -1, -1, -1, -1 },
+	{   5,  8,  9,  5,  2,  8,  5,  6,  2,  3,  8,  2, -1, -1, -1, -1 },
+	{   9,  5,  6,  9,  6,  0,  0,  6,  2, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  5,  8,  1,  8,  0,  5,  6,  8,  3,  8,  2,  6,  2,  8, -1 },
+	{   1,  5,  6,  2,  1,  6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  3,  6,  1,  6, 10,  3,  8,  6,  5,  6,  9,  8,  9,  6, -1 },
+	{  10,  1,  0, 10,  0,  6,  9,  5,  0,  5,  6,  0, -1, -1, -1, -1 },
+	{   0,  3,  8,  5,  6, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{  10,  5,  6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{  11,  5, 10,  7,  5, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{  11,  5, 10, 11,  7,  5,  8,  3,  0, -1, -1, -1, -1, -1, -1, -1 },
+	{   5, 11,  7,  5, 10, 11,  1,  9,  0, -1, -1, -1, -1, -1, -1, -1 },
+	{  10,  7,  5, 10, 11,  7,  9,  8,  1,  8,  3,  1, -1, -1, -1, -1 },
+	{  11,  1,  2, 11,  7,  1,  7,  5,  1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  8,  3,  1,  2,  7,  1,  7,  5,  7,  2, 11, -1, -1, -1, -1 },
+	{   9,  7,  5,  9,  2,  7,  9,  0,  2,  2, 11,  7, -1, -1, -1, -1 },
+	{   7,  5,  2,  7,  2, 11,  5,  9,  2,  3,  2,  8,  9,  8,  2, -1 },
+	{   2,  5, 10,  2,  3,  5,  3,  7,  5, -1, -1, -1, -1, -1, -1, -1 },
+	{   8,  2,  0,  8,  5,  2,  8,  7,  5, 10,  2,  5, -1, -1, -1, -1 },
+	{   9,  0,  1,  5, 10,  3,  5,  3,  7,  3, 10,  2, -1, -1, -1, -1 },
+	{   9,  8,  2,  9,  2,  1,  8,  7,  2, 10,  2,  5,  7,  5,  2, -1 },
+	{   1,  3,  5,  3,  7,  5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  8,  7,  0,  7,  1,  1,  7,  5, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  0,  3,  9,  3,  5,  5,  3,  7, -1, -1, -1, -1, -1, -1, -1 },
+	{   9,  8,  7,  5,  9,  7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   5,  8,  4,  5, 10,  8, 10, 11,  8, -1, -1, -1, -1, -1, -1, -1 },
+	{   5,  0,  4,  5, 11,  0,  5, 10, 11, 11,  3,  0, -1, -1, -1, -1 },
+	{   0,  1,  9,  8,  4, 10,  8, 10, 11, 10,  4,  5, -1, -1, -1, -1 },
+	{  10, 11,  4, 10,  4,  5, 11,  3,  4,  9,  4,  1,  3,  1,  4, -1 },
+	{   2,  5,  1,  2,  8,  5,  2, 11,  8,  4,  5,  8, -1, -1, -1, -1 },
+	{   0,  4, 11,  0, 11,  3,  4,  5, 11,  2, 11,  1,  5,  1, 11, -1 },
+	{   0,  2,  5,  0,  5,  9,  2, 11,  5,  4,  5,  8, 11,  8,  5, -1 },
+	{   9,  4,  5,  2, 11,  3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   2,  5, 10,  3,  5,  2,  3,  4,  5,  3,  8,  4, -1, -1, -1, -1 },
+	{   5, 10,  2,  5,  2,  4,  4,  2,  0, -1, -1, -1, -1, -1, -1, -1 },
+	{   3, 10,  2,  3,  5, 10,  3,  8,  5,  4,  5,  8,  0,  1,  9, -1 },
+	{   5, 10,  2,  5,  2,  4,  1,  9,  2,  9,  4,  2, -1, -1, -1, -1 },
+	{   8,  4,  5,  8,  5,  3,  3,  5,  1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  4,  5,  1,  0,  5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   8,  4,  5,  8,  5,  3,  9,  0,  5,  0,  3,  5, -1, -1, -1, -1 },
+	{   9,  4,  5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   4, 11,  7,  4,  9, 11,  9, 10, 11, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  8,  3,  4,  9,  7,  9, 11,  7,  9, 10, 11, -1, -1, -1, -1 },
+	{   1, 10, 11,  1, 11,  4,  1,  4,  0,  7,  4, 11, -1, -1, -1, -1 },
+	{   3,  1,  4,  3,  4,  8,  1, 10,  4,  7,  4, 11, 10, 11,  4, -1 },
+	{   4, 11,  7,  9, 11,  4,  9,  2, 11,  9,  1,  2, -1, -1, -1, -1 },
+	{   9,  7,  4,  9, 11,  7,  9,  1, 11,  2, 11,  1,  0,  8,  3, -1 },
+	{  11,  7,  4, 11,  4,  2,  2,  4,  0, -1, -1, -1, -1, -1, -1, -1 },
+	{  11,  7,  4, 11,  4,  2,  8,  3,  4,  3,  2,  4, -1, -1, -1, -1 },
+	{   2,  9, 10,  2,  7,  9,  2,  3,  7,  7,  4,  9, -1, -1, -1, -1 },
+	{   9, 10,  7,  9,  7,  4, 10,  2,  7,  8,  7,  0,  2,  0,  7, -1 },
+	{   3,  7, 10,  3, 10,  2,  7,  4, 10,  1, 10,  0,  4,  0, 10, -1 },
+	{   1, 10,  2,  8,  7,  4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   4,  9,  1,  4,  1,  7,  7,  1,  3, -1, -1, -1, -1, -1, -1, -1 },
+	{   4,  9,  1,  4,  1,  7,  0,  8,  1,  8,  7,  1, -1, -1, -1, -1 },
+	{   4,  0,  3,  7,  4,  3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   4,  8,  7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   9, 10,  8, 10, 11,  8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   3,  0,  9,  3,  9, 11, 11,  9, 10, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  1, 10,  0, 10,  8,  8, 10, 11, -1, -1, -1, -1, -1, -1, -1 },
+	{   3,  1, 10, 11,  3, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  2, 11,  1, 11,  9,  9, 11,  8, -1, -1, -1, -1, -1, -1, -1 },
+	{   3,  0,  9,  3,  9, 11,  1,  2,  9,  2, 11,  9, -1, -1, -1, -1 },
+	{   0,  2, 11,  8,  0, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   3,  2, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   2,  3,  8,  2,  8, 10, 10,  8,  9, -1, -1, -1, -1, -1, -1, -1 },
+	{   9, 10,  2,  0,  9,  2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   2,  3,  8,  2,  8, 10,  0,  1,  8,  1, 10,  8, -1, -1, -1, -1 },
+	{   1, 10,  2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   1,  3,  8,  9,  1,  8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  9,  1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{   0,  3,  8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+};
+
+// Cube corners as x, y, z offsets, corner order of s_indices.
+static const uint8_t s_corner[8][3] =
+{
+	{ 0, 1, 1 },
+	{ 1, 1, 1 },
+	{ 1, 1, 0 },
+	{ 0, 1, 0 },
+	{ 0, 0, 1 },
+	{ 1, 0, 1 },
+	{ 1, 0, 0 },
+	{ 0, 0, 0 },
+};
+
+// Cube edges as x, y, z offset of lower edge end and edge axis.
+static const uint8_t s_edge[12][4] =
+{
+	{ 0, 1, 1, 0 },
+	{ 1, 1, 0, 2 },
+	{ 0, 1, 0, 0 },
+	{ 0, 1, 0, 2 },
+	{ 0, 0, 1, 0 },
+	{ 1, 0, 0, 2 },
+	{ 0, 0, 0, 0 },
+	{ 0, 0, 0, 2 },
+	{ 0, 0, 1, 1 },
+	{ 1, 0, 1, 1 },
+	{ 1, 0, 0, 1 },
+	{ 0, 0, 0, 1 },
+};
+
+#define MC_JOB_EVALUATE   0
+#define MC_JOB_BUILD      1
+#define MC_JOB_POLYGONIZE 2
+#define MC_JOB_COPY       3
+
+MarchingCubes::MarchingCubes(uint32_t _dimX, uint32_t _dimY, uint32_t _dimZ, uint32_t _numThreads)
+	: m_numThreads(_numThreads < 1 ? 1 : _numThreads > MC_MAX_THREADS ? MC_MAX_THREADS : _numThreads)
+	, m_exit(false)
+	, m_job(MC_JOB_EVALUATE)
+	, m_dimX(_dimX)
+	, m_dimY(_dimY)
+	, m_dimZ(_dimZ)
+	, m_pitch( (_dimX+3) & ~3)
+	, m_cellSize(1.0f)
+	, m_iso(0.0f)
+	, m_balls(NULL)
+	, m_numBalls(0)
+{
+	BX_CHECK(2 <= _dimX && 2 <= _dimY && 2 <= _dimZ, "Grid must have at least 2x2x2 samples.");
+
+	m_origin[0] = 0.0f;
+	m_origin[1] = 0.0f;
+	m_origin[2] = 0.0f;
+
+	const uint32_t size = m_pitch*m_dimY*m_dimZ*sizeof(float);
+	m_data = malloc(size + 15);
+	m_field = (float*)( ( (uintptr_t)m_data + 15) & ~uintptr_t(15) );
+	memset(m_field, 0, size);
+
+	// Level 0 are blocks of cells, each next level halves dimensions
+	// until single node is left.
+	Level level;
+	level.m_dimX = (m_dimX-1 + MC_BLOCK_SIZE-1)/MC_BLOCK_SIZE;
+	level.m_dimY = (m_dimY-1 + MC_BLOCK_SIZE-1)/MC_BLOCK_SIZE;
+	level.m_dimZ = (m_dimZ-1 + MC_BLOCK_SIZE-1)/MC_BLOCK_SIZE;
+	for (;;)
+	{
+		level.m_minMax.resize(level.m_dimX*level.m_dimY*level.m_dimZ*2);
+		m_levels.push_back(level);
+
+		if (1 == level.m_dimX
+		&&  1 == level.m_dimY
+		&&  1 == level.m_dimZ)
+		{
+			break;
+		}
+
+		level.m_dimX = (level.m_dimX+1)/2;
+		level.m_dimY = (level.m_dimY+1)/2;
+		level.m_dimZ = (level.m_dimZ+1)/2;
+	}
+
+	m_numSlabs = m_levels[0].m_dimZ;
+	m_slabs.resize(m_numSlabs);
+
+	const uint32_t cacheSize = m_pitch*m_dimY*(MC_BLOCK_SIZE+1)*3;
+	for (uint32_t ii = 0; ii < m_numThreads; ++ii)
+	{
+		m_threadData[ii].m_edgeCache.resize(cacheSize, UINT32_MAX);
+	}
+
+	m_decl.begin();
+	m_decl.add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float);
+	m_decl.add(bgfx::Attrib::Normal, 3, bgfx::AttribType::Float);
+	m_decl.add(bgfx::Attrib::Color0, 4, bgfx::AttribType::Uint8, true);
+	m_decl.end();
+
+	memset(&m_stats, 0, sizeof(McStats) );
+
+	// Worker 0 is calling thread.
+	for (uint32_t ii = 1; ii < m_numThreads; ++ii)
+	{
+		Worker& worker = m_worker[ii];
+		worker.m_mc = this;
+		worker.m_index = ii;
+		worker.m_thread.init(workerFunc, &worker);
+	}
+}
+
+MarchingCubes::~MarchingCubes()
+{
+	m_exit = true;
+	for (uint32_t ii = 1; ii < m_numThreads; ++ii)
+	{
+		m_worker[ii].m_start.post();
+		m_worker[ii].m_thread.shutdown();
+	}
+
+	free(m_data);
+}
+
+void MarchingCubes::setTransform(const float* _origin, float _cellSize)
+{
+	m_origin[0] = _origin[0];
+	m_origin[1] = _origin[1];
+	m_origin[2] = _origin[2];
+	m_cellSize = _cellSize;
+}
+
+void MarchingCubes::evaluateMetaballs(const float* _balls, uint32_t _num)
+{
+	const int64_t start = bx::getHPCounter();
+
+	m_balls = _balls;
+	m_numBalls = _num;
+	run(MC_JOB_EVALUATE);
+
+	m_stats.m_evaluateTime = bx::getHPCounter() - start;
+}
+
+void MarchingCubes::polygonize(float _iso)
+{
+	const int64_t start = bx::getHPCounter();
+
+	m_iso = _iso;
+	run(MC_JOB_BUILD);
+
+	// Upper pyramid levels are small, reduce them on calling thread.
+	for (uint32_t ii = 1, num = uint32_t(m_levels.size() ); ii < num; ++ii)
+	{
+		const Level& src = m_levels[ii-1];
+		Level& dst = m_levels[ii];
+
+		for (uint32_t zz = 0; zz < dst.m_dimZ; ++zz)
+		{
+			for (uint32_t yy = 0; yy < dst.m_dimY; ++yy)
+			{
+				for (uint32_t xx = 0; xx < dst.m_dimX; ++xx)
+				{
+					float min = HUGE_VALF;
+					float max = -HUGE_VALF;
+
+					for (uint32_t cz = zz*2, czEnd = cz+2 < src.m_dimZ ? cz+2 : src.m_dimZ; cz < czEnd; ++cz)
+					{
+						for (uint32_t cy = yy*2, cyEnd = cy+2 < src.m_dimY ? cy+2 : src.m_dimY; cy < cyEnd; ++cy)
+						{
+							for (uint32_t cx = xx*2, cxEnd = cx+2 < src.m_dimX ? cx+2 : src.m_dimX; cx < cxEnd; ++cx)
+							{
+								const float* minMax = &src.m_minMax[( (cz*src.m_dimY + cy)*src.m_dimX + cx)*2];
+								min = minMax[0] < min ? minMax[0] : min;
+								max = minMax[1] > max ? minMax[1] : max;
+							}
+						}
+					}
+
+					float* minMax = &dst.m_minMax[( (zz*dst.m_dimY + yy)*dst.m_dimX + xx)*2];
+					minMax[0] = min;
+					minMax[1] = max;
+				}
+			}
+		}
+	}
+
+	run(MC_JOB_POLYGONIZE);
+
+	const Level& blocks = m_levels[0];
+	m_stats.m_numBlocks = blocks.m_dimX*blocks.m_dimY*blocks.m_dimZ;
+	m_stats.m_numBlocksEmpty = 0;
+	m_stats.m_numVertices = 0;
+	m_stats.m_numIndices = 0;
+	m_stats.m_numSplits = 0;
+	for (uint32_t ii = 0; ii < m_numSlabs; ++ii)
+	{
+		const Slab& slab = m_slabs[ii];
+		m_stats.m_numBlocksEmpty += slab.m_numBlocksEmpty;
+		m_stats.m_numVertices += uint32_t(slab.m_vertices.size() );
+		m_stats.m_numIndices += uint32_t(slab.m_indices.size() );
+		m_stats.m_numSplits += 1 < slab.m_parts.size();
+	}
+
+	m_stats.m_polygonizeTime = bx::getHPCounter() - start;
+}
+
+uint32_t MarchingCubes::submit(uint8_t _view, bgfx::ProgramHandle _program, const float* _mtx, uint64_t _state)
+{
+	m_batches.clear();
+	m_submitParts.clear();
+
+	for (uint32_t ii = 0; ii < m_numSlabs; ++ii)
+	{
+		Slab& slab = m_slabs[ii];
+		for (uint32_t jj = 0, num = uint32_t(slab.m_parts.size() ); jj < num; ++jj)
+		{
+			SlabPart& part = slab.m_parts[jj];
+			part.m_dstVertices = NULL;
+			part.m_dstIndices = NULL;
+			m_submitParts.push_back(&part);
+		}
+	}
+
+	// Batch adjacent slab parts while vertices are addressable with 16-bit
+	// indices. Each part fits, so every batch takes at least one.
+	const uint32_t numParts = uint32_t(m_submitParts.size() );
+	bool full = false;
+	for (uint32_t first = 0; first < numParts && !full;)
+	{
+		uint32_t numVertices = 0;
+		uint32_t numIndices = 0;
+		uint32_t last = first;
+		for (; last < numParts; ++last)
+		{
+			const SlabPart& part = *m_submitParts[last];
+			if (numVertices + part.m_numVertices > UINT16_MAX)
+			{
+				break;
+			}
+
+			numVertices += part.m_numVertices;
+			numIndices += part.m_numIndices;
+		}
+
+		if (0 != numIndices)
+		{
+			if (!bgfx::checkAvailTransientBuffers(numVertices, m_decl, numIndices) )
+			{
+				full = true;
+				break;
+			}
+
+			Batch batch;
+			bgfx::allocTransientVertexBuffer(&batch.m_tvb, numVertices, m_decl);
+			bgfx::allocTransientIndexBuffer(&batch.m_tib, numIndices);
+
+			McVertex* vertices = (McVertex*)batch.m_tvb.data;
+			uint16_t* indices = (uint16_t*)batch.m_tib.data;
+			uint32_t baseVertex = 0;
+			for (uint32_t ii = first; ii < last; ++ii)
+			{
+				SlabPart& part = *m_submitParts[ii];
+				part.m_dstVertices = vertices;
+				part.m_dstIndices = indices;
+				part.m_baseVertex = baseVertex;
+				vertices += part.m_numVertices;
+				indices += part.m_numIndices;
+				baseVertex += part.m_numVertices;
+			}
+
+			m_batches.push_back(batch);
+		}
+
+		first = last;
+	}
+
+	run(MC_JOB_COPY);
+
+	for (uint32_t ii = 0, num = uint32_t(m_batches.size() ); ii < num; ++ii)
+	{
+		const Batch& batch = m_batches[ii];
+
+		bgfx::setTransform(_mtx);
+		bgfx::setProgram(_program);
+		bgfx::setVertexBuffer(&batch.m_tvb);
+		bgfx::setIndexBuffer(&batch.m_tib);
+		bgfx::setState(_state);
+		bgfx::submit(_view);
+	}
+
+	m_stats.m_numDraws = uint32_t(m_batches.size() );
+
+	return full ? 0 : m_stats.m_numDraws;
+}
+
+int32_t MarchingCubes::workerFunc(void* _userData)
+{
+	Worker* worker = (Worker*)_userData;
+	MarchingCubes* mc = worker->m_mc;
+
+	for (;;)
+	{
+		worker->m_start.wait();
+		if (mc->m_exit)
+		{
+			break;
+		}
+
+		mc->execute(worker->m_index);
+		mc->m_done.post();
+	}
+
+	return 0;
+}
+
+void MarchingCubes::run(uint8_t _job)
+{
+	m_job = _job;
+
+	for (uint32_t ii = 1; ii < m_numThreads; ++ii)
+	{
+		m_worker[ii].m_start.post();
+	}
+
+	execute(0);
+
+	for (uint32_t ii = 1; ii < m_numThreads; ++ii)
+	{
+		m_done.wait();
+	}
+}
+
+void MarchingCubes::execute(uint32_t _index)
+{
+	// Slices and slabs are interleaved between threads, so that threads
+	// get similar share of surface.
+	switch (m_job)
+	{
+	case MC_JOB_EVALUATE:
+		for (uint32_t zz = _index; zz < m_dimZ; zz += m_numThreads)
+		{
+			evaluateSlice(zz);
+		}
+		break;
+
+	case MC_JOB_BUILD:
+		for (uint32_t zz = _index; zz < m_numSlabs; zz += m_numThreads)
+		{
+			buildBlocks(zz);
+		}
+		break;
+
+	case MC_JOB_POLYGONIZE:
+		for (uint32_t zz = _index; zz < m_numSlabs; zz += m_numThreads)
+		{
+			polygonizeSlab(_index, zz);
+		}
+		break;
+
+	case MC_JOB_COPY:
+		for (uint32_t zz = _index; zz < m_numSlabs; zz += m_numThreads)
+		{
+			copySlab(zz);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+void MarchingCubes::evaluateSlice(uint32_t _z)
+{
+	const float4_t one = float4_splat(1.0f);
+	const float4_t epsilon = float4_splat(1e-6f);
+	const float4_t step = float4_splat(4.0f*m_cellSize);
+	const float4_t startX = float4_ld(m_origin[0]
+		, m_origin[0] + m_cellSize
+		, m_origin[0] + m_cellSize*2.0f
+		, m_origin[0] + m_cellSize*3.0f
+		);
+	const float4_t posZ = float4_splat(m_origin[2] + float(_z)*m_cellSize);
+
+	for (uint32_t yy = 0; yy < m_dimY; ++yy)
+	{
+		const float4_t posY = float4_splat(m_origin[1] + float(yy)*m_cellSize);
+		float* row = &m_field[(_z*m_dimY + yy)*m_pitch];
+
+		float4_t posX = startX;
+		for (uint32_t xx = 0; xx < m_pitch; xx += 4)
+		{
+			float4_t sum = float4_zero();
+
+			for (uint32_t ii = 0; ii < m_numBalls; ++ii)
+			{
+				const float* ball = &m_balls[ii*4];
+				const float4_t dx = float4_sub(float4_splat(ball[0]), posX);
+				const float4_t dy = float4_sub(float4_splat(ball[1]), posY);
+				const float4_t dz = float4_sub(float4_splat(ball[2]), posZ);
+				const float4_t invr2 = float4_splat(ball[3]*ball[3]);
+				const float4_t dot = float4_mul(float4_madd(dx, dx, float4_madd(dy, dy, float4_mul(dz, dz) ) ), invr2);
+				sum = float4_add(sum, float4_div(one, float4_max(dot, epsilon) ) );
+			}
+
+			float4_st(&row[xx], float4_sub(sum, one) );
+			posX = float4_add(posX, step);
+		}
+	}
+}
+
+void MarchingCubes::buildBlocks(uint32_t _bz)
+{
+	Level& level = m_levels[0];
+
+	const uint32_t z0 = _bz*MC_BLOCK_SIZE;
+	const uint32_t z1 = z0+MC_BLOCK_SIZE < m_dimZ-1 ? z0+MC_BLOCK_SIZE : m_dimZ-1;
+
+	for (uint32_t by = 0; by < level.m_dimY; ++by)
+	{
+		const uint32_t y0 = by*MC_BLOCK_SIZE;
+		const uint32_t y1 = y0+MC_BLOCK_SIZE < m_dimY-1 ? y0+MC_BLOCK_SIZE : m_dimY-1;
+
+		for (uint32_t bx = 0; bx < level.m_dimX; ++bx)
+		{
+			const uint32_t x0 = bx*MC_BLOCK_SIZE;
+			const uint32_t x1 = x0+MC_BLOCK_SIZE < m_dimX-1 ? x0+MC_BLOCK_SIZE : m_dimX-1;
+
+			// Samples on block faces are shared with neighbour blocks.
+			float min = HUGE_VALF;
+			float max = -HUGE_VALF;
+			for (uint32_t zz = z0; zz <= z1; ++zz)
+			{
+				for (uint32_t yy = y0; yy <= y1; ++yy)
+				{
+					const float* row = &m_field[(zz*m_dimY + yy)*m_pitch];
+					for (uint32_t xx = x0; xx <= x1; ++xx)
+					{
+						min = row[xx] < min ? row[xx] : min;
+						max = row[xx] > max ? row[xx] : max;
+					}
+				}
+			}
+
+			float* minMax = &level.m_minMax[( (_bz*level.m_dimY + by)*level.m_dimX + bx)*2];
+			minMax[0] = min;
+			minMax[1] = max;
+		}
+	}
+}
+
+void MarchingCubes::polygonizeSlab(uint32_t _thread, uint32_t _bz)
+{
+	Slab& slab = m_slabs[_bz];
+	slab.m_vertices.clear();
+	slab.m_indices.clear();
+	slab.m_keys.clear();
+	slab.m_parts.clear();
+	slab.m_numBlocksEmpty = 0;
+	slab.m_z0 = _bz*MC_BLOCK_SIZE;
+	beginPart(slab);
+
+	const uint32_t top = uint32_t(m_levels.size() )-1;
+	const Level& level = m_levels[top];
+	for (uint32_t yy = 0; yy < level.m_dimY; ++yy)
+	{
+		for (uint32_t xx = 0; xx < level.m_dimX; ++xx)
+		{
+			visit(_thread, slab, top, xx, yy, _bz);
+		}
+	}
+
+	for (uint32_t ii = 0, num = uint32_t(slab.m_parts.size() ); ii < num; ++ii)
+	{
+		SlabPart& part = slab.m_parts[ii];
+		const bool lastPart = ii+1 == num;
+		part.m_numVertices = (lastPart ? uint32_t(slab.m_vertices.size() ) : slab.m_parts[ii+1].m_firstVertex) - part.m_firstVertex;
+		part.m_numIndices  = (lastPart ? uint32_t(slab.m_indices.size() )  : slab.m_parts[ii+1].m_firstIndex)  - part.m_firstIndex;
+	}
+}
+
+void MarchingCubes::beginPart(Slab& _slab)
+{
+	SlabPart part;
+	part.m_firstVertex = uint32_t(_slab.m_vertices.size() );
+	part.m_firstIndex = uint32_t(_slab.m_indices.size() );
+	part.m_numVertices = 0;
+	part.m_numIndices = 0;
+	part.m_dstVertices = NULL;
+	part.m_dstIndices = NULL;
+	part.m_baseVertex = 0;
+	_slab.m_parts.push_back(part);
+}
+
+void MarchingCubes::visit(uint32_t _thread, Slab& _slab, uint32_t _level, uint32_t _x, uint32_t _y, uint32_t _bz)
+{
+	const Level& level = m_levels[_level];
+	const uint32_t zz = _bz>>_level;
+	const float* minMax = &level.m_minMax[( (zz*level.m_dimY + _y)*level.m_dimX + _x)*2];
+
+	// Cell is crossed when some corner is below iso and some is not.
+	if (minMax[0] >= m_iso
+	||  minMax[1] <  m_iso)
+	{
+		// Count skipped blocks of this slab.
+		const Level& blocks = m_levels[0];
+		const uint32_t x0 = _x<<_level;
+		const uint32_t y0 = _y<<_level;
+		const uint32_t x1 = (_x+1)<<_level;
+		const uint32_t y1 = (_y+1)<<_level;
+		_slab.m_numBlocksEmpty += ( (x1 < blocks.m_dimX ? x1 : blocks.m_dimX) - x0)
+			* ( (y1 < blocks.m_dimY ? y1 : blocks.m_dimY) - y0)
+			;
+		return;
+	}
+
+	if (0 == _level)
+	{
+		polygonizeBlock(_thread, _slab, _x, _y, _bz);
+		return;
+	}
+
+	const Level& child = m_levels[_level-1];
+	for (uint32_t cy = _y*2, cyEnd = cy+2 < child.m_dimY ? cy+2 : child.m_dimY; cy < cyEnd; ++cy)
+	{
+		for (uint32_t cx = _x*2, cxEnd = cx+2 < child.m_dimX ? cx+2 : child.m_dimX; cx < cxEnd; ++cx)
+		{
+			visit(_thread, _slab, _level-1, cx, cy, _bz);
+		}
+	}
+}
+
+void MarchingCubes::polygonizeBlock(uint32_t _thread, Slab& _slab, uint32_t _bx, uint32_t _by, uint32_t _bz)
+{
+	const uint32_t x0 = _bx*MC_BLOCK_SIZE;
+	const uint32_t y0 = _by*MC_BLOCK_SIZE;
+	const uint32_t z0 = _bz*MC_BLOCK_SIZE;
+	const uint32_t x1 = x0+MC_BLOCK_SIZE < m_dimX-1 ? x0+MC_BLOCK_SIZE : m_dimX-1;
+	const uint32_t y1 = y0+MC_BLOCK_SIZE < m_dimY-1 ? y0+MC_BLOCK_SIZE : m_dimY-1;
+	const uint32_t z1 = z0+MC_BLOCK_SIZE < m_dimZ-1 ? z0+MC_BLOCK_SIZE : m_dimZ-1;
+
+	const uint32_t offset[8] =
+	{
+		(1*m_dimY + 1)*m_pitch + 0,
+		(1*m_dimY + 1)*m_pitch + 1,
+		(0*m_dimY + 1)*m_pitch + 1,
+		(0*m_dimY + 1)*m_pitch + 0,
+		(1*m_dimY + 0)*m_pitch + 0,
+		(1*m_dimY + 0)*m_pitch + 1,
+		(0*m_dimY + 0)*m_pitch + 1,
+		(0*m_dimY + 0)*m_pitch + 0,
+	};
+
+	for (uint32_t zz = z0; zz < z1; ++zz)
+	{
+		for (uint32_t yy = y0; yy < y1; ++yy)
+		{
+			for (uint32_t xx = x0; xx < x1; ++xx)
+			{
+				const float* val = &m_field[(zz*m_dimY + yy)*m_pitch + xx];
+
+				uint8_t cubeindex = 0;
+				for (uint32_t ii = 0; ii < 8; ++ii)
+				{
+					cubeindex |= (val[offset[ii] ] < m_iso) ? uint8_t(1<<ii) : 0;
+				}
+
+				if (0x00 == cubeindex
+				||  0xff == cubeindex)
+				{
+					continue;
+				}
+
+				// Cell adds at most 12 new vertices, continue in new part
+				// when they wouldn't be addressable with 16-bit indices.
+				if (_slab.m_vertices.size() - _slab.m_parts.back().m_firstVertex + 12 > UINT16_MAX)
+				{
+					beginPart(_slab);
+				}
+
+				const int8_t* indices = s_indices[cubeindex];
+				for (uint32_t ii = 0; indices[ii] != -1; ++ii)
+				{
+					const uint8_t* edge = s_edge[indices[ii] ];
+					_slab.m_indices.push_back(edgeVertex(_thread, _slab, xx+edge[0], yy+edge[1], zz+edge[2], edge[3]) );
+				}
+			}
+		}
+	}
+}
+
+void MarchingCubes::gradient(float* _result, uint32_t _x, uint32_t _y, uint32_t _z) const
+{
+	// Central differences, one sided at grid border. Gradient points
+	// toward lower field values.
+	const uint32_t x0 = 0 < _x ? _x-1 : _x;
+	const uint32_t y0 = 0 < _y ? _y-1 : _y;
+	const uint32_t z0 = 0 < _z ? _z-1 : _z;
+	const uint32_t x1 = _x+1 < m_dimX ? _x+1 : _x;
+	const uint32_t y1 = _y+1 < m_dimY ? _y+1 : _y;
+	const uint32_t z1 = _z+1 < m_dimZ ? _z+1 : _z;
+
+	const float* row = &m_field[(_z*m_dimY + _y)*m_pitch];
+	_result[0] = row[x0] - row[x1];
+	_result[1] = m_field[(_z*m_dimY + y0)*m_pitch + _x] - m_field[(_z*m_dimY + y1)*m_pitch + _x];
+	_result[2] = m_field[(z0*m_dimY + _y)*m_pitch + _x] - m_field[(z1*m_dimY + _y)*m_pitch + _x];
+}
+
+uint16_t MarchingCubes::edgeVertex(uint32_t _thread, Slab& _slab, uint32_t _x, uint32_t _y, uint32_t _z, uint32_t _axis)
+{
+	// Edge cache is reused between slabs and frames without clearing,
+	// cached index is valid only if vertex was created for the same edge.
+	// Vertices of previous parts are not addressable from current part.
+	const uint32_t key = ( (_z*m_dimY + _y)*m_pitch + _x)*3 + _axis;
+	const uint32_t local = ( ( (_z - _slab.m_z0)*m_dimY + _y)*m_pitch + _x)*3 + _axis;
+	const uint32_t firstVertex = _slab.m_parts.back().m_firstVertex;
+	uint32_t& cached = m_threadData[_thread].m_edgeCache[local];
+	if (cached < _slab.m_keys.size()
+	&&  cached >= firstVertex
+	&&  key == _slab.m_keys[cached])
+	{
+		return uint16_t(cached - firstVertex);
+	}
+
+	const uint32_t end[3] =
+	{
+		_x + (0 == _axis),
+		_y + (1 == _axis),
+		_z + (2 == _axis),
+	};
+
+	const float v0 = m_field[(_z*m_dimY + _y)*m_pitch + _x];
+	const float v1 = m_field[(end[2]*m_dimY + end[1])*m_pitch + end[0] ];
+	float lerp = fabsf(v1 - v0) < 0.00001f ? 0.0f : (m_iso - v0)/(v1 - v0);
+	lerp = lerp < 0.0f ? 0.0f : lerp > 1.0f ? 1.0f : lerp;
+
+	float pos[3] = { float(_x), float(_y), float(_z) };
+	pos[_axis] += lerp;
+
+	float n0[3];
+	float n1[3];
+	gradient(n0, _x, _y, _z);
+	gradient(n1, end[0], end[1], end[2]);
+
+	float normal[3] =
+	{
+		n0[0] + lerp * (n1[0] - n0[0]),
+		n0[1] + lerp * (n1[1] - n0[1]),
+		n0[2] + lerp * (n1[2] - n0[2]),
+	};
+	const float len = sqrtf(normal[0]*normal[0] + normal[1]*normal[1] + normal[2]*normal[2]);
+	const float invLen = 0.0f < len ? 1.0f/len : 0.0f;
+
+	McVertex vertex;
+	vertex.m_pos[0] = m_origin[0] + pos[0]*m_cellSize;
+	vertex.m_pos[1] = m_origin[1] + pos[1]*m_cellSize;
+	vertex.m_pos[2] = m_origin[2] + pos[2]*m_cellSize;
+	vertex.m_normal[0] = normal[0]*invLen;
+	vertex.m_normal[1] = normal[1]*invLen;
+	vertex.m_normal[2] = normal[2]*invLen;
+
+	// Color from position in grid.
+	const uint32_t rr = uint8_t(pos[0]/float(m_dimX-1)*255.0f);
+	const uint32_t gg = uint8_t(pos[1]/float(m_dimY-1)*255.0f);
+	const uint32_t bb = uint8_t(pos[2]/float(m_dimZ-1)*255.0f);
+	vertex.m_abgr = 0xff000000
+		| (bb<<16)
+		| (gg<<8)
+		| rr
+		;
+
+	cached = uint32_t(_slab.m_vertices.size() );
+	_slab.m_vertices.push_back(vertex);
+	_slab.m_keys.push_back(key);
+
+	return uint16_t(cached - firstVertex);
+}
+
+void MarchingCubes::copySlab(uint32_t _bz)
+{
+	const Slab& slab = m_slabs[_bz];
+
+	for (uint32_t ii = 0, num = uint32_t(slab.m_parts.size() ); ii < num; ++ii)
+	{
+		const SlabPart& part = slab.m_parts[ii];
+		if (NULL == part.m_dstVertices)
+		{
+			continue;
+		}
+
+		if (0 != part.m_numVertices)
+		{
+			memcpy(part.m_dstVertices, &slab.m_vertices[part.m_firstVertex], part.m_numVertices*sizeof(McVertex) );
+		}
+
+		const uint16_t base = uint16_t(part.m_baseVertex);
+		for (uint32_t jj = 0; jj < part.m_numIndices; ++jj)
+		{
+			part.m_dstIndices[jj] = uint16_t(slab.m_indices[part.m_firstIndex + jj] + base);
+		}
+	}
+}
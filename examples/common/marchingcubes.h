@@ -0,0 +1,227 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#ifndef MARCHINGCUBES_H_HEADER_GUARD
+#define MARCHINGCUBES_H_HEADER_GUARD
+
+#include <vector>
+
+#include <bgfx.h>
+#include <bx/bx.h>
+#include <bx/sem.h>
+#include <bx/thread.h>
+
+#define MC_MAX_THREADS 16
+#define MC_BLOCK_SIZE  4
+
+struct McVertex
+{
+	float m_pos[3];
+	float m_normal[3];
+	uint32_t m_abgr;
+};
+
+struct McStats
+{
+	uint32_t m_numBlocks;
+	uint32_t m_numBlocksEmpty;  //!< Blocks skipped by min/max pyramid.
+	uint32_t m_numVertices;
+	uint32_t m_numIndices;
+	uint32_t m_numSplits;       //!< Slabs split in parts to fit 16-bit indices.
+	uint32_t m_numDraws;
+	int64_t m_evaluateTime;     //!< bx::getHPCounter ticks.
+	int64_t m_polygonizeTime;   //!< bx::getHPCounter ticks.
+};
+
+/// Marching cubes iso surface extraction.
+///
+/// Field is sampled on regular grid, with x rows padded to multiple of
+/// four samples. Grid cells are grouped into blocks of MC_BLOCK_SIZE^3
+/// cells, and min/max field value of blocks is reduced into pyramid.
+/// Blocks whose range doesn't contain iso value are skipped, top down
+/// through the pyramid.
+///
+/// One row of blocks along z is slab. Slabs are polygonized in
+/// parallel, each into its own vertex and 16-bit index list. Vertices
+/// are created once per crossed grid edge and shared by all triangles of
+/// slab using that edge. Slab with more vertices than 16-bit indices can
+/// address continues in new part, and vertices shared across part
+/// boundary are duplicated. Slabs are copied into transient buffers in
+/// parallel too, and batched into as few draw calls as 16-bit indices
+/// allow.
+///
+/// Usage:
+///
+///   mc.evaluateMetaballs(balls, numBalls); // or fill getField()
+///   mc.polygonize(iso);
+///   mc.submit(view, program, mtx);
+///
+class MarchingCubes
+{
+public:
+	/// @param _dimX Number of samples along x.
+	/// @param _dimY Number of samples along y.
+	/// @param _dimZ Number of samples along z.
+	/// @param _numThreads Total number of threads including calling
+	///   thread, up to MC_MAX_THREADS.
+	MarchingCubes(uint32_t _dimX, uint32_t _dimY, uint32_t _dimZ, uint32_t _numThreads);
+	~MarchingCubes();
+
+	/// Position of sample 0 and distance between samples, vertex
+	/// positions are in this space.
+	void setTransform(const float* _origin, float _cellSize);
+
+	/// Field samples, sample at (x, y, z) is at index
+	/// (z*getDimY() + y)*getPitch() + x.
+	float* getField()
+	{
+		return m_field;
+	}
+
+	uint32_t getPitch() const
+	{
+		return m_pitch;
+	}
+
+	uint32_t getDimX() const
+	{
+		return m_dimX;
+	}
+
+	uint32_t getDimY() const
+	{
+		return m_dimY;
+	}
+
+	uint32_t getDimZ() const
+	{
+		return m_dimZ;
+	}
+
+	/// Evaluate metaball field sum(1/(dist^2*invRadius^2) ) - 1 at
+	/// samples, four samples at the time.
+	///
+	/// @param _balls Balls as x, y, z, 1/radius, in setTransform space.
+	/// @param _num Number of balls.
+	///
+	void evaluateMetaballs(const float* _balls, uint32_t _num);
+
+	/// Extract surface where field crosses _iso. Surface faces toward
+	/// lower field values.
+	void polygonize(float _iso);
+
+	/// Copy surface into transient buffers and submit it.
+	///
+	/// @returns Number of draw calls, 0 if transient buffers are full.
+	///
+	uint32_t submit(uint8_t _view, bgfx::ProgramHandle _program, const float* _mtx, uint64_t _state = BGFX_STATE_DEFAULT);
+
+	const bgfx::VertexDecl& getDecl() const
+	{
+		return m_decl;
+	}
+
+	const McStats& getStats() const
+	{
+		return m_stats;
+	}
+
+private:
+	struct Worker
+	{
+		MarchingCubes* m_mc;
+		uint32_t m_index;
+		bx::Thread m_thread;
+		bx::Semaphore m_start;
+	};
+
+	struct Level
+	{
+		uint32_t m_dimX;
+		uint32_t m_dimY;
+		uint32_t m_dimZ;
+		std::vector<float> m_minMax;
+	};
+
+	struct SlabPart
+	{
+		uint32_t m_firstVertex;
+		uint32_t m_firstIndex;
+		uint32_t m_numVertices;
+		uint32_t m_numIndices;
+
+		McVertex* m_dstVertices;
+		uint16_t* m_dstIndices;
+		uint32_t m_baseVertex;
+	};
+
+	struct Slab
+	{
+		std::vector<McVertex> m_vertices;
+		std::vector<uint16_t> m_indices; //!< Relative to first vertex of part.
+		std::vector<uint32_t> m_keys;
+		std::vector<SlabPart> m_parts;
+		uint32_t m_numBlocksEmpty;
+		uint32_t m_z0;
+	};
+
+	struct Batch
+	{
+		bgfx::TransientVertexBuffer m_tvb;
+		bgfx::TransientIndexBuffer m_tib;
+	};
+
+	struct ThreadData
+	{
+		std::vector<uint32_t> m_edgeCache;
+	};
+
+	static int32_t workerFunc(void* _userData);
+
+	void run(uint8_t _job);
+	void execute(uint32_t _index);
+
+	void evaluateSlice(uint32_t _z);
+	void buildBlocks(uint32_t _bz);
+	void polygonizeSlab(uint32_t _thread, uint32_t _bz);
+	void beginPart(Slab& _slab);
+	void visit(uint32_t _thread, Slab& _slab, uint32_t _level, uint32_t _x, uint32_t _y, uint32_t _bz);
+	void polygonizeBlock(uint32_t _thread, Slab& _slab, uint32_t _bx, uint32_t _by, uint32_t _bz);
+	void gradient(float* _result, uint32_t _x, uint32_t _y, uint32_t _z) const;
+	uint16_t edgeVertex(uint32_t _thread, Slab& _slab, uint32_t _x, uint32_t _y, uint32_t _z, uint32_t _axis);
+	void copySlab(uint32_t _bz);
+
+	Worker m_worker[MC_MAX_THREADS];
+	bx::Semaphore m_done;
+	uint32_t m_numThreads;
+	bool m_exit;
+	uint8_t m_job;
+
+	uint32_t m_dimX;
+	uint32_t m_dimY;
+	uint32_t m_dimZ;
+	uint32_t m_pitch;
+	uint32_t m_numSlabs;
+	float m_origin[3];
+	float m_cellSize;
+	float m_iso;
+
+	const float* m_balls;
+	uint32_t m_numBalls;
+
+	void* m_data;
+	float* m_field;
+
+	std::vector<Level> m_levels;
+	std::vector<Slab> m_slabs;
+	std::vector<SlabPart*> m_submitParts;
+	std::vector<Batch> m_batches;
+	ThreadData m_threadData[MC_MAX_THREADS];
+
+	bgfx::VertexDecl m_decl;
+	McStats m_stats;
+};
+
+#endif // MARCHINGCUBES_H_HEADER_GUARD
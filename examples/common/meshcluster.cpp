@@ -0,0 +1,178 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <bx/bx.h>
+#include <bx/float4_t.h>
+#include "meshcluster.h"
+#include "cull.h"
+
+bool meshClustersRead(bx::ReaderI* _reader, MeshClusters& _clusters)
+{
+	memset(&_clusters, 0, sizeof(MeshClusters) );
+
+	uint32_t num;
+	if (4 != bx::read(_reader, num) )
+	{
+		return false;
+	}
+
+	if (0 == num)
+	{
+		return true;
+	}
+
+	// 2 uint32 and 8 float arrays, padded to 4 elements.
+	const uint32_t stride = (num+3) & ~3;
+	uint8_t* data = (uint8_t*)malloc(stride*10*sizeof(float) + 15);
+	uint8_t* aligned = (uint8_t*)( ( (uintptr_t)data + 15) & ~uintptr_t(15) );
+	memset(aligned, 0, stride*10*sizeof(float) );
+
+	_clusters.m_num = num;
+	_clusters.m_data = data;
+	_clusters.m_startIndex = (uint32_t*)aligned;
+	_clusters.m_numIndices = &_clusters.m_startIndex[stride];
+	_clusters.m_centerX    = (float*)&_clusters.m_numIndices[stride];
+	_clusters.m_centerY    = &_clusters.m_centerX[stride*1];
+	_clusters.m_centerZ    = &_clusters.m_centerX[stride*2];
+	_clusters.m_radius     = &_clusters.m_centerX[stride*3];
+	_clusters.m_coneX      = &_clusters.m_centerX[stride*4];
+	_clusters.m_coneY      = &_clusters.m_centerX[stride*5];
+	_clusters.m_coneZ      = &_clusters.m_centerX[stride*6];
+	_clusters.m_coneCutoff = &_clusters.m_centerX[stride*7];
+
+	// Padding is never back facing.
+	for (uint32_t ii = num; ii < stride; ++ii)
+	{
+		_clusters.m_coneCutoff[ii] = 1.0f;
+	}
+
+	for (uint32_t ii = 0; ii < num; ++ii)
+	{
+		// start index, num indices, sphere, aabb, cone axis and cutoff.
+		uint32_t range[2];
+		float bounds[4+6+4];
+		if (int32_t(sizeof(range) ) != bx::read(_reader, range, sizeof(range) )
+		||  int32_t(sizeof(bounds) ) != bx::read(_reader, bounds, sizeof(bounds) ) )
+		{
+			meshClustersFree(_clusters);
+			return false;
+		}
+
+		_clusters.m_startIndex[ii] = range[0];
+		_clusters.m_numIndices[ii] = range[1];
+		_clusters.m_centerX[ii]    = bounds[0];
+		_clusters.m_centerY[ii]    = bounds[1];
+		_clusters.m_centerZ[ii]    = bounds[2];
+		_clusters.m_radius[ii]     = bounds[3];
+		_clusters.m_coneX[ii]      = bounds[10];
+		_clusters.m_coneY[ii]      = bounds[11];
+		_clusters.m_coneZ[ii]      = bounds[12];
+		_clusters.m_coneCutoff[ii] = bounds[13];
+	}
+
+	return true;
+}
+
+void meshClustersFree(MeshClusters& _clusters)
+{
+	free(_clusters.m_data);
+	memset(&_clusters, 0, sizeof(MeshClusters) );
+}
+
+uint32_t meshClustersCull(uint32_t* _visible, const MeshClusters& _clusters, const float* _mvp, const float* _eye)
+{
+	using namespace bx;
+
+	// Frustum planes in model space.
+	Frustum frustum;
+	frustumFromMtx(frustum, _mvp);
+
+	float4_t planeX[6];
+	float4_t planeY[6];
+	float4_t planeZ[6];
+	float4_t planeW[6];
+	for (uint32_t ii = 0; ii < 6; ++ii)
+	{
+		const float* plane = frustum.m_planes[ii];
+		planeX[ii] = float4_splat(plane[0]);
+		planeY[ii] = float4_splat(plane[1]);
+		planeZ[ii] = float4_splat(plane[2]);
+		planeW[ii] = float4_splat(plane[3]);
+	}
+
+	const float4_t eyeX = float4_splat(_eye[0]);
+	const float4_t eyeY = float4_splat(_eye[1]);
+	const float4_t eyeZ = float4_splat(_eye[2]);
+	const float4_t zero = float4_zero();
+
+	BX_ALIGN_STRUCT_16(uint32_t mask[4]);
+	uint32_t numVisible = 0;
+
+	for (uint32_t ii = 0, num = _clusters.m_num; ii < num; ii += 4)
+	{
+		const float4_t cx     = float4_ld(&_clusters.m_centerX[ii]);
+		const float4_t cy     = float4_ld(&_clusters.m_centerY[ii]);
+		const float4_t cz     = float4_ld(&_clusters.m_centerZ[ii]);
+		const float4_t radius = float4_ld(&_clusters.m_radius[ii]);
+
+		float4_t visible = float4_isplat(UINT32_C(0xffffffff) );
+		for (uint32_t jj = 0; jj < 6; ++jj)
+		{
+			const float4_t dist = float4_madd(cx, planeX[jj]
+								, float4_madd(cy, planeY[jj]
+								, float4_madd(cz, planeZ[jj]
+								, float4_add(planeW[jj], radius) ) ) );
+			visible = float4_and(visible, float4_cmpge(dist, zero) );
+		}
+
+		// Back facing when dot(center - eye, axis) >= cutoff*length(center - eye) + radius.
+		const float4_t dx = float4_sub(cx, eyeX);
+		const float4_t dy = float4_sub(cy, eyeY);
+		const float4_t dz = float4_sub(cz, eyeZ);
+		const float4_t dot = float4_madd(dx, float4_ld(&_clusters.m_coneX[ii])
+						   , float4_madd(dy, float4_ld(&_clusters.m_coneY[ii])
+						   , float4_mul(dz, float4_ld(&_clusters.m_coneZ[ii]) ) ) );
+		const float4_t len = float4_sqrt(float4_madd(dx, dx, float4_madd(dy, dy, float4_mul(dz, dz) ) ) );
+		const float4_t back = float4_cmpge(dot, float4_madd(float4_ld(&_clusters.m_coneCutoff[ii]), len, radius) );
+		visible = float4_andc(visible, back);
+
+		float4_st(mask, visible);
+		for (uint32_t jj = 0, end = num - ii < 4 ? num - ii : 4; jj < end; ++jj)
+		{
+			_visible[numVisible] = ii + jj;
+			numVisible += 0 != mask[jj];
+		}
+	}
+
+	return numVisible;
+}
+
+uint32_t meshClustersRanges(uint32_t* _startIndex, uint32_t* _numIndices, const MeshClusters& _clusters, const uint32_t* _visible, uint32_t _numVisible)
+{
+	uint32_t numRanges = 0;
+
+	for (uint32_t ii = 0; ii < _numVisible; ++ii)
+	{
+		const uint32_t cluster = _visible[ii];
+		const uint32_t start = _clusters.m_startIndex[cluster];
+		const uint32_t num = _clusters.m_numIndices[cluster];
+
+		if (0 < numRanges
+		&&  _startIndex[numRanges-1] + _numIndices[numRanges-1] == start)
+		{
+			_numIndices[numRanges-1] += num;
+		}
+		else
+		{
+			_startIndex[numRanges] = start;
+			_numIndices[numRanges] = num;
+			++numRanges;
+		}
+	}
+
+	return numRanges;
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#ifndef MESHCLUSTER_H_HEADER_GUARD
+#define MESHCLUSTER_H_HEADER_GUARD
+
+#include <bx/readerwriter.h>
+
+/// Primitive clusters (geometryc --cluster), bounds are stored as
+/// structure of arrays, 16 byte aligned and padded to multiple of 4.
+struct MeshClusters
+{
+	uint32_t m_num;
+	uint32_t* m_startIndex;
+	uint32_t* m_numIndices;
+	float* m_centerX;
+	float* m_centerY;
+	float* m_centerZ;
+	float* m_radius;
+	float* m_coneX;
+	float* m_coneY;
+	float* m_coneZ;
+	float* m_coneCutoff;
+	void* m_data;
+};
+
+/// Read clusters of one primitive from CLS chunk.
+///
+/// @returns False if stream is corrupted.
+///
+bool meshClustersRead(bx::ReaderI* _reader, MeshClusters& _clusters);
+
+/// Free cluster arrays.
+void meshClustersFree(MeshClusters& _clusters);
+
+/// Cull clusters against view frustum and normal cone, four clusters at
+/// the time.
+///
+/// @param _visible Indices of visible clusters, must hold m_num entries.
+/// @param _clusters Clusters.
+/// @param _mvp Model view projection matrix.
+/// @param _eye Eye position in model space.
+/// @returns Number of visible clusters.
+///
+uint32_t meshClustersCull(uint32_t* _visible, const MeshClusters& _clusters, const float* _mvp, const float* _eye);
+
+/// Merge visible clusters adjacent in index buffer into index ranges.
+///
+/// @returns Number of ranges.
+///
+uint32_t meshClustersRanges(uint32_t* _startIndex, uint32_t* _numIndices, const MeshClusters& _clusters, const uint32_t* _visible, uint32_t _numVisible);
+
+#endif // MESHCLUSTER_H_HEADER_GUARD
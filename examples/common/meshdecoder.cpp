@@ -0,0 +1,313 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#include <string.h>
+#include "meshdecoder.h"
+
+// Must match tools/geometryc/meshencoder.cpp.
+#define MESH_BLOCK_SIZE         (64<<10)
+#define MESH_PROB_BITS          12
+#define MESH_PROB_SCALE         (1<<MESH_PROB_BITS)
+#define MESH_RANS_L             (1u<<23)
+
+#define MESH_BLOCK_RAW          0
+#define MESH_BLOCK_CONSTANT     1
+#define MESH_BLOCK_RANS         2
+
+#define MESH_VERTEX_QUANTIZED_POSITION UINT8_C(0x1)
+
+struct MeshStreamReader
+{
+	MeshStreamReader(bx::ReaderI* _reader)
+		: m_reader(_reader)
+		, m_pos(0)
+		, m_size(0)
+	{
+	}
+
+	/// Returns pointer to next decoded bytes, _num is clamped to number of
+	/// bytes available in current block.
+	const uint8_t* next(uint32_t& _num)
+	{
+		if (m_pos == m_size
+		&&  !readBlock() )
+		{
+			return NULL;
+		}
+
+		const uint32_t avail = m_size - m_pos;
+		_num = _num < avail ? _num : avail;
+
+		const uint8_t* data = &m_block[m_pos];
+		m_pos += _num;
+		return data;
+	}
+
+	bool readByte(uint8_t& _byte)
+	{
+		if (m_pos == m_size
+		&&  !readBlock() )
+		{
+			return false;
+		}
+
+		_byte = m_block[m_pos++];
+		return true;
+	}
+
+	bool readVarint(uint32_t& _value)
+	{
+		_value = 0;
+		for (uint32_t shift = 0; shift < 32; shift += 7)
+		{
+			uint8_t byte;
+			if (1 != bx::read(m_reader, byte) )
+			{
+				return false;
+			}
+
+			_value |= uint32_t(byte&0x7f)<<shift;
+			if (0 == (byte&0x80) )
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool readBlock()
+	{
+		uint32_t size;
+		uint8_t mode;
+		if (4 != bx::read(m_reader, size)
+		||  1 != bx::read(m_reader, mode)
+		||  0 == size
+		||  MESH_BLOCK_SIZE < size)
+		{
+			return false;
+		}
+
+		m_pos = 0;
+		m_size = size;
+
+		switch (mode)
+		{
+		case MESH_BLOCK_RAW:
+			return int32_t(size) == bx::read(m_reader, m_block, size);
+
+		case MESH_BLOCK_CONSTANT:
+			{
+				uint8_t symbol;
+				if (1 != bx::read(m_reader, symbol) )
+				{
+					return false;
+				}
+
+				memset(m_block, symbol, size);
+			}
+			return true;
+
+		case MESH_BLOCK_RANS:
+			return readRans(size);
+
+		default:
+			break;
+		}
+
+		return false;
+	}
+
+	bool readRans(uint32_t _size)
+	{
+		uint8_t mask[32];
+		if (int32_t(sizeof(mask) ) != bx::read(m_reader, mask, sizeof(mask) ) )
+		{
+			return false;
+		}
+
+		uint32_t total = 0;
+		for (uint32_t ii = 0; ii < 256; ++ii)
+		{
+			uint32_t freq = 0;
+			if (0 != (mask[ii>>3] & (1<<(ii&7) ) )
+			&&  (!readVarint(freq) || MESH_PROB_SCALE < total + freq) )
+			{
+				return false;
+			}
+
+			m_freq[ii] = freq;
+			m_start[ii] = total;
+			memset(&m_symbol[total], ii, freq);
+			total += freq;
+		}
+
+		uint32_t payloadSize;
+		if (MESH_PROB_SCALE != total
+		||  4 != bx::read(m_reader, payloadSize)
+		||  4 > payloadSize
+		||  MESH_BLOCK_SIZE < payloadSize
+		||  int32_t(payloadSize) != bx::read(m_reader, m_payload, payloadSize) )
+		{
+			return false;
+		}
+
+		const uint8_t* ptr = m_payload;
+		const uint8_t* end = m_payload + payloadSize;
+
+		uint32_t xx = 0
+			| (uint32_t(ptr[0])<< 0)
+			| (uint32_t(ptr[1])<< 8)
+			| (uint32_t(ptr[2])<<16)
+			| (uint32_t(ptr[3])<<24)
+			;
+		ptr += 4;
+
+		for (uint32_t ii = 0; ii < _size; ++ii)
+		{
+			const uint32_t slot = xx & (MESH_PROB_SCALE-1);
+			const uint8_t symbol = m_symbol[slot];
+			m_block[ii] = symbol;
+
+			xx = m_freq[symbol] * (xx >> MESH_PROB_BITS) + slot - m_start[symbol];
+
+			while (xx < MESH_RANS_L)
+			{
+				xx = (xx << 8) | (ptr < end ? *ptr++ : 0);
+			}
+		}
+
+		return true;
+	}
+
+	bx::ReaderI* m_reader;
+	uint32_t m_pos;
+	uint32_t m_size;
+	uint32_t m_freq[256];
+	uint32_t m_start[256];
+	uint8_t m_symbol[MESH_PROB_SCALE];
+	uint8_t m_block[MESH_BLOCK_SIZE];
+	uint8_t m_payload[MESH_BLOCK_SIZE];
+};
+
+bool meshDecodeVertices(bx::ReaderI* _reader, void* _vertices, uint32_t _numVertices, const bgfx::VertexDecl& _decl)
+{
+	uint8_t* vertices = (uint8_t*)_vertices;
+	const uint32_t stride = _decl.getStride();
+
+	uint8_t flags;
+	if (1 != bx::read(_reader, flags) )
+	{
+		return false;
+	}
+
+	MeshStreamReader* stream = new MeshStreamReader(_reader);
+	bool ok = true;
+
+	uint32_t skipBegin = stride;
+	uint32_t skipEnd = stride;
+
+	if (0 != (flags & MESH_VERTEX_QUANTIZED_POSITION) )
+	{
+		float min[3];
+		float scale[3];
+		ok &= int32_t(sizeof(min) ) == bx::read(_reader, min, sizeof(min) );
+		ok &= int32_t(sizeof(scale) ) == bx::read(_reader, scale, sizeof(scale) );
+
+		const uint32_t positionOffset = _decl.getOffset(bgfx::Attrib::Position);
+		skipBegin = positionOffset;
+		skipEnd = positionOffset + 3*sizeof(float);
+
+		for (uint32_t jj = 0; jj < 3 && ok; ++jj)
+		{
+			uint8_t* dest = vertices + positionOffset + jj*sizeof(float);
+			uint16_t prev = 0;
+
+			// Blocks have even size, low and high byte never straddle blocks.
+			for (uint32_t ii = 0; ii < _numVertices && ok;)
+			{
+				uint32_t num = (_numVertices - ii)*2;
+				const uint8_t* data = stream->next(num);
+				if (NULL == data)
+				{
+					ok = false;
+					break;
+				}
+
+				for (const uint8_t* end = data + num; data < end; data += 2, ++ii)
+				{
+					const uint16_t delta = uint16_t(data[0] | (data[1]<<8) );
+					prev = uint16_t(prev + ( (delta>>1) ^ -(delta&1) ) );
+
+					const float value = min[jj] + float(prev)*scale[jj];
+					memcpy(dest + ii*stride, &value, sizeof(float) );
+				}
+			}
+		}
+	}
+
+	for (uint32_t offset = 0; offset < stride && ok; ++offset)
+	{
+		if (offset >= skipBegin
+		&&  offset <  skipEnd)
+		{
+			continue;
+		}
+
+		uint8_t* dest = vertices + offset;
+		uint8_t prev = 0;
+
+		for (uint32_t ii = 0; ii < _numVertices && ok;)
+		{
+			uint32_t num = _numVertices - ii;
+			const uint8_t* data = stream->next(num);
+			if (NULL == data)
+			{
+				ok = false;
+				break;
+			}
+
+			for (const uint8_t* end = data + num; data < end; ++data, ++ii)
+			{
+				prev = uint8_t(prev + *data);
+				dest[ii*stride] = prev;
+			}
+		}
+	}
+
+	delete stream;
+
+	return ok;
+}
+
+bool meshDecodeIndices(bx::ReaderI* _reader, uint16_t* _indices, uint32_t _numIndices)
+{
+	MeshStreamReader* stream = new MeshStreamReader(_reader);
+	bool ok = true;
+
+	int32_t prev = 0;
+	for (uint32_t ii = 0; ii < _numIndices && ok; ++ii)
+	{
+		uint32_t value = 0;
+		for (uint32_t shift = 0; ok; shift += 7)
+		{
+			uint8_t byte = 0;
+			ok = shift < 32 && stream->readByte(byte);
+			value |= uint32_t(byte&0x7f)<<shift;
+
+			if (0 == (byte&0x80) )
+			{
+				break;
+			}
+		}
+
+		prev += int32_t(value>>1) ^ -int32_t(value&1);
+		_indices[ii] = uint16_t(prev);
+	}
+
+	delete stream;
+
+	return ok;
+}
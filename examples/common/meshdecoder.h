@@ -0,0 +1,36 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#ifndef MESHDECODER_H_HEADER_GUARD
+#define MESHDECODER_H_HEADER_GUARD
+
+#include <bgfx.h>
+#include <bx/readerwriter.h>
+
+/// Decode compressed vertex stream (geometryc --compress).
+///
+/// Stream is decoded block by block, from reader straight into
+/// destination memory (f.e. memory returned by bgfx::alloc), only one
+/// compressed block is kept in memory at the time.
+///
+/// @param _reader Reader positioned at the start of vertex stream.
+/// @param _vertices Destination, must hold _numVertices*_decl.getStride()
+///   bytes.
+/// @param _numVertices Number of vertices.
+/// @param _decl Vertex declaration.
+/// @returns False if stream is corrupted.
+///
+bool meshDecodeVertices(bx::ReaderI* _reader, void* _vertices, uint32_t _numVertices, const bgfx::VertexDecl& _decl);
+
+/// Decode compressed index stream (geometryc --compress).
+///
+/// @param _reader Reader positioned at the start of index stream.
+/// @param _indices Destination, must hold _numIndices 16-bit indices.
+/// @param _numIndices Number of indices.
+/// @returns False if stream is corrupted.
+///
+bool meshDecodeIndices(bx::ReaderI* _reader, uint16_t* _indices, uint32_t _numIndices);
+
+#endif // MESHDECODER_H_HEADER_GUARD
@@ -0,0 +1,319 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#include "entry/dbg.h"
+#include "meshloader.h"
+#include "meshdecoder.h"
+
+static const bgfx::Memory* copyOrRef(void* _data, uint32_t _size, bool _keep)
+{
+	if (_keep)
+	{
+		return bgfx::makeRef(_data, _size);
+	}
+
+	const bgfx::Memory* mem = bgfx::alloc(_size);
+	memcpy(mem->data, _data, _size);
+	free(_data);
+	return mem;
+}
+
+// Streams are read into temporary memory first, bgfx memory can't be
+// released without creating buffer from it. Returns NULL if stream is
+// corrupted.
+static const bgfx::Memory* readVertices(bx::ReaderSeekerI* _reader, uint32_t _chunk, uint16_t _numVertices, const bgfx::VertexDecl& _decl, bool _keep, uint8_t*& _data)
+{
+	const uint32_t size = _numVertices*_decl.getStride();
+	uint8_t* data = (uint8_t*)malloc(size);
+
+	const bool valid = MESH_CHUNK_MAGIC_VBC == _chunk
+		? meshDecodeVertices(_reader, data, _numVertices, _decl)
+		: int32_t(size) == bx::read(_reader, data, size)
+		;
+
+	if (!valid)
+	{
+		DBG("Corrupted vertex stream at %d", _reader->seek() );
+		free(data);
+		return NULL;
+	}
+
+	_data = _keep ? data : NULL;
+	return copyOrRef(data, size, _keep);
+}
+
+static const bgfx::Memory* readIndices(bx::ReaderSeekerI* _reader, uint32_t _chunk, uint32_t _numIndices, bool _keep, uint16_t*& _data)
+{
+	const uint32_t size = _numIndices*2;
+	uint16_t* data = (uint16_t*)malloc(size);
+
+	const bool valid = MESH_CHUNK_MAGIC_IBC == _chunk
+		? meshDecodeIndices(_reader, data, _numIndices)
+		: int32_t(size) == bx::read(_reader, data, size)
+		;
+
+	if (!valid)
+	{
+		DBG("Corrupted index stream at %d", _reader->seek() );
+		free(data);
+		return NULL;
+	}
+
+	_data = _keep ? data : NULL;
+	return copyOrRef(data, size, _keep);
+}
+
+static void groupUnload(MeshGroup& _group)
+{
+	if (bgfx::isValid(_group.m_vbh) )
+	{
+		bgfx::destroyVertexBuffer(_group.m_vbh);
+	}
+
+	if (bgfx::isValid(_group.m_ibh) )
+	{
+		bgfx::destroyIndexBuffer(_group.m_ibh);
+	}
+
+	if (bgfx::isValid(_group.m_shadowVbh) )
+	{
+		bgfx::destroyVertexBuffer(_group.m_shadowVbh);
+	}
+
+	if (bgfx::isValid(_group.m_shadowIbh) )
+	{
+		bgfx::destroyIndexBuffer(_group.m_shadowIbh);
+	}
+
+	for (MeshPrimitiveArray::iterator it = _group.m_prims.begin(), itEnd = _group.m_prims.end(); it != itEnd; ++it)
+	{
+		meshClustersFree(it->m_clusters);
+	}
+
+	free(_group.m_vertices);
+	free(_group.m_indices);
+	_group.reset();
+}
+
+bool meshLoad(MeshGroupArray& _groups, bgfx::VertexDecl& _decl, const char* _filePath, uint32_t _flags, MeshChunkFn _chunkFn, void* _userData)
+{
+	bx::CrtFileReader reader;
+	if (0 != reader.open(_filePath) )
+	{
+		DBG("Failed to open mesh %s.", _filePath);
+		return false;
+	}
+
+	const bool keepData = 0 != (_flags & MESH_LOAD_KEEP_DATA);
+	const uint32_t firstGroup = uint32_t(_groups.size() );
+
+	MeshGroup group;
+	bool shadow = false;
+	uint16_t lod = 0;
+	float lodError = 0.0f;
+	bool result = true;
+
+	uint32_t chunk;
+	while (result
+	&&     4 == bx::read(&reader, chunk) )
+	{
+		switch (chunk)
+		{
+		case MESH_CHUNK_MAGIC_LOD:
+			bx::read(&reader, lod);
+			bx::read(&reader, lodError);
+			break;
+
+		case MESH_CHUNK_MAGIC_SHD:
+			// Following VB and IB are depth only variant of the group.
+			shadow = true;
+			break;
+
+		case MESH_CHUNK_MAGIC_VB:
+		case MESH_CHUNK_MAGIC_VBC:
+			{
+				Sphere sphere;
+				Aabb aabb;
+				Obb obb;
+				bx::read(&reader, sphere);
+				bx::read(&reader, aabb);
+				bx::read(&reader, obb);
+
+				bgfx::VertexDecl decl;
+				bx::read(&reader, decl);
+
+				uint16_t numVertices;
+				bx::read(&reader, numVertices);
+
+				if (shadow)
+				{
+					uint8_t* data = NULL;
+					const bgfx::Memory* mem = readVertices(&reader, chunk, numVertices, decl, false, data);
+					result = NULL != mem;
+					if (result)
+					{
+						group.m_shadowVbh = bgfx::createVertexBuffer(mem, decl);
+					}
+				}
+				else
+				{
+					group.m_lod = lod;
+					group.m_lodError = lodError;
+
+					group.m_sphere = sphere;
+					group.m_aabb = aabb;
+					group.m_obb = obb;
+
+					_decl = decl;
+					group.m_numVertices = numVertices;
+					const bgfx::Memory* mem = readVertices(&reader, chunk, numVertices, decl, keepData, group.m_vertices);
+					result = NULL != mem;
+					if (result)
+					{
+						group.m_vbh = bgfx::createVertexBuffer(mem, decl);
+					}
+				}
+			}
+			break;
+
+		case MESH_CHUNK_MAGIC_IB:
+		case MESH_CHUNK_MAGIC_IBC:
+			{
+				uint32_t numIndices;
+				bx::read(&reader, numIndices);
+
+				if (shadow)
+				{
+					uint16_t* data = NULL;
+					const bgfx::Memory* mem = readIndices(&reader, chunk, numIndices, false, data);
+					result = NULL != mem;
+					if (result)
+					{
+						group.m_shadowIbh = bgfx::createIndexBuffer(mem);
+					}
+					shadow = false;
+				}
+				else
+				{
+					group.m_numIndices = numIndices;
+					const bgfx::Memory* mem = readIndices(&reader, chunk, numIndices, keepData, group.m_indices);
+					result = NULL != mem;
+					if (result)
+					{
+						group.m_ibh = bgfx::createIndexBuffer(mem);
+					}
+				}
+			}
+			break;
+
+		case MESH_CHUNK_MAGIC_PRI:
+			{
+				uint16_t len;
+				bx::read(&reader, len);
+
+				std::string material;
+				material.resize(len);
+				bx::read(&reader, const_cast<char*>(material.c_str() ), len);
+
+				uint16_t num;
+				bx::read(&reader, num);
+
+				for (uint32_t ii = 0; ii < num; ++ii)
+				{
+					bx::read(&reader, len);
+
+					std::string name;
+					name.resize(len);
+					bx::read(&reader, const_cast<char*>(name.c_str() ), len);
+
+					MeshPrimitive prim;
+					bx::read(&reader, prim.m_startIndex);
+					bx::read(&reader, prim.m_numIndices);
+					bx::read(&reader, prim.m_startVertex);
+					bx::read(&reader, prim.m_numVertices);
+					bx::read(&reader, prim.m_sphere);
+					bx::read(&reader, prim.m_aabb);
+					bx::read(&reader, prim.m_obb);
+					memset(&prim.m_clusters, 0, sizeof(MeshClusters) );
+
+					group.m_prims.push_back(prim);
+				}
+
+				_groups.push_back(group);
+				group.reset();
+			}
+			break;
+
+		case MESH_CHUNK_MAGIC_CLS:
+			{
+				// Clusters of primitives from preceding PRI chunk.
+				uint16_t num;
+				bx::read(&reader, num);
+
+				// Size of cluster data is not known, chunk that doesn't
+				// match primitives can't be skipped.
+				if (firstGroup == _groups.size()
+				||  num > _groups.back().m_prims.size() )
+				{
+					DBG("Invalid cluster chunk at %d", reader.seek() );
+					result = false;
+					break;
+				}
+
+				MeshPrimitiveArray& prims = _groups.back().m_prims;
+				for (uint32_t ii = 0; ii < num && result; ++ii)
+				{
+					result = meshClustersRead(&reader, prims[ii].m_clusters);
+					if (!result)
+					{
+						DBG("Corrupted cluster data at %d", reader.seek() );
+					}
+				}
+			}
+			break;
+
+		default:
+			// Size of chunk is not known, only callback can skip it.
+			if (NULL == _chunkFn
+			||  !_chunkFn(&reader, chunk, uint32_t(_groups.size() ), group, _decl, _userData) )
+			{
+				DBG("Unknown chunk %08x at %d", chunk, reader.seek() );
+				result = false;
+			}
+			break;
+		}
+	}
+
+	reader.close();
+
+	if (!result)
+	{
+		// Release group being loaded, and groups loaded from this file.
+		groupUnload(group);
+
+		for (MeshGroupArray::iterator it = _groups.begin() + firstGroup, itEnd = _groups.end(); it != itEnd; ++it)
+		{
+			groupUnload(*it);
+		}
+
+		_groups.erase(_groups.begin() + firstGroup, _groups.end() );
+	}
+
+	return result;
+}
+
+void meshUnload(MeshGroupArray& _groups)
+{
+	for (MeshGroupArray::iterator it = _groups.begin(), itEnd = _groups.end(); it != itEnd; ++it)
+	{
+		groupUnload(*it);
+	}
+
+	_groups.clear();
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#ifndef MESHLOADER_H_HEADER_GUARD
+#define MESHLOADER_H_HEADER_GUARD
+
+#include <vector>
+#include <bgfx.h>
+#include <bx/readerwriter.h>
+#include "bounds.h"
+#include "meshcluster.h"
+
+#define MESH_CHUNK_MAGIC_VB  BX_MAKEFOURCC('V', 'B', ' ', 0x0)
+#define MESH_CHUNK_MAGIC_VBC BX_MAKEFOURCC('V', 'B', 'C', 0x0)
+#define MESH_CHUNK_MAGIC_IB  BX_MAKEFOURCC('I', 'B', ' ', 0x0)
+#define MESH_CHUNK_MAGIC_IBC BX_MAKEFOURCC('I', 'B', 'C', 0x0)
+#define MESH_CHUNK_MAGIC_PRI BX_MAKEFOURCC('P', 'R', 'I', 0x0)
+#define MESH_CHUNK_MAGIC_LOD BX_MAKEFOURCC('L', 'O', 'D', 0x0)
+#define MESH_CHUNK_MAGIC_SHD BX_MAKEFOURCC('S', 'H', 'D', 0x0)
+#define MESH_CHUNK_MAGIC_CLS BX_MAKEFOURCC('C', 'L', 'S', 0x0)
+#define MESH_CHUNK_MAGIC_ADJ BX_MAKEFOURCC('A', 'D', 'J', 0x0)
+
+#define MESH_LOAD_KEEP_DATA UINT32_C(0x00000001) //!< Keep copy of group vertices and indices in memory.
+
+struct MeshPrimitive
+{
+	uint32_t m_startIndex;
+	uint32_t m_numIndices;
+	uint32_t m_startVertex;
+	uint32_t m_numVertices;
+
+	Sphere m_sphere;
+	Aabb m_aabb;
+	Obb m_obb;
+
+	MeshClusters m_clusters; //!< Empty if mesh has no CLS chunk.
+};
+
+typedef std::vector<MeshPrimitive> MeshPrimitiveArray;
+
+struct MeshGroup
+{
+	MeshGroup()
+	{
+		reset();
+	}
+
+	void reset()
+	{
+		m_vbh.idx = bgfx::invalidHandle;
+		m_ibh.idx = bgfx::invalidHandle;
+		m_shadowVbh.idx = bgfx::invalidHandle;
+		m_shadowIbh.idx = bgfx::invalidHandle;
+		m_numVertices = 0;
+		m_vertices = NULL;
+		m_numIndices = 0;
+		m_indices = NULL;
+		m_lod = 0;
+		m_lodError = 0.0f;
+		m_prims.clear();
+	}
+
+	bgfx::VertexBufferHandle m_vbh;
+	bgfx::IndexBufferHandle m_ibh;
+	bgfx::VertexBufferHandle m_shadowVbh; //!< Depth only variant (SHD chunk), might be invalid.
+	bgfx::IndexBufferHandle m_shadowIbh;  //!< Depth only variant (SHD chunk), might be invalid.
+	uint16_t m_numVertices;
+	uint8_t* m_vertices;  //!< Only with MESH_LOAD_KEEP_DATA.
+	uint32_t m_numIndices;
+	uint16_t* m_indices;  //!< Only with MESH_LOAD_KEEP_DATA.
+	uint16_t m_lod;
+	float m_lodError;
+	Sphere m_sphere;
+	Aabb m_aabb;
+	Obb m_obb;
+	MeshPrimitiveArray m_prims;
+};
+
+typedef std::vector<MeshGroup> MeshGroupArray;
+
+/// Called for chunks not handled by loader (f.e. ADJ). Callback must
+/// read whole chunk.
+///
+/// @param _reader Reader positioned after chunk magic.
+/// @param _chunk Chunk magic.
+/// @param _groupIndex Index group will have in group array.
+/// @param _group Group being loaded.
+/// @param _decl Vertex declaration of group.
+/// @param _userData User data passed to meshLoad.
+/// @returns False if chunk is unknown.
+///
+typedef bool (*MeshChunkFn)(bx::ReaderSeekerI* _reader, uint32_t _chunk, uint32_t _groupIndex, const MeshGroup& _group, const bgfx::VertexDecl& _decl, void* _userData);
+
+/// Load mesh created by geometryc.
+///
+/// @param _groups Loaded groups are appended to this array.
+/// @param _decl Vertex declaration of mesh.
+/// @param _filePath Mesh file path.
+/// @param _flags MESH_LOAD_* flags.
+/// @param _chunkFn Callback for chunks not handled by loader.
+/// @param _userData User data passed to _chunkFn.
+/// @returns False if file can't be opened, data is corrupted, or
+///   loading stopped at unknown chunk. Groups loaded from file are
+///   released and removed from _groups on failure.
+///
+bool meshLoad(MeshGroupArray& _groups, bgfx::VertexDecl& _decl, const char* _filePath, uint32_t _flags = 0, MeshChunkFn _chunkFn = NULL, void* _userData = NULL);
+
+/// Destroy buffers and free memory of all groups.
+void meshUnload(MeshGroupArray& _groups);
+
+#endif // MESHLOADER_H_HEADER_GUARD
@@ -0,0 +1,520 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <bx/float4_t.h>
+#include <bx/timer.h>
+#include "fpumath.h"
+#include "occlusion.h"
+
+using namespace bx;
+
+OcclusionCulling::OcclusionCulling(uint32_t _width, uint32_t _height, uint32_t _numThreads)
+	: m_numThreads(_numThreads < 1 ? 1 : _numThreads > OCCLUSION_MAX_THREADS ? OCCLUSION_MAX_THREADS : _numThreads)
+	, m_exit(false)
+{
+	m_width  = (_width  + OCCLUSION_TILE_SIZE - 1) & ~(OCCLUSION_TILE_SIZE - 1);
+	m_height = (_height + OCCLUSION_TILE_SIZE - 1) & ~(OCCLUSION_TILE_SIZE - 1);
+	m_tilesX = m_width /OCCLUSION_TILE_SIZE;
+	m_tilesY = m_height/OCCLUSION_TILE_SIZE;
+
+	// Bands are whole rows of tiles.
+	m_bandHeight = (m_tilesY + m_numThreads - 1)/m_numThreads*OCCLUSION_TILE_SIZE;
+
+	const uint32_t size = (m_width*m_height + m_tilesX*m_tilesY)*sizeof(float);
+	m_data = malloc(size + 15);
+	m_depth = (float*)( ( (uintptr_t)m_data + 15) & ~uintptr_t(15) );
+	m_tiles = &m_depth[m_width*m_height];
+
+	for (uint32_t ii = 0, num = m_width*m_height + m_tilesX*m_tilesY; ii < num; ++ii)
+	{
+		m_depth[ii] = 1.0f;
+	}
+
+	mtxIdentity(m_viewProj);
+	memset(&m_stats, 0, sizeof(OcclusionStats) );
+
+	// Worker 0 is calling thread.
+	for (uint32_t ii = 1; ii < m_numThreads; ++ii)
+	{
+		Worker& worker = m_worker[ii];
+		worker.m_occlusion = this;
+		worker.m_index = ii;
+		worker.m_thread.init(workerFunc, &worker);
+	}
+}
+
+OcclusionCulling::~OcclusionCulling()
+{
+	m_exit = true;
+	for (uint32_t ii = 1; ii < m_numThreads; ++ii)
+	{
+		m_worker[ii].m_start.post();
+		m_worker[ii].m_thread.shutdown();
+	}
+
+	free(m_data);
+}
+
+int32_t OcclusionCulling::workerFunc(void* _userData)
+{
+	Worker* worker = (Worker*)_userData;
+	OcclusionCulling* occlusion = worker->m_occlusion;
+
+	for (;;)
+	{
+		worker->m_start.wait();
+		if (occlusion->m_exit)
+		{
+			break;
+		}
+
+		occlusion->rasterizeBand(worker->m_index);
+		occlusion->m_done.post();
+	}
+
+	return 0;
+}
+
+void OcclusionCulling::begin(const float* _viewProj)
+{
+	memcpy(m_viewProj, _viewProj, sizeof(m_viewProj) );
+	m_triangles.clear();
+	memset(&m_stats, 0, sizeof(OcclusionStats) );
+}
+
+void OcclusionCulling::addOccluder(const float* _mtx, const void* _vertices, uint32_t _numVertices, uint32_t _stride, const uint16_t* _indices, uint32_t _numIndices)
+{
+	const int64_t start = bx::getHPCounter();
+
+	float mvp[16];
+	mtxMul(mvp, _mtx, m_viewProj);
+
+	const float4_t row0 = float4_ld(mvp[ 0], mvp[ 1], mvp[ 2], mvp[ 3]);
+	const float4_t row1 = float4_ld(mvp[ 4], mvp[ 5], mvp[ 6], mvp[ 7]);
+	const float4_t row2 = float4_ld(mvp[ 8], mvp[ 9], mvp[10], mvp[11]);
+	const float4_t row3 = float4_ld(mvp[12], mvp[13], mvp[14], mvp[15]);
+
+	// Transform positions to clip space.
+	m_clip.resize(_numVertices*4);
+	BX_ALIGN_STRUCT_16(float clip[4]);
+	const uint8_t* vertices = (const uint8_t*)_vertices;
+	for (uint32_t ii = 0; ii < _numVertices; ++ii)
+	{
+		const float* position = (const float*)(vertices + ii*_stride);
+		const float4_t result = float4_madd(float4_splat(position[0]), row0
+							  , float4_madd(float4_splat(position[1]), row1
+							  , float4_madd(float4_splat(position[2]), row2
+							  , row3) ) );
+		float4_st(clip, result);
+		memcpy(&m_clip[ii*4], clip, sizeof(clip) );
+	}
+
+	const float width  = float(m_width);
+	const float height = float(m_height);
+	const int32_t maxX = int32_t(m_width-1);
+	const int32_t maxY = int32_t(m_height-1);
+
+	for (uint32_t ii = 0; ii < _numIndices; ii += 3)
+	{
+		const float* vertex[3] =
+		{
+			&m_clip[_indices[ii+0]*4],
+			&m_clip[_indices[ii+1]*4],
+			&m_clip[_indices[ii+2]*4],
+		};
+
+		// Drop triangles crossing near plane.
+		if (0.0f > vertex[0][2]
+		||  0.0f > vertex[1][2]
+		||  0.0f > vertex[2][2]
+		||  0.0f >= vertex[0][3]
+		||  0.0f >= vertex[1][3]
+		||  0.0f >= vertex[2][3])
+		{
+			continue;
+		}
+
+		Triangle tri;
+		for (uint32_t jj = 0; jj < 3; ++jj)
+		{
+			const float invW = 1.0f/vertex[jj][3];
+			tri.m_x[jj] = (vertex[jj][0]*invW*0.5f + 0.5f)*width;
+			tri.m_y[jj] = (0.5f - vertex[jj][1]*invW*0.5f)*height;
+			tri.m_z[jj] = vertex[jj][2]*invW;
+		}
+
+		const float area = (tri.m_x[1] - tri.m_x[0])*(tri.m_y[2] - tri.m_y[0])
+						 - (tri.m_y[1] - tri.m_y[0])*(tri.m_x[2] - tri.m_x[0])
+						 ;
+		if (0.0f == area)
+		{
+			continue;
+		}
+
+		// Occluders are double sided, make winding consistent.
+		if (0.0f > area)
+		{
+			float tmp;
+			tmp = tri.m_x[1]; tri.m_x[1] = tri.m_x[2]; tri.m_x[2] = tmp;
+			tmp = tri.m_y[1]; tri.m_y[1] = tri.m_y[2]; tri.m_y[2] = tmp;
+			tmp = tri.m_z[1]; tri.m_z[1] = tri.m_z[2]; tri.m_z[2] = tmp;
+		}
+
+		tri.m_minX = int32_t(floorf(fminf(tri.m_x[0], fminf(tri.m_x[1], tri.m_x[2]) ) ) );
+		tri.m_maxX = int32_t(floorf(fmaxf(tri.m_x[0], fmaxf(tri.m_x[1], tri.m_x[2]) ) ) );
+		tri.m_minY = int32_t(floorf(fminf(tri.m_y[0], fminf(tri.m_y[1], tri.m_y[2]) ) ) );
+		tri.m_maxY = int32_t(floorf(fmaxf(tri.m_y[0], fmaxf(tri.m_y[1], tri.m_y[2]) ) ) );
+		tri.m_minX = tri.m_minX < 0 ? 0 : tri.m_minX;
+		tri.m_minY = tri.m_minY < 0 ? 0 : tri.m_minY;
+		tri.m_maxX = tri.m_maxX > maxX ? maxX : tri.m_maxX;
+		tri.m_maxY = tri.m_maxY > maxY ? maxY : tri.m_maxY;
+
+		if (tri.m_minX <= tri.m_maxX
+		&&  tri.m_minY <= tri.m_maxY)
+		{
+			m_triangles.push_back(tri);
+		}
+	}
+
+	++m_stats.m_numOccluders;
+	m_stats.m_rasterizeTime += bx::getHPCounter() - start;
+}
+
+void OcclusionCulling::rasterize()
+{
+	const int64_t start = bx::getHPCounter();
+
+	const uint32_t numBands = (m_height + m_bandHeight - 1)/m_bandHeight;
+
+	for (uint32_t ii = 1; ii < numBands; ++ii)
+	{
+		m_worker[ii].m_start.post();
+	}
+
+	rasterizeBand(0);
+
+	for (uint32_t ii = 1; ii < numBands; ++ii)
+	{
+		m_done.wait();
+	}
+
+	m_stats.m_numTriangles = uint32_t(m_triangles.size() );
+	m_stats.m_rasterizeTime += bx::getHPCounter() - start;
+}
+
+void OcclusionCulling::rasterizeBand(uint32_t _index)
+{
+	const uint32_t begin = _index*m_bandHeight;
+	const uint32_t end = begin + m_bandHeight < m_height ? begin + m_bandHeight : m_height;
+
+	for (uint32_t ii = begin*m_width, num = end*m_width; ii < num; ++ii)
+	{
+		m_depth[ii] = 1.0f;
+	}
+
+	for (std::vector<Triangle>::const_iterator it = m_triangles.begin(), itEnd = m_triangles.end(); it != itEnd; ++it)
+	{
+		const Triangle& tri = *it;
+		const int32_t minY = tri.m_minY > int32_t(begin) ? tri.m_minY : int32_t(begin);
+		const int32_t maxY = tri.m_maxY < int32_t(end-1) ? tri.m_maxY : int32_t(end-1);
+		if (minY <= maxY)
+		{
+			rasterizeTriangle(tri, minY, maxY);
+		}
+	}
+
+	// Tiles hold farthest depth of their pixels.
+	for (uint32_t yy = begin; yy < end; yy += OCCLUSION_TILE_SIZE)
+	{
+		for (uint32_t tx = 0; tx < m_tilesX; ++tx)
+		{
+			const float* depth = &m_depth[yy*m_width + tx*OCCLUSION_TILE_SIZE];
+			float4_t max = float4_ld(depth);
+			for (uint32_t ii = 0; ii < OCCLUSION_TILE_SIZE; ++ii, depth += m_width)
+			{
+				max = float4_max(max, float4_max(float4_ld(depth), float4_ld(depth + 4) ) );
+			}
+
+			BX_ALIGN_STRUCT_16(float tmp[4]);
+			float4_st(tmp, max);
+			m_tiles[yy/OCCLUSION_TILE_SIZE*m_tilesX + tx] = fmaxf(fmaxf(tmp[0], tmp[1]), fmaxf(tmp[2], tmp[3]) );
+		}
+	}
+}
+
+void OcclusionCulling::rasterizeTriangle(const Triangle& _tri, int32_t _minY, int32_t _maxY)
+{
+	const float* xx = _tri.m_x;
+	const float* yy = _tri.m_y;
+	const float* zz = _tri.m_z;
+
+	// Edge functions E(x, y) = A*x + B*y + C, positive inside.
+	float edgeA[3];
+	float edgeB[3];
+	float edgeC[3];
+	for (uint32_t ii = 0; ii < 3; ++ii)
+	{
+		const uint32_t jj = (ii+1)%3;
+		edgeA[ii] = yy[ii] - yy[jj];
+		edgeB[ii] = xx[jj] - xx[ii];
+		edgeC[ii] = -(edgeA[ii]*xx[ii] + edgeB[ii]*yy[ii]);
+	}
+
+	// Depth plane from barycentrics, edge ii is opposite to vertex (ii+2)%3.
+	const float invArea = 1.0f/(edgeA[0]*xx[2] + edgeB[0]*yy[2] + edgeC[0]);
+	const float depthA = (edgeA[1]*zz[0] + edgeA[2]*zz[1] + edgeA[0]*zz[2])*invArea;
+	const float depthB = (edgeB[1]*zz[0] + edgeB[2]*zz[1] + edgeB[0]*zz[2])*invArea;
+	const float depthC = (edgeC[1]*zz[0] + edgeC[2]*zz[1] + edgeC[0]*zz[2])*invArea;
+
+	// Edge functions of shared edge are not exact negatives of each other
+	// after rounding, and pixel centers on shared edge might end up outside
+	// of both triangles. Bias edges outward by fraction of pixel to keep
+	// occluder meshes watertight, pixels covered twice just keep nearest
+	// depth.
+	for (uint32_t ii = 0; ii < 3; ++ii)
+	{
+		edgeC[ii] += (fabsf(edgeA[ii]) + fabsf(edgeB[ii]) )*(1.0f/256.0f);
+	}
+
+	const float4_t edgeA0 = float4_splat(edgeA[0]);
+	const float4_t edgeA1 = float4_splat(edgeA[1]);
+	const float4_t edgeA2 = float4_splat(edgeA[2]);
+	const float4_t depthA4 = float4_splat(depthA);
+	const float4_t offset = float4_ld(0.5f, 1.5f, 2.5f, 3.5f);
+	const float4_t zero = float4_zero();
+
+	const int32_t minX = _tri.m_minX & ~3;
+
+	for (int32_t py = _minY; py <= _maxY; ++py)
+	{
+		const float fy = float(py) + 0.5f;
+		const float4_t row0 = float4_splat(edgeB[0]*fy + edgeC[0]);
+		const float4_t row1 = float4_splat(edgeB[1]*fy + edgeC[1]);
+		const float4_t row2 = float4_splat(edgeB[2]*fy + edgeC[2]);
+		const float4_t rowDepth = float4_splat(depthB*fy + depthC);
+
+		float* depth = &m_depth[py*m_width];
+
+		// Pixel is covered when its center is inside of biased edges.
+		for (int32_t px = minX; px <= _tri.m_maxX; px += 4)
+		{
+			const float4_t fx = float4_add(float4_splat(float(px) ), offset);
+			const float4_t e0 = float4_madd(fx, edgeA0, row0);
+			const float4_t e1 = float4_madd(fx, edgeA1, row1);
+			const float4_t e2 = float4_madd(fx, edgeA2, row2);
+			const float4_t inside = float4_and(float4_cmpgt(e0, zero)
+								  , float4_and(float4_cmpgt(e1, zero), float4_cmpgt(e2, zero) ) );
+
+			const float4_t zz4  = float4_madd(fx, depthA4, rowDepth);
+			const float4_t cur  = float4_ld(&depth[px]);
+			const float4_t nearest = float4_min(cur, zz4);
+			float4_st(&depth[px], float4_or(float4_and(inside, nearest), float4_andc(cur, inside) ) );
+		}
+	}
+}
+
+struct OcclusionMtx
+{
+	void init(const float* _mtx)
+	{
+		for (uint32_t ii = 0; ii < 16; ++ii)
+		{
+			m_mtx[ii] = float4_splat(_mtx[ii]);
+		}
+	}
+
+	float4_t m_mtx[16];
+};
+
+// Projects 8 corners of box, box is visible when it crosses near plane,
+// or when any depth buffer pixel under its screen rectangle is farther
+// than its nearest corner.
+static bool testBox(const OcclusionMtx& _mtx
+	, const float* _depth
+	, const float* _tiles
+	, uint32_t _width
+	, uint32_t _height
+	, uint32_t _tilesX
+	, float _cx, float _cy, float _cz
+	, float _ex, float _ey, float _ez
+	)
+{
+	const float4_t* mtx = _mtx.m_mtx;
+
+	const float4_t signX = float4_ld(-1.0f,  1.0f, -1.0f, 1.0f);
+	const float4_t signY = float4_ld(-1.0f, -1.0f,  1.0f, 1.0f);
+	const float4_t xx = float4_madd(float4_splat(_ex), signX, float4_splat(_cx) );
+	const float4_t yy = float4_madd(float4_splat(_ey), signY, float4_splat(_cy) );
+	const float4_t z0 = float4_splat(_cz - _ez);
+	const float4_t z1 = float4_splat(_cz + _ez);
+
+	const float4_t xy0 = float4_madd(xx, mtx[0], float4_madd(yy, mtx[4], mtx[12]) );
+	const float4_t xy1 = float4_madd(xx, mtx[1], float4_madd(yy, mtx[5], mtx[13]) );
+	const float4_t xy2 = float4_madd(xx, mtx[2], float4_madd(yy, mtx[6], mtx[14]) );
+	const float4_t xy3 = float4_madd(xx, mtx[3], float4_madd(yy, mtx[7], mtx[15]) );
+
+	const float4_t clipX0 = float4_madd(z0, mtx[ 8], xy0);
+	const float4_t clipY0 = float4_madd(z0, mtx[ 9], xy1);
+	const float4_t clipZ0 = float4_madd(z0, mtx[10], xy2);
+	const float4_t clipW0 = float4_madd(z0, mtx[11], xy3);
+	const float4_t clipX1 = float4_madd(z1, mtx[ 8], xy0);
+	const float4_t clipY1 = float4_madd(z1, mtx[ 9], xy1);
+	const float4_t clipZ1 = float4_madd(z1, mtx[10], xy2);
+	const float4_t clipW1 = float4_madd(z1, mtx[11], xy3);
+
+	// Any corner in front of near plane.
+	const float4_t zero = float4_zero();
+	BX_ALIGN_STRUCT_16(uint32_t mask[4]);
+	float4_st(mask, float4_or(float4_or(float4_cmplt(clipZ0, zero), float4_cmplt(clipZ1, zero) )
+							, float4_or(float4_cmpge(zero, clipW0), float4_cmpge(zero, clipW1) ) ) );
+	if (0 != (mask[0] | mask[1] | mask[2] | mask[3]) )
+	{
+		return true;
+	}
+
+	const float4_t one = float4_splat(1.0f);
+	const float4_t invW0 = float4_div(one, clipW0);
+	const float4_t invW1 = float4_div(one, clipW1);
+	const float4_t ndcX0 = float4_mul(clipX0, invW0);
+	const float4_t ndcY0 = float4_mul(clipY0, invW0);
+	const float4_t ndcX1 = float4_mul(clipX1, invW1);
+	const float4_t ndcY1 = float4_mul(clipY1, invW1);
+
+	BX_ALIGN_STRUCT_16(float minX[4]);
+	BX_ALIGN_STRUCT_16(float maxX[4]);
+	BX_ALIGN_STRUCT_16(float minY[4]);
+	BX_ALIGN_STRUCT_16(float maxY[4]);
+	BX_ALIGN_STRUCT_16(float minZ[4]);
+	float4_st(minX, float4_min(ndcX0, ndcX1) );
+	float4_st(maxX, float4_max(ndcX0, ndcX1) );
+	float4_st(minY, float4_min(ndcY0, ndcY1) );
+	float4_st(maxY, float4_max(ndcY0, ndcY1) );
+	float4_st(minZ, float4_min(float4_mul(clipZ0, invW0), float4_mul(clipZ1, invW1) ) );
+
+	const float ndcMinX = fminf(fminf(minX[0], minX[1]), fminf(minX[2], minX[3]) );
+	const float ndcMaxX = fmaxf(fmaxf(maxX[0], maxX[1]), fmaxf(maxX[2], maxX[3]) );
+	const float ndcMinY = fminf(fminf(minY[0], minY[1]), fminf(minY[2], minY[3]) );
+	const float ndcMaxY = fmaxf(fmaxf(maxY[0], maxY[1]), fmaxf(maxY[2], maxY[3]) );
+	const float nearZ   = fminf(fminf(minZ[0], minZ[1]), fminf(minZ[2], minZ[3]) );
+
+	// Screen y is flipped.
+	const float width  = float(_width);
+	const float height = float(_height);
+	int32_t x0 = int32_t(floorf( (ndcMinX*0.5f + 0.5f)*width) );
+	int32_t x1 = int32_t(floorf( (ndcMaxX*0.5f + 0.5f)*width) );
+	int32_t y0 = int32_t(floorf( (0.5f - ndcMaxY*0.5f)*height) );
+	int32_t y1 = int32_t(floorf( (0.5f - ndcMinY*0.5f)*height) );
+	x0 = x0 < 0 ? 0 : x0;
+	y0 = y0 < 0 ? 0 : y0;
+	x1 = x1 > int32_t(_width -1) ? int32_t(_width -1) : x1;
+	y1 = y1 > int32_t(_height-1) ? int32_t(_height-1) : y1;
+
+	// Off screen, leave it to frustum culling.
+	if (x0 > x1
+	||  y0 > y1)
+	{
+		return true;
+	}
+
+	for (int32_t ty = y0/OCCLUSION_TILE_SIZE, tyEnd = y1/OCCLUSION_TILE_SIZE; ty <= tyEnd; ++ty)
+	{
+		for (int32_t tx = x0/OCCLUSION_TILE_SIZE, txEnd = x1/OCCLUSION_TILE_SIZE; tx <= txEnd; ++tx)
+		{
+			if (_tiles[ty*_tilesX + tx] < nearZ)
+			{
+				// Whole tile is nearer than box.
+				continue;
+			}
+
+			const int32_t px0 = x0 > tx*OCCLUSION_TILE_SIZE ? x0 : tx*OCCLUSION_TILE_SIZE;
+			const int32_t py0 = y0 > ty*OCCLUSION_TILE_SIZE ? y0 : ty*OCCLUSION_TILE_SIZE;
+			const int32_t px1 = x1 < (tx+1)*OCCLUSION_TILE_SIZE-1 ? x1 : (tx+1)*OCCLUSION_TILE_SIZE-1;
+			const int32_t py1 = y1 < (ty+1)*OCCLUSION_TILE_SIZE-1 ? y1 : (ty+1)*OCCLUSION_TILE_SIZE-1;
+
+			for (int32_t py = py0; py <= py1; ++py)
+			{
+				const float* depth = &_depth[py*_width];
+				for (int32_t px = px0; px <= px1; ++px)
+				{
+					if (depth[px] >= nearZ)
+					{
+						return true;
+					}
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+bool OcclusionCulling::testAabb(const float* _center, const float* _extent)
+{
+	OcclusionMtx mtx;
+	mtx.init(m_viewProj);
+
+	return testBox(mtx, m_depth, m_tiles, m_width, m_height, m_tilesX
+		, _center[0], _center[1], _center[2]
+		, _extent[0], _extent[1], _extent[2]
+		);
+}
+
+uint32_t OcclusionCulling::testAabbs(uint32_t* _visible, const CullAabbs& _aabbs, const uint32_t* _candidates, uint32_t _num)
+{
+	const int64_t start = bx::getHPCounter();
+
+	OcclusionMtx mtx;
+	mtx.init(m_viewProj);
+
+	uint32_t numVisible = 0;
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		const uint32_t index = _candidates[ii];
+		const bool visible = testBox(mtx, m_depth, m_tiles, m_width, m_height, m_tilesX
+			, _aabbs.m_centerX[index], _aabbs.m_centerY[index], _aabbs.m_centerZ[index]
+			, _aabbs.m_extentX[index], _aabbs.m_extentY[index], _aabbs.m_extentZ[index]
+			);
+
+		_visible[numVisible] = index;
+		numVisible += visible;
+	}
+
+	m_stats.m_numTested += _num;
+	m_stats.m_numCulled += _num - numVisible;
+	m_stats.m_testTime += bx::getHPCounter() - start;
+
+	return numVisible;
+}
+
+uint32_t OcclusionCulling::testSpheres(uint32_t* _visible, const CullSpheres& _spheres, const uint32_t* _candidates, uint32_t _num)
+{
+	const int64_t start = bx::getHPCounter();
+
+	OcclusionMtx mtx;
+	mtx.init(m_viewProj);
+
+	uint32_t numVisible = 0;
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		const uint32_t index = _candidates[ii];
+		const float radius = _spheres.m_radius[index];
+		const bool visible = testBox(mtx, m_depth, m_tiles, m_width, m_height, m_tilesX
+			, _spheres.m_centerX[index], _spheres.m_centerY[index], _spheres.m_centerZ[index]
+			, radius, radius, radius
+			);
+
+		_visible[numVisible] = index;
+		numVisible += visible;
+	}
+
+	m_stats.m_numTested += _num;
+	m_stats.m_numCulled += _num - numVisible;
+	m_stats.m_testTime += bx::getHPCounter() - start;
+
+	return numVisible;
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#ifndef OCCLUSION_H_HEADER_GUARD
+#define OCCLUSION_H_HEADER_GUARD
+
+#include <vector>
+
+#include <bx/bx.h>
+#include <bx/sem.h>
+#include <bx/thread.h>
+
+#include "cull.h"
+
+#define OCCLUSION_MAX_THREADS 16
+#define OCCLUSION_TILE_SIZE   8
+
+struct OcclusionStats
+{
+	uint32_t m_numOccluders;
+	uint32_t m_numTriangles;   //!< Occluder triangles rasterized.
+	uint32_t m_numTested;
+	uint32_t m_numCulled;
+	int64_t m_rasterizeTime;   //!< bx::getHPCounter ticks.
+	int64_t m_testTime;        //!< bx::getHPCounter ticks.
+};
+
+/// CPU occlusion culling.
+///
+/// Occluder triangles are rasterized into low resolution depth buffer,
+/// screen is split into horizontal bands, and each band is rasterized on
+/// its own thread. Depth buffer is reduced into tiles holding farthest
+/// depth of tile, object bounds are tested against tiles first and only
+/// against pixels of tiles where test is inconclusive.
+///
+/// Depth is post-projection z/w, with 0 at near plane (fpumath mtxProj).
+/// Occluder triangles crossing near plane are dropped, and objects with
+/// bounds crossing near plane are always visible, both keep culling
+/// conservative.
+///
+/// Usage:
+///
+///   occlusion.begin(viewProj);
+///   occlusion.addOccluder(mtx, vertices, numVertices, stride, indices, numIndices);
+///   occlusion.rasterize();
+///   numVisible = occlusion.testAabbs(visible, aabbs, candidates, numCandidates);
+///
+class OcclusionCulling
+{
+public:
+	/// @param _width Depth buffer width, rounded up to multiple of
+	///   OCCLUSION_TILE_SIZE.
+	/// @param _height Depth buffer height, rounded up to multiple of
+	///   OCCLUSION_TILE_SIZE.
+	/// @param _numThreads Total number of threads including calling
+	///   thread, up to OCCLUSION_MAX_THREADS.
+	OcclusionCulling(uint32_t _width, uint32_t _height, uint32_t _numThreads);
+	~OcclusionCulling();
+
+	/// Start new frame, clear occluders and statistics.
+	void begin(const float* _viewProj);
+
+	/// Add occluder mesh, triangles are transformed and set up on calling
+	/// thread.
+	///
+	/// @param _mtx Model matrix.
+	/// @param _vertices Pointer to float3 position of first vertex.
+	/// @param _numVertices Number of vertices.
+	/// @param _stride Vertex stride.
+	/// @param _indices Triangle list indices.
+	/// @param _numIndices Number of indices.
+	///
+	void addOccluder(const float* _mtx, const void* _vertices, uint32_t _numVertices, uint32_t _stride, const uint16_t* _indices, uint32_t _numIndices);
+
+	/// Rasterize occluders and build depth tiles.
+	void rasterize();
+
+	/// Test boxes against depth buffer.
+	///
+	/// @param _visible Indices of visible boxes, can be the same array as
+	///   _candidates.
+	/// @param _aabbs World space boxes.
+	/// @param _candidates Indices of boxes to test, f.e. output of
+	///   cullAabbs.
+	/// @param _num Number of candidates.
+	/// @returns Number of visible boxes.
+	///
+	uint32_t testAabbs(uint32_t* _visible, const CullAabbs& _aabbs, const uint32_t* _candidates, uint32_t _num);
+
+	/// Test spheres against depth buffer, spheres are tested as boxes
+	/// around spheres.
+	uint32_t testSpheres(uint32_t* _visible, const CullSpheres& _spheres, const uint32_t* _candidates, uint32_t _num);
+
+	/// Returns true when box is visible.
+	bool testAabb(const float* _center, const float* _extent);
+
+	const OcclusionStats& getStats() const
+	{
+		return m_stats;
+	}
+
+	uint32_t getWidth() const
+	{
+		return m_width;
+	}
+
+	uint32_t getHeight() const
+	{
+		return m_height;
+	}
+
+	/// Depth buffer, m_width*m_height floats.
+	const float* getDepth() const
+	{
+		return m_depth;
+	}
+
+private:
+	struct Triangle
+	{
+		float m_x[3];
+		float m_y[3];
+		float m_z[3];
+		int32_t m_minX;
+		int32_t m_maxX;
+		int32_t m_minY;
+		int32_t m_maxY;
+	};
+
+	struct Worker
+	{
+		OcclusionCulling* m_occlusion;
+		uint32_t m_index;
+		bx::Thread m_thread;
+		bx::Semaphore m_start;
+	};
+
+	static int32_t workerFunc(void* _userData);
+
+	void rasterizeBand(uint32_t _index);
+	void rasterizeTriangle(const Triangle& _tri, int32_t _minY, int32_t _maxY);
+
+	Worker m_worker[OCCLUSION_MAX_THREADS];
+	bx::Semaphore m_done;
+	uint32_t m_numThreads;
+	bool m_exit;
+
+	uint32_t m_width;
+	uint32_t m_height;
+	uint32_t m_tilesX;
+	uint32_t m_tilesY;
+	uint32_t m_bandHeight;
+	float m_viewProj[16];
+
+	std::vector<Triangle> m_triangles;
+	std::vector<float> m_clip;
+
+	void* m_data;
+	float* m_depth;
+	float* m_tiles;
+
+	OcclusionStats m_stats;
+};
+
+#endif // OCCLUSION_H_HEADER_GUARD
@@ -0,0 +1,453 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <map>
+#include <bx/debug.h>
+#include <bx/float4_t.h>
+#include "shadowvolume.h"
+
+using namespace bx;
+
+static void svMeshAlloc(SvMesh& _mesh, uint32_t _numEdges, uint32_t _numFaces)
+{
+	const uint32_t edgeStride = (_numEdges+3) & ~3;
+	const uint32_t faceStride = (_numFaces+3) & ~3;
+	const uint32_t size = 0
+		+ edgeStride*8*sizeof(float)
+		+ faceStride*4*sizeof(float)
+		+ edgeStride*2*sizeof(uint16_t)
+		;
+
+	_mesh.m_numEdges = _numEdges;
+	_mesh.m_numFaces = _numFaces;
+	_mesh.m_data = malloc(size + 15);
+	float* data = (float*)( ( (uintptr_t)_mesh.m_data + 15) & ~uintptr_t(15) );
+	memset(data, 0, size);
+
+	_mesh.m_plane0X = data;
+	_mesh.m_plane0Y = &_mesh.m_plane0X[edgeStride];
+	_mesh.m_plane0Z = &_mesh.m_plane0Y[edgeStride];
+	_mesh.m_plane0W = &_mesh.m_plane0Z[edgeStride];
+	_mesh.m_plane1X = &_mesh.m_plane0W[edgeStride];
+	_mesh.m_plane1Y = &_mesh.m_plane1X[edgeStride];
+	_mesh.m_plane1Z = &_mesh.m_plane1Y[edgeStride];
+	_mesh.m_plane1W = &_mesh.m_plane1Z[edgeStride];
+	_mesh.m_faceX   = &_mesh.m_plane1W[edgeStride];
+	_mesh.m_faceY   = &_mesh.m_faceX[faceStride];
+	_mesh.m_faceZ   = &_mesh.m_faceY[faceStride];
+	_mesh.m_faceW   = &_mesh.m_faceZ[faceStride];
+	_mesh.m_edgeI0  = (uint16_t*)&_mesh.m_faceW[faceStride];
+	_mesh.m_edgeI1  = &_mesh.m_edgeI0[edgeStride];
+}
+
+// Fill face planes and edge planes from face indices of edges.
+static void svMeshInit(SvMesh& _mesh, const uint16_t* _edgeIndices, const uint32_t* _edgeFaces, uint32_t _numEdges, const bgfx::VertexDecl& _decl, const uint8_t* _vertices, const uint16_t* _indices, uint32_t _numIndices)
+{
+	svMeshAlloc(_mesh, _numEdges, _numIndices/3);
+	_mesh.m_indices = _indices;
+	_mesh.m_vertices = _vertices;
+	_mesh.m_stride = _decl.getStride();
+
+	for (uint32_t ii = 0, num = _mesh.m_numFaces; ii < num; ++ii)
+	{
+		const float* v0 = (const float*)&_vertices[_indices[ii*3+0]*_mesh.m_stride];
+		const float* v1 = (const float*)&_vertices[_indices[ii*3+1]*_mesh.m_stride];
+		const float* v2 = (const float*)&_vertices[_indices[ii*3+2]*_mesh.m_stride];
+
+		// Plane faces away from clockwise front face.
+		const float vec0[3] = { v2[0] - v0[0], v2[1] - v0[1], v2[2] - v0[2] };
+		const float vec1[3] = { v1[0] - v2[0], v1[1] - v2[1], v1[2] - v2[2] };
+		float normal[3] =
+		{
+			vec0[1]*vec1[2] - vec0[2]*vec1[1],
+			vec0[2]*vec1[0] - vec0[0]*vec1[2],
+			vec0[0]*vec1[1] - vec0[1]*vec1[0],
+		};
+		const float len = sqrtf(normal[0]*normal[0] + normal[1]*normal[1] + normal[2]*normal[2]);
+		const float invLen = 0.0f < len ? 1.0f/len : 0.0f;
+		normal[0] *= invLen;
+		normal[1] *= invLen;
+		normal[2] *= invLen;
+
+		_mesh.m_faceX[ii] = normal[0];
+		_mesh.m_faceY[ii] = normal[1];
+		_mesh.m_faceZ[ii] = normal[2];
+		_mesh.m_faceW[ii] = -(normal[0]*v0[0] + normal[1]*v0[1] + normal[2]*v0[2]);
+	}
+
+	for (uint32_t ii = 0; ii < _numEdges; ++ii)
+	{
+		_mesh.m_edgeI0[ii] = _edgeIndices[ii*2+0];
+		_mesh.m_edgeI1[ii] = _edgeIndices[ii*2+1];
+
+		const uint32_t face0 = _edgeFaces[ii*2+0];
+		_mesh.m_plane0X[ii] = _mesh.m_faceX[face0];
+		_mesh.m_plane0Y[ii] = _mesh.m_faceY[face0];
+		_mesh.m_plane0Z[ii] = _mesh.m_faceZ[face0];
+		_mesh.m_plane0W[ii] = _mesh.m_faceW[face0];
+
+		const uint32_t face1 = _edgeFaces[ii*2+1];
+		if (UINT32_MAX != face1)
+		{
+			_mesh.m_plane1X[ii] = _mesh.m_faceX[face1];
+			_mesh.m_plane1Y[ii] = _mesh.m_faceY[face1];
+			_mesh.m_plane1Z[ii] = _mesh.m_faceZ[face1];
+			_mesh.m_plane1W[ii] = _mesh.m_faceW[face1];
+		}
+	}
+}
+
+void svMeshBuild(SvMesh& _mesh, const bgfx::VertexDecl& _decl, const uint8_t* _vertices, uint16_t _numVertices, const uint16_t* _indices, uint32_t _numIndices)
+{
+	uint16_t* weld = (uint16_t*)malloc(_numVertices*sizeof(uint16_t) );
+	bgfx::weldVertices(weld, _decl, _vertices, _numVertices, 0.0001f);
+
+	// Edge is shared by face with edge in i0, i1 order and face with edge in
+	// i1, i0 order. Edges of non-manifold meshes used by more faces are
+	// split into more edges.
+	typedef std::map<std::pair<uint16_t, uint16_t>, uint32_t> EdgeMap;
+	EdgeMap edgeMap;
+
+	std::vector<uint16_t> edgeIndices;
+	std::vector<uint32_t> edgeFaces;
+
+	for (uint32_t ii = 0, num = _numIndices/3; ii < num; ++ii)
+	{
+		const uint16_t ui[3] =
+		{
+			weld[_indices[ii*3+0] ],
+			weld[_indices[ii*3+1] ],
+			weld[_indices[ii*3+2] ],
+		};
+
+		for (uint32_t jj = 0; jj < 3; ++jj)
+		{
+			const uint16_t i0 = ui[jj];
+			const uint16_t i1 = ui[(jj+1)%3];
+			if (i0 == i1)
+			{
+				continue;
+			}
+
+			EdgeMap::iterator it = edgeMap.find(std::make_pair(i1, i0) );
+			if (it != edgeMap.end()
+			&&  UINT32_MAX == edgeFaces[it->second*2+1])
+			{
+				edgeFaces[it->second*2+1] = ii;
+				continue;
+			}
+
+			const uint32_t edge = uint32_t(edgeIndices.size()/2);
+			edgeMap[std::make_pair(i0, i1)] = edge;
+			edgeIndices.push_back(i0);
+			edgeIndices.push_back(i1);
+			edgeFaces.push_back(ii);
+			edgeFaces.push_back(UINT32_MAX);
+		}
+	}
+
+	free(weld);
+
+	const uint32_t numEdges = uint32_t(edgeFaces.size()/2);
+	svMeshInit(_mesh
+		, edgeIndices.empty() ? NULL : &edgeIndices[0]
+		, edgeFaces.empty() ? NULL : &edgeFaces[0]
+		, numEdges
+		, _decl
+		, _vertices
+		, _indices
+		, _numIndices
+		);
+}
+
+bool svMeshRead(bx::ReaderI* _reader, SvMesh& _mesh, const bgfx::VertexDecl& _decl, const uint8_t* _vertices, uint16_t _numVertices, const uint16_t* _indices, uint32_t _numIndices)
+{
+	uint32_t numEdges;
+	if (4 != bx::read(_reader, numEdges) )
+	{
+		return false;
+	}
+
+	// Each face adds at most 3 edges, this also keeps sizes below from
+	// overflowing.
+	if (numEdges > _numIndices)
+	{
+		return false;
+	}
+
+	std::vector<uint16_t> edgeIndices(numEdges*2+1);
+	std::vector<uint32_t> edgeFaces(numEdges*2+1);
+	const int32_t indicesSize = int32_t(numEdges*2*sizeof(uint16_t) );
+	const int32_t facesSize = int32_t(numEdges*2*sizeof(uint32_t) );
+	if (indicesSize != bx::read(_reader, &edgeIndices[0], indicesSize)
+	||  facesSize != bx::read(_reader, &edgeFaces[0], facesSize) )
+	{
+		return false;
+	}
+
+	const uint32_t numFaces = _numIndices/3;
+	for (uint32_t ii = 0; ii < numEdges; ++ii)
+	{
+		if (edgeIndices[ii*2] >= _numVertices
+		||  edgeIndices[ii*2+1] >= _numVertices
+		||  edgeFaces[ii*2] >= numFaces
+		|| (edgeFaces[ii*2+1] >= numFaces && UINT32_MAX != edgeFaces[ii*2+1]) )
+		{
+			return false;
+		}
+	}
+
+	svMeshInit(_mesh, &edgeIndices[0], &edgeFaces[0], numEdges, _decl, _vertices, _indices, _numIndices);
+
+	return true;
+}
+
+void svMeshFree(SvMesh& _mesh)
+{
+	free(_mesh.m_data);
+	_mesh.m_data = NULL;
+	_mesh.m_numEdges = 0;
+	_mesh.m_numFaces = 0;
+}
+
+static void svWriteSide(SvVolume& _volume, const SvMesh& _mesh, uint16_t _i0, uint16_t _i1, int32_t _k, uint32_t _num, bool _winding)
+{
+	const float* v0 = (const float*)&_mesh.m_vertices[_i0*_mesh.m_stride];
+	const float* v1 = (const float*)&_mesh.m_vertices[_i1*_mesh.m_stride];
+
+	const uint16_t index = uint16_t(_volume.m_vertices.size() );
+
+	SvVertex vertex;
+	vertex.m_k = float(_k);
+
+	memcpy(vertex.m_pos, v0, 3*sizeof(float) );
+	vertex.m_extrude = 0.0f;
+	_volume.m_vertices.push_back(vertex);
+	vertex.m_extrude = 1.0f;
+	_volume.m_vertices.push_back(vertex);
+
+	memcpy(vertex.m_pos, v1, 3*sizeof(float) );
+	vertex.m_extrude = 0.0f;
+	_volume.m_vertices.push_back(vertex);
+	vertex.m_extrude = 1.0f;
+	_volume.m_vertices.push_back(vertex);
+
+	const uint16_t winding = uint16_t(_winding);
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		_volume.m_indices.push_back(index);
+		_volume.m_indices.push_back(index + 2 - winding);
+		_volume.m_indices.push_back(index + 1 + winding);
+
+		_volume.m_indices.push_back(index + 2);
+		_volume.m_indices.push_back(index + 3 - winding*2);
+		_volume.m_indices.push_back(index + 1 + winding*2);
+	}
+}
+
+void svExtract(SvVolume& _volume, const SvMesh& _mesh, const float* _light, uint8_t _flags)
+{
+	_volume.m_vertices.clear();
+	_volume.m_indices.clear();
+	_volume.m_frontCap.clear();
+	_volume.m_backCap.clear();
+
+	const bool faceBased = 0 != (_flags & SV_FLAGS_FACE_BASED);
+	const bool textureAsStencil = 0 != (_flags & SV_FLAGS_TEXTURE_AS_STENCIL);
+
+	const float4_t lx = float4_splat(_light[0]);
+	const float4_t ly = float4_splat(_light[1]);
+	const float4_t lz = float4_splat(_light[2]);
+	const float4_t zero = float4_zero();
+	const float4_t two = float4_splat(2.0f);
+
+	BX_ALIGN_STRUCT_16(float k[4]);
+
+	// Sides beyond 16-bit index range are dropped.
+	const size_t maxVertices = SV_MAX_SIDES*4;
+
+	for (uint32_t ii = 0, num = _mesh.m_numEdges; ii < num && _volume.m_vertices.size() < maxVertices; ii += 4)
+	{
+		const float4_t f0 = float4_madd(float4_ld(&_mesh.m_plane0X[ii]), lx
+			, float4_madd(float4_ld(&_mesh.m_plane0Y[ii]), ly
+			, float4_madd(float4_ld(&_mesh.m_plane0Z[ii]), lz
+			, float4_ld(&_mesh.m_plane0W[ii]) ) ) );
+		const float4_t f1 = float4_madd(float4_ld(&_mesh.m_plane1X[ii]), lx
+			, float4_madd(float4_ld(&_mesh.m_plane1Y[ii]), ly
+			, float4_madd(float4_ld(&_mesh.m_plane1Z[ii]), lz
+			, float4_ld(&_mesh.m_plane1W[ii]) ) ) );
+
+		// k = 2*(front0 - front1), silhouette edges have non-zero k.
+		const float4_t front0 = float4_and(float4_cmpgt(f0, zero), two);
+		const float4_t front1 = float4_and(float4_cmpgt(f1, zero), two);
+		float4_st(k, float4_sub(front0, front1) );
+
+		for (uint32_t jj = 0, end = num-ii < 4 ? num-ii : 4; jj < end && _volume.m_vertices.size() < maxVertices; ++jj)
+		{
+			const int32_t edgeK = int32_t(k[jj]);
+			if (0 == edgeK)
+			{
+				continue;
+			}
+
+			const uint16_t i0 = _mesh.m_edgeI0[ii+jj];
+			const uint16_t i1 = _mesh.m_edgeI1[ii+jj];
+
+			if (faceBased)
+			{
+				// Side quad follows winding of front facing face.
+				if (0 < edgeK)
+				{
+					svWriteSide(_volume, _mesh, i0, i1, 1, 1, true);
+				}
+				else
+				{
+					svWriteSide(_volume, _mesh, i1, i0, 1, 1, true);
+				}
+			}
+			else
+			{
+				const int32_t stencilK = textureAsStencil ? 1 : edgeK;
+				svWriteSide(_volume, _mesh, i0, i1, edgeK, uint32_t(abs(stencilK) ), 0 < stencilK);
+			}
+		}
+	}
+
+	BX_WARN(_volume.m_vertices.size() < maxVertices, "Shadow volume sides are limited to %d, silhouette might be incomplete.", SV_MAX_SIDES);
+
+	if (0 == (_flags & SV_FLAGS_DEPTH_FAIL) )
+	{
+		return;
+	}
+
+	const uint32_t numCaps = faceBased || textureAsStencil ? 1 : 2;
+
+	BX_ALIGN_STRUCT_16(float facing[4]);
+
+	for (uint32_t ii = 0, num = _mesh.m_numFaces; ii < num; ii += 4)
+	{
+		const float4_t f = float4_madd(float4_ld(&_mesh.m_faceX[ii]), lx
+			, float4_madd(float4_ld(&_mesh.m_faceY[ii]), ly
+			, float4_madd(float4_ld(&_mesh.m_faceZ[ii]), lz
+			, float4_ld(&_mesh.m_faceW[ii]) ) ) );
+		float4_st(facing, f);
+
+		for (uint32_t jj = 0, end = num-ii < 4 ? num-ii : 4; jj < end; ++jj)
+		{
+			const uint16_t* indices = &_mesh.m_indices[(ii+jj)*3];
+			std::vector<uint16_t>& cap = 0.0f < facing[jj] ? _volume.m_frontCap : _volume.m_backCap;
+
+			for (uint32_t kk = 0; kk < numCaps; ++kk)
+			{
+				cap.push_back(indices[0]);
+				cap.push_back(indices[1]);
+				cap.push_back(indices[2]);
+			}
+		}
+	}
+}
+
+ShadowVolumeBatch::ShadowVolumeBatch(uint32_t _numThreads)
+	: m_numThreads(_numThreads < 1 ? 1 : _numThreads > SV_MAX_THREADS ? SV_MAX_THREADS : _numThreads)
+	, m_exit(false)
+	, m_page(0)
+{
+	// Worker 0 is calling thread.
+	for (uint32_t ii = 1; ii < m_numThreads; ++ii)
+	{
+		Worker& worker = m_worker[ii];
+		worker.m_batch = this;
+		worker.m_index = ii;
+		worker.m_thread.init(workerFunc, &worker);
+	}
+}
+
+ShadowVolumeBatch::~ShadowVolumeBatch()
+{
+	m_exit = true;
+	for (uint32_t ii = 1; ii < m_numThreads; ++ii)
+	{
+		m_worker[ii].m_start.post();
+		m_worker[ii].m_thread.shutdown();
+	}
+}
+
+void ShadowVolumeBatch::begin()
+{
+	m_jobs.clear();
+	m_page ^= 1;
+}
+
+uint32_t ShadowVolumeBatch::add(const SvMesh& _mesh, const float* _light, uint8_t _flags)
+{
+	Job job;
+	job.m_mesh = &_mesh;
+	job.m_light[0] = _light[0];
+	job.m_light[1] = _light[1];
+	job.m_light[2] = _light[2];
+	job.m_flags = _flags;
+	m_jobs.push_back(job);
+
+	return uint32_t(m_jobs.size()-1);
+}
+
+void ShadowVolumeBatch::run()
+{
+	std::vector<SvVolume>& volumes = m_volumes[m_page];
+	if (volumes.size() < m_jobs.size() )
+	{
+		volumes.resize(m_jobs.size() );
+	}
+
+	const uint32_t numJobs = uint32_t(m_jobs.size() );
+	const uint32_t numThreads = numJobs < m_numThreads ? numJobs : m_numThreads;
+
+	for (uint32_t ii = 1; ii < numThreads; ++ii)
+	{
+		m_worker[ii].m_start.post();
+	}
+
+	execute(0);
+
+	for (uint32_t ii = 1; ii < numThreads; ++ii)
+	{
+		m_done.wait();
+	}
+}
+
+int32_t ShadowVolumeBatch::workerFunc(void* _userData)
+{
+	Worker* worker = (Worker*)_userData;
+	ShadowVolumeBatch* batch = worker->m_batch;
+
+	for (;;)
+	{
+		worker->m_start.wait();
+		if (batch->m_exit)
+		{
+			break;
+		}
+
+		batch->execute(worker->m_index);
+		batch->m_done.post();
+	}
+
+	return 0;
+}
+
+void ShadowVolumeBatch::execute(uint32_t _index)
+{
+	// Jobs are interleaved between threads, jobs of one light are next to
+	// each other so each thread gets share of every light.
+	std::vector<SvVolume>& volumes = m_volumes[m_page];
+	for (uint32_t ii = _index, num = uint32_t(m_jobs.size() ); ii < num; ii += m_numThreads)
+	{
+		const Job& job = m_jobs[ii];
+		svExtract(volumes[ii], *job.m_mesh, job.m_light, job.m_flags);
+	}
+}
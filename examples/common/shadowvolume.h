@@ -0,0 +1,173 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#ifndef SHADOWVOLUME_H_HEADER_GUARD
+#define SHADOWVOLUME_H_HEADER_GUARD
+
+#include <vector>
+
+#include <bgfx.h>
+#include <bx/bx.h>
+#include <bx/readerwriter.h>
+#include <bx/sem.h>
+#include <bx/thread.h>
+
+#define SV_MAX_THREADS 16
+#define SV_MAX_SIDES ( (UINT16_MAX+1)/4)
+
+#define SV_FLAGS_DEPTH_FAIL         UINT8_C(0x01) //!< Write front and back caps.
+#define SV_FLAGS_FACE_BASED         UINT8_C(0x02) //!< One side quad per silhouette edge, oriented by front face.
+#define SV_FLAGS_TEXTURE_AS_STENCIL UINT8_C(0x04) //!< Side quads and caps are written once.
+
+/// Shadow volume side vertex, position, extrusion (0 or 1), and edge
+/// multiplier. Multiplier is 2 when only face 0 of edge faces light, -2
+/// when only face 1 does, and 1 for SV_FLAGS_FACE_BASED.
+struct SvVertex
+{
+	float m_pos[3];
+	float m_extrude;
+	float m_k;
+};
+
+/// Edge adjacency and face planes of mesh group, stored as structure of
+/// arrays, 16 byte aligned and padded to multiple of 4.
+///
+/// Edge connects welded vertices m_edgeI0 and m_edgeI1, plane 0 is plane
+/// of face with edge in i0, i1 order, and plane 1 is plane of face with
+/// edge in i1, i0 order. Plane 1 of open edges is zero.
+///
+struct SvMesh
+{
+	uint32_t m_numEdges;
+	uint16_t* m_edgeI0;
+	uint16_t* m_edgeI1;
+	float* m_plane0X;
+	float* m_plane0Y;
+	float* m_plane0Z;
+	float* m_plane0W;
+	float* m_plane1X;
+	float* m_plane1Y;
+	float* m_plane1Z;
+	float* m_plane1W;
+
+	uint32_t m_numFaces;
+	const uint16_t* m_indices; //!< Group indices, not owned.
+	float* m_faceX;
+	float* m_faceY;
+	float* m_faceZ;
+	float* m_faceW;
+
+	const uint8_t* m_vertices; //!< Group vertices, position first, not owned.
+	uint16_t m_stride;
+
+	void* m_data;
+};
+
+/// Build edge adjacency from triangle list, vertices with the same
+/// position are welded.
+void svMeshBuild(SvMesh& _mesh, const bgfx::VertexDecl& _decl, const uint8_t* _vertices, uint16_t _numVertices, const uint16_t* _indices, uint32_t _numIndices);
+
+/// Read edge adjacency from ADJ chunk (geometryc --adjacency), chunk
+/// magic is already read.
+///
+/// @returns False if stream is corrupted, or if edges don't match group
+///   vertices and indices.
+///
+bool svMeshRead(bx::ReaderI* _reader, SvMesh& _mesh, const bgfx::VertexDecl& _decl, const uint8_t* _vertices, uint16_t _numVertices, const uint16_t* _indices, uint32_t _numIndices);
+
+void svMeshFree(SvMesh& _mesh);
+
+/// Shadow volume geometry for one mesh and light. Side vertices are
+/// indexed with 16-bit indices, each silhouette edge adds 4 vertices, so
+/// volume has at most SV_MAX_SIDES sides.
+struct SvVolume
+{
+	std::vector<SvVertex> m_vertices;
+	std::vector<uint16_t> m_indices;
+	std::vector<uint16_t> m_frontCap;  //!< Indices into group vertex buffer.
+	std::vector<uint16_t> m_backCap;   //!< Indices into group vertex buffer.
+};
+
+/// Extract silhouette edges and write shadow volume, four edges and
+/// faces are tested against light at the time.
+///
+/// @param _volume Output, previous content is discarded.
+/// @param _mesh Mesh.
+/// @param _light Light position in model space.
+/// @param _flags SV_FLAGS_*.
+///
+void svExtract(SvVolume& _volume, const SvMesh& _mesh, const float* _light, uint8_t _flags);
+
+/// Shadow volumes of many meshes and lights extracted in parallel.
+///
+/// Jobs are added on calling thread, and distributed between worker
+/// threads by run. Volumes are double buffered, volumes of previous frame
+/// stay valid after begin, so they can be referenced by bgfx::makeRef
+/// until frame is rendered.
+///
+/// Usage:
+///
+///   batch.begin();
+///   job = batch.add(mesh, light, flags);
+///   batch.run();
+///   const SvVolume& volume = batch.getVolume(job);
+///
+class ShadowVolumeBatch
+{
+public:
+	/// @param _numThreads Total number of threads including calling
+	///   thread, up to SV_MAX_THREADS.
+	ShadowVolumeBatch(uint32_t _numThreads);
+	~ShadowVolumeBatch();
+
+	/// Start new frame, clear jobs.
+	void begin();
+
+	/// @returns Job index.
+	uint32_t add(const SvMesh& _mesh, const float* _light, uint8_t _flags);
+
+	void run();
+
+	const SvVolume& getVolume(uint32_t _job) const
+	{
+		return m_volumes[m_page][_job];
+	}
+
+	uint32_t getNumJobs() const
+	{
+		return uint32_t(m_jobs.size() );
+	}
+
+private:
+	struct Job
+	{
+		const SvMesh* m_mesh;
+		float m_light[3];
+		uint8_t m_flags;
+	};
+
+	struct Worker
+	{
+		ShadowVolumeBatch* m_batch;
+		uint32_t m_index;
+		bx::Thread m_thread;
+		bx::Semaphore m_start;
+	};
+
+	static int32_t workerFunc(void* _userData);
+
+	void execute(uint32_t _index);
+
+	Worker m_worker[SV_MAX_THREADS];
+	bx::Semaphore m_done;
+	uint32_t m_numThreads;
+	bool m_exit;
+
+	std::vector<Job> m_jobs;
+	std::vector<SvVolume> m_volumes[2];
+	uint32_t m_page;
+};
+
+#endif // SHADOWVOLUME_H_HEADER_GUARD
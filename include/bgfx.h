@@ -238,6 +238,7 @@
 #define BGFX_TEXTURE_COMPARE_ALWAYS      UINT32_C(0x00080000)
 #define BGFX_TEXTURE_COMPARE_SHIFT       16
 #define BGFX_TEXTURE_COMPARE_MASK        UINT32_C(0x000f0000)
+#define BGFX_TEXTURE_STREAMING           UINT32_C(0x00100000)
 #define BGFX_TEXTURE_RESERVED_SHIFT      24
 #define BGFX_TEXTURE_RESERVED_MASK       UINT32_C(0xff000000)
 
@@ -265,6 +266,24 @@
 #define BGFX_RESET_VSYNC                 UINT32_C(0x00000080)
 #define BGFX_RESET_CAPTURE               UINT32_C(0x00000100)
 
+///
+#define BGFX_VERTEX_QUANTIZE_NONE              UINT32_C(0x00000000)
+#define BGFX_VERTEX_QUANTIZE_POSITION_HALF     UINT32_C(0x00000001)
+#define BGFX_VERTEX_QUANTIZE_NORMAL_UINT8      UINT32_C(0x00000002)
+#define BGFX_VERTEX_QUANTIZE_NORMAL_OCTAHEDRAL UINT32_C(0x00000004)
+#define BGFX_VERTEX_QUANTIZE_TANGENT_UINT8     UINT32_C(0x00000008)
+#define BGFX_VERTEX_QUANTIZE_COLOR_UINT8       UINT32_C(0x00000010)
+#define BGFX_VERTEX_QUANTIZE_WEIGHT_UINT8      UINT32_C(0x00000020)
+#define BGFX_VERTEX_QUANTIZE_TEXCOORD_HALF     UINT32_C(0x00000040)
+#define BGFX_VERTEX_QUANTIZE_DEFAULT (0 \
+			| BGFX_VERTEX_QUANTIZE_POSITION_HALF \
+			| BGFX_VERTEX_QUANTIZE_NORMAL_UINT8 \
+			| BGFX_VERTEX_QUANTIZE_TANGENT_UINT8 \
+			| BGFX_VERTEX_QUANTIZE_COLOR_UINT8 \
+			| BGFX_VERTEX_QUANTIZE_WEIGHT_UINT8 \
+			| BGFX_VERTEX_QUANTIZE_TEXCOORD_HALF \
+			)
+
 ///
 #define BGFX_CAPS_TEXTURE_FORMAT_BC1     UINT64_C(0x0000000000000001)
 #define BGFX_CAPS_TEXTURE_FORMAT_BC2     UINT64_C(0x0000000000000002)
@@ -297,6 +316,7 @@
 #define BGFX_CAPS_RENDERER_MULTITHREADED UINT64_C(0x0000000020000000)
 #define BGFX_CAPS_FRAGMENT_DEPTH         UINT64_C(0x0000000040000000)
 #define BGFX_CAPS_BLEND_INDEPENDENT      UINT64_C(0x0000000080000000)
+#define BGFX_CAPS_TEXTURE_2D_ARRAY       UINT64_C(0x0000000100000000)
 
 #define BGFX_CAPS_TEXTURE_DEPTH_MASK (0 \
 			| BGFX_CAPS_TEXTURE_FORMAT_D16 \
@@ -454,14 +474,18 @@ namespace bgfx
 	};
 
 	static const uint16_t invalidHandle = UINT16_MAX;
+	static const uint16_t invalidView = UINT16_MAX; //!< All 8-bit values are valid view ids.
 
 	BGFX_HANDLE(DynamicIndexBufferHandle);
 	BGFX_HANDLE(DynamicVertexBufferHandle);
 	BGFX_HANDLE(FrameBufferHandle);
+	BGFX_HANDLE(FrameGraphTargetHandle);
 	BGFX_HANDLE(IndexBufferHandle);
 	BGFX_HANDLE(ProgramHandle);
 	BGFX_HANDLE(ShaderHandle);
+	BGFX_HANDLE(StateHandle);
 	BGFX_HANDLE(TextureHandle);
+	BGFX_HANDLE(UniformBlockHandle);
 	BGFX_HANDLE(UniformHandle);
 	BGFX_HANDLE(VertexBufferHandle);
 	BGFX_HANDLE(VertexDeclHandle);
@@ -503,6 +527,26 @@ namespace bgfx
 
 		/// Captured frame.
 		virtual void captureFrame(const void* _data, uint32_t _size) = 0;
+
+		/// Called when streamed texture mip level becomes resident, and
+		/// sampling from texture will use it.
+		///
+		/// NOTE:
+		///   This callback is called from render thread. bgfx API can't be
+		///   called from render thread, application should queue request
+		///   and act on it from main thread.
+		///
+		virtual void textureMipResident(TextureHandle _handle, uint8_t _mip) = 0;
+
+		/// Called when texture which top mips were dropped by texture
+		/// residency manager is used again. Mips from 0 up to, but not
+		/// including _mip should be provided again with updateTexture2D.
+		///
+		/// NOTE:
+		///   bgfx API can't be called from render thread, application
+		///   should queue request and update texture from main thread.
+		///
+		virtual void textureRestream(TextureHandle _handle, uint8_t _mip) = 0;
 	};
 
 	inline CallbackI::~CallbackI()
@@ -575,6 +619,35 @@ namespace bgfx
 		uint8_t bitsPerPixel;
 	};
 
+	/// View mask, one bit per view. Mask constructed from uint32_t
+	/// selects views 0-31.
+	struct ViewMask
+	{
+		ViewMask(uint32_t _mask = 0)
+		{
+			m_mask[0] = _mask;
+			for (uint32_t ii = 1; ii < 8; ++ii)
+			{
+				m_mask[ii] = 0;
+			}
+		}
+
+		/// Add view to mask.
+		ViewMask& add(uint8_t _id)
+		{
+			m_mask[_id/32] |= UINT32_C(1)<<(_id%32);
+			return *this;
+		}
+
+		/// Returns true if view is in mask.
+		bool has(uint8_t _id) const
+		{
+			return 0 != (m_mask[_id/32] & (UINT32_C(1)<<(_id%32) ) );
+		}
+
+		uint32_t m_mask[8];
+	};
+
 	/// Vertex declaration.
 	struct VertexDecl
 	{
@@ -640,8 +713,110 @@ namespace bgfx
 	/// @param _srcData Source vertex stream data.
 	/// @param _num Number of vertices to convert from source to destination.
 	///
+	/// NOTE:
+	///   Builds conversion ops on every call. When converting multiple
+	///   vertex streams between the same declarations use VertexConverter.
+	///
 	void vertexConvert(const VertexDecl& _destDecl, void* _destData, const VertexDecl& _srcDecl, const void* _srcData, uint32_t _num = 1);
 
+	/// Vertex stream converter between two vertex stream formats.
+	///
+	/// Conversion ops are resolved once in init, and vertices are converted
+	/// in blocks with specialized kernels for Float to Half, Uint8 and
+	/// Int16 attributes. Other conversions fall back to vertexUnpack and
+	/// vertexPack.
+	///
+	struct VertexConverter
+	{
+		/// Resolve conversion ops.
+		///
+		/// @param _destDecl Destination vertex stream declaration.
+		/// @param _srcDecl Source vertex stream declaration.
+		///
+		void init(const VertexDecl& _destDecl, const VertexDecl& _srcDecl);
+
+		/// Convert vertex stream data.
+		///
+		/// @param _destData Destination vertex stream.
+		/// @param _srcData Source vertex stream data.
+		/// @param _num Number of vertices to convert from source to destination.
+		///
+		void convert(void* _destData, const void* _srcData, uint32_t _num = 1) const;
+
+		struct Op
+		{
+			uint16_t m_src;
+			uint16_t m_dest;
+			uint8_t m_attr;
+			uint8_t m_kernel;
+			uint8_t m_srcNum;
+			uint8_t m_destNum;
+			uint8_t m_size;
+			bool m_asInt;
+		};
+
+		VertexDecl m_destDecl;
+		VertexDecl m_srcDecl;
+		Op m_op[Attrib::Count];
+		uint8_t m_numOps;
+		bool m_copy;
+	};
+
+	/// Build compact vertex declaration for float vertex stream.
+	///
+	/// @param _destDecl Compact vertex stream declaration.
+	/// @param _srcDecl Source vertex stream declaration. Only AttribType::Float
+	///   attributes are quantized, other attributes are kept as is.
+	/// @param _flags Quantization flags:
+	///   `BGFX_VERTEX_QUANTIZE_POSITION_HALF` - Position as AttribType::Half.
+	///   `BGFX_VERTEX_QUANTIZE_NORMAL_UINT8` - Normal as 4 AttribType::Uint8
+	///     packed with asInt, same as geometryc --packnormal 1.
+	///   `BGFX_VERTEX_QUANTIZE_NORMAL_OCTAHEDRAL` - Normal as 2 AttribType::Int16
+	///     octahedral encoded. Vertex shader must decode normal.
+	///   `BGFX_VERTEX_QUANTIZE_TANGENT_UINT8` - Tangent as 4 AttribType::Uint8
+	///     packed with asInt.
+	///   `BGFX_VERTEX_QUANTIZE_COLOR_UINT8` - Color0 and Color1 as 4
+	///     normalized AttribType::Uint8.
+	///   `BGFX_VERTEX_QUANTIZE_WEIGHT_UINT8` - Weight as normalized
+	///     AttribType::Uint8.
+	///   `BGFX_VERTEX_QUANTIZE_TEXCOORD_HALF` - TexCoord0-7 as AttribType::Half.
+	///
+	/// NOTE:
+	///   AttribType::Half requires BGFX_CAPS_VERTEX_ATTRIB_HALF.
+	///
+	void vertexQuantizeDecl(VertexDecl& _destDecl, const VertexDecl& _srcDecl, uint32_t _flags = BGFX_VERTEX_QUANTIZE_DEFAULT);
+
+	/// Pick most compact vertex declaration for float vertex stream that
+	/// keeps quantization error of every attribute within tolerance.
+	///
+	/// @param _destDecl Compact vertex stream declaration.
+	/// @param _srcDecl Source vertex stream declaration.
+	/// @param _srcData Source vertex stream data.
+	/// @param _num Number of vertices in source vertex stream.
+	/// @param _maxError Maximal absolute per component error.
+	/// @param _flags Quantization flags of allowed encodings, see
+	///   vertexQuantizeDecl.
+	///
+	void vertexQuantizePick(VertexDecl& _destDecl, const VertexDecl& _srcDecl, const void* _srcData, uint32_t _num, float _maxError, uint32_t _flags = BGFX_VERTEX_QUANTIZE_DEFAULT);
+
+	/// Quantize float vertex stream into compact vertex stream.
+	///
+	/// @param _destDecl Compact vertex stream declaration, created with
+	///   vertexQuantizeDecl, vertexQuantizePick or by user.
+	/// @param _destData Destination vertex stream.
+	/// @param _srcDecl Source vertex stream declaration.
+	/// @param _srcData Source vertex stream data.
+	/// @param _num Number of vertices to quantize.
+	/// @param _error Optional output of maximal absolute per component error
+	///   for each attribute.
+	/// @returns Maximal absolute per component error of all attributes.
+	///
+	/// NOTE:
+	///   Normal with 2 components in destination and 3 or more in source is
+	///   octahedral encoded, error is measured on decoded normal.
+	///
+	float vertexQuantize(const VertexDecl& _destDecl, void* _destData, const VertexDecl& _srcDecl, const void* _srcData, uint32_t _num, float _error[Attrib::Count] = NULL);
+
 	/// Weld vertices.
 	///
 	/// @param _output Welded vertices remapping table. The size of buffer
@@ -654,6 +829,41 @@ namespace bgfx
 	///
 	uint16_t weldVertices(uint16_t* _output, const VertexDecl& _decl, const void* _data, uint16_t _num, float _epsilon = 0.001f);
 
+	/// Weld vertices.
+	///
+	/// @param _output Welded vertices remapping table. The size of buffer
+	///   must be the same as number of vertices.
+	/// @param _decl Vertex stream declaration.
+	/// @param _data Vertex stream.
+	/// @param _num Number of vertices in vertex stream.
+	/// @param _epsilon Error tolerance for vertex position comparison.
+	/// @param _allocator Allocator for temporary hash table. When NULL CRT
+	///   allocator is used.
+	/// @returns Number of unique vertices after vertex welding.
+	///
+	/// NOTE:
+	///   Unlike 16-bit version this one doesn't use stack for hash table,
+	///   and it's suitable for vertex streams with millions of vertices.
+	///
+	uint32_t weldVertices(uint32_t* _output, const VertexDecl& _decl, const void* _data, uint32_t _num, float _epsilon = 0.001f, bx::ReallocatorI* _allocator = NULL);
+
+	/// Weld vertex stream, and generate index buffer for it.
+	///
+	/// @param _destData Unique vertices. The size of buffer must be large
+	///   enough to hold all source vertices.
+	/// @param _indices Index buffer. The size of buffer must be the same as
+	///   number of vertices.
+	/// @param _decl Vertex stream declaration.
+	/// @param _srcData Vertex stream, f.e. unindexed triangle list.
+	/// @param _num Number of vertices in vertex stream.
+	/// @param _epsilon Error tolerance for comparison of all vertex
+	///   attributes. When 0 vertices must be binary equal.
+	/// @param _allocator Allocator for temporary hash table. When NULL CRT
+	///   allocator is used.
+	/// @returns Number of unique vertices written into _destData.
+	///
+	uint32_t vertexWeld(void* _destData, uint32_t* _indices, const VertexDecl& _decl, const void* _srcData, uint32_t _num, float _epsilon = 0.0f, bx::ReallocatorI* _allocator = NULL);
+
 	/// Swizzle RGBA8 image to BGRA8.
 	///
 	/// @param _width Width of input image (pixels).
@@ -734,6 +944,29 @@ namespace bgfx
 	///
 	void setDebug(uint32_t _debug);
 
+	/// Set maximum amount of streamed texture data uploaded per frame.
+	///
+	/// @param _bytesPerFrame Budget in bytes. At least one pending update
+	///   for texture created with BGFX_TEXTURE_STREAMING flag is uploaded
+	///   each frame regardless of budget.
+	///
+	void setTextureStreamBudget(uint32_t _bytesPerFrame);
+
+	/// Set texture memory budget for texture residency manager.
+	///
+	/// @param _bytes Budget in bytes. When resident texture memory is over
+	///   budget, top mips of least recently used 2D textures are dropped,
+	///   and CallbackI::textureRestream is called once texture is used
+	///   again. Set to 0 to disable residency manager.
+	///
+	/// NOTE:
+	///   Texture storage is reallocated without dropped mips, and kept
+	///   mips are copied into it. When renderer can't copy texture data
+	///   (OpenGL without ARB_copy_image, OpenGL ES), kept mips are lost
+	///   and CallbackI::textureRestream asks for all mips.
+	///
+	void setTextureMemoryBudget(uint64_t _bytes);
+
 	/// Clear internal debug text buffer.
 	void dbgTextClear(uint8_t _attr = 0, bool _small = false);
 
@@ -917,6 +1150,10 @@ namespace bgfx
 	///   BGFX_TEXTURE_[MIN/MAG/MIP]_[POINT/ANISOTROPIC] - Point or anisotropic
 	///     sampling.
 	///
+	///   BGFX_TEXTURE_STREAMING - Texture mips are uploaded progressively.
+	///     Updates are applied within stream budget, and sampling is
+	///     clamped to mips that are resident. See: createTexture2D.
+	///
 	/// @param _skip Skip top level mips when parsing texture.
 	/// @param _info Returns parsed texture information.
 	/// @returns Texture handle.
@@ -932,6 +1169,12 @@ namespace bgfx
 	/// @param _flags
 	/// @param _mem
 	///
+	/// NOTE:
+	///   To stream texture create it with BGFX_TEXTURE_STREAMING flag and
+	///   without memory, then provide mips starting from the smallest one
+	///   with updateTexture2D. Once whole mip is updated and all smaller
+	///   mips are resident, CallbackI::textureMipResident is called.
+	///
 	TextureHandle createTexture2D(uint16_t _width, uint16_t _height, uint8_t _numMips, TextureFormat::Enum _format, uint32_t _flags = BGFX_TEXTURE_NONE, const Memory* _mem = NULL);
 
 	/// Create 3D texture.
@@ -946,6 +1189,22 @@ namespace bgfx
 	///
 	TextureHandle createTexture3D(uint16_t _width, uint16_t _height, uint16_t _depth, uint8_t _numMips, TextureFormat::Enum _format, uint32_t _flags = BGFX_TEXTURE_NONE, const Memory* _mem = NULL);
 
+	/// Create 2D texture array.
+	///
+	/// @param _width
+	/// @param _height
+	/// @param _numLayers Number of layers in texture array.
+	/// @param _numMips
+	/// @param _format
+	/// @param _flags
+	/// @param _mem Texture data. Layers are stored one after another, each
+	///   layer containing complete mip chain.
+	///
+	/// NOTE:
+	///   Availability depends on: BGFX_CAPS_TEXTURE_2D_ARRAY.
+	///
+	TextureHandle createTexture2DArray(uint16_t _width, uint16_t _height, uint16_t _numLayers, uint8_t _numMips, TextureFormat::Enum _format, uint32_t _flags = BGFX_TEXTURE_NONE, const Memory* _mem = NULL);
+
 	/// Create Cube texture.
 	///
 	/// @param _size
@@ -984,6 +1243,21 @@ namespace bgfx
 	///
 	void updateTexture3D(TextureHandle _handle, uint8_t _mip, uint16_t _x, uint16_t _y, uint16_t _z, uint16_t _width, uint16_t _height, uint16_t _depth, const Memory* _mem);
 
+	/// Update 2D texture array layer.
+	///
+	/// @param _handle
+	/// @param _layer Layer in texture array.
+	/// @param _mip
+	/// @param _x
+	/// @param _y
+	/// @param _width
+	/// @param _height
+	/// @param _mem
+	/// @param _pitch Pitch of input image (bytes). When _pitch is set to
+	///   UINT16_MAX, it will be calculated internally based on _width.
+	///
+	void updateTexture2DArray(TextureHandle _handle, uint16_t _layer, uint8_t _mip, uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height, const Memory* _mem, uint16_t _pitch = UINT16_MAX);
+
 	/// Update Cube texture.
 	///
 	/// @param _handle
@@ -1042,6 +1316,23 @@ namespace bgfx
 	/// Destroy frame buffer.
 	void destroyFrameBuffer(FrameBufferHandle _handle);
 
+	/// Allocate transient frame buffer.
+	///
+	/// @param _width Texture width.
+	/// @param _height Texture height.
+	/// @param _format Texture format.
+	/// @param _textureFlags Texture flags.
+	/// @param _firstView First view in which frame buffer is used.
+	/// @param _lastView Last view in which frame buffer is used.
+	///
+	/// NOTE:
+	///   Transient frame buffer is valid only for current frame, and it
+	///   must not be destroyed. Frame buffers are pooled and reused across
+	///   frames, and within frame between requests that have matching
+	///   size, format and flags, and non-overlapping view ranges.
+	///
+	FrameBufferHandle allocTransientFrameBuffer(uint16_t _width, uint16_t _height, TextureFormat::Enum _format, uint32_t _textureFlags = BGFX_TEXTURE_U_CLAMP|BGFX_TEXTURE_V_CLAMP, uint8_t _firstView = 0, uint8_t _lastView = UINT8_MAX);
+
 	/// Create shader uniform parameter.
 	///
 	/// @param _name Uniform name in shader.
@@ -1074,6 +1365,57 @@ namespace bgfx
 	/// Destroy shader uniform parameter.
 	void destroyUniform(UniformHandle _handle);
 
+	/// Create immutable render state block.
+	///
+	/// @param _state State flags. See: setState.
+	/// @param _rgba Blend factor. See: setState.
+	/// @param _fstencil Front stencil state. See: setStencil.
+	/// @param _bstencil Back stencil state. See: setStencil.
+	/// @param _samplerFlags Per stage texture sampler flags, used for
+	///   textures set with default flags (UINT32_MAX). NULL keeps texture
+	///   default sampler flags.
+	/// @param _numSamplers Number of elements in _samplerFlags.
+	///
+	/// NOTE:
+	///   State blocks are validated and packed once at creation, and
+	///   renderer translates them to native state objects at the same
+	///   time. Native state is set only when block changes between draw
+	///   primitives. Setting state block with setState(StateHandle)
+	///   replaces both setState and setStencil calls for draw primitive,
+	///   calling either of them afterwards falls back to raw state.
+	///
+	StateHandle createState(uint64_t _state, uint32_t _rgba = 0, uint32_t _fstencil = BGFX_STENCIL_NONE, uint32_t _bstencil = BGFX_STENCIL_NONE, const uint32_t* _samplerFlags = NULL, uint8_t _numSamplers = 0);
+
+	/// Destroy render state block.
+	void destroyState(StateHandle _handle);
+
+	/// Create uniform block.
+	///
+	/// Uniform block holds uniform values shared by many draw primitives,
+	/// like light lists or skinning palettes. Values are set once per frame
+	/// between beginUniformBlock and endUniformBlock, and block is bound to
+	/// draw primitive with setUniformBlock.
+	///
+	UniformBlockHandle createUniformBlock();
+
+	/// Destroy uniform block.
+	void destroyUniformBlock(UniformBlockHandle _handle);
+
+	/// Begin update of uniform block for this frame. Uniforms set with
+	/// setUniform until endUniformBlock are written into block instead of
+	/// draw primitive.
+	///
+	/// @param _handle Uniform block.
+	///
+	/// NOTE:
+	///   Block values are valid only for current frame. Updating block
+	///   again in the same frame replaces previous values.
+	///
+	void beginUniformBlock(UniformBlockHandle _handle);
+
+	/// End update of uniform block.
+	void endUniformBlock();
+
 	/// Set view name.
 	///
 	/// @param _id View id.
@@ -1102,7 +1444,7 @@ namespace bgfx
 	/// @param _width Width of view port region.
 	/// @param _height Height of view port region.
 	///
-	void setViewRectMask(uint32_t _viewMask, uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height);
+	void setViewRectMask(const ViewMask& _viewMask, uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height);
 
 	/// Set view scissor. Draw primitive outside view will be clipped. When
 	/// _x, _y, _width and _height are set to 0, scissor will be disabled.
@@ -1124,7 +1466,7 @@ namespace bgfx
 	/// @param _width Width of scissor region.
 	/// @param _height Height of scissor region.
 	///
-	void setViewScissorMask(uint32_t _viewMask, uint16_t _x = 0, uint16_t _y = 0, uint16_t _width = 0, uint16_t _height = 0);
+	void setViewScissorMask(const ViewMask& _viewMask, uint16_t _x = 0, uint16_t _y = 0, uint16_t _width = 0, uint16_t _height = 0);
 
 	/// Set view clear flags.
 	///
@@ -1138,14 +1480,14 @@ namespace bgfx
 	void setViewClear(uint8_t _id, uint8_t _flags, uint32_t _rgba = 0x000000ff, float _depth = 1.0f, uint8_t _stencil = 0);
 
 	/// Set view clear flags for multiple views.
-	void setViewClearMask(uint32_t _viewMask, uint8_t _flags, uint32_t _rgba = 0x000000ff, float _depth = 1.0f, uint8_t _stencil = 0);
+	void setViewClearMask(const ViewMask& _viewMask, uint8_t _flags, uint32_t _rgba = 0x000000ff, float _depth = 1.0f, uint8_t _stencil = 0);
 
 	/// Set view into sequential mode. Draw calls will be sorted in the same
 	/// order in which submit calls were called.
 	void setViewSeq(uint8_t _id, bool _enabled);
 
 	/// Set multiple views into sequential mode.
-	void setViewSeqMask(uint32_t _viewMask, bool _enabled);
+	void setViewSeqMask(const ViewMask& _viewMask, bool _enabled);
 
 	/// Set view frame buffer.
 	///
@@ -1163,14 +1505,58 @@ namespace bgfx
 	///   frame buffer handle will draw primitives from this view into
 	///   default back buffer.
 	///
-	void setViewFrameBufferMask(uint32_t _viewMask, FrameBufferHandle _handle);
+	void setViewFrameBufferMask(const ViewMask& _viewMask, FrameBufferHandle _handle);
+
+	/// Declare frame graph render target for current frame.
+	///
+	/// @param _width Texture width.
+	/// @param _height Texture height.
+	/// @param _format Texture format.
+	/// @param _textureFlags Texture flags.
+	///
+	/// NOTE:
+	///   Frame graph is optional layer over setViewFrameBuffer. Views
+	///   declare render targets they write and read with frameGraphWrite
+	///   and frameGraphRead, and frameGraphCompile culls views which
+	///   output is not used, and assigns frame buffers to views. Render
+	///   targets which lifetimes don't overlap share the same frame
+	///   buffer. Frame graph is reset on every bgfx::frame call.
+	///
+	FrameGraphTargetHandle frameGraphCreateTarget(uint16_t _width, uint16_t _height, TextureFormat::Enum _format, uint32_t _textureFlags = BGFX_TEXTURE_U_CLAMP|BGFX_TEXTURE_V_CLAMP);
+
+	/// Declare that view renders into frame graph render target. View can
+	/// write only one render target.
+	void frameGraphWrite(uint8_t _id, FrameGraphTargetHandle _handle);
+
+	/// Declare that view samples frame graph render target.
+	void frameGraphRead(uint8_t _id, FrameGraphTargetHandle _handle);
+
+	/// Cull views and assign frame buffers to frame graph render targets.
+	/// Views that don't write frame graph render target (back buffer, or
+	/// frame buffer set with setViewFrameBuffer) are never culled.
+	/// Frame buffer assignment lasts until next bgfx::frame call, after
+	/// that views get back frame buffer set with setViewFrameBuffer.
+	void frameGraphCompile();
+
+	/// Returns true if view was culled by frameGraphCompile. Application
+	/// should skip submitting draw calls to culled views.
+	bool frameGraphIsViewCulled(uint8_t _id);
+
+	/// Returns frame buffer assigned to frame graph render target by
+	/// frameGraphCompile, or invalid handle if render target is not used.
+	FrameBufferHandle frameGraphGetFrameBuffer(FrameGraphTargetHandle _handle);
 
 	/// Set view view and projection matrices, all draw primitives in this
 	/// view will use these matrices.
-	void setViewTransform(uint8_t _id, const void* _view, const void* _proj, uint8_t _other = 0xff);
+	///
+	/// @param _other View id of other view used for u_viewProjX. When set
+	///   to invalidView, view uses its own matrices. NOTE: 0xff is valid
+	///   view id 255, not "own matrices".
+	///
+	void setViewTransform(uint8_t _id, const void* _view, const void* _proj, uint16_t _other = invalidView);
 
 	/// Set view view and projection matrices for multiple views.
-	void setViewTransformMask(uint32_t _viewMask, const void* _view, const void* _proj, uint8_t _other = 0xff);
+	void setViewTransformMask(const ViewMask& _viewMask, const void* _view, const void* _proj, uint16_t _other = invalidView);
 
 	/// Sets debug marker.
 	void setMarker(const char* _marker);
@@ -1209,6 +1595,12 @@ namespace bgfx
 	///
 	void setStencil(uint32_t _fstencil, uint32_t _bstencil = BGFX_STENCIL_NONE);
 
+	/// Set render state block for draw primitive.
+	///
+	/// @param _handle State block created with createState.
+	///
+	void setState(StateHandle _handle);
+
 	/// Set scissor for draw primitive. For scissor for all primitives in
 	/// view see setViewScissor.
 	///
@@ -1247,6 +1639,17 @@ namespace bgfx
 	/// Set shader uniform parameter for draw primitive.
 	void setUniform(UniformHandle _handle, const void* _value, uint16_t _num = 1);
 
+	/// Set uniform block for draw primitive.
+	///
+	/// @param _handle Uniform block updated in this frame.
+	///
+	/// NOTE:
+	///   Block values are uploaded only when block or program changes
+	///   between draw primitives. Uniforms set with setUniform for draw
+	///   primitive override block values.
+	///
+	void setUniformBlock(UniformBlockHandle _handle);
+
 	/// Set index buffer for draw primitive.
 	void setIndexBuffer(IndexBufferHandle _handle, uint32_t _firstIndex = 0, uint32_t _numIndices = UINT32_MAX);
 
@@ -1321,7 +1724,7 @@ namespace bgfx
 	/// @param _depth Depth for sorting.
 	/// @returns Number of draw calls.
 	///
-	uint32_t submitMask(uint32_t _viewMask, int32_t _depth = 0);
+	uint32_t submitMask(const ViewMask& _viewMask, int32_t _depth = 0);
 
 	/// Discard all previously set state for draw call.
 	void discard();
@@ -0,0 +1,39 @@
+--
+-- Copyright 2010-2014 Branimir Karadzic. All rights reserved.
+-- License: http://www.opensource.org/licenses/BSD-2-Clause
+--
+
+project "bench"
+	uuid "4c8d2e61-f0a7-4b3e-9d15-6a2b7c9e0f43"
+	kind "ConsoleApp"
+
+	includedirs {
+		BX_DIR .. "include",
+		BGFX_DIR .. "include",
+		BGFX_DIR .. "examples/common",
+	}
+
+	files {
+		BGFX_DIR .. "src/vertexdecl.**",
+		BGFX_DIR .. "tools/bench/**.cpp",
+		BGFX_DIR .. "tools/bench/**.h",
+		BGFX_DIR .. "tools/geometryc/bounds.**",
+		BGFX_DIR .. "tools/geometryc/jobs.**",
+		BGFX_DIR .. "tools/geometryc/math.h",
+		BGFX_DIR .. "examples/common/bounds.h",
+		BGFX_DIR .. "examples/common/cull.**",
+		BGFX_DIR .. "examples/common/fpumath.h",
+		BGFX_DIR .. "examples/common/occlusion.**",
+	}
+
+	configuration { "linux-*" }
+		links {
+			"pthread",
+		}
+
+	configuration { "osx" }
+		links {
+			"Cocoa.framework",
+		}
+
+	strip()
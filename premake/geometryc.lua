@@ -21,6 +21,11 @@ project "geometryc"
 		BGFX_DIR .. "tools/geometryc/**.h",
 	}
 
+	configuration { "linux-*" }
+		links {
+			"pthread",
+		}
+
 	configuration { "osx" }
 		links {
 			"Cocoa.framework",
@@ -176,3 +176,4 @@ dofile "makedisttex.lua"
 dofile "shaderc.lua"
 dofile "texturec.lua"
 dofile "geometryc.lua"
+dofile "bench.lua"
@@ -127,6 +127,14 @@ namespace bgfx
 		virtual void captureFrame(const void* /*_data*/, uint32_t /*_size*/) BX_OVERRIDE
 		{
 		}
+
+		virtual void textureMipResident(TextureHandle /*_handle*/, uint8_t /*_mip*/) BX_OVERRIDE
+		{
+		}
+
+		virtual void textureRestream(TextureHandle /*_handle*/, uint8_t /*_mip*/) BX_OVERRIDE
+		{
+		}
 	};
 
 #ifndef BGFX_CONFIG_MEMORY_TRACKING
@@ -546,6 +554,278 @@ namespace bgfx
 		}
 	}
 
+	void FrameBufferPool::init()
+	{
+		m_num = 0;
+	}
+
+	void FrameBufferPool::shutdown()
+	{
+		BGFX_CHECK_MAIN_THREAD();
+
+		for (uint32_t ii = 0, num = m_num; ii < num; ++ii)
+		{
+			destroyFrameBuffer(m_entry[ii].m_handle);
+		}
+
+		m_num = 0;
+	}
+
+	FrameBufferHandle FrameBufferPool::alloc(uint16_t _width, uint16_t _height, TextureFormat::Enum _format, uint32_t _textureFlags, uint8_t _firstView, uint8_t _lastView, uint32_t _frame)
+	{
+		BGFX_CHECK_MAIN_THREAD();
+
+		const uint32_t firstView = bx::uint32_min(_firstView, BGFX_CONFIG_MAX_VIEWS-1);
+		const uint32_t lastView  = bx::uint32_max(firstView, bx::uint32_min(_lastView, BGFX_CONFIG_MAX_VIEWS-1) );
+
+		Entry* entry = NULL;
+
+		for (uint32_t ii = 0, num = m_num; ii < num && NULL == entry; ++ii)
+		{
+			Entry& candidate = m_entry[ii];
+			if (_width  == candidate.m_width
+			&&  _height == candidate.m_height
+			&&  _format == candidate.m_format
+			&&  _textureFlags == candidate.m_textureFlags)
+			{
+				if (_frame != candidate.m_lastFrame)
+				{
+					memset(candidate.m_views, 0, sizeof(candidate.m_views) );
+				}
+
+				bool overlap = false;
+				for (uint32_t view = firstView; view <= lastView && !overlap; ++view)
+				{
+					overlap = 0 != (candidate.m_views[view/32] & (UINT32_C(1)<<(view%32) ) );
+				}
+
+				if (!overlap)
+				{
+					entry = &candidate;
+				}
+			}
+		}
+
+		if (NULL == entry)
+		{
+			if (BGFX_CONFIG_MAX_TRANSIENT_FRAME_BUFFERS == m_num)
+			{
+				// Pool is full, replace least recently used frame buffer
+				// that is not used in this frame.
+				uint32_t oldest = UINT32_MAX;
+				for (uint32_t ii = 0, num = m_num; ii < num; ++ii)
+				{
+					if (_frame != m_entry[ii].m_lastFrame
+					&& (UINT32_MAX == oldest || m_entry[ii].m_lastFrame < m_entry[oldest].m_lastFrame) )
+					{
+						oldest = ii;
+					}
+				}
+
+				BX_WARN(UINT32_MAX != oldest, "Failed to allocate transient frame buffer, pool is full.");
+				if (UINT32_MAX == oldest)
+				{
+					FrameBufferHandle invalid = BGFX_INVALID_HANDLE;
+					return invalid;
+				}
+
+				destroyFrameBuffer(m_entry[oldest].m_handle);
+				m_entry[oldest] = m_entry[--m_num];
+			}
+
+			FrameBufferHandle handle = createFrameBuffer(_width, _height, _format, _textureFlags);
+			if (!isValid(handle) )
+			{
+				return handle;
+			}
+
+			entry = &m_entry[m_num++];
+			entry->m_handle = handle;
+			entry->m_textureFlags = _textureFlags;
+			entry->m_width = _width;
+			entry->m_height = _height;
+			entry->m_format = uint8_t(_format);
+			memset(entry->m_views, 0, sizeof(entry->m_views) );
+		}
+
+		entry->m_lastFrame = _frame;
+		for (uint32_t view = firstView; view <= lastView; ++view)
+		{
+			entry->m_views[view/32] |= UINT32_C(1)<<(view%32);
+		}
+
+		return entry->m_handle;
+	}
+
+	void FrameBufferPool::update(uint32_t _frame)
+	{
+		BGFX_CHECK_MAIN_THREAD();
+
+		for (uint32_t ii = 0; ii < m_num;)
+		{
+			Entry& entry = m_entry[ii];
+			if (_frame - entry.m_lastFrame > BGFX_CONFIG_TRANSIENT_FRAME_BUFFER_LIFETIME)
+			{
+				destroyFrameBuffer(entry.m_handle);
+				entry = m_entry[--m_num];
+			}
+			else
+			{
+				++ii;
+			}
+		}
+	}
+
+	void FrameGraph::init()
+	{
+		memset(m_assignedFb, 0xff, sizeof(m_assignedFb) );
+		reset();
+	}
+
+	void FrameGraph::reset()
+	{
+		memset(m_read, 0, sizeof(m_read) );
+		memset(m_write, 0xff, sizeof(m_write) );
+		memset(m_culled, 0, sizeof(m_culled) );
+		m_num = 0;
+	}
+
+	FrameGraphTargetHandle FrameGraph::createTarget(uint16_t _width, uint16_t _height, TextureFormat::Enum _format, uint32_t _textureFlags)
+	{
+		BX_WARN(BGFX_CONFIG_MAX_FRAME_GRAPH_TARGETS > m_num, "Failed to declare frame graph render target.");
+		if (BGFX_CONFIG_MAX_FRAME_GRAPH_TARGETS == m_num)
+		{
+			FrameGraphTargetHandle invalid = BGFX_INVALID_HANDLE;
+			return invalid;
+		}
+
+		FrameGraphTargetHandle handle = { m_num++ };
+		Target& target = m_target[handle.idx];
+		target.m_fb.idx = invalidHandle;
+		target.m_textureFlags = _textureFlags;
+		target.m_width = _width;
+		target.m_height = _height;
+		target.m_format = uint8_t(_format);
+
+		return handle;
+	}
+
+	void FrameGraph::write(uint8_t _id, FrameGraphTargetHandle _handle)
+	{
+		BX_CHECK(_handle.idx < m_num, "Invalid frame graph render target handle %d.", _handle.idx);
+		BX_WARN(invalidHandle == m_write[_id], "View %d already writes frame graph render target %d.", _id, m_write[_id]);
+		m_write[_id] = _handle.idx;
+	}
+
+	void FrameGraph::read(uint8_t _id, FrameGraphTargetHandle _handle)
+	{
+		BX_CHECK(_handle.idx < m_num, "Invalid frame graph render target handle %d.", _handle.idx);
+		m_read[_id][_handle.idx/32] |= UINT32_C(1)<<(_handle.idx%32);
+	}
+
+	void FrameGraph::compile(FrameBufferPool& _pool, uint32_t _frame, FrameBufferHandle* _fb)
+	{
+		// Compile might be called more than once per frame.
+		restore(_fb);
+
+		uint32_t needed[(BGFX_CONFIG_MAX_FRAME_GRAPH_TARGETS+31)/32];
+		memset(needed, 0, sizeof(needed) );
+
+		uint16_t firstView[BGFX_CONFIG_MAX_FRAME_GRAPH_TARGETS];
+		uint8_t lastView[BGFX_CONFIG_MAX_FRAME_GRAPH_TARGETS];
+		memset(firstView, 0xff, sizeof(firstView) );
+		memset(lastView, 0, sizeof(lastView) );
+
+		// Views are executed in order, so walking them backward every view
+		// that reads render target is visited before views that write it.
+		// View is alive if it doesn't write frame graph render target, or
+		// if render target it writes is read by view that is alive.
+		for (uint32_t ii = BGFX_CONFIG_MAX_VIEWS; ii > 0; --ii)
+		{
+			const uint32_t view = ii-1;
+			const uint16_t write = m_write[view];
+
+			m_culled[view] = invalidHandle != write
+				&& 0 == (needed[write/32] & (UINT32_C(1)<<(write%32) ) )
+				;
+
+			if (m_culled[view])
+			{
+				continue;
+			}
+
+			if (invalidHandle != write)
+			{
+				firstView[write] = uint16_t(view);
+				lastView[write] = uint8_t(bx::uint32_max(lastView[write], view) );
+			}
+
+			for (uint32_t jj = 0; jj < BX_COUNTOF(needed); ++jj)
+			{
+				needed[jj] |= m_read[view][jj];
+			}
+
+			for (uint16_t target = 0; target < m_num; ++target)
+			{
+				if (0 != (m_read[view][target/32] & (UINT32_C(1)<<(target%32) ) ) )
+				{
+					lastView[target] = uint8_t(bx::uint32_max(lastView[target], view) );
+				}
+			}
+		}
+
+		// Frame buffer pool shares frame buffers between requests with
+		// non-overlapping view ranges, which aliases render targets.
+		for (uint16_t target = 0; target < m_num; ++target)
+		{
+			Target& tgt = m_target[target];
+			tgt.m_fb.idx = invalidHandle;
+
+			if (UINT16_MAX != firstView[target])
+			{
+				tgt.m_fb = _pool.alloc(tgt.m_width
+					, tgt.m_height
+					, TextureFormat::Enum(tgt.m_format)
+					, tgt.m_textureFlags
+					, uint8_t(firstView[target])
+					, lastView[target]
+					, _frame
+					);
+			}
+		}
+
+		for (uint32_t view = 0; view < BGFX_CONFIG_MAX_VIEWS; ++view)
+		{
+			const uint16_t write = m_write[view];
+			if (invalidHandle != write
+			&&  !m_culled[view])
+			{
+				m_appFb[view] = _fb[view];
+				m_assignedFb[view] = m_target[write].m_fb;
+				_fb[view] = m_target[write].m_fb;
+			}
+		}
+	}
+
+	void FrameGraph::restore(FrameBufferHandle* _fb)
+	{
+		// Pooled frame buffers are valid only for frame in which graph was
+		// compiled. Put back frame buffer application set, unless
+		// application changed it after compile.
+		for (uint32_t view = 0; view < BGFX_CONFIG_MAX_VIEWS; ++view)
+		{
+			if (isValid(m_assignedFb[view]) )
+			{
+				if (_fb[view].idx == m_assignedFb[view].idx)
+				{
+					_fb[view] = m_appFb[view];
+				}
+
+				m_assignedFb[view].idx = invalidHandle;
+			}
+		}
+	}
+
 	const char* s_uniformTypeName[UniformType::Count] =
 	{
 		"int",
@@ -611,6 +891,22 @@ namespace bgfx
 		return PredefinedUniform::Count;
 	}
 
+	void Frame::resolveStateBlock()
+	{
+		if (invalidHandle != m_state.m_stateBlock)
+		{
+			const StateBlock& block = s_ctx->m_stateBlock[m_state.m_stateBlock];
+			for (uint32_t ii = 0; ii < BGFX_STATE_TEX_COUNT; ++ii)
+			{
+				Sampler& sampler = m_state.m_sampler[ii];
+				if (BGFX_SAMPLER_DEFAULT_FLAGS == sampler.m_flags)
+				{
+					sampler.m_flags = block.m_sampler[ii];
+				}
+			}
+		}
+	}
+
 	uint32_t Frame::submit(uint8_t _id, int32_t _depth)
 	{
 		if (m_discard)
@@ -631,6 +927,7 @@ namespace bgfx
 		{
 			m_key.m_depth = _depth;
 			m_key.m_view = _id;
+			m_usedViews[_id/32] |= UINT32_C(1)<<(_id%32);
 			m_key.m_seq = s_ctx->m_seq[_id] & s_ctx->m_seqMask[_id];
 			s_ctx->m_seq[_id]++;
 			uint64_t key = m_key.encode();
@@ -640,6 +937,7 @@ namespace bgfx
 
 			m_state.m_constEnd = m_constantBuffer->getPos();
 			m_state.m_flags |= m_flags;
+			resolveStateBlock();
 			m_renderState[m_numRenderStates] = m_state;
 			++m_numRenderStates;
 		}
@@ -650,7 +948,7 @@ namespace bgfx
 		return m_num;
 	}
 
-	uint32_t Frame::submitMask(uint32_t _viewMask, int32_t _depth)
+	uint32_t Frame::submitMask(const ViewMask& _viewMask, int32_t _depth)
 	{
 		if (m_discard)
 		{
@@ -661,7 +959,10 @@ namespace bgfx
 		if (BGFX_CONFIG_MAX_DRAW_CALLS-1 <= m_num
 		|| (0 == m_state.m_numVertices && 0 == m_state.m_numIndices) )
 		{
-			m_numDropped += bx::uint32_cntbits(_viewMask);
+			for (uint32_t ii = 0; ii < BGFX_VIEW_MASK_WORDS; ++ii)
+			{
+				m_numDropped += bx::uint32_cntbits(_viewMask.m_mask[ii]);
+			}
 			return m_num;
 		}
 
@@ -670,22 +971,28 @@ namespace bgfx
 		{
 			m_key.m_depth = _depth;
 
-			for (uint32_t id = 0, viewMask = _viewMask, ntz = bx::uint32_cnttz(_viewMask); 0 != viewMask; viewMask >>= 1, id += 1, ntz = bx::uint32_cnttz(viewMask) )
+			for (uint32_t ii = 0; ii < BGFX_VIEW_MASK_WORDS; ++ii)
 			{
-				viewMask >>= ntz;
-				id += ntz;
+				m_usedViews[ii] |= _viewMask.m_mask[ii];
 
-				m_key.m_view = id;
-				m_key.m_seq = s_ctx->m_seq[id] & s_ctx->m_seqMask[id];
-				s_ctx->m_seq[id]++;
-				uint64_t key = m_key.encode();
-				m_sortKeys[m_num] = key;
-				m_sortValues[m_num] = m_numRenderStates;
-				++m_num;
+				for (uint32_t id = ii*32, viewMask = _viewMask.m_mask[ii], ntz = bx::uint32_cnttz(viewMask); 0 != viewMask; viewMask >>= 1, id += 1, ntz = bx::uint32_cnttz(viewMask) )
+				{
+					viewMask >>= ntz;
+					id += ntz;
+
+					m_key.m_view = uint8_t(id);
+					m_key.m_seq = s_ctx->m_seq[id] & s_ctx->m_seqMask[id];
+					s_ctx->m_seq[id]++;
+					uint64_t key = m_key.encode();
+					m_sortKeys[m_num] = key;
+					m_sortValues[m_num] = m_numRenderStates;
+					++m_num;
+				}
 			}
 
 			m_state.m_constEnd = m_constantBuffer->getPos();
 			m_state.m_flags |= m_flags;
+			resolveStateBlock();
 			m_renderState[m_numRenderStates] = m_state;
 			++m_numRenderStates;
 		}
@@ -701,6 +1008,142 @@ namespace bgfx
 		bx::radixSort64(m_sortKeys, s_ctx->m_tempKeys, m_sortValues, s_ctx->m_tempValues, m_num);
 	}
 
+	void PredefinedMatrixCache::reset(const Frame* _frame, const Matrix4& _bias)
+	{
+		m_frame = _frame;
+		m_begin = 0;
+		m_end = 0;
+
+		// Only views with draw calls (and views they take matrices from)
+		// are valid, matrices of other views are stale.
+		for (uint32_t ii = 0; ii < BGFX_VIEW_MASK_WORDS; ++ii)
+		{
+			for (uint32_t id = ii*32, viewMask = _frame->m_usedViews[ii], ntz = bx::uint32_cnttz(viewMask); 0 != viewMask; viewMask >>= 1, id += 1, ntz = bx::uint32_cnttz(viewMask) )
+			{
+				viewMask >>= ntz;
+				id += ntz;
+
+				bx::float4x4_mul(&m_viewProj[id].un.f4x4, &_frame->m_view[id].un.f4x4, &_frame->m_proj[id].un.f4x4);
+			}
+		}
+
+		for (uint32_t ii = 0; ii < BGFX_VIEW_MASK_WORDS; ++ii)
+		{
+			for (uint32_t id = ii*32, viewMask = _frame->m_usedViews[ii], ntz = bx::uint32_cnttz(viewMask); 0 != viewMask; viewMask >>= 1, id += 1, ntz = bx::uint32_cnttz(viewMask) )
+			{
+				viewMask >>= ntz;
+				id += ntz;
+
+				bx::float4x4_mul(&m_viewProjBias[id].un.f4x4, &m_viewProj[_frame->m_other[id] ].un.f4x4, &_bias.un.f4x4);
+			}
+		}
+	}
+
+	void PredefinedMatrixCache::nextStamp()
+	{
+		++m_stamp;
+		if (0 == m_stamp)
+		{
+			memset(m_tag, 0, sizeof(m_tag) );
+			m_stamp = 1;
+		}
+	}
+
+	void PredefinedMatrixCache::prepare(uint32_t _item)
+	{
+		const Frame* frame = m_frame;
+		m_begin = _item;
+		m_end = bx::uint32_min(_item+BGFX_CONFIG_MAX_PREDEFINED_MATRIX_BATCH, frame->m_num);
+
+		// Find unique view and matrix index pairs of batch. Draws are sorted
+		// by view, so pairs of one view are found by matrix index only.
+		uint32_t num = 0;
+		uint16_t view = UINT16_MAX;
+		SortKey key;
+
+		for (uint32_t item = m_begin; item < m_end; ++item)
+		{
+			key.decode(frame->m_sortKeys[item]);
+			const uint8_t mask = m_mask[key.m_program];
+			if (0 == mask)
+			{
+				continue;
+			}
+
+			if (key.m_view != view)
+			{
+				view = key.m_view;
+				nextStamp();
+			}
+
+			const uint32_t matrix = frame->m_renderState[frame->m_sortValues[item] ].m_matrix;
+			if (m_stamp != m_tag[matrix])
+			{
+				m_tag[matrix] = m_stamp;
+				m_slot[matrix] = uint16_t(num);
+				m_pairMatrix[num] = matrix;
+				m_pairView[num] = uint8_t(view);
+				m_pairMask[num] = 0;
+				++num;
+			}
+
+			const uint16_t slot = m_slot[matrix];
+			m_pairMask[slot] |= mask;
+			m_draw[item-m_begin] = slot;
+		}
+
+		// Rows of view matrices are loaded once per view, and splatted
+		// model rows are shared by all products of pair.
+		using namespace bx;
+
+		view = UINT16_MAX;
+		float4_t vv[4];
+		float4_t vp[4];
+		float4_t vpx[4];
+
+		for (uint32_t ii = 0; ii < num; ++ii)
+		{
+			if (m_pairView[ii] != view)
+			{
+				view = m_pairView[ii];
+				for (uint32_t jj = 0; jj < 4; ++jj)
+				{
+					vv[jj]  = frame->m_view[view].un.f4x4.col[jj];
+					vp[jj]  = m_viewProj[view].un.f4x4.col[jj];
+					vpx[jj] = m_viewProjBias[view].un.f4x4.col[jj];
+				}
+			}
+
+			const uint8_t mask = m_pairMask[ii];
+			const float4x4_t& model = frame->m_matrixCache.m_cache[m_pairMatrix[ii] ].un.f4x4;
+			Matrix4* mtx = m_mtx[ii];
+
+			for (uint32_t jj = 0; jj < 4; ++jj)
+			{
+				const float4_t row  = model.col[jj];
+				const float4_t xxxx = float4_swiz_xxxx(row);
+				const float4_t yyyy = float4_swiz_yyyy(row);
+				const float4_t zzzz = float4_swiz_zzzz(row);
+				const float4_t wwww = float4_swiz_wwww(row);
+
+				if (0 != (mask & (1<<ModelView) ) )
+				{
+					mtx[ModelView].un.f4x4.col[jj] = float4_madd(wwww, vv[3], float4_madd(zzzz, vv[2], float4_madd(yyyy, vv[1], float4_mul(xxxx, vv[0]) ) ) );
+				}
+
+				if (0 != (mask & (1<<ModelViewProj) ) )
+				{
+					mtx[ModelViewProj].un.f4x4.col[jj] = float4_madd(wwww, vp[3], float4_madd(zzzz, vp[2], float4_madd(yyyy, vp[1], float4_mul(xxxx, vp[0]) ) ) );
+				}
+
+				if (0 != (mask & (1<<ModelViewProjX) ) )
+				{
+					mtx[ModelViewProjX].un.f4x4.col[jj] = float4_madd(wwww, vpx[3], float4_madd(zzzz, vpx[2], float4_madd(yyyy, vpx[1], float4_mul(xxxx, vpx[0]) ) ) );
+				}
+			}
+		}
+	}
+
 	const Caps* getCaps()
 	{
 		BGFX_CHECK_MAIN_THREAD();
@@ -764,6 +1207,7 @@ namespace bgfx
 		CAPS_FLAGS(BGFX_CAPS_RENDERER_MULTITHREADED),
 		CAPS_FLAGS(BGFX_CAPS_FRAGMENT_DEPTH),
 		CAPS_FLAGS(BGFX_CAPS_BLEND_INDEPENDENT),
+		CAPS_FLAGS(BGFX_CAPS_TEXTURE_2D_ARRAY),
 #undef CAPS_FLAGS
 	};
 
@@ -948,6 +1392,19 @@ namespace bgfx
 		m_render = &m_frame[0];
 		m_submit = &m_frame[1];
 		m_debug = BGFX_DEBUG_NONE;
+		m_textureStreamBudget = BGFX_CONFIG_TEXTURE_STREAM_BUDGET;
+		m_textureMemoryUsed = 0;
+		m_textureMemoryResident = 0;
+		m_textureMemoryBudget = BGFX_CONFIG_TEXTURE_MEMORY_BUDGET;
+
+		memset(m_uniformDirty, 0, sizeof(m_uniformDirty) );
+		memset(m_uniformOverride, 0, sizeof(m_uniformOverride) );
+
+		memset(m_textureRef, 0, sizeof(m_textureRef) );
+
+		memset(m_textureStream, 0, sizeof(m_textureStream) );
+		m_textureStreamRead = 0;
+		m_textureStreamNum = 0;
 
 		m_submit->create();
 		m_render->create();
@@ -989,6 +1446,8 @@ namespace bgfx
 
 		m_textVideoMemBlitter.init();
 		m_clearQuad.init();
+		m_frameBufferPool.init();
+		m_frameGraph.init();
 
 		m_submit->m_transientVb = createTransientVertexBuffer(BGFX_CONFIG_TRANSIENT_VERTEX_BUFFER_SIZE);
 		m_submit->m_transientIb = createTransientIndexBuffer(BGFX_CONFIG_TRANSIENT_INDEX_BUFFER_SIZE);
@@ -997,11 +1456,11 @@ namespace bgfx
 		m_submit->m_transientIb = createTransientIndexBuffer(BGFX_CONFIG_TRANSIENT_INDEX_BUFFER_SIZE);
 		frame();
 
-		for (uint8_t ii = 0; ii < BGFX_CONFIG_MAX_VIEWS; ++ii)
+		for (uint32_t ii = 0; ii < BGFX_CONFIG_MAX_VIEWS; ++ii)
 		{
 			char name[256];
 			bx::snprintf(name, sizeof(name), "%02d view", ii);
-			setViewName(ii, name);
+			setViewName(uint8_t(ii), name);
 		}
 	}
 
@@ -1014,6 +1473,7 @@ namespace bgfx
 		destroyTransientIndexBuffer(m_submit->m_transientIb);
 		m_textVideoMemBlitter.shutdown();
 		m_clearQuad.shutdown();
+		m_frameBufferPool.shutdown();
 		frame();
 
 		destroyTransientVertexBuffer(m_submit->m_transientVb);
@@ -1061,6 +1521,8 @@ namespace bgfx
 			CHECK_HANDLE_LEAK(m_textureHandle);
 			CHECK_HANDLE_LEAK(m_frameBufferHandle);
 			CHECK_HANDLE_LEAK(m_uniformHandle);
+			CHECK_HANDLE_LEAK(m_stateHandle);
+			CHECK_HANDLE_LEAK(m_uniformBlockHandle);
 
 #undef CHECK_HANDLE_LEAK
 		}
@@ -1122,11 +1584,17 @@ namespace bgfx
 		{
 			m_uniformHandle.free(_frame->m_freeUniformHandle[ii].idx);
 		}
+
+		for (uint16_t ii = 0, num = _frame->m_numFreeStateHandles; ii < num; ++ii)
+		{
+			m_stateHandle.free(_frame->m_freeStateHandle[ii].idx);
+		}
 	}
 
 	uint32_t Context::frame()
 	{
 		BX_CHECK(0 == m_instBufferCount, "Instance buffer allocated, but not used. This is incorrect, and causes memory leak.");
+		BX_CHECK(invalidHandle == m_submit->m_uniformBlockUpdate, "Uniform block %d update is not ended.", m_submit->m_uniformBlockUpdate);
 
 		// wait for render thread to finish
 		renderSemWait();
@@ -1147,18 +1615,143 @@ namespace bgfx
 #endif // BGFX_CONFIG_MULTITHREADED
 	}
 
+	uint32_t Context::calcTextureMipsSize(const TextureRef& _ref, uint8_t _startMip, uint8_t _endMip)
+	{
+		uint32_t size = 0;
+
+		for (uint8_t mip = _startMip; mip < _endMip; ++mip)
+		{
+			TextureInfo info;
+			calcTextureSize(info
+				, (uint16_t)bx::uint32_max(1, _ref.m_width >>mip)
+				, (uint16_t)bx::uint32_max(1, _ref.m_height>>mip)
+				, 1
+				, 1
+				, TextureFormat::Enum(_ref.m_format)
+				);
+			size += info.storageSize;
+		}
+
+		return size;
+	}
+
+	void Context::evictTextures()
+	{
+		if (0 == m_textureMemoryBudget
+		||  m_textureMemoryResident <= m_textureMemoryBudget)
+		{
+			return;
+		}
+
+		for (uint16_t ii = 0; ii < BGFX_CONFIG_MAX_TEXTURES; ++ii)
+		{
+			const TextureRef& ref = m_textureRef[ii];
+			if (0 < ref.m_refCount
+			&&  ref.m_evictable
+			&&  ref.m_lastUsed != m_frames
+			&&  ref.m_baseMip+1 < ref.m_numMips)
+			{
+				m_textureLru.add(ref.m_lastUsed, ii);
+			}
+		}
+
+		if (!m_textureLru.sort() )
+		{
+			return;
+		}
+
+		uint8_t* baseMip = m_textureLruBaseMip;
+		for (uint32_t ii = 0, num = m_textureLru.m_num; ii < num; ++ii)
+		{
+			baseMip[ii] = m_textureRef[m_textureLru.m_values[ii] ].m_baseMip;
+		}
+
+		// Drop one top mip at the time, starting from least recently used
+		// texture, until resident texture memory gets under budget. Render
+		// thread reallocates texture storage without dropped mips.
+		bool evicted = true;
+		while (evicted
+		&&     m_textureMemoryResident > m_textureMemoryBudget)
+		{
+			evicted = false;
+
+			for (uint32_t ii = 0, num = m_textureLru.m_num; ii < num && m_textureMemoryResident > m_textureMemoryBudget; ++ii)
+			{
+				TextureRef& ref = m_textureRef[m_textureLru.m_values[ii] ];
+				if (ref.m_baseMip+1 < ref.m_numMips)
+				{
+					const uint32_t size = calcTextureMipsSize(ref, ref.m_baseMip, ref.m_baseMip+1);
+					m_textureMemoryResident -= size;
+					ref.m_residentSize -= size;
+					++ref.m_baseMip;
+					evicted = true;
+				}
+			}
+		}
+
+		for (uint32_t ii = 0, num = m_textureLru.m_num; ii < num; ++ii)
+		{
+			const uint16_t idx = uint16_t(m_textureLru.m_values[ii]);
+			const TextureRef& ref = m_textureRef[idx];
+			if (baseMip[ii] != ref.m_baseMip)
+			{
+				TextureHandle handle = { idx };
+				CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::EvictTexture);
+				cmdbuf.write(handle);
+				cmdbuf.write(ref.m_baseMip);
+				cmdbuf.write(ref.m_width);
+				cmdbuf.write(ref.m_height);
+				cmdbuf.write(ref.m_numMips);
+			}
+		}
+
+		m_textureLru.reset();
+	}
+
 	void Context::swap()
 	{
 		freeDynamicBuffers();
+		m_frameBufferPool.update(m_frames);
+		m_frameGraph.reset();
+		evictTextures();
 		m_submit->m_resolution = m_resolution;
 		m_submit->m_debug = m_debug;
+		m_submit->m_textureStreamBudget = m_textureStreamBudget;
+		m_submit->m_textureMemoryUsed = m_textureMemoryUsed;
+		m_submit->m_textureMemoryResident = m_textureMemoryResident;
 		memcpy(m_submit->m_fb, m_fb, sizeof(m_fb) );
+		m_frameGraph.restore(m_fb);
 		memcpy(m_submit->m_clear, m_clear, sizeof(m_clear) );
 		memcpy(m_submit->m_rect, m_rect, sizeof(m_rect) );
 		memcpy(m_submit->m_scissor, m_scissor, sizeof(m_scissor) );
-		memcpy(m_submit->m_view, m_view, sizeof(m_view) );
-		memcpy(m_submit->m_proj, m_proj, sizeof(m_proj) );
 		memcpy(m_submit->m_other, m_other, sizeof(m_other) );
+
+		// Renderer reads matrices only for views with draw calls, copy just
+		// those and views they take shadow matrices from.
+		uint32_t* usedViews = m_submit->m_usedViews;
+		for (uint32_t ii = 0; ii < BGFX_VIEW_MASK_WORDS; ++ii)
+		{
+			for (uint32_t id = ii*32, viewMask = usedViews[ii], ntz = bx::uint32_cnttz(viewMask); 0 != viewMask; viewMask >>= 1, id += 1, ntz = bx::uint32_cnttz(viewMask) )
+			{
+				viewMask >>= ntz;
+				id += ntz;
+
+				const uint8_t other = m_other[id];
+				usedViews[other/32] |= UINT32_C(1)<<(other%32);
+			}
+		}
+
+		for (uint32_t ii = 0; ii < BGFX_VIEW_MASK_WORDS; ++ii)
+		{
+			for (uint32_t id = ii*32, viewMask = usedViews[ii], ntz = bx::uint32_cnttz(viewMask); 0 != viewMask; viewMask >>= 1, id += 1, ntz = bx::uint32_cnttz(viewMask) )
+			{
+				viewMask >>= ntz;
+				id += ntz;
+
+				memcpy(&m_submit->m_view[id], &m_view[id], sizeof(Matrix4) );
+				memcpy(&m_submit->m_proj[id], &m_proj[id], sizeof(Matrix4) );
+			}
+		}
 		m_submit->finish();
 
 		Frame* temp = m_render;
@@ -1184,6 +1777,7 @@ namespace bgfx
 		rendererExecCommands(m_render->m_cmdPre);
 		if (m_rendererInitialized)
 		{
+			flushTextureStream(m_render->m_textureStreamBudget);
 			rendererSubmit();
 		}
 		rendererExecCommands(m_render->m_cmdPost);
@@ -1193,7 +1787,7 @@ namespace bgfx
 		return m_exit;
 	}
 
-	void Context::rendererUpdateUniforms(ConstantBuffer* _constantBuffer, uint32_t _begin, uint32_t _end)
+	void Context::rendererUpdateUniforms(ConstantBuffer* _constantBuffer, uint32_t _begin, uint32_t _end, const uint32_t* _mask, uint32_t* _updated)
 	{
 		_constantBuffer->reset(_begin);
 		while (_constantBuffer->getPos() < _end)
@@ -1215,6 +1809,19 @@ namespace bgfx
 			const char* data = _constantBuffer->read(size);
 			if (UniformType::Count > type)
 			{
+				const uint32_t bit = UINT32_C(1)<<(loc%32);
+				if (NULL != _mask
+				&&  0 == (_mask[loc/32] & bit) )
+				{
+					continue;
+				}
+
+				m_uniformDirty[loc/32] |= bit;
+				if (NULL != _updated)
+				{
+					_updated[loc/32] |= bit;
+				}
+
 				if (copy)
 				{
 					rendererUpdateUniform(loc, data, size);
@@ -1231,6 +1838,50 @@ namespace bgfx
 		}
 	}
 
+	bool Context::rendererUpdateUniforms(const RenderState& _state, uint16_t& _uniformBlock)
+	{
+		bool changed = false;
+
+		if (_uniformBlock != _state.m_uniformBlock)
+		{
+			_uniformBlock = _state.m_uniformBlock;
+			memset(m_uniformOverride, 0, sizeof(m_uniformOverride) );
+
+			if (invalidHandle != _uniformBlock)
+			{
+				const UniformBlock& block = m_render->m_uniformBlock[_uniformBlock];
+				rendererUpdateUniforms(m_render->m_uniformBlockBuffer, block.m_begin, block.m_end);
+				changed = true;
+			}
+		}
+		else if (invalidHandle != _uniformBlock)
+		{
+			uint32_t overridden = 0;
+			for (uint32_t ii = 0; ii < BGFX_UNIFORM_MASK_WORDS; ++ii)
+			{
+				overridden |= m_uniformOverride[ii];
+			}
+
+			// Restore only block values previous draw call overrode.
+			if (0 != overridden)
+			{
+				const UniformBlock& block = m_render->m_uniformBlock[_uniformBlock];
+				rendererUpdateUniforms(m_render->m_uniformBlockBuffer, block.m_begin, block.m_end, m_uniformOverride);
+				memset(m_uniformOverride, 0, sizeof(m_uniformOverride) );
+				changed = true;
+			}
+		}
+
+		if (_state.m_constBegin < _state.m_constEnd)
+		{
+			uint32_t* updated = invalidHandle != _uniformBlock ? m_uniformOverride : NULL;
+			rendererUpdateUniforms(m_render->m_constantBuffer, _state.m_constBegin, _state.m_constEnd, NULL, updated);
+			changed = true;
+		}
+
+		return changed;
+	}
+
 	void Context::flushTextureUpdateBatch(CommandBuffer& _cmdbuf)
 	{
 		if (m_textureUpdateBatch.sort() )
@@ -1294,6 +1945,133 @@ namespace bgfx
 		}
 	}
 
+	bool Context::resizeTextureStream(TextureHandle _handle, uint8_t _skip)
+	{
+		TextureStream& stream = m_textureStream[_handle.idx];
+		if (_skip == stream.m_skip)
+		{
+			return true;
+		}
+
+		const uint16_t width  = uint16_t(bx::uint32_max(1, stream.m_width >>_skip) );
+		const uint16_t height = uint16_t(bx::uint32_max(1, stream.m_height>>_skip) );
+		const bool preserved = rendererResizeTexture(_handle, width, height, stream.m_numMips-_skip);
+		stream.m_skip = _skip;
+
+		if (!preserved)
+		{
+			stream.m_resident = 0;
+			stream.m_baseMip = stream.m_numMips;
+		}
+
+		return preserved;
+	}
+
+	void Context::updateTextureStreamBaseMip(TextureHandle _handle)
+	{
+		const TextureStream& stream = m_textureStream[_handle.idx];
+		const uint8_t baseMip = uint8_t(bx::uint32_min(stream.m_baseMip, stream.m_numMips-1) );
+		rendererUpdateTextureBaseMip(_handle, baseMip-stream.m_skip);
+	}
+
+	void Context::applyTextureStreamUpdate(const TextureStreamUpdate& _update)
+	{
+		const TextureHandle handle = _update.m_handle;
+		const uint8_t mip = _update.m_mip;
+
+		TextureStream& stream = m_textureStream[handle.idx];
+		if (mip < stream.m_skip)
+		{
+			// Mip was evicted after update was queued.
+			release(_update.m_mem);
+			return;
+		}
+
+		rendererUpdateTextureBegin(handle, _update.m_side, mip-stream.m_skip);
+		rendererUpdateTexture(handle, _update.m_side, mip-stream.m_skip, _update.m_rect, _update.m_z, _update.m_depth, _update.m_pitch, _update.m_mem);
+		rendererUpdateTextureEnd();
+
+		release(_update.m_mem);
+
+		const uint32_t width  = bx::uint32_max(1, stream.m_width >>mip);
+		const uint32_t height = bx::uint32_max(1, stream.m_height>>mip);
+		const Rect& rect = _update.m_rect;
+
+		if (0 == rect.m_x
+		&&  0 == rect.m_y
+		&&  width  <= rect.m_width
+		&&  height <= rect.m_height)
+		{
+			stream.m_resident |= UINT32_C(1)<<mip;
+
+			// Mip becomes usable only once all smaller mips are resident.
+			uint8_t baseMip = stream.m_baseMip;
+			while (0 < baseMip
+			&&     0 != (stream.m_resident & (UINT32_C(1)<<(baseMip-1) ) ) )
+			{
+				--baseMip;
+				g_callback->textureMipResident(handle, baseMip);
+			}
+
+			if (baseMip != stream.m_baseMip)
+			{
+				stream.m_baseMip = baseMip;
+				updateTextureStreamBaseMip(handle);
+			}
+		}
+
+		// Once all mips are resident and nothing is queued, updates go
+		// directly to texture again.
+		if (0 == stream.m_baseMip
+		&&  0 == stream.m_numQueued)
+		{
+			stream.m_streaming = false;
+		}
+	}
+
+	void Context::purgeTextureStream(TextureHandle _handle)
+	{
+		uint32_t num = 0;
+
+		for (uint32_t ii = 0, numUpdates = m_textureStreamNum; ii < numUpdates; ++ii)
+		{
+			const TextureStreamUpdate update = m_textureStreamQueue[(m_textureStreamRead + ii) % BGFX_CONFIG_MAX_TEXTURE_STREAM_UPDATES];
+
+			if (isValid(_handle)
+			&&  _handle.idx != update.m_handle.idx)
+			{
+				m_textureStreamQueue[(m_textureStreamRead + num) % BGFX_CONFIG_MAX_TEXTURE_STREAM_UPDATES] = update;
+				++num;
+			}
+			else
+			{
+				--m_textureStream[update.m_handle.idx].m_numQueued;
+				release(update.m_mem);
+			}
+		}
+
+		m_textureStreamNum = num;
+	}
+
+	void Context::flushTextureStream(uint32_t _budget)
+	{
+		uint32_t size = 0;
+
+		// At least one update is applied each frame, so that stream always
+		// makes progress even when budget is smaller than a single mip.
+		while (0 != m_textureStreamNum
+		&&    (0 == size || size < _budget) )
+		{
+			const TextureStreamUpdate update = m_textureStreamQueue[m_textureStreamRead];
+			m_textureStreamRead = (m_textureStreamRead + 1) % BGFX_CONFIG_MAX_TEXTURE_STREAM_UPDATES;
+			--m_textureStreamNum;
+			--m_textureStream[update.m_handle.idx].m_numQueued;
+
+			size += update.m_mem->size;
+			applyTextureStreamUpdate(update);
+		}
+	}
+
 	void Context::rendererExecCommands(CommandBuffer& _cmdbuf)
 	{
 		_cmdbuf.reset();
@@ -1319,6 +2097,9 @@ namespace bgfx
 				{
 					BX_CHECK(m_rendererInitialized, "This shouldn't happen! Bad synchronization?");
 					m_rendererInitialized = false;
+
+					TextureHandle invalid = BGFX_INVALID_HANDLE;
+					purgeTextureStream(invalid);
 				}
 				break;
 
@@ -1545,6 +2326,11 @@ namespace bgfx
 
 					rendererCreateTexture(handle, mem, flags, skip);
 
+					TextureStream& stream = m_textureStream[handle.idx];
+					stream.m_numQueued = 0;
+					stream.m_skip = 0;
+					stream.m_streaming = false;
+
 					bx::MemoryReader reader(mem->data, mem->size);
 
 					uint32_t magic;
@@ -1559,6 +2345,27 @@ namespace bgfx
 						{
 							release(tc.m_mem);
 						}
+						else if (0 != (flags & BGFX_TEXTURE_STREAMING) )
+						{
+							BX_WARN(!tc.m_cubeMap && 1 >= tc.m_depth && !tc.m_array
+								, "Texture streaming is supported only for 2D textures."
+								);
+
+							if (!tc.m_cubeMap
+							&&  1 >= tc.m_depth
+							&&  !tc.m_array)
+							{
+								const uint8_t startLod = uint8_t(bx::uint32_min(skip, tc.m_numMips-1) );
+								stream.m_resident = 0;
+								stream.m_width  = uint16_t(bx::uint32_max(1, tc.m_width >>startLod) );
+								stream.m_height = uint16_t(bx::uint32_max(1, tc.m_height>>startLod) );
+								stream.m_numMips = tc.m_numMips - startLod;
+								stream.m_baseMip = stream.m_numMips;
+								stream.m_streaming = true;
+
+								updateTextureStreamBaseMip(handle);
+							}
+						}
 					}
 
 					release(mem);
@@ -1583,6 +2390,32 @@ namespace bgfx
 					uint8_t mip;
 					_cmdbuf.read(mip);
 
+					if (m_textureStream[handle.idx].m_streaming)
+					{
+						TextureStreamUpdate update;
+						update.m_handle = handle;
+						update.m_side = side;
+						update.m_mip = mip;
+						_cmdbuf.read(update.m_rect);
+						_cmdbuf.read(update.m_z);
+						_cmdbuf.read(update.m_depth);
+						_cmdbuf.read(update.m_pitch);
+						_cmdbuf.read(update.m_mem);
+
+						if (BGFX_CONFIG_MAX_TEXTURE_STREAM_UPDATES == m_textureStreamNum)
+						{
+							BX_WARN(false, "Texture stream queue is full, update is applied immediately.");
+							applyTextureStreamUpdate(update);
+						}
+						else
+						{
+							m_textureStreamQueue[(m_textureStreamRead + m_textureStreamNum) % BGFX_CONFIG_MAX_TEXTURE_STREAM_UPDATES] = update;
+							++m_textureStreamNum;
+							++m_textureStream[handle.idx].m_numQueued;
+						}
+						break;
+					}
+
 					_cmdbuf.skip<Rect>();
 					_cmdbuf.skip<uint16_t>();
 					_cmdbuf.skip<uint16_t>();
@@ -1598,11 +2431,82 @@ namespace bgfx
 				}
 				break;
 
+			case CommandBuffer::EvictTexture:
+				{
+					TextureHandle handle;
+					_cmdbuf.read(handle);
+
+					uint8_t baseMip;
+					_cmdbuf.read(baseMip);
+
+					uint16_t width;
+					_cmdbuf.read(width);
+
+					uint16_t height;
+					_cmdbuf.read(height);
+
+					uint8_t numMips;
+					_cmdbuf.read(numMips);
+
+					// Evicted texture is switched to streaming mode, so that
+					// dropped mips can be provided again with updates.
+					TextureStream& stream = m_textureStream[handle.idx];
+					if (!stream.m_streaming)
+					{
+						stream.m_resident = (UINT32_C(1)<<numMips)-1;
+						stream.m_width = width;
+						stream.m_height = height;
+						stream.m_numMips = numMips;
+						stream.m_baseMip = 0;
+						stream.m_streaming = true;
+					}
+
+					stream.m_resident &= ~( (UINT32_C(1)<<baseMip)-1);
+					stream.m_baseMip = uint8_t(bx::uint32_max(stream.m_baseMip, baseMip) );
+
+					// Storage of dropped mips is released.
+					resizeTextureStream(handle, baseMip);
+					updateTextureStreamBaseMip(handle);
+				}
+				break;
+
+			case CommandBuffer::RestreamTexture:
+				{
+					TextureHandle handle;
+					_cmdbuf.read(handle);
+
+					uint8_t mip;
+					_cmdbuf.read(mip);
+
+					// Storage for all mips is allocated again before
+					// application provides dropped mips. When kept mips
+					// were lost during resize, all mips are requested.
+					TextureStream& stream = m_textureStream[handle.idx];
+					if (stream.m_streaming)
+					{
+						if (!resizeTextureStream(handle, 0) )
+						{
+							mip = stream.m_numMips;
+						}
+
+						updateTextureStreamBaseMip(handle);
+					}
+
+					g_callback->textureRestream(handle, mip);
+				}
+				break;
+
 			case CommandBuffer::DestroyTexture:
 				{
 					TextureHandle handle;
 					_cmdbuf.read(handle);
 
+					if (m_textureStream[handle.idx].m_streaming)
+					{
+						purgeTextureStream(handle);
+						m_textureStream[handle.idx].m_streaming = false;
+					}
+
 					rendererDestroyTexture(handle);
 				}
 				break;
@@ -1663,6 +2567,27 @@ namespace bgfx
 				}
 				break;
 
+			case CommandBuffer::CreateState:
+				{
+					StateHandle handle;
+					_cmdbuf.read(handle);
+
+					StateBlock block;
+					_cmdbuf.read(block);
+
+					rendererCreateState(handle, block);
+				}
+				break;
+
+			case CommandBuffer::DestroyState:
+				{
+					StateHandle handle;
+					_cmdbuf.read(handle);
+
+					rendererDestroyState(handle);
+				}
+				break;
+
 			case CommandBuffer::SaveScreenShot:
 				{
 					uint16_t len;
@@ -1729,6 +2654,18 @@ namespace bgfx
 		s_ctx->setDebug(_debug);
 	}
 
+	void setTextureStreamBudget(uint32_t _bytesPerFrame)
+	{
+		BGFX_CHECK_MAIN_THREAD();
+		s_ctx->setTextureStreamBudget(_bytesPerFrame);
+	}
+
+	void setTextureMemoryBudget(uint64_t _bytes)
+	{
+		BGFX_CHECK_MAIN_THREAD();
+		s_ctx->setTextureMemoryBudget(_bytes);
+	}
+
 	void dbgTextClear(uint8_t _attr, bool _small)
 	{
 		BGFX_CHECK_MAIN_THREAD();
@@ -1937,7 +2874,7 @@ namespace bgfx
 			height = bx::uint32_max(1, height);
 			depth  = bx::uint32_max(1, depth);
 
-			size += _width*_height*depth*bpp/8;
+			size += width*height*depth*bpp/8;
 
 			width >>= 1;
 			height >>= 1;
@@ -1991,9 +2928,11 @@ namespace bgfx
 		tc.m_height = _height;
 		tc.m_sides = 0;
 		tc.m_depth = 0;
+		tc.m_numLayers = 1;
 		tc.m_numMips = _numMips;
 		tc.m_format = uint8_t(_format);
 		tc.m_cubeMap = false;
+		tc.m_array = false;
 		tc.m_mem = _mem;
 		bx::write(&writer, tc);
 
@@ -2032,9 +2971,55 @@ namespace bgfx
 		tc.m_height = _height;
 		tc.m_sides = 0;
 		tc.m_depth = _depth;
+		tc.m_numLayers = 1;
+		tc.m_numMips = _numMips;
+		tc.m_format = uint8_t(_format);
+		tc.m_cubeMap = false;
+		tc.m_array = false;
+		tc.m_mem = _mem;
+		bx::write(&writer, tc);
+
+		return s_ctx->createTexture(mem, _flags, 0, NULL);
+	}
+
+	TextureHandle createTexture2DArray(uint16_t _width, uint16_t _height, uint16_t _numLayers, uint8_t _numMips, TextureFormat::Enum _format, uint32_t _flags, const Memory* _mem)
+	{
+		BGFX_CHECK_MAIN_THREAD();
+		BX_CHECK(0 != (g_caps.supported & BGFX_CAPS_TEXTURE_2D_ARRAY), "Texture2DArray is not supported! Use bgfx::getCaps to check backend renderer capabilities.");
+
+		_numLayers = bx::uint32_max(1, _numLayers);
+		_numMips = bx::uint32_max(1, _numMips);
+
+		if (BX_ENABLED(BGFX_CONFIG_DEBUG)
+		&&  NULL != _mem)
+		{
+			TextureInfo ti;
+			calcTextureSize(ti, _width, _height, 1, _numMips, _format);
+			BX_CHECK(ti.storageSize*_numLayers == _mem->size
+				, "createTexture2DArray: Texture storage size doesn't match passed memory size (storage size: %d, memory size: %d)"
+				, ti.storageSize*_numLayers
+				, _mem->size
+				);
+		}
+
+		uint32_t size = sizeof(uint32_t)+sizeof(TextureCreate);
+		const Memory* mem = alloc(size);
+
+		bx::StaticMemoryBlockWriter writer(mem->data, mem->size);
+		uint32_t magic = BGFX_CHUNK_MAGIC_TEX;
+		bx::write(&writer, magic);
+
+		TextureCreate tc;
+		tc.m_flags = _flags;
+		tc.m_width = _width;
+		tc.m_height = _height;
+		tc.m_sides = 0;
+		tc.m_depth = 0;
+		tc.m_numLayers = _numLayers;
 		tc.m_numMips = _numMips;
 		tc.m_format = uint8_t(_format);
 		tc.m_cubeMap = false;
+		tc.m_array = true;
 		tc.m_mem = _mem;
 		bx::write(&writer, tc);
 
@@ -2072,9 +3057,11 @@ namespace bgfx
 		tc.m_height = _size;
 		tc.m_sides = 6;
 		tc.m_depth = 0;
+		tc.m_numLayers = 1;
 		tc.m_numMips = _numMips;
 		tc.m_format = uint8_t(_format);
 		tc.m_cubeMap = true;
+		tc.m_array = false;
 		tc.m_mem = _mem;
 		bx::write(&writer, tc);
 
@@ -2118,6 +3105,21 @@ namespace bgfx
 		}
 	}
 
+	void updateTexture2DArray(TextureHandle _handle, uint16_t _layer, uint8_t _mip, uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height, const Memory* _mem, uint16_t _pitch)
+	{
+		BGFX_CHECK_MAIN_THREAD();
+		BX_CHECK(NULL != _mem, "_mem can't be NULL");
+		if (_width == 0
+		||  _height == 0)
+		{
+			release(_mem);
+		}
+		else
+		{
+			s_ctx->updateTexture(_handle, 0, _mip, _x, _y, _layer, _width, _height, 1, _pitch, _mem);
+		}
+	}
+
 	void updateTextureCube(TextureHandle _handle, uint8_t _side, uint8_t _mip, uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height, const Memory* _mem, uint16_t _pitch)
 	{
 		BGFX_CHECK_MAIN_THREAD();
@@ -2157,6 +3159,12 @@ namespace bgfx
 		return handle;
 	}
 
+	FrameBufferHandle allocTransientFrameBuffer(uint16_t _width, uint16_t _height, TextureFormat::Enum _format, uint32_t _textureFlags, uint8_t _firstView, uint8_t _lastView)
+	{
+		BGFX_CHECK_MAIN_THREAD();
+		return s_ctx->allocTransientFrameBuffer(_width, _height, _format, _textureFlags, _firstView, _lastView);
+	}
+
 	void destroyFrameBuffer(FrameBufferHandle _handle)
 	{
 		BGFX_CHECK_MAIN_THREAD();
@@ -2175,6 +3183,42 @@ namespace bgfx
 		s_ctx->destroyUniform(_handle);
 	}
 
+	StateHandle createState(uint64_t _state, uint32_t _rgba, uint32_t _fstencil, uint32_t _bstencil, const uint32_t* _samplerFlags, uint8_t _numSamplers)
+	{
+		BGFX_CHECK_MAIN_THREAD();
+		return s_ctx->createState(_state, _rgba, _fstencil, _bstencil, _samplerFlags, _numSamplers);
+	}
+
+	void destroyState(StateHandle _handle)
+	{
+		BGFX_CHECK_MAIN_THREAD();
+		s_ctx->destroyState(_handle);
+	}
+
+	UniformBlockHandle createUniformBlock()
+	{
+		BGFX_CHECK_MAIN_THREAD();
+		return s_ctx->createUniformBlock();
+	}
+
+	void destroyUniformBlock(UniformBlockHandle _handle)
+	{
+		BGFX_CHECK_MAIN_THREAD();
+		s_ctx->destroyUniformBlock(_handle);
+	}
+
+	void beginUniformBlock(UniformBlockHandle _handle)
+	{
+		BGFX_CHECK_MAIN_THREAD();
+		s_ctx->beginUniformBlock(_handle);
+	}
+
+	void endUniformBlock()
+	{
+		BGFX_CHECK_MAIN_THREAD();
+		s_ctx->endUniformBlock();
+	}
+
 	void setViewName(uint8_t _id, const char* _name)
 	{
 		BGFX_CHECK_MAIN_THREAD();
@@ -2187,7 +3231,7 @@ namespace bgfx
 		s_ctx->setViewRect(_id, _x, _y, _width, _height);
 	}
 
-	void setViewRectMask(uint32_t _viewMask, uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height)
+	void setViewRectMask(const ViewMask& _viewMask, uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height)
 	{
 		BGFX_CHECK_MAIN_THREAD();
 		s_ctx->setViewRectMask(_viewMask, _x, _y, _width, _height);
@@ -2199,7 +3243,7 @@ namespace bgfx
 		s_ctx->setViewScissor(_id, _x, _y, _width, _height);
 	}
 
-	void setViewScissorMask(uint32_t _viewMask, uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height)
+	void setViewScissorMask(const ViewMask& _viewMask, uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height)
 	{
 		BGFX_CHECK_MAIN_THREAD();
 		s_ctx->setViewScissorMask(_viewMask, _x, _y, _width, _height);
@@ -2211,7 +3255,7 @@ namespace bgfx
 		s_ctx->setViewClear(_id, _flags, _rgba, _depth, _stencil);
 	}
 
-	void setViewClearMask(uint32_t _viewMask, uint8_t _flags, uint32_t _rgba, float _depth, uint8_t _stencil)
+	void setViewClearMask(const ViewMask& _viewMask, uint8_t _flags, uint32_t _rgba, float _depth, uint8_t _stencil)
 	{
 		BGFX_CHECK_MAIN_THREAD();
 		s_ctx->setViewClearMask(_viewMask, _flags, _rgba, _depth, _stencil);
@@ -2223,7 +3267,7 @@ namespace bgfx
 		s_ctx->setViewSeq(_id, _enabled);
 	}
 
-	void setViewSeqMask(uint32_t _viewMask, bool _enabled)
+	void setViewSeqMask(const ViewMask& _viewMask, bool _enabled)
 	{
 		BGFX_CHECK_MAIN_THREAD();
 		s_ctx->setViewSeqMask(_viewMask, _enabled);
@@ -2235,19 +3279,55 @@ namespace bgfx
 		s_ctx->setViewFrameBuffer(_id, _handle);
 	}
 
-	void setViewFrameBufferMask(uint32_t _mask, FrameBufferHandle _handle)
+	void setViewFrameBufferMask(const ViewMask& _mask, FrameBufferHandle _handle)
 	{
 		BGFX_CHECK_MAIN_THREAD();
 		s_ctx->setViewFrameBufferMask(_mask, _handle);
 	}
 
-	void setViewTransform(uint8_t _id, const void* _view, const void* _proj, uint8_t _other)
+	FrameGraphTargetHandle frameGraphCreateTarget(uint16_t _width, uint16_t _height, TextureFormat::Enum _format, uint32_t _textureFlags)
+	{
+		BGFX_CHECK_MAIN_THREAD();
+		return s_ctx->frameGraphCreateTarget(_width, _height, _format, _textureFlags);
+	}
+
+	void frameGraphWrite(uint8_t _id, FrameGraphTargetHandle _handle)
+	{
+		BGFX_CHECK_MAIN_THREAD();
+		s_ctx->frameGraphWrite(_id, _handle);
+	}
+
+	void frameGraphRead(uint8_t _id, FrameGraphTargetHandle _handle)
+	{
+		BGFX_CHECK_MAIN_THREAD();
+		s_ctx->frameGraphRead(_id, _handle);
+	}
+
+	void frameGraphCompile()
+	{
+		BGFX_CHECK_MAIN_THREAD();
+		s_ctx->frameGraphCompile();
+	}
+
+	bool frameGraphIsViewCulled(uint8_t _id)
+	{
+		BGFX_CHECK_MAIN_THREAD();
+		return s_ctx->frameGraphIsViewCulled(_id);
+	}
+
+	FrameBufferHandle frameGraphGetFrameBuffer(FrameGraphTargetHandle _handle)
+	{
+		BGFX_CHECK_MAIN_THREAD();
+		return s_ctx->frameGraphGetFrameBuffer(_handle);
+	}
+
+	void setViewTransform(uint8_t _id, const void* _view, const void* _proj, uint16_t _other)
 	{
 		BGFX_CHECK_MAIN_THREAD();
 		s_ctx->setViewTransform(_id, _view, _proj, _other);
 	}
 
-	void setViewTransformMask(uint32_t _viewMask, const void* _view, const void* _proj, uint8_t _other)
+	void setViewTransformMask(const ViewMask& _viewMask, const void* _view, const void* _proj, uint16_t _other)
 	{
 		BGFX_CHECK_MAIN_THREAD();
 		s_ctx->setViewTransformMask(_viewMask, _view, _proj, _other);
@@ -2271,6 +3351,12 @@ namespace bgfx
 		s_ctx->setStencil(_fstencil, _bstencil);
 	}
 
+	void setState(StateHandle _handle)
+	{
+		BGFX_CHECK_MAIN_THREAD();
+		s_ctx->setState(_handle);
+	}
+
 	uint16_t setScissor(uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height)
 	{
 		BGFX_CHECK_MAIN_THREAD();
@@ -2301,6 +3387,12 @@ namespace bgfx
 		s_ctx->setUniform(_handle, _value, _num);
 	}
 
+	void setUniformBlock(UniformBlockHandle _handle)
+	{
+		BGFX_CHECK_MAIN_THREAD();
+		s_ctx->setUniformBlock(_handle);
+	}
+
 	void setIndexBuffer(IndexBufferHandle _handle, uint32_t _firstIndex, uint32_t _numIndices)
 	{
 		BGFX_CHECK_MAIN_THREAD();
@@ -2370,7 +3462,7 @@ namespace bgfx
 		return s_ctx->submit(_id, _depth);
 	}
 
-	uint32_t submitMask(uint32_t _viewMask, int32_t _depth)
+	uint32_t submitMask(const ViewMask& _viewMask, int32_t _depth)
 	{
 		BGFX_CHECK_MAIN_THREAD();
 		return s_ctx->submitMask(_viewMask, _depth);
@@ -223,9 +223,11 @@ namespace bgfx
 		uint16_t m_height;
 		uint16_t m_sides;
 		uint16_t m_depth;
+		uint16_t m_numLayers;
 		uint8_t m_numMips;
 		uint8_t m_format;
 		bool m_cubeMap;
+		bool m_array;
 		const Memory* m_mem;
 	};
 
@@ -298,6 +300,13 @@ namespace bgfx
 		return uint32_t( (_stencil >> (32*_0or1) ) );
 	}
 
+	inline uint8_t getTransSortOrder(uint64_t _state)
+	{
+		uint8_t blend = ( (_state&BGFX_STATE_BLEND_MASK)>>BGFX_STATE_BLEND_SHIFT)&0xff;
+		// transparency sort order table
+		return "\x0\x1\x1\x2\x2\x1\x2\x1\x2\x1\x1\x1\x1\x1\x1\x1\x1\x1\x1"[( (blend)&0xf) + (!!blend)];
+	}
+
 	void dump(const VertexDecl& _decl);
 
 	struct TextVideoMem
@@ -465,6 +474,56 @@ namespace bgfx
 		ProgramHandle m_program[BGFX_CONFIG_MAX_FRAME_BUFFER_ATTACHMENTS];
 	};
 
+	struct FrameBufferPool
+	{
+		void init();
+		void shutdown();
+		FrameBufferHandle alloc(uint16_t _width, uint16_t _height, TextureFormat::Enum _format, uint32_t _textureFlags, uint8_t _firstView, uint8_t _lastView, uint32_t _frame);
+		void update(uint32_t _frame);
+
+		struct Entry
+		{
+			FrameBufferHandle m_handle;
+			uint32_t m_textureFlags;
+			uint32_t m_lastFrame;
+			uint32_t m_views[(BGFX_CONFIG_MAX_VIEWS+31)/32];
+			uint16_t m_width;
+			uint16_t m_height;
+			uint8_t m_format;
+		};
+
+		Entry m_entry[BGFX_CONFIG_MAX_TRANSIENT_FRAME_BUFFERS];
+		uint16_t m_num;
+	};
+
+	struct FrameGraph
+	{
+		void init();
+		void reset();
+		FrameGraphTargetHandle createTarget(uint16_t _width, uint16_t _height, TextureFormat::Enum _format, uint32_t _textureFlags);
+		void write(uint8_t _id, FrameGraphTargetHandle _handle);
+		void read(uint8_t _id, FrameGraphTargetHandle _handle);
+		void compile(FrameBufferPool& _pool, uint32_t _frame, FrameBufferHandle* _fb);
+		void restore(FrameBufferHandle* _fb);
+
+		struct Target
+		{
+			FrameBufferHandle m_fb;
+			uint32_t m_textureFlags;
+			uint16_t m_width;
+			uint16_t m_height;
+			uint8_t m_format;
+		};
+
+		Target m_target[BGFX_CONFIG_MAX_FRAME_GRAPH_TARGETS];
+		uint32_t m_read[BGFX_CONFIG_MAX_VIEWS][(BGFX_CONFIG_MAX_FRAME_GRAPH_TARGETS+31)/32];
+		uint16_t m_write[BGFX_CONFIG_MAX_VIEWS];
+		bool m_culled[BGFX_CONFIG_MAX_VIEWS];
+		FrameBufferHandle m_appFb[BGFX_CONFIG_MAX_VIEWS];      //!< Frame buffer application set before compile.
+		FrameBufferHandle m_assignedFb[BGFX_CONFIG_MAX_VIEWS]; //!< Frame buffer compile assigned to view.
+		uint16_t m_num;
+	};
+
 	struct PredefinedUniform
 	{
 		enum Enum
@@ -516,8 +575,11 @@ namespace bgfx
 			CreateProgram,
 			CreateTexture,
 			UpdateTexture,
+			EvictTexture,
+			RestreamTexture,
 			CreateFrameBuffer,
 			CreateUniform,
+			CreateState,
 			UpdateViewName,
 			End,
 			RendererShutdownEnd,
@@ -531,6 +593,7 @@ namespace bgfx
 			DestroyTexture,
 			DestroyFrameBuffer,
 			DestroyUniform,
+			DestroyState,
 			SaveScreenShot,
 		};
 
@@ -613,15 +676,26 @@ namespace bgfx
 		void operator=(const CommandBuffer&);
 	};
 
+#if BGFX_CONFIG_MAX_VIEWS > 256
+#	error "BGFX_CONFIG_MAX_VIEWS must not be larger than 256, view id is 8-bit."
+#endif // BGFX_CONFIG_MAX_VIEWS > 256
+
+#define BGFX_VIEW_MASK_WORDS ( (BGFX_CONFIG_MAX_VIEWS+31)/32)
+#define BGFX_UNIFORM_MASK_WORDS ( (BGFX_CONFIG_MAX_UNIFORMS+31)/32)
+
 	struct SortKey
 	{
 		uint64_t encode()
 		{
 			// |               3               2               1               0|
 			// |fedcba9876543210fedcba9876543210fedcba9876543210fedcba9876543210|
-			// |             vvvvvsssssssssssttmmmmmmmmmdddddddddddddddddddddddd|
+			// |          vvvvvvvvsssssssssssttmmmmmmmmmdddddddddddddddddddddddd|
 			// |                 ^          ^ ^        ^                       ^|
 			// |                 |          | |        |                       ||
+			//
+			// v - view (8-bit, 0x2e), s - sequence (11-bit, 0x23), t - transparency
+			// (2-bit, 0x21), m - program (9-bit, 0x18), d - depth (24-bit). Bits
+			// above view are unused.
 
 			const uint64_t tmp0 = m_depth;
 			const uint64_t tmp1 = uint64_t(m_program)<<0x18;
@@ -745,6 +819,45 @@ namespace bgfx
 		uint16_t m_idx;
 	};
 
+	struct UniformBlock
+	{
+		uint32_t m_begin;
+		uint32_t m_end;
+	};
+
+	struct StateBlock
+	{
+		uint64_t m_flags;
+		uint64_t m_stencil;
+		uint32_t m_rgba;
+		uint32_t m_sampler[BGFX_STATE_TEX_COUNT];
+		uint8_t m_trans;
+	};
+
+	struct TextureStream
+	{
+		uint32_t m_resident;
+		uint16_t m_width;
+		uint16_t m_height;
+		uint16_t m_numQueued; //!< Updates waiting in stream queue.
+		uint8_t m_numMips;
+		uint8_t m_baseMip;
+		uint8_t m_skip;       //!< Top mips without storage in texture.
+		bool m_streaming;
+	};
+
+	struct TextureStreamUpdate
+	{
+		TextureHandle m_handle;
+		uint8_t m_side;
+		uint8_t m_mip;
+		Rect m_rect;
+		uint16_t m_z;
+		uint16_t m_depth;
+		uint16_t m_pitch;
+		Memory* m_mem;
+	};
+
 #define CONSTANT_OPCODE_TYPE_SHIFT 27
 #define CONSTANT_OPCODE_TYPE_MASK  UINT32_C(0xf8000000)
 #define CONSTANT_OPCODE_LOC_SHIFT  11
@@ -848,7 +961,10 @@ namespace bgfx
 		void writeUniform(UniformType::Enum _type, uint16_t _loc, const void* _value, uint16_t _num = 1);
 		void writeUniformHandle(UniformType::Enum _type, uint16_t _loc, UniformHandle _handle, uint16_t _num = 1);
 		void writeMarker(const char* _marker);
-		void commit();
+
+		/// Uploads constants. When _mask is not NULL, only uniforms with
+		/// handle bit set in _mask are uploaded.
+		void commit(const uint32_t* _mask = NULL);
 
 	private:
 		ConstantBuffer(uint32_t _size)
@@ -949,6 +1065,8 @@ namespace bgfx
 			m_numInstances = 1;
 			m_num = 1;
 			m_scissor = UINT16_MAX;
+			m_stateBlock = invalidHandle;
+			m_uniformBlock = invalidHandle;
 			m_vertexBuffer.idx = invalidHandle;
 			m_vertexDecl.idx = invalidHandle;
 			m_indexBuffer.idx = invalidHandle;
@@ -976,6 +1094,8 @@ namespace bgfx
 		uint16_t m_numInstances;
 		uint16_t m_num;
 		uint16_t m_scissor;
+		uint16_t m_stateBlock;
+		uint16_t m_uniformBlock;
 
 		VertexBufferHandle m_vertexBuffer;
 		VertexDeclHandle m_vertexDecl;
@@ -1033,6 +1153,7 @@ namespace bgfx
 		void create()
 		{
 			m_constantBuffer = ConstantBuffer::create(BGFX_CONFIG_MAX_CONSTANT_BUFFER_SIZE);
+			m_uniformBlockBuffer = ConstantBuffer::create(BGFX_CONFIG_MAX_UNIFORM_BLOCK_BUFFER_SIZE);
 			reset();
 			start();
 			m_textVideoMem = BX_NEW(g_allocator, TextVideoMem);
@@ -1041,6 +1162,7 @@ namespace bgfx
 		void destroy()
 		{
 			ConstantBuffer::destroy(m_constantBuffer);
+			ConstantBuffer::destroy(m_uniformBlockBuffer);
 			BX_DELETE(g_allocator, m_textVideoMem);
 		}
 
@@ -1066,6 +1188,10 @@ namespace bgfx
 			m_cmdPre.start();
 			m_cmdPost.start();
 			m_constantBuffer->reset();
+			m_uniformBlockBuffer->reset();
+			memset(m_uniformBlock, 0, sizeof(m_uniformBlock) );
+			m_uniformBlockUpdate = invalidHandle;
+			memset(m_usedViews, 0, sizeof(m_usedViews) );
 			m_discard = false;
 		}
 
@@ -1075,6 +1201,7 @@ namespace bgfx
 			m_cmdPost.finish();
 
 			m_constantBuffer->finish();
+			m_uniformBlockBuffer->finish();
 
 			if (0 < m_numDropped)
 			{
@@ -1093,16 +1220,42 @@ namespace bgfx
 
 		void setState(uint64_t _state, uint32_t _rgba)
 		{
-			uint8_t blend = ( (_state&BGFX_STATE_BLEND_MASK)>>BGFX_STATE_BLEND_SHIFT)&0xff;
-			// transparency sort order table
-			m_key.m_trans = "\x0\x1\x1\x2\x2\x1\x2\x1\x2\x1\x1\x1\x1\x1\x1\x1\x1\x1\x1"[( (blend)&0xf) + (!!blend)];
+			m_key.m_trans = getTransSortOrder(_state);
 			m_state.m_flags = _state;
 			m_state.m_rgba = _rgba;
+			m_state.m_stateBlock = invalidHandle;
+		}
+
+		void setState(StateHandle _handle, const StateBlock& _block)
+		{
+			m_key.m_trans = _block.m_trans;
+			m_state.m_flags = _block.m_flags;
+			m_state.m_stencil = _block.m_stencil;
+			m_state.m_rgba = _block.m_rgba;
+			m_state.m_stateBlock = _handle.idx;
 		}
 
 		void setStencil(uint32_t _fstencil, uint32_t _bstencil)
 		{
 			m_state.m_stencil = packStencil(_fstencil, _bstencil);
+			m_state.m_stateBlock = invalidHandle;
+		}
+
+		void beginUniformBlock(UniformBlockHandle _handle)
+		{
+			m_uniformBlockUpdate = _handle.idx;
+			m_uniformBlock[_handle.idx].m_begin = m_uniformBlockBuffer->getPos();
+		}
+
+		void endUniformBlock()
+		{
+			m_uniformBlock[m_uniformBlockUpdate].m_end = m_uniformBlockBuffer->getPos();
+			m_uniformBlockUpdate = invalidHandle;
+		}
+
+		void setUniformBlock(UniformBlockHandle _handle)
+		{
+			m_state.m_uniformBlock = _handle.idx;
 		}
 
 		uint16_t setScissor(uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height)
@@ -1207,8 +1360,9 @@ namespace bgfx
 			m_flags = BGFX_STATE_NONE;
 		}
 
+		void resolveStateBlock();
 		uint32_t submit(uint8_t _id, int32_t _depth);
-		uint32_t submitMask(uint32_t _viewMask, int32_t _depth);
+		uint32_t submitMask(const ViewMask& _viewMask, int32_t _depth);
 		void sort();
 
 		bool checkAvailTransientIndexBuffer(uint32_t _num)
@@ -1249,7 +1403,11 @@ namespace bgfx
 
 		void writeUniform(UniformType::Enum _type, UniformHandle _handle, const void* _value, uint16_t _num)
 		{
-			m_constantBuffer->writeUniform(_type, _handle.idx, _value, _num);
+			ConstantBuffer* constantBuffer = invalidHandle == m_uniformBlockUpdate
+				? m_constantBuffer
+				: m_uniformBlockBuffer
+				;
+			constantBuffer->writeUniform(_type, _handle.idx, _value, _num);
 		}
 
 		void free(IndexBufferHandle _handle)
@@ -1300,6 +1458,12 @@ namespace bgfx
 			++m_numFreeUniformHandles;
 		}
 
+		void free(StateHandle _handle)
+		{
+			m_freeStateHandle[m_numFreeStateHandles] = _handle;
+			++m_numFreeStateHandles;
+		}
+
 		void resetFreeHandles()
 		{
 			m_numFreeIndexBufferHandles = 0;
@@ -1310,6 +1474,7 @@ namespace bgfx
 			m_numFreeTextureHandles = 0;
 			m_numFreeFrameBufferHandles = 0;
 			m_numFreeUniformHandles = 0;
+			m_numFreeStateHandles = 0;
 		}
 
 		SortKey m_key;
@@ -1321,6 +1486,7 @@ namespace bgfx
 		Matrix4 m_view[BGFX_CONFIG_MAX_VIEWS];
 		Matrix4 m_proj[BGFX_CONFIG_MAX_VIEWS];
 		uint8_t m_other[BGFX_CONFIG_MAX_VIEWS];
+		uint32_t m_usedViews[BGFX_VIEW_MASK_WORDS]; //!< Views with draw calls, and their other views after swap.
 
 		uint64_t m_sortKeys[BGFX_CONFIG_MAX_DRAW_CALLS];
 		uint16_t m_sortValues[BGFX_CONFIG_MAX_DRAW_CALLS];
@@ -1329,6 +1495,9 @@ namespace bgfx
 		uint64_t m_flags;
 
 		ConstantBuffer* m_constantBuffer;
+		ConstantBuffer* m_uniformBlockBuffer;
+		UniformBlock m_uniformBlock[BGFX_CONFIG_MAX_UNIFORM_BLOCKS];
+		uint16_t m_uniformBlockUpdate; //!< Block between begin/endUniformBlock, or invalidHandle.
 
 		uint16_t m_num;
 		uint16_t m_numRenderStates;
@@ -1344,6 +1513,9 @@ namespace bgfx
 
 		Resolution m_resolution;
 		uint32_t m_debug;
+		uint32_t m_textureStreamBudget;
+		uint64_t m_textureMemoryUsed;
+		uint64_t m_textureMemoryResident;
 
 		CommandBuffer m_cmdPre;
 		CommandBuffer m_cmdPost;
@@ -1356,6 +1528,7 @@ namespace bgfx
 		uint16_t m_numFreeTextureHandles;
 		uint16_t m_numFreeFrameBufferHandles;
 		uint16_t m_numFreeUniformHandles;
+		uint16_t m_numFreeStateHandles;
 
 		IndexBufferHandle m_freeIndexBufferHandle[BGFX_CONFIG_MAX_INDEX_BUFFERS];
 		VertexDeclHandle m_freeVertexDeclHandle[BGFX_CONFIG_MAX_VERTEX_DECLS];
@@ -1365,6 +1538,7 @@ namespace bgfx
 		TextureHandle m_freeTextureHandle[BGFX_CONFIG_MAX_TEXTURES];
 		FrameBufferHandle m_freeFrameBufferHandle[BGFX_CONFIG_MAX_FRAME_BUFFERS];
 		UniformHandle m_freeUniformHandle[BGFX_CONFIG_MAX_UNIFORMS];
+		StateHandle m_freeStateHandle[BGFX_CONFIG_MAX_STATES];
 		TextVideoMem* m_textVideoMem;
 
 		int64_t m_waitSubmit;
@@ -1373,6 +1547,87 @@ namespace bgfx
 		bool m_discard;
 	};
 
+	/// Model view, model view projection and model view projection of other
+	/// view with bias, used by predefined uniforms. Products are computed
+	/// for batch of sorted draws at the time, once per view and matrix index
+	/// pair, and shared by all draws of batch with the same pair.
+	struct PredefinedMatrixCache
+	{
+		enum Enum
+		{
+			ModelView,
+			ModelViewProj,
+			ModelViewProjX,
+
+			Count
+		};
+
+		PredefinedMatrixCache()
+			: m_frame(NULL)
+			, m_begin(0)
+			, m_end(0)
+			, m_stamp(0)
+		{
+			memset(m_mask, 0, sizeof(m_mask) );
+			memset(m_tag, 0, sizeof(m_tag) );
+		}
+
+		void setProgram(uint16_t _idx, const PredefinedUniform* _predefined, uint8_t _num)
+		{
+			uint8_t mask = 0;
+			for (uint32_t ii = 0; ii < _num; ++ii)
+			{
+				switch (_predefined[ii].m_type)
+				{
+				case PredefinedUniform::ModelView:      mask |= 1<<ModelView;      break;
+				case PredefinedUniform::ModelViewProj:  mask |= 1<<ModelViewProj;  break;
+				case PredefinedUniform::ModelViewProjX: mask |= 1<<ModelViewProjX; break;
+				default: break;
+				}
+			}
+
+			m_mask[_idx] = mask;
+		}
+
+		/// Compute view projection matrices of frame, must be called after
+		/// frame is sorted.
+		void reset(const Frame* _frame, const Matrix4& _bias);
+
+		/// Matrix for draw _item of sorted frame, only valid when program of
+		/// draw uses it. Draws must be visited in order.
+		const Matrix4& get(uint32_t _item, Enum _type)
+		{
+			if (_item >= m_end)
+			{
+				prepare(_item);
+			}
+
+			return m_mtx[m_draw[_item-m_begin] ][_type];
+		}
+
+		Matrix4 m_viewProj[BGFX_CONFIG_MAX_VIEWS];
+		Matrix4 m_viewProjBias[BGFX_CONFIG_MAX_VIEWS]; //!< View projection of other view with bias.
+
+	private:
+		void prepare(uint32_t _item);
+		void nextStamp();
+
+		Matrix4 m_mtx[BGFX_CONFIG_MAX_PREDEFINED_MATRIX_BATCH][Count];
+		uint16_t m_draw[BGFX_CONFIG_MAX_PREDEFINED_MATRIX_BATCH];
+		uint32_t m_pairMatrix[BGFX_CONFIG_MAX_PREDEFINED_MATRIX_BATCH];
+		uint8_t m_pairView[BGFX_CONFIG_MAX_PREDEFINED_MATRIX_BATCH];
+		uint8_t m_pairMask[BGFX_CONFIG_MAX_PREDEFINED_MATRIX_BATCH];
+
+		uint32_t m_tag[BGFX_CONFIG_MAX_MATRIX_CACHE];
+		uint16_t m_slot[BGFX_CONFIG_MAX_MATRIX_CACHE];
+		uint8_t m_mask[BGFX_CONFIG_MAX_PROGRAMS];
+
+		const Frame* m_frame;
+		uint32_t m_begin;
+		uint32_t m_end;
+		uint32_t m_stamp;
+	};
+
 	struct VertexDeclRef
 	{
 		VertexDeclRef()
@@ -1561,6 +1816,10 @@ namespace bgfx
 			, m_instBufferCount(0)
 			, m_frames(0)
 			, m_debug(BGFX_DEBUG_NONE)
+			, m_textureStreamBudget(BGFX_CONFIG_TEXTURE_STREAM_BUDGET)
+			, m_textureMemoryUsed(0)
+			, m_textureMemoryResident(0)
+			, m_textureMemoryBudget(BGFX_CONFIG_TEXTURE_MEMORY_BUDGET)
 			, m_rendererInitialized(false)
 			, m_exit(false)
 		{
@@ -1606,6 +1865,16 @@ namespace bgfx
 			m_debug = _debug;
 		}
 
+		BGFX_API_FUNC(void setTextureStreamBudget(uint32_t _bytesPerFrame) )
+		{
+			m_textureStreamBudget = _bytesPerFrame;
+		}
+
+		BGFX_API_FUNC(void setTextureMemoryBudget(uint64_t _bytes) )
+		{
+			m_textureMemoryBudget = _bytes;
+		}
+
 		BGFX_API_FUNC(void dbgTextClear(uint8_t _attr, bool _small) )
 		{
 			m_submit->m_textVideoMem->resize(_small, (uint16_t)m_resolution.m_width, (uint16_t)m_resolution.m_height);
@@ -2170,10 +2439,12 @@ namespace bgfx
 
 		BGFX_API_FUNC(TextureHandle createTexture(const Memory* _mem, uint32_t _flags, uint8_t _skip, TextureInfo* _info) )
 		{
+			ImageContainer imageContainer;
+			const bool parsed = imageParse(imageContainer, _mem->data, _mem->size);
+
 			if (NULL != _info)
 			{
-				ImageContainer imageContainer;
-				if (imageParse(imageContainer, _mem->data, _mem->size) )
+				if (parsed)
 				{
 					calcTextureSize(*_info
 						, (uint16_t)imageContainer.m_width
@@ -2201,6 +2472,43 @@ namespace bgfx
 			{
 				TextureRef& ref = m_textureRef[handle.idx];
 				ref.m_refCount = 1;
+				ref.m_size = 0;
+				ref.m_residentSize = 0;
+				ref.m_lastUsed = m_frames;
+				ref.m_numMips = 0;
+				ref.m_baseMip = 0;
+				ref.m_evictable = false;
+
+				if (parsed)
+				{
+					const uint8_t startLod = uint8_t(bx::uint32_min(_skip, imageContainer.m_numMips-1) );
+					ref.m_width  = uint16_t(bx::uint32_max(1, imageContainer.m_width >>startLod) );
+					ref.m_height = uint16_t(bx::uint32_max(1, imageContainer.m_height>>startLod) );
+					ref.m_format = imageContainer.m_format;
+					ref.m_numMips = imageContainer.m_numMips - startLod;
+					ref.m_evictable = true
+						&& 0 == (_flags & BGFX_TEXTURE_RT_MASK)
+						&& !imageContainer.m_cubeMap
+						&& 1 >= imageContainer.m_depth
+						&& !imageContainer.m_array
+						;
+
+					TextureInfo info;
+					calcTextureSize(info
+						, ref.m_width
+						, ref.m_height
+						, (uint16_t)bx::uint32_max(1, imageContainer.m_depth>>startLod)
+						, ref.m_numMips
+						, TextureFormat::Enum(ref.m_format)
+						);
+					ref.m_size = info.storageSize
+						* (imageContainer.m_cubeMap ? 6 : 1)
+						* bx::uint32_max(1, imageContainer.m_numLayers)
+						;
+					ref.m_residentSize = ref.m_size;
+					m_textureMemoryUsed += ref.m_size;
+					m_textureMemoryResident += ref.m_residentSize;
+				}
 
 				CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::CreateTexture);
 				cmdbuf.write(handle);
@@ -2235,6 +2543,11 @@ namespace bgfx
 			int32_t refs = --ref.m_refCount;
 			if (0 == refs)
 			{
+				m_textureMemoryUsed -= ref.m_size;
+				m_textureMemoryResident -= ref.m_residentSize;
+				ref.m_size = 0;
+				ref.m_residentSize = 0;
+
 				CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::DestroyTexture);
 				cmdbuf.write(_handle);
 				m_submit->free(_handle);
@@ -2286,6 +2599,11 @@ namespace bgfx
 			return handle;
 		}
 
+		BGFX_API_FUNC(FrameBufferHandle allocTransientFrameBuffer(uint16_t _width, uint16_t _height, TextureFormat::Enum _format, uint32_t _textureFlags, uint8_t _firstView, uint8_t _lastView) )
+		{
+			return m_frameBufferPool.alloc(_width, _height, _format, _textureFlags, _firstView, _lastView, m_frames);
+		}
+
 		BGFX_API_FUNC(void destroyFrameBuffer(FrameBufferHandle _handle) )
 		{
 			CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::DestroyFrameBuffer);
@@ -2378,6 +2696,82 @@ namespace bgfx
 			}
 		}
 
+		BGFX_API_FUNC(StateHandle createState(uint64_t _state, uint32_t _rgba, uint32_t _fstencil, uint32_t _bstencil, const uint32_t* _samplerFlags, uint8_t _numSamplers) )
+		{
+			StateHandle handle = { m_stateHandle.alloc() };
+
+			BX_WARN(isValid(handle), "Failed to allocate state handle.");
+			if (isValid(handle) )
+			{
+				StateBlock& block = m_stateBlock[handle.idx];
+				block.m_flags = _state;
+				block.m_stencil = packStencil(_fstencil, _bstencil);
+				block.m_rgba = _rgba;
+				block.m_trans = getTransSortOrder(_state);
+
+				const uint32_t num = NULL == _samplerFlags ? 0 : bx::uint32_min(_numSamplers, BGFX_STATE_TEX_COUNT);
+				for (uint32_t ii = 0; ii < BGFX_STATE_TEX_COUNT; ++ii)
+				{
+					block.m_sampler[ii] = ii < num && 0 == (_samplerFlags[ii]&BGFX_SAMPLER_DEFAULT_FLAGS)
+						? _samplerFlags[ii]
+						: BGFX_SAMPLER_DEFAULT_FLAGS
+						;
+				}
+
+				CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::CreateState);
+				cmdbuf.write(handle);
+				cmdbuf.write(block);
+			}
+
+			return handle;
+		}
+
+		BGFX_API_FUNC(void destroyState(StateHandle _handle) )
+		{
+			BX_CHECK(isValid(_handle), "Destroying invalid state handle.");
+			CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::DestroyState);
+			cmdbuf.write(_handle);
+			m_submit->free(_handle);
+		}
+
+		BGFX_API_FUNC(void setState(StateHandle _handle) )
+		{
+			BX_CHECK(isValid(_handle), "Can't set state with invalid handle.");
+			m_submit->setState(_handle, m_stateBlock[_handle.idx]);
+		}
+
+		BGFX_API_FUNC(UniformBlockHandle createUniformBlock() )
+		{
+			UniformBlockHandle handle = { m_uniformBlockHandle.alloc() };
+			BX_WARN(isValid(handle), "Failed to allocate uniform block handle.");
+			return handle;
+		}
+
+		BGFX_API_FUNC(void destroyUniformBlock(UniformBlockHandle _handle) )
+		{
+			BX_CHECK(isValid(_handle), "Destroying invalid uniform block handle.");
+			m_uniformBlockHandle.free(_handle.idx);
+		}
+
+		BGFX_API_FUNC(void beginUniformBlock(UniformBlockHandle _handle) )
+		{
+			BX_CHECK(isValid(_handle), "Can't update uniform block with invalid handle.");
+			BX_CHECK(invalidHandle == m_submit->m_uniformBlockUpdate, "Uniform block %d update is not ended.", m_submit->m_uniformBlockUpdate);
+			m_submit->beginUniformBlock(_handle);
+		}
+
+		BGFX_API_FUNC(void endUniformBlock() )
+		{
+			BX_CHECK(invalidHandle != m_submit->m_uniformBlockUpdate, "Uniform block update is not started.");
+			m_submit->endUniformBlock();
+		}
+
+		BGFX_API_FUNC(void setUniformBlock(UniformBlockHandle _handle) )
+		{
+			BX_CHECK(isValid(_handle), "Can't set uniform block with invalid handle.");
+			m_submit->setUniformBlock(_handle);
+		}
+
 		BGFX_API_FUNC(void saveScreenShot(const char* _filePath) )
 		{
 			CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::SaveScreenShot);
@@ -2404,14 +2798,17 @@ namespace bgfx
 			rect.m_height = bx::uint16_max(_height, 1);
 		}
 
-		BGFX_API_FUNC(void setViewRectMask(uint32_t _viewMask, uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height) )
+		BGFX_API_FUNC(void setViewRectMask(const ViewMask& _viewMask, uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height) )
 		{
-			for (uint32_t view = 0, viewMask = _viewMask, ntz = bx::uint32_cnttz(_viewMask); 0 != viewMask; viewMask >>= 1, view += 1, ntz = bx::uint32_cnttz(viewMask) )
+			for (uint32_t ii = 0; ii < BGFX_VIEW_MASK_WORDS; ++ii)
 			{
-				viewMask >>= ntz;
-				view += ntz;
+				for (uint32_t view = ii*32, viewMask = _viewMask.m_mask[ii], ntz = bx::uint32_cnttz(viewMask); 0 != viewMask; viewMask >>= 1, view += 1, ntz = bx::uint32_cnttz(viewMask) )
+				{
+					viewMask >>= ntz;
+					view += ntz;
 
-				setViewRect( (uint8_t)view, _x, _y, _width, _height);
+					setViewRect( (uint8_t)view, _x, _y, _width, _height);
+				}
 			}
 		}
 
@@ -2424,14 +2821,17 @@ namespace bgfx
 			scissor.m_height = _height;
 		}
 
-		BGFX_API_FUNC(void setViewScissorMask(uint32_t _viewMask, uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height) )
+		BGFX_API_FUNC(void setViewScissorMask(const ViewMask& _viewMask, uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height) )
 		{
-			for (uint32_t view = 0, viewMask = _viewMask, ntz = bx::uint32_cnttz(_viewMask); 0 != viewMask; viewMask >>= 1, view += 1, ntz = bx::uint32_cnttz(viewMask) )
+			for (uint32_t ii = 0; ii < BGFX_VIEW_MASK_WORDS; ++ii)
 			{
-				viewMask >>= ntz;
-				view += ntz;
+				for (uint32_t view = ii*32, viewMask = _viewMask.m_mask[ii], ntz = bx::uint32_cnttz(viewMask); 0 != viewMask; viewMask >>= 1, view += 1, ntz = bx::uint32_cnttz(viewMask) )
+				{
+					viewMask >>= ntz;
+					view += ntz;
 
-				setViewScissor( (uint8_t)view, _x, _y, _width, _height);
+					setViewScissor( (uint8_t)view, _x, _y, _width, _height);
+				}
 			}
 		}
 
@@ -2444,14 +2844,17 @@ namespace bgfx
 			clear.m_stencil = _stencil;
 		}
 
-		BGFX_API_FUNC(void setViewClearMask(uint32_t _viewMask, uint8_t _flags, uint32_t _rgba, float _depth, uint8_t _stencil) )
+		BGFX_API_FUNC(void setViewClearMask(const ViewMask& _viewMask, uint8_t _flags, uint32_t _rgba, float _depth, uint8_t _stencil) )
 		{
-			for (uint32_t view = 0, viewMask = _viewMask, ntz = bx::uint32_cnttz(_viewMask); 0 != viewMask; viewMask >>= 1, view += 1, ntz = bx::uint32_cnttz(viewMask) )
+			for (uint32_t ii = 0; ii < BGFX_VIEW_MASK_WORDS; ++ii)
 			{
-				viewMask >>= ntz;
-				view += ntz;
+				for (uint32_t view = ii*32, viewMask = _viewMask.m_mask[ii], ntz = bx::uint32_cnttz(viewMask); 0 != viewMask; viewMask >>= 1, view += 1, ntz = bx::uint32_cnttz(viewMask) )
+				{
+					viewMask >>= ntz;
+					view += ntz;
 
-				setViewClear( (uint8_t)view, _flags, _rgba, _depth, _stencil);
+					setViewClear( (uint8_t)view, _flags, _rgba, _depth, _stencil);
+				}
 			}
 		}
 
@@ -2460,15 +2863,18 @@ namespace bgfx
 			m_seqMask[_id] = _enabled ? 0xffff : 0x0;
 		}
 
-		BGFX_API_FUNC(void setViewSeqMask(uint32_t _viewMask, bool _enabled) )
+		BGFX_API_FUNC(void setViewSeqMask(const ViewMask& _viewMask, bool _enabled) )
 		{
 			uint16_t mask = _enabled ? 0xffff : 0x0;
-			for (uint32_t view = 0, viewMask = _viewMask, ntz = bx::uint32_cnttz(_viewMask); 0 != viewMask; viewMask >>= 1, view += 1, ntz = bx::uint32_cnttz(viewMask) )
+			for (uint32_t ii = 0; ii < BGFX_VIEW_MASK_WORDS; ++ii)
 			{
-				viewMask >>= ntz;
-				view += ntz;
+				for (uint32_t view = ii*32, viewMask = _viewMask.m_mask[ii], ntz = bx::uint32_cnttz(viewMask); 0 != viewMask; viewMask >>= 1, view += 1, ntz = bx::uint32_cnttz(viewMask) )
+				{
+					viewMask >>= ntz;
+					view += ntz;
 
-				m_seqMask[view] = mask;
+					m_seqMask[view] = mask;
+				}
 			}
 		}
 
@@ -2477,22 +2883,57 @@ namespace bgfx
 			m_fb[_id] = _handle;
 		}
 
-		BGFX_API_FUNC(void setViewFrameBufferMask(uint32_t _viewMask, FrameBufferHandle _handle) )
+		BGFX_API_FUNC(void setViewFrameBufferMask(const ViewMask& _viewMask, FrameBufferHandle _handle) )
 		{
-			for (uint32_t view = 0, viewMask = _viewMask, ntz = bx::uint32_cnttz(_viewMask); 0 != viewMask; viewMask >>= 1, view += 1, ntz = bx::uint32_cnttz(viewMask) )
+			for (uint32_t ii = 0; ii < BGFX_VIEW_MASK_WORDS; ++ii)
 			{
-				viewMask >>= ntz;
-				view += ntz;
+				for (uint32_t view = ii*32, viewMask = _viewMask.m_mask[ii], ntz = bx::uint32_cnttz(viewMask); 0 != viewMask; viewMask >>= 1, view += 1, ntz = bx::uint32_cnttz(viewMask) )
+				{
+					viewMask >>= ntz;
+					view += ntz;
 
-				m_fb[view] = _handle;
+					m_fb[view] = _handle;
+				}
 			}
 		}
 
-		BGFX_API_FUNC(void setViewTransform(uint8_t _id, const void* _view, const void* _proj, uint8_t _other) )
+		BGFX_API_FUNC(FrameGraphTargetHandle frameGraphCreateTarget(uint16_t _width, uint16_t _height, TextureFormat::Enum _format, uint32_t _textureFlags) )
+		{
+			return m_frameGraph.createTarget(_width, _height, _format, _textureFlags);
+		}
+
+		BGFX_API_FUNC(void frameGraphWrite(uint8_t _id, FrameGraphTargetHandle _handle) )
+		{
+			m_frameGraph.write(_id, _handle);
+		}
+
+		BGFX_API_FUNC(void frameGraphRead(uint8_t _id, FrameGraphTargetHandle _handle) )
+		{
+			m_frameGraph.read(_id, _handle);
+		}
+
+		BGFX_API_FUNC(void frameGraphCompile() )
+		{
+			m_frameGraph.compile(m_frameBufferPool, m_frames, m_fb);
+		}
+
+		BGFX_API_FUNC(bool frameGraphIsViewCulled(uint8_t _id) )
+		{
+			return m_frameGraph.m_culled[_id];
+		}
+
+		BGFX_API_FUNC(FrameBufferHandle frameGraphGetFrameBuffer(FrameGraphTargetHandle _handle) )
+		{
+			BX_CHECK(_handle.idx < m_frameGraph.m_num, "Invalid frame graph render target handle %d.", _handle.idx);
+			return m_frameGraph.m_target[_handle.idx].m_fb;
+		}
+
+		BGFX_API_FUNC(void setViewTransform(uint8_t _id, const void* _view, const void* _proj, uint16_t _other) )
 		{
+			BX_CHECK(invalidView == _other || BGFX_CONFIG_MAX_VIEWS > _other, "Invalid other view %d.", _other);
 			if (BGFX_CONFIG_MAX_VIEWS > _other)
 			{
-				m_other[_id] = _other;
+				m_other[_id] = uint8_t(_other);
 			}
 			else
 			{
@@ -2518,14 +2959,17 @@ namespace bgfx
 			}
 		}
 
-		BGFX_API_FUNC(void setViewTransformMask(uint32_t _viewMask, const void* _view, const void* _proj, uint8_t _other) )
+		BGFX_API_FUNC(void setViewTransformMask(const ViewMask& _viewMask, const void* _view, const void* _proj, uint16_t _other) )
 		{
-			for (uint32_t view = 0, viewMask = _viewMask, ntz = bx::uint32_cnttz(_viewMask); 0 != viewMask; viewMask >>= 1, view += 1, ntz = bx::uint32_cnttz(viewMask) )
+			for (uint32_t ii = 0; ii < BGFX_VIEW_MASK_WORDS; ++ii)
 			{
-				viewMask >>= ntz;
-				view += ntz;
+				for (uint32_t view = ii*32, viewMask = _viewMask.m_mask[ii], ntz = bx::uint32_cnttz(viewMask); 0 != viewMask; viewMask >>= 1, view += 1, ntz = bx::uint32_cnttz(viewMask) )
+				{
+					viewMask >>= ntz;
+					view += ntz;
 
-				setViewTransform( (uint8_t)view, _view, _proj, _other);
+					setViewTransform( (uint8_t)view, _view, _proj, _other);
+				}
 			}
 		}
 
@@ -2613,8 +3057,32 @@ namespace bgfx
 			m_submit->setProgram(_handle);
 		}
 
+		void textureTouch(TextureHandle _handle)
+		{
+			TextureRef& ref = m_textureRef[_handle.idx];
+			ref.m_lastUsed = m_frames;
+
+			if (0 != ref.m_baseMip)
+			{
+				CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::RestreamTexture);
+				cmdbuf.write(_handle);
+				cmdbuf.write(ref.m_baseMip);
+
+				// Assume application provides dropped mips again.
+				const uint32_t size = calcTextureMipsSize(ref, 0, ref.m_baseMip);
+				m_textureMemoryResident += size;
+				ref.m_residentSize += size;
+				ref.m_baseMip = 0;
+			}
+		}
+
 		BGFX_API_FUNC(void setTexture(uint8_t _stage, UniformHandle _sampler, TextureHandle _handle, uint32_t _flags) )
 		{
+			if (isValid(_handle) )
+			{
+				textureTouch(_handle);
+			}
+
 			m_submit->setTexture(_stage, _sampler, _handle, _flags);
 		}
 
@@ -2626,6 +3094,7 @@ namespace bgfx
 			{
 				textureHandle = m_frameBufferRef[_handle.idx].m_th[_attachment];
 				BX_CHECK(isValid(textureHandle), "Frame buffer texture %d is invalid.", _attachment);
+				textureTouch(textureHandle);
 			}
 
 			m_submit->setTexture(_stage, _sampler, textureHandle, _flags);
@@ -2636,7 +3105,7 @@ namespace bgfx
 			return m_submit->submit(_id, _depth);
 		}
 
-		BGFX_API_FUNC(uint32_t submitMask(uint32_t _viewMask, int32_t _depth) )
+		BGFX_API_FUNC(uint32_t submitMask(const ViewMask& _viewMask, int32_t _depth) )
 		{
 			return m_submit->submitMask(_viewMask, _depth);
 		}
@@ -2652,6 +3121,7 @@ namespace bgfx
 		void freeDynamicBuffers();
 		void freeAllHandles(Frame* _frame);
 		void frameNoRenderWait();
+		void evictTextures();
 		void swap();
 
 		// render thread
@@ -2680,16 +3150,26 @@ namespace bgfx
 		void rendererUpdateTexture(TextureHandle _handle, uint8_t _side, uint8_t _mip, const Rect& _rect, uint16_t _z, uint16_t _depth, uint16_t _pitch, const Memory* _mem);
 		void rendererUpdateTextureEnd();
 		void rendererDestroyTexture(TextureHandle _handle);
+		void rendererUpdateTextureBaseMip(TextureHandle _handle, uint8_t _mip);
+		bool rendererResizeTexture(TextureHandle _handle, uint16_t _width, uint16_t _height, uint8_t _numMips);
 		void rendererCreateFrameBuffer(FrameBufferHandle _handle, uint8_t _num, const TextureHandle* _textureHandles);
 		void rendererDestroyFrameBuffer(FrameBufferHandle _handle);
 		void rendererCreateUniform(UniformHandle _handle, UniformType::Enum _type, uint16_t _num, const char* _name);
 		void rendererDestroyUniform(UniformHandle _handle);
+		void rendererCreateState(StateHandle _handle, const StateBlock& _block);
+		void rendererDestroyState(StateHandle _handle);
 		void rendererSaveScreenShot(const char* _filePath);
 		void rendererUpdateViewName(uint8_t _id, const char* _name);
 		void rendererUpdateUniform(uint16_t _loc, const void* _data, uint32_t _size);
 		void rendererSetMarker(const char* _marker, uint32_t _size);
-		void rendererUpdateUniforms(ConstantBuffer* _constantBuffer, uint32_t _begin, uint32_t _end);
+		void rendererUpdateUniforms(ConstantBuffer* _constantBuffer, uint32_t _begin, uint32_t _end, const uint32_t* _mask = NULL, uint32_t* _updated = NULL);
+		bool rendererUpdateUniforms(const RenderState& _state, uint16_t& _uniformBlock);
 		void flushTextureUpdateBatch(CommandBuffer& _cmdbuf);
+		bool resizeTextureStream(TextureHandle _handle, uint8_t _skip);
+		void updateTextureStreamBaseMip(TextureHandle _handle);
+		void applyTextureStreamUpdate(const TextureStreamUpdate& _update);
+		void purgeTextureStream(TextureHandle _handle);
+		void flushTextureStream(uint32_t _budget);
 		void rendererExecCommands(CommandBuffer& _cmdbuf);
 		void rendererSubmit();
 
@@ -2748,6 +3228,10 @@ namespace bgfx
 		uint64_t m_tempKeys[BGFX_CONFIG_MAX_DRAW_CALLS];
 		uint16_t m_tempValues[BGFX_CONFIG_MAX_DRAW_CALLS];
 
+		PredefinedMatrixCache m_predefinedMatrixCache;
+		uint32_t m_uniformDirty[BGFX_UNIFORM_MASK_WORDS];    //!< Uniforms updated since last program commit.
+		uint32_t m_uniformOverride[BGFX_UNIFORM_MASK_WORDS]; //!< Uniforms updated by previous draw call.
+
 		DynamicIndexBuffer m_dynamicIndexBuffers[BGFX_CONFIG_MAX_DYNAMIC_INDEX_BUFFERS];
 		DynamicVertexBuffer m_dynamicVertexBuffers[BGFX_CONFIG_MAX_DYNAMIC_VERTEX_BUFFERS];
 
@@ -2770,6 +3254,8 @@ namespace bgfx
 		bx::HandleAllocT<BGFX_CONFIG_MAX_TEXTURES> m_textureHandle;
 		bx::HandleAllocT<BGFX_CONFIG_MAX_FRAME_BUFFERS> m_frameBufferHandle;
 		bx::HandleAllocT<BGFX_CONFIG_MAX_UNIFORMS> m_uniformHandle;
+		bx::HandleAllocT<BGFX_CONFIG_MAX_STATES> m_stateHandle;
+		bx::HandleAllocT<BGFX_CONFIG_MAX_UNIFORM_BLOCKS> m_uniformBlockHandle;
 
 		struct ShaderRef
 		{
@@ -2794,9 +3280,20 @@ namespace bgfx
 
 		struct TextureRef
 		{
+			uint32_t m_size;         //!< Allocated storage.
+			uint32_t m_residentSize; //!< Storage of mips from m_baseMip down.
+			uint32_t m_lastUsed;
+			uint16_t m_width;
+			uint16_t m_height;
 			int16_t m_refCount;
+			uint8_t m_format;
+			uint8_t m_numMips;
+			uint8_t m_baseMip;
+			bool m_evictable;
 		};
 
+		static uint32_t calcTextureMipsSize(const TextureRef& _ref, uint8_t _startMip, uint8_t _endMip);
+
 		struct FrameBufferRef
 		{
 			TextureHandle m_th[BGFX_CONFIG_MAX_FRAME_BUFFER_ATTACHMENTS];
@@ -2809,6 +3306,7 @@ namespace bgfx
 		ProgramRef m_programRef[BGFX_CONFIG_MAX_PROGRAMS];
 		TextureRef m_textureRef[BGFX_CONFIG_MAX_TEXTURES];
 		FrameBufferRef m_frameBufferRef[BGFX_CONFIG_MAX_FRAME_BUFFERS];
+		StateBlock m_stateBlock[BGFX_CONFIG_MAX_STATES];
 		VertexDeclRef m_declRef;
 
 		FrameBufferHandle m_fb[BGFX_CONFIG_MAX_VIEWS];
@@ -2825,9 +3323,15 @@ namespace bgfx
 		int32_t  m_instBufferCount;
 		uint32_t m_frames;
 		uint32_t m_debug;
+		uint32_t m_textureStreamBudget;
+		uint64_t m_textureMemoryUsed;
+		uint64_t m_textureMemoryResident;
+		uint64_t m_textureMemoryBudget;
 
 		TextVideoMemBlitter m_textVideoMemBlitter;
 		ClearQuad m_clearQuad;
+		FrameBufferPool m_frameBufferPool;
+		FrameGraph m_frameGraph;
 
 		bool m_rendererInitialized;
 		bool m_exit;
@@ -2835,6 +3339,15 @@ namespace bgfx
 		BX_CACHE_LINE_ALIGN_MARKER();
 		typedef UpdateBatchT<256> TextureUpdateBatch;
 		TextureUpdateBatch m_textureUpdateBatch;
+
+		typedef UpdateBatchT<BGFX_CONFIG_MAX_TEXTURES> TextureLruBatch;
+		TextureLruBatch m_textureLru;
+		uint8_t m_textureLruBaseMip[BGFX_CONFIG_MAX_TEXTURES];
+
+		TextureStream m_textureStream[BGFX_CONFIG_MAX_TEXTURES];
+		TextureStreamUpdate m_textureStreamQueue[BGFX_CONFIG_MAX_TEXTURE_STREAM_UPDATES];
+		uint32_t m_textureStreamRead;
+		uint32_t m_textureStreamNum;
 	};
 
 #undef BGFX_API_FUNC
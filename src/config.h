@@ -125,18 +125,26 @@
 #	define BGFX_CONFIG_MAX_MATRIX_CACHE (64<<10)
 #endif // BGFX_CONFIG_MAX_MATRIX_CACHE
 
+#ifndef BGFX_CONFIG_MAX_PREDEFINED_MATRIX_BATCH
+#	define BGFX_CONFIG_MAX_PREDEFINED_MATRIX_BATCH 1024
+#endif // BGFX_CONFIG_MAX_PREDEFINED_MATRIX_BATCH
+
 #ifndef BGFX_CONFIG_MAX_RECT_CACHE
 #	define BGFX_CONFIG_MAX_RECT_CACHE 512
 #endif //  BGFX_CONFIG_MAX_RECT_CACHE
 
 #ifndef BGFX_CONFIG_MAX_VIEWS
-#	define BGFX_CONFIG_MAX_VIEWS 32
+#	define BGFX_CONFIG_MAX_VIEWS 256
 #endif // BGFX_CONFIG_MAX_VIEWS
 
 #ifndef BGFX_CONFIG_MAX_VERTEX_DECLS
 #	define BGFX_CONFIG_MAX_VERTEX_DECLS 64
 #endif // BGFX_CONFIG_MAX_VERTEX_DECLS
 
+#ifndef BGFX_CONFIG_VERTEX_CONVERT_BLOCK_SIZE
+#	define BGFX_CONFIG_VERTEX_CONVERT_BLOCK_SIZE 64
+#endif // BGFX_CONFIG_VERTEX_CONVERT_BLOCK_SIZE
+
 #ifndef BGFX_CONFIG_MAX_INDEX_BUFFERS
 #	define BGFX_CONFIG_MAX_INDEX_BUFFERS (4<<10)
 #endif // BGFX_CONFIG_MAX_INDEX_BUFFERS
@@ -177,6 +185,20 @@
 #	define BGFX_CONFIG_MAX_FRAME_BUFFERS 64
 #endif // BGFX_CONFIG_MAX_FRAME_BUFFERS
 
+#ifndef BGFX_CONFIG_MAX_TRANSIENT_FRAME_BUFFERS
+#	define BGFX_CONFIG_MAX_TRANSIENT_FRAME_BUFFERS 32
+#endif // BGFX_CONFIG_MAX_TRANSIENT_FRAME_BUFFERS
+
+/// Number of frames pooled transient frame buffer is kept alive after
+/// it was last used.
+#ifndef BGFX_CONFIG_TRANSIENT_FRAME_BUFFER_LIFETIME
+#	define BGFX_CONFIG_TRANSIENT_FRAME_BUFFER_LIFETIME 8
+#endif // BGFX_CONFIG_TRANSIENT_FRAME_BUFFER_LIFETIME
+
+#ifndef BGFX_CONFIG_MAX_FRAME_GRAPH_TARGETS
+#	define BGFX_CONFIG_MAX_FRAME_GRAPH_TARGETS 32
+#endif // BGFX_CONFIG_MAX_FRAME_GRAPH_TARGETS
+
 #ifndef BGFX_CONFIG_MAX_FRAME_BUFFER_ATTACHMENTS
 #	define BGFX_CONFIG_MAX_FRAME_BUFFER_ATTACHMENTS 4
 #endif // BGFX_CONFIG_MAX_FRAME_BUFFER_ATTACHMENTS
@@ -185,6 +207,26 @@
 #	define BGFX_CONFIG_MAX_UNIFORMS 512
 #endif // BGFX_CONFIG_MAX_CONSTANTS
 
+#ifndef BGFX_CONFIG_MAX_STATES
+#	define BGFX_CONFIG_MAX_STATES 256
+#endif // BGFX_CONFIG_MAX_STATES
+
+#ifndef BGFX_CONFIG_MAX_UNIFORM_BLOCKS
+#	define BGFX_CONFIG_MAX_UNIFORM_BLOCKS 64
+#endif // BGFX_CONFIG_MAX_UNIFORM_BLOCKS
+
+#ifndef BGFX_CONFIG_MAX_TEXTURE_STREAM_UPDATES
+#	define BGFX_CONFIG_MAX_TEXTURE_STREAM_UPDATES 1024
+#endif // BGFX_CONFIG_MAX_TEXTURE_STREAM_UPDATES
+
+#ifndef BGFX_CONFIG_TEXTURE_STREAM_BUDGET
+#	define BGFX_CONFIG_TEXTURE_STREAM_BUDGET (1<<20)
+#endif // BGFX_CONFIG_TEXTURE_STREAM_BUDGET
+
+#ifndef BGFX_CONFIG_TEXTURE_MEMORY_BUDGET
+#	define BGFX_CONFIG_TEXTURE_MEMORY_BUDGET 0
+#endif // BGFX_CONFIG_TEXTURE_MEMORY_BUDGET
+
 #ifndef BGFX_CONFIG_MAX_COMMAND_BUFFER_SIZE
 #	define BGFX_CONFIG_MAX_COMMAND_BUFFER_SIZE (64<<10)
 #endif // BGFX_CONFIG_MAX_COMMAND_BUFFER_SIZE
@@ -201,6 +243,10 @@
 #	define BGFX_CONFIG_MAX_CONSTANT_BUFFER_SIZE (512<<10)
 #endif // BGFX_CONFIG_MAX_CONSTANT_BUFFER_SIZE
 
+#ifndef BGFX_CONFIG_MAX_UNIFORM_BLOCK_BUFFER_SIZE
+#	define BGFX_CONFIG_MAX_UNIFORM_BLOCK_BUFFER_SIZE (128<<10)
+#endif // BGFX_CONFIG_MAX_UNIFORM_BLOCK_BUFFER_SIZE
+
 #ifndef BGFX_CONFIG_USE_TINYSTL
 #	define BGFX_CONFIG_USE_TINYSTL 1
 #endif // BGFX_CONFIG_USE_TINYSTL
@@ -927,6 +927,19 @@ namespace bgfx
 #define DDS_BC4U BX_MAKEFOURCC('B', 'C', '4', 'U')
 #define DDS_ATI2 BX_MAKEFOURCC('A', 'T', 'I', '2')
 #define DDS_BC5U BX_MAKEFOURCC('B', 'C', '5', 'U')
+#define DDS_DX10 BX_MAKEFOURCC('D', 'X', '1', '0')
+
+#define DDS_DX10_HEADER_SIZE 20
+
+#define DXGI_FORMAT_R8_UNORM           61
+#define DXGI_FORMAT_BC1_UNORM          71
+#define DXGI_FORMAT_BC2_UNORM          74
+#define DXGI_FORMAT_BC3_UNORM          77
+#define DXGI_FORMAT_BC4_UNORM          80
+#define DXGI_FORMAT_BC5_UNORM          83
+#define DXGI_FORMAT_B8G8R8A8_UNORM     87
+#define DXGI_FORMAT_R16G16B16A16_FLOAT 10
+#define DXGI_FORMAT_R16G16B16A16_UNORM 11
 
 #define D3DFMT_A16B16G16R16  36
 #define D3DFMT_A16B16G16R16F 113
@@ -990,6 +1003,24 @@ namespace bgfx
 		{ DDPF_ALPHA,                TextureFormat::R8      },
 	};
 
+	static struct TranslateDxgiFormat
+	{
+		uint32_t m_format;
+		TextureFormat::Enum m_textureFormat;
+
+	} s_translateDxgiFormat[] =
+	{
+		{ DXGI_FORMAT_BC1_UNORM,          TextureFormat::BC1     },
+		{ DXGI_FORMAT_BC2_UNORM,          TextureFormat::BC2     },
+		{ DXGI_FORMAT_BC3_UNORM,          TextureFormat::BC3     },
+		{ DXGI_FORMAT_BC4_UNORM,          TextureFormat::BC4     },
+		{ DXGI_FORMAT_BC5_UNORM,          TextureFormat::BC5     },
+		{ DXGI_FORMAT_R16G16B16A16_UNORM, TextureFormat::RGBA16  },
+		{ DXGI_FORMAT_R16G16B16A16_FLOAT, TextureFormat::RGBA16F },
+		{ DXGI_FORMAT_B8G8R8A8_UNORM,     TextureFormat::BGRA8   },
+		{ DXGI_FORMAT_R8_UNORM,           TextureFormat::R8      },
+	};
+
 	bool imageParseDds(ImageContainer& _imageContainer, bx::ReaderSeekerI* _reader)
 	{
 		uint32_t headerSize;
@@ -1069,28 +1100,63 @@ namespace bgfx
 
 		TextureFormat::Enum format = TextureFormat::Unknown;
 		bool hasAlpha = pixelFlags & DDPF_ALPHAPIXELS;
+		uint32_t offset = DDS_IMAGE_DATA_OFFSET;
+		uint32_t arraySize = 1;
 
-		uint32_t ddsFormat = pixelFlags & DDPF_FOURCC ? fourcc : pixelFlags;
-		for (uint32_t ii = 0; ii < BX_COUNTOF(s_translateDdsFormat); ++ii)
+		if (0 != (pixelFlags & DDPF_FOURCC)
+		&&  DDS_DX10 == fourcc)
 		{
-			if (s_translateDdsFormat[ii].m_format == ddsFormat)
+			uint32_t dxgiFormat;
+			bx::read(_reader, dxgiFormat);
+
+			uint32_t dimension;
+			bx::read(_reader, dimension);
+
+			uint32_t miscFlags;
+			bx::read(_reader, miscFlags);
+
+			bx::read(_reader, arraySize);
+
+			bx::skip(_reader, 4); // miscFlags2
+
+			for (uint32_t ii = 0; ii < BX_COUNTOF(s_translateDxgiFormat); ++ii)
 			{
-				format = s_translateDdsFormat[ii].m_textureFormat;
-				break;
+				if (s_translateDxgiFormat[ii].m_format == dxgiFormat)
+				{
+					format = s_translateDxgiFormat[ii].m_textureFormat;
+					break;
+				}
+			}
+
+			offset += DDS_DX10_HEADER_SIZE;
+		}
+		else
+		{
+			uint32_t ddsFormat = pixelFlags & DDPF_FOURCC ? fourcc : pixelFlags;
+			for (uint32_t ii = 0; ii < BX_COUNTOF(s_translateDdsFormat); ++ii)
+			{
+				if (s_translateDdsFormat[ii].m_format == ddsFormat)
+				{
+					format = s_translateDdsFormat[ii].m_textureFormat;
+					break;
+				}
 			}
 		}
 
 		_imageContainer.m_data = NULL;
 		_imageContainer.m_size = 0;
-		_imageContainer.m_offset = DDS_IMAGE_DATA_OFFSET;
+		_imageContainer.m_offset = offset;
 		_imageContainer.m_width = width;
 		_imageContainer.m_height = height;
 		_imageContainer.m_depth = depth;
+		_imageContainer.m_numLayers = uint16_t(bx::uint32_max(1, arraySize) );
+		_imageContainer.m_array = 1 < arraySize;
 		_imageContainer.m_format = format;
 		_imageContainer.m_numMips = (caps[0] & DDSCAPS_MIPMAP) ? mips : 1;
 		_imageContainer.m_hasAlpha = hasAlpha;
 		_imageContainer.m_cubeMap = cubeMap;
 		_imageContainer.m_ktx = false;
+		_imageContainer.m_pvr3 = false;
 
 		return TextureFormat::Unknown != format;
 	}
@@ -1230,11 +1296,14 @@ namespace bgfx
 		_imageContainer.m_width = width;
 		_imageContainer.m_height = height;
 		_imageContainer.m_depth = depth;
+		_imageContainer.m_numLayers = uint16_t(bx::uint32_max(1, numberOfArrayElements) );
+		_imageContainer.m_array = 0 < numberOfArrayElements;
 		_imageContainer.m_format = format;
 		_imageContainer.m_numMips = numMips;
 		_imageContainer.m_hasAlpha = hasAlpha;
 		_imageContainer.m_cubeMap = numFaces > 1;
 		_imageContainer.m_ktx = true;
+		_imageContainer.m_pvr3 = false;
 
 		return TextureFormat::Unknown != format;
 	}
@@ -1347,11 +1416,14 @@ namespace bgfx
 		_imageContainer.m_width = width;
 		_imageContainer.m_height = height;
 		_imageContainer.m_depth = depth;
+		_imageContainer.m_numLayers = uint16_t(bx::uint32_max(1, numSurfaces) );
+		_imageContainer.m_array = 1 < numSurfaces;
 		_imageContainer.m_format = format;
 		_imageContainer.m_numMips = numMips;
 		_imageContainer.m_hasAlpha = hasAlpha;
 		_imageContainer.m_cubeMap = numFaces > 1;
 		_imageContainer.m_ktx = false;
+		_imageContainer.m_pvr3 = true;
 
 		return TextureFormat::Unknown != format;
 	}
@@ -1393,10 +1465,13 @@ namespace bgfx
 			_imageContainer.m_width = tc.m_width;
 			_imageContainer.m_height = tc.m_height;
 			_imageContainer.m_depth = tc.m_depth;
+			_imageContainer.m_numLayers = tc.m_numLayers;
+			_imageContainer.m_array = tc.m_array;
 			_imageContainer.m_numMips = tc.m_numMips;
 			_imageContainer.m_hasAlpha = false;
 			_imageContainer.m_cubeMap = tc.m_cubeMap;
 			_imageContainer.m_ktx = false;
+			_imageContainer.m_pvr3 = false;
 
 			return true;
 		}
@@ -1586,7 +1661,7 @@ namespace bgfx
 		}
 	}
 
-	bool imageGetRawData(const ImageContainer& _imageContainer, uint8_t _side, uint8_t _lod, const void* _data, uint32_t _size, ImageMip& _mip)
+	bool imageGetRawData(const ImageContainer& _imageContainer, uint16_t _side, uint8_t _lod, const void* _data, uint32_t _size, ImageMip& _mip)
 	{
 		uint32_t offset = _imageContainer.m_offset;
 		TextureFormat::Enum type = TextureFormat::Enum(_imageContainer.m_format);
@@ -1610,15 +1685,20 @@ namespace bgfx
 			_size = _imageContainer.m_size;
 		}
 
-		for (uint8_t side = 0, numSides = _imageContainer.m_cubeMap ? 6 : 1; side < numSides; ++side)
+		// Side index is layer*numSides+side.
+		const uint32_t numSides = (_imageContainer.m_cubeMap ? 6 : 1) * _imageContainer.m_numLayers;
+
+		if (_imageContainer.m_ktx
+		||  _imageContainer.m_pvr3)
 		{
+			// KTX and PVR3 store mip level of all layers and sides one after
+			// another. KTX prefixes each mip level with imageSize.
 			uint32_t width  = _imageContainer.m_width;
 			uint32_t height = _imageContainer.m_height;
 			uint32_t depth  = _imageContainer.m_depth;
 
 			for (uint8_t lod = 0, num = _imageContainer.m_numMips; lod < num; ++lod)
 			{
-				// skip imageSize in KTX format.
 				offset += _imageContainer.m_ktx ? sizeof(uint32_t) : 0;
 
 				width  = bx::uint32_max(blockWidth,  width);
@@ -1627,6 +1707,53 @@ namespace bgfx
 
 				uint32_t size = width*height*depth*bpp/8;
 
+				if (lod == _lod)
+				{
+					if (_side >= numSides)
+					{
+						return false;
+					}
+
+					_mip.m_width = width;
+					_mip.m_height = height;
+					_mip.m_blockSize = blockSize;
+					_mip.m_size = size;
+					_mip.m_data = (const uint8_t*)_data + offset + _side*size;
+					_mip.m_bpp = bpp;
+					_mip.m_format = type;
+					_mip.m_hasAlpha = hasAlpha;
+					return true;
+				}
+
+				offset += size*numSides;
+
+				BX_CHECK(offset <= _size, "Reading past size of data buffer! (offset %d, size %d)", offset, _size);
+				BX_UNUSED(_size);
+
+				width  >>= 1;
+				height >>= 1;
+				depth  >>= 1;
+			}
+
+			return false;
+		}
+
+		// DDS and texture created from memory store all mip levels of side
+		// one after another, and each layer contains all sides.
+		for (uint32_t side = 0; side < numSides; ++side)
+		{
+			uint32_t width  = _imageContainer.m_width;
+			uint32_t height = _imageContainer.m_height;
+			uint32_t depth  = _imageContainer.m_depth;
+
+			for (uint8_t lod = 0, num = _imageContainer.m_numMips; lod < num; ++lod)
+			{
+				width  = bx::uint32_max(blockWidth,  width);
+				height = bx::uint32_max(blockHeight, height);
+				depth  = bx::uint32_max(1, depth);
+
+				uint32_t size = width*height*depth*bpp/8;
+
 				if (side == _side
 				&&  lod == _lod)
 				{
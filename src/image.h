@@ -18,11 +18,14 @@ namespace bgfx
 		uint32_t m_width;
 		uint32_t m_height;
 		uint32_t m_depth;
+		uint16_t m_numLayers;
 		uint8_t m_format;
 		uint8_t m_numMips;
 		bool m_hasAlpha;
 		bool m_cubeMap;
+		bool m_array;
 		bool m_ktx;
+		bool m_pvr3;
 	};
 
 	struct ImageMip
@@ -91,7 +94,7 @@ namespace bgfx
 	void imageDecodeToBgra8(uint8_t* _dst, const uint8_t* _src, uint32_t _width, uint32_t _height, uint32_t _srcPitch, uint8_t _type);
 
 	///
-	bool imageGetRawData(const ImageContainer& _dds, uint8_t _side, uint8_t _index, const void* _data, uint32_t _size, ImageMip& _mip);
+	bool imageGetRawData(const ImageContainer& _dds, uint16_t _side, uint8_t _index, const void* _data, uint32_t _size, ImageMip& _mip);
 
 } // namespace bgfx
 
@@ -347,6 +347,7 @@ namespace bgfx
 			: m_captureTexture(NULL)
 			, m_captureResolve(NULL)
 			, m_wireframe(false)
+			, m_stateCacheGeneration(0)
 			, m_flags(BGFX_RESET_NONE)
 			, m_vsChanges(0)
 			, m_fsChanges(0)
@@ -620,6 +621,7 @@ namespace bgfx
 			m_depthStencilStateCache.invalidate();
 			m_rasterizerStateCache.invalidate();
 			m_samplerStateCache.invalidate();
+			++m_stateCacheGeneration;
 		}
 
 		void updateMsaa()
@@ -853,7 +855,7 @@ namespace bgfx
 			m_deviceCtx->IASetInputLayout(layout);
 		}
 
-		void setBlendState(uint64_t _state, uint32_t _rgba = 0)
+		ID3D11BlendState* getBlendState(uint64_t _state, uint32_t _rgba, float* _blendFactor)
 		{
 			_state &= 0
 				| BGFX_STATE_BLEND_MASK
@@ -873,13 +875,16 @@ namespace bgfx
 						  || f1 == (_state & f1)
 						  ;
 
-			float blendFactor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+			_blendFactor[0] = 1.0f;
+			_blendFactor[1] = 1.0f;
+			_blendFactor[2] = 1.0f;
+			_blendFactor[3] = 1.0f;
 			if (hasFactor)
 			{
-				blendFactor[0] = ( (_rgba>>24)     )/255.0f;
-				blendFactor[1] = ( (_rgba>>16)&0xff)/255.0f;
-				blendFactor[2] = ( (_rgba>> 8)&0xff)/255.0f;
-				blendFactor[3] = ( (_rgba    )&0xff)/255.0f;
+				_blendFactor[0] = ( (_rgba>>24)     )/255.0f;
+				_blendFactor[1] = ( (_rgba>>16)&0xff)/255.0f;
+				_blendFactor[2] = ( (_rgba>> 8)&0xff)/255.0f;
+				_blendFactor[3] = ( (_rgba    )&0xff)/255.0f;
 			}
 			else
 			{
@@ -957,15 +962,22 @@ namespace bgfx
 				m_blendStateCache.add(hash, bs);
 			}
 
+			return bs;
+		}
+
+		void setBlendState(uint64_t _state, uint32_t _rgba = 0)
+		{
+			float blendFactor[4];
+			ID3D11BlendState* bs = getBlendState(_state, _rgba, blendFactor);
 			m_deviceCtx->OMSetBlendState(bs, blendFactor, 0xffffffff);
 		}
 
-		void setDepthStencilState(uint64_t _state, uint64_t _stencil = 0)
+		ID3D11DepthStencilState* getDepthStencilState(uint64_t _state, uint64_t _stencil, uint32_t& _ref)
 		{
 			_state &= BGFX_STATE_DEPTH_WRITE|BGFX_STATE_DEPTH_TEST_MASK;
 
 			uint32_t fstencil = unpackStencil(0, _stencil);
-			uint32_t ref = (fstencil&BGFX_STENCIL_FUNC_REF_MASK)>>BGFX_STENCIL_FUNC_REF_SHIFT;
+			_ref = (fstencil&BGFX_STENCIL_FUNC_REF_MASK)>>BGFX_STENCIL_FUNC_REF_SHIFT;
 			_stencil &= packStencil(~BGFX_STENCIL_FUNC_REF_MASK, BGFX_STENCIL_MASK);
 
 			bx::HashMurmur2A murmur;
@@ -1005,6 +1017,13 @@ namespace bgfx
 				m_depthStencilStateCache.add(hash, dss);
 			}
 
+			return dss;
+		}
+
+		void setDepthStencilState(uint64_t _state, uint64_t _stencil = 0)
+		{
+			uint32_t ref;
+			ID3D11DepthStencilState* dss = getDepthStencilState(_state, _stencil, ref);
 			m_deviceCtx->OMSetDepthStencilState(dss, ref);
 		}
 
@@ -1014,10 +1033,11 @@ namespace bgfx
 			{
 				m_wireframe = _wireframe;
 				m_rasterizerStateCache.invalidate();
+				++m_stateCacheGeneration;
 			}
 		}
 
-		void setRasterizerState(uint64_t _state, bool _wireframe = false, bool _scissor = false)
+		ID3D11RasterizerState* getRasterizerState(uint64_t _state, bool _wireframe, bool _scissor)
 		{
 			_state &= BGFX_STATE_CULL_MASK|BGFX_STATE_MSAA;
 			_state |= _wireframe ? BGFX_STATE_PT_LINES : BGFX_STATE_NONE;
@@ -1045,7 +1065,34 @@ namespace bgfx
 				m_rasterizerStateCache.add(_state, rs);
 			}
 
-			m_deviceCtx->RSSetState(rs);
+			return rs;
+		}
+
+		void setRasterizerState(uint64_t _state, bool _wireframe = false, bool _scissor = false)
+		{
+			m_deviceCtx->RSSetState(getRasterizerState(_state, _wireframe, _scissor) );
+		}
+
+		void resolveStateBlock(NativeStateBlock& _block)
+		{
+			_block.m_blendState = getBlendState(_block.m_flags, _block.m_rgba, _block.m_blendFactor);
+			_block.m_depthStencilState = getDepthStencilState(_block.m_flags, _block.m_stencil, _block.m_stencilRef);
+			_block.m_rasterizerState[0] = getRasterizerState(_block.m_flags, m_wireframe, false);
+			_block.m_rasterizerState[1] = getRasterizerState(_block.m_flags, m_wireframe, true);
+			_block.m_cacheGeneration = m_stateCacheGeneration;
+		}
+
+		void setStateBlock(uint16_t _idx, bool _scissor)
+		{
+			NativeStateBlock& block = m_stateBlocks[_idx];
+			if (block.m_cacheGeneration != m_stateCacheGeneration)
+			{
+				resolveStateBlock(block);
+			}
+
+			m_deviceCtx->OMSetBlendState(block.m_blendState, block.m_blendFactor, 0xffffffff);
+			m_deviceCtx->OMSetDepthStencilState(block.m_depthStencilState, block.m_stencilRef);
+			m_deviceCtx->RSSetState(block.m_rasterizerState[_scissor]);
 		}
 
 		ID3D11SamplerState* getSamplerState(uint32_t _flags)
@@ -1272,6 +1319,9 @@ namespace bgfx
 		StateCacheT<ID3D11RasterizerState> m_rasterizerStateCache;
 		StateCacheT<ID3D11SamplerState> m_samplerStateCache;
 
+		NativeStateBlock m_stateBlocks[BGFX_CONFIG_MAX_STATES];
+		uint32_t m_stateCacheGeneration;
+
 		TextVideoMem m_textVideoMem;
 
 		TextureStage m_textureStage;
@@ -1392,7 +1442,7 @@ namespace bgfx
 		deviceCtx->Unmap(m_ptr, 0);
 	}
 
-	void ConstantBuffer::commit()
+	void ConstantBuffer::commit(const uint32_t* _mask)
 	{
 		reset();
 
@@ -1412,6 +1462,7 @@ namespace bgfx
 			decodeOpcode(opcode, type, loc, num, copy);
 
 			const char* data;
+			bool skip = false;
 			if (copy)
 			{
 				data = read(g_uniformTypeSize[type]*num);
@@ -1421,6 +1472,14 @@ namespace bgfx
 				UniformHandle handle;
 				memcpy(&handle, read(sizeof(UniformHandle) ), sizeof(UniformHandle) );
 				data = (const char*)s_renderCtx->m_uniforms[handle.idx];
+				skip = NULL != _mask
+					&& 0 == (_mask[handle.idx/32] & (UINT32_C(1)<<(handle.idx%32) ) )
+					;
+			}
+
+			if (skip)
+			{
+				continue;
 			}
 
 #define CASE_IMPLEMENT_UNIFORM(_uniform, _glsuffix, _dxsuffix, _type) \
@@ -1969,6 +2028,48 @@ namespace bgfx
 		DX_RELEASE(m_ptr, 0);
 	}
 
+	bool Texture::resize(uint32_t _width, uint32_t _height, uint8_t _numMips)
+	{
+		BX_CHECK(Texture2D == m_type, "Only 2D textures can be resized.");
+
+		const ImageBlockInfo& blockInfo = getBlockInfo(TextureFormat::Enum(m_textureFormat) );
+
+		D3D11_TEXTURE2D_DESC desc;
+		m_texture2d->GetDesc(&desc);
+		desc.Width = bx::uint32_max(blockInfo.blockWidth,  _width);
+		desc.Height = bx::uint32_max(blockInfo.blockHeight, _height);
+		desc.MipLevels = _numMips;
+		desc.Usage = D3D11_USAGE_DEFAULT;
+
+		ID3D11Texture2D* texture;
+		DX_CHECK(s_renderCtx->m_device->CreateTexture2D(&desc, NULL, &texture) );
+
+		// Both mip chains end with the same mip, mips present in both
+		// storages have the same size and are copied on GPU.
+		for (uint32_t lod = 0; lod < _numMips; ++lod)
+		{
+			const int32_t srcLod = int32_t(lod + m_numMips) - int32_t(_numMips);
+			if (0 <= srcLod)
+			{
+				s_renderCtx->m_deviceCtx->CopySubresourceRegion(texture, lod, 0, 0, 0, m_texture2d, srcLod, NULL);
+			}
+		}
+
+		DX_RELEASE(m_srv, 0);
+		DX_RELEASE(m_ptr, 0);
+		m_texture2d = texture;
+		m_numMips = _numMips;
+
+		D3D11_SHADER_RESOURCE_VIEW_DESC srvd;
+		memset(&srvd, 0, sizeof(srvd) );
+		srvd.Format = s_textureFormat[m_textureFormat].m_fmtSrv;
+		srvd.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+		srvd.Texture2D.MipLevels = _numMips;
+		DX_CHECK(s_renderCtx->m_device->CreateShaderResourceView(m_ptr, &srvd, &m_srv) );
+
+		return true;
+	}
+
 	void Texture::update(uint8_t _side, uint8_t _mip, const Rect& _rect, uint16_t _z, uint16_t _depth, uint16_t _pitch, const Memory* _mem)
 	{
 		ID3D11DeviceContext* deviceCtx = s_renderCtx->m_deviceCtx;
@@ -2198,7 +2299,9 @@ namespace bgfx
 
 	void Context::rendererCreateProgram(ProgramHandle _handle, ShaderHandle _vsh, ShaderHandle _fsh)
 	{
-		s_renderCtx->m_program[_handle.idx].create(s_renderCtx->m_shaders[_vsh.idx], s_renderCtx->m_shaders[_fsh.idx]);
+		Program& program = s_renderCtx->m_program[_handle.idx];
+		program.create(s_renderCtx->m_shaders[_vsh.idx], s_renderCtx->m_shaders[_fsh.idx]);
+		m_predefinedMatrixCache.setProgram(_handle.idx, program.m_predefined, program.m_numPredefined);
 	}
 
 	void Context::rendererDestroyProgram(ProgramHandle _handle)
@@ -2229,6 +2332,16 @@ namespace bgfx
 		s_renderCtx->m_textures[_handle.idx].destroy();
 	}
 
+	bool Context::rendererResizeTexture(TextureHandle _handle, uint16_t _width, uint16_t _height, uint8_t _numMips)
+	{
+		return s_renderCtx->m_textures[_handle.idx].resize(_width, _height, _numMips);
+	}
+
+	void Context::rendererUpdateTextureBaseMip(TextureHandle _handle, uint8_t _mip)
+	{
+		s_renderCtx->m_deviceCtx->SetResourceMinLOD(s_renderCtx->m_textures[_handle.idx].m_ptr, float(_mip) );
+	}
+
 	void Context::rendererCreateFrameBuffer(FrameBufferHandle _handle, uint8_t _num, const TextureHandle* _textureHandles)
 	{
 		s_renderCtx->m_frameBuffers[_handle.idx].create(_num, _textureHandles);
@@ -2259,6 +2372,21 @@ namespace bgfx
 		s_renderCtx->m_uniforms[_handle.idx] = NULL;
 	}
 
+	void Context::rendererCreateState(StateHandle _handle, const StateBlock& _block)
+	{
+		NativeStateBlock& block = s_renderCtx->m_stateBlocks[_handle.idx];
+		block.m_flags = _block.m_flags;
+		block.m_stencil = _block.m_stencil;
+		block.m_rgba = _block.m_rgba;
+		s_renderCtx->resolveStateBlock(block);
+	}
+
+	void Context::rendererDestroyState(StateHandle _handle)
+	{
+		// State objects are owned by state caches.
+		s_renderCtx->m_stateBlocks[_handle.idx].m_cacheGeneration = UINT32_MAX;
+	}
+
 	void Context::rendererSaveScreenShot(const char* _filePath)
 	{
 		s_renderCtx->saveScreenShot(_filePath);
@@ -2315,19 +2443,17 @@ namespace bgfx
 		currentState.m_flags = BGFX_STATE_NONE;
 		currentState.m_stencil = packStencil(BGFX_STENCIL_NONE, BGFX_STENCIL_NONE);
 
-		Matrix4 viewProj[BGFX_CONFIG_MAX_VIEWS];
-		for (uint32_t ii = 0; ii < BGFX_CONFIG_MAX_VIEWS; ++ii)
-		{
-			bx::float4x4_mul(&viewProj[ii].un.f4x4, &m_render->m_view[ii].un.f4x4, &m_render->m_proj[ii].un.f4x4);
-		}
+		m_predefinedMatrixCache.reset(m_render, s_bias);
 
 		bool wireframe = !!(m_render->m_debug&BGFX_DEBUG_WIREFRAME);
 		bool scissorEnabled = false;
 		s_renderCtx->setDebugWireframe(wireframe);
 
 		uint16_t programIdx = invalidHandle;
+		uint16_t uniformBlock = invalidHandle;
+		uint16_t stateBlock = invalidHandle;
 		SortKey key;
-		uint8_t view = 0xff;
+		uint16_t view = UINT16_MAX;
 		FrameBufferHandle fbh = BGFX_INVALID_HANDLE;
 		float alphaRef = 0.0f;
 		D3D11_PRIMITIVE_TOPOLOGY primType = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
@@ -2371,6 +2497,7 @@ namespace bgfx
 
 					view = key.m_view;
 					programIdx = invalidHandle;
+					stateBlock = invalidHandle;
 
 					if (m_render->m_fb[view].idx != fbh.idx)
 					{
@@ -2441,7 +2568,43 @@ namespace bgfx
 						deviceCtx->RSSetScissorRects(1, &rc);
 					}
 
-					s_renderCtx->setRasterizerState(newFlags, wireframe, scissorEnabled);
+					if (invalidHandle == state.m_stateBlock)
+					{
+						s_renderCtx->setRasterizerState(newFlags, wireframe, scissorEnabled);
+					}
+					else
+					{
+						// Set state block again with rasterizer state matching scissor.
+						stateBlock = invalidHandle;
+					}
+				}
+
+				if (invalidHandle != state.m_stateBlock)
+				{
+					// Blend, depth stencil and rasterizer state objects of block
+					// are resolved at creation, and set only when block changes.
+					if (stateBlock != state.m_stateBlock)
+					{
+						stateBlock = state.m_stateBlock;
+						s_renderCtx->setStateBlock(stateBlock, scissorEnabled);
+					}
+
+					changedFlags &= ~(0
+						| BGFX_STATE_BLEND_MASK
+						| BGFX_STATE_BLEND_EQUATION_MASK
+						| BGFX_STATE_BLEND_INDEPENDENT
+						| BGFX_STATE_ALPHA_WRITE
+						| BGFX_STATE_RGB_WRITE
+						| BGFX_STATE_DEPTH_WRITE
+						| BGFX_STATE_DEPTH_TEST_MASK
+						| BGFX_STATE_CULL_MASK
+						| BGFX_STATE_MSAA
+						);
+					changedStencil = 0;
+				}
+				else
+				{
+					stateBlock = invalidHandle;
 				}
 
 				if ( (BGFX_STATE_DEPTH_WRITE|BGFX_STATE_DEPTH_TEST_MASK) & changedFlags
@@ -2488,8 +2651,7 @@ namespace bgfx
 				}
 
 				bool programChanged = false;
-				bool constantsChanged = state.m_constBegin < state.m_constEnd;
-				rendererUpdateUniforms(m_render->m_constantBuffer, state.m_constBegin, state.m_constEnd);
+				bool constantsChanged = rendererUpdateUniforms(state, uniformBlock);
 
 				if (key.m_program != programIdx)
 				{
@@ -2532,7 +2694,9 @@ namespace bgfx
 
 					if (constantsChanged)
 					{
-						program.commit();
+						// Same program keeps values of uniforms that didn't change.
+						program.commit(programChanged ? NULL : m_uniformDirty);
+						memset(m_uniformDirty, 0, sizeof(m_uniformDirty) );
 					}
 
 					for (uint32_t ii = 0, num = program.m_numPredefined; ii < num; ++ii)
@@ -2571,7 +2735,7 @@ namespace bgfx
 
 						case PredefinedUniform::ViewProj:
 							{
-								s_renderCtx->setShaderConstant(flags, predefined.m_loc, viewProj[view].un.val, bx::uint32_min(4, predefined.m_count) );
+								s_renderCtx->setShaderConstant(flags, predefined.m_loc, m_predefinedMatrixCache.m_viewProj[view].un.val, bx::uint32_min(4, predefined.m_count) );
 							}
 							break;
 
@@ -2584,44 +2748,28 @@ namespace bgfx
 
 						case PredefinedUniform::ModelView:
 							{
-								Matrix4 modelView;
-								const Matrix4& model = m_render->m_matrixCache.m_cache[state.m_matrix];
-								bx::float4x4_mul(&modelView.un.f4x4, &model.un.f4x4, &m_render->m_view[view].un.f4x4);
+								const Matrix4& modelView = m_predefinedMatrixCache.get(item, PredefinedMatrixCache::ModelView);
 								s_renderCtx->setShaderConstant(flags, predefined.m_loc, modelView.un.val, bx::uint32_min(4, predefined.m_count) );
 							}
 							break;
 
 						case PredefinedUniform::ModelViewProj:
 							{
-								Matrix4 modelViewProj;
-								const Matrix4& model = m_render->m_matrixCache.m_cache[state.m_matrix];
-								bx::float4x4_mul(&modelViewProj.un.f4x4, &model.un.f4x4, &viewProj[view].un.f4x4);
+								const Matrix4& modelViewProj = m_predefinedMatrixCache.get(item, PredefinedMatrixCache::ModelViewProj);
 								s_renderCtx->setShaderConstant(flags, predefined.m_loc, modelViewProj.un.val, bx::uint32_min(4, predefined.m_count) );
 							}
 							break;
 
 						case PredefinedUniform::ModelViewProjX:
 							{
-								const Matrix4& model = m_render->m_matrixCache.m_cache[state.m_matrix];
-
-								uint8_t other = m_render->m_other[view];
-								Matrix4 viewProjBias;
-								bx::float4x4_mul(&viewProjBias.un.f4x4, &viewProj[other].un.f4x4, &s_bias.un.f4x4);
-
-								Matrix4 modelViewProj;
-								bx::float4x4_mul(&modelViewProj.un.f4x4, &model.un.f4x4, &viewProjBias.un.f4x4);
-
+								const Matrix4& modelViewProj = m_predefinedMatrixCache.get(item, PredefinedMatrixCache::ModelViewProjX);
 								s_renderCtx->setShaderConstant(flags, predefined.m_loc, modelViewProj.un.val, bx::uint32_min(4, predefined.m_count) );
 							}
 							break;
 
 						case PredefinedUniform::ViewProjX:
 							{
-								uint8_t other = m_render->m_other[view];
-								Matrix4 viewProjBias;
-								bx::float4x4_mul(&viewProjBias.un.f4x4, &viewProj[other].un.f4x4, &s_bias.un.f4x4);
-
-								s_renderCtx->setShaderConstant(flags, predefined.m_loc, viewProjBias.un.val, bx::uint32_min(4, predefined.m_count) );
+								s_renderCtx->setShaderConstant(flags, predefined.m_loc, m_predefinedMatrixCache.m_viewProjBias[view].un.val, bx::uint32_min(4, predefined.m_count) );
 							}
 							break;
 
@@ -2883,6 +3031,8 @@ namespace bgfx
 				tvm.printf(10, pos++, 0x8e, "     Indices: %7d", statsNumIndices);
 				tvm.printf(10, pos++, 0x8e, "    DVB size: %7d", m_render->m_vboffset);
 				tvm.printf(10, pos++, 0x8e, "    DIB size: %7d", m_render->m_iboffset);
+				tvm.printf(10, pos++, 0x8e, "    Textures: %7d [KiB]", uint32_t(m_render->m_textureMemoryUsed>>10) );
+				tvm.printf(10, pos++, 0x8e, "    Resident: %7d [KiB]", uint32_t(m_render->m_textureMemoryResident>>10) );
 
 				uint8_t attr[2] = { 0x89, 0x8a };
 				uint8_t attrIndex = m_render->m_waitSubmit < m_render->m_waitRender;
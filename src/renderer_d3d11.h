@@ -204,16 +204,16 @@ namespace bgfx
 			m_fsh = NULL;
 		}
 
-		void commit()
+		void commit(const uint32_t* _mask = NULL)
 		{
 			if (NULL != m_vsh->m_constantBuffer)
 			{
-				m_vsh->m_constantBuffer->commit();
+				m_vsh->m_constantBuffer->commit(_mask);
 			}
 
 			if (NULL != m_fsh->m_constantBuffer)
 			{
-				m_fsh->m_constantBuffer->commit();
+				m_fsh->m_constantBuffer->commit(_mask);
 			}
 		}
 
@@ -243,6 +243,7 @@ namespace bgfx
 
 		void create(const Memory* _mem, uint32_t _flags, uint8_t _skip);
 		void destroy();
+		bool resize(uint32_t _width, uint32_t _height, uint8_t _numMips);
 		void update(uint8_t _side, uint8_t _mip, const Rect& _rect, uint16_t _z, uint16_t _depth, uint16_t _pitch, const Memory* _mem);
 		void commit(uint8_t _stage, uint32_t _flags = BGFX_SAMPLER_DEFAULT_FLAGS);
 		void resolve();
@@ -281,6 +282,31 @@ namespace bgfx
 		uint8_t m_num;
 	};
 
+	struct NativeStateBlock
+	{
+		NativeStateBlock()
+			: m_blendState(NULL)
+			, m_depthStencilState(NULL)
+			, m_cacheGeneration(UINT32_MAX)
+		{
+			m_rasterizerState[0] = NULL;
+			m_rasterizerState[1] = NULL;
+		}
+
+		uint64_t m_flags;
+		uint64_t m_stencil;
+		uint32_t m_rgba;
+
+		// State objects are owned by state caches, block is resolved again
+		// when caches are invalidated.
+		ID3D11BlendState* m_blendState;
+		ID3D11DepthStencilState* m_depthStencilState;
+		ID3D11RasterizerState* m_rasterizerState[2]; //!< Without and with scissor test.
+		float m_blendFactor[4];
+		uint32_t m_stencilRef;
+		uint32_t m_cacheGeneration;
+	};
+
 } // namespace bgfx
 
 #endif // BGFX_RENDERER_D3D11_H_HEADER_GUARD
@@ -1034,6 +1034,7 @@ namespace bgfx
 		FrameBuffer m_frameBuffers[BGFX_CONFIG_MAX_FRAME_BUFFERS];
 		UniformRegistry m_uniformReg;
 		void* m_uniforms[BGFX_CONFIG_MAX_UNIFORMS];
+		NativeStateBlock m_stateBlocks[BGFX_CONFIG_MAX_STATES];
 
 		uint32_t m_samplerFlags[BGFX_STATE_TEX_COUNT];
 
@@ -1756,6 +1757,52 @@ namespace bgfx
 		}
 	}
 
+	bool Texture::resize(uint32_t _width, uint32_t _height, uint8_t _numMips)
+	{
+		BX_CHECK(Texture2D == m_type, "Only 2D textures can be resized.");
+
+		const TextureFormat::Enum fmt = TextureFormat::Enum(m_textureFormat);
+		const ImageBlockInfo& blockInfo = getBlockInfo(fmt);
+		const uint32_t blockHeight = isCompressed(fmt) ? blockInfo.blockHeight : 1;
+
+		IDirect3DTexture9* texture = m_texture2d;
+		const uint8_t numMips = m_numMips;
+		createTexture(bx::uint32_max(blockInfo.blockWidth, _width), bx::uint32_max(blockInfo.blockHeight, _height), _numMips);
+
+		// Both mip chains end with the same mip, mips present in both
+		// storages have the same size.
+		for (uint32_t lod = 0; lod < _numMips; ++lod)
+		{
+			const int32_t srcLod = int32_t(lod + numMips) - int32_t(_numMips);
+			if (0 <= srcLod)
+			{
+				D3DLOCKED_RECT srcRect;
+				DX_CHECK(texture->LockRect(srcLod, &srcRect, NULL, D3DLOCK_READONLY) );
+
+				D3DLOCKED_RECT dstRect;
+				DX_CHECK(m_texture2d->LockRect(lod, &dstRect, NULL, 0) );
+
+				const uint32_t height = bx::uint32_max(1, _height>>lod);
+				const uint32_t pitch  = bx::uint32_min(srcRect.Pitch, dstRect.Pitch);
+				const uint8_t* src = (const uint8_t*)srcRect.pBits;
+				uint8_t* dst = (uint8_t*)dstRect.pBits;
+				for (uint32_t yy = 0, num = (height+blockHeight-1)/blockHeight; yy < num; ++yy)
+				{
+					memcpy(dst, src, pitch);
+					src += srcRect.Pitch;
+					dst += dstRect.Pitch;
+				}
+
+				DX_CHECK(m_texture2d->UnlockRect(lod) );
+				DX_CHECK(texture->UnlockRect(srcLod) );
+			}
+		}
+
+		DX_RELEASE(texture, 0);
+
+		return true;
+	}
+
 	void Texture::updateBegin(uint8_t _side, uint8_t _mip)
 	{
 		uint32_t slicePitch;
@@ -2033,7 +2080,138 @@ namespace bgfx
 			) );
 	}
 
-	void ConstantBuffer::commit()
+	static const D3DRENDERSTATETYPE s_stateBlockRs[NativeStateBlock::Count] =
+	{
+		D3DRS_CULLMODE,
+		D3DRS_ZWRITEENABLE,
+		D3DRS_ZENABLE,
+		D3DRS_ZFUNC,
+		D3DRS_COLORWRITEENABLE,
+		D3DRS_ALPHABLENDENABLE,
+		D3DRS_SRCBLEND,
+		D3DRS_DESTBLEND,
+		D3DRS_BLENDOP,
+		D3DRS_SEPARATEALPHABLENDENABLE,
+		D3DRS_SRCBLENDALPHA,
+		D3DRS_DESTBLENDALPHA,
+		D3DRS_BLENDOPALPHA,
+		D3DRS_BLENDFACTOR,
+		D3DRS_MULTISAMPLEANTIALIAS,
+		D3DRS_STENCILENABLE,
+		D3DRS_TWOSIDEDSTENCILMODE,
+		D3DRS_STENCILREF,
+		D3DRS_STENCILMASK,
+		D3DRS_STENCILFUNC,
+		D3DRS_STENCILFAIL,
+		D3DRS_STENCILZFAIL,
+		D3DRS_STENCILPASS,
+		D3DRS_CCW_STENCILFUNC,
+		D3DRS_CCW_STENCILFAIL,
+		D3DRS_CCW_STENCILZFAIL,
+		D3DRS_CCW_STENCILPASS,
+	};
+
+	void NativeStateBlock::create(uint64_t _flags, uint64_t _stencil, uint32_t _rgba)
+	{
+		m_valid = 0;
+
+#define SET_RS(_enum, _value) \
+		m_value[(_enum)] = DWORD(_value); \
+		m_valid |= UINT32_C(1)<<(_enum)
+
+		const uint32_t cull = uint32_t( (_flags&BGFX_STATE_CULL_MASK)>>BGFX_STATE_CULL_SHIFT);
+		SET_RS(CullMode, s_cullMode[cull]);
+		SET_RS(ZWriteEnable, !!(BGFX_STATE_DEPTH_WRITE & _flags) );
+
+		const uint32_t func = uint32_t( (_flags&BGFX_STATE_DEPTH_TEST_MASK)>>BGFX_STATE_DEPTH_TEST_SHIFT);
+		SET_RS(ZEnable, 0 != func);
+		if (0 != func)
+		{
+			SET_RS(ZFunc, s_cmpFunc[func]);
+		}
+
+		uint32_t writeEnable = (_flags&BGFX_STATE_ALPHA_WRITE) ? D3DCOLORWRITEENABLE_ALPHA : 0;
+		writeEnable |= (_flags&BGFX_STATE_RGB_WRITE) ? D3DCOLORWRITEENABLE_RED|D3DCOLORWRITEENABLE_GREEN|D3DCOLORWRITEENABLE_BLUE : 0;
+		SET_RS(ColorWriteEnable, writeEnable);
+
+		const bool enabled = !!(BGFX_STATE_BLEND_MASK & _flags);
+		SET_RS(AlphaBlendEnable, enabled);
+		if (enabled)
+		{
+			const uint32_t blend    = uint32_t( (_flags&BGFX_STATE_BLEND_MASK)>>BGFX_STATE_BLEND_SHIFT);
+			const uint32_t equation = uint32_t( (_flags&BGFX_STATE_BLEND_EQUATION_MASK)>>BGFX_STATE_BLEND_EQUATION_SHIFT);
+
+			const uint32_t srcRGB  = (blend    )&0xf;
+			const uint32_t dstRGB  = (blend>> 4)&0xf;
+			const uint32_t srcA    = (blend>> 8)&0xf;
+			const uint32_t dstA    = (blend>>12)&0xf;
+
+			const uint32_t equRGB = (equation   )&0x7;
+			const uint32_t equA   = (equation>>3)&0x7;
+
+			SET_RS(SrcBlend,  s_blendFactor[srcRGB].m_src);
+			SET_RS(DestBlend, s_blendFactor[dstRGB].m_dst);
+			SET_RS(BlendOp,   s_blendEquation[equRGB]);
+
+			const bool separate = srcRGB != srcA || dstRGB != dstA || equRGB != equA;
+			SET_RS(SeparateAlphaBlendEnable, separate);
+			if (separate)
+			{
+				SET_RS(SrcBlendAlpha,  s_blendFactor[srcA].m_src);
+				SET_RS(DestBlendAlpha, s_blendFactor[dstA].m_dst);
+				SET_RS(BlendOpAlpha,   s_blendEquation[equA]);
+			}
+
+			if (s_blendFactor[srcRGB].m_factor || s_blendFactor[dstRGB].m_factor)
+			{
+				SET_RS(BlendFactor, D3DCOLOR_RGBA(_rgba>>24, (_rgba>>16)&0xff, (_rgba>>8)&0xff, _rgba&0xff) );
+			}
+		}
+
+		SET_RS(MultisampleAntialias, (_flags&BGFX_STATE_MSAA) == BGFX_STATE_MSAA);
+
+		SET_RS(StencilEnable, 0 != _stencil);
+		if (0 != _stencil)
+		{
+			uint32_t fstencil = unpackStencil(0, _stencil);
+			uint32_t bstencil = unpackStencil(1, _stencil);
+			uint32_t frontAndBack = bstencil != BGFX_STENCIL_NONE && bstencil != fstencil;
+			SET_RS(TwoSidedStencilMode, 0 != frontAndBack);
+			SET_RS(StencilRef,  (fstencil&BGFX_STENCIL_FUNC_REF_MASK)>>BGFX_STENCIL_FUNC_REF_SHIFT);
+			SET_RS(StencilMask, (fstencil&BGFX_STENCIL_FUNC_RMASK_MASK)>>BGFX_STENCIL_FUNC_RMASK_SHIFT);
+
+			for (uint32_t ii = 0, num = frontAndBack+1; ii < num; ++ii)
+			{
+				const uint32_t stencil = unpackStencil(ii, _stencil);
+				const uint32_t offset  = ii*(CcwStencilFunc-StencilFunc);
+				const uint32_t sfunc = (stencil&BGFX_STENCIL_TEST_MASK)>>BGFX_STENCIL_TEST_SHIFT;
+				const uint32_t sfail = (stencil&BGFX_STENCIL_OP_FAIL_S_MASK)>>BGFX_STENCIL_OP_FAIL_S_SHIFT;
+				const uint32_t zfail = (stencil&BGFX_STENCIL_OP_FAIL_Z_MASK)>>BGFX_STENCIL_OP_FAIL_Z_SHIFT;
+				const uint32_t zpass = (stencil&BGFX_STENCIL_OP_PASS_Z_MASK)>>BGFX_STENCIL_OP_PASS_Z_SHIFT;
+				SET_RS(StencilFunc +offset, s_cmpFunc[sfunc]);
+				SET_RS(StencilFail +offset, s_stencilOp[sfail]);
+				SET_RS(StencilZFail+offset, s_stencilOp[zfail]);
+				SET_RS(StencilPass +offset, s_stencilOp[zpass]);
+			}
+		}
+
+#undef SET_RS
+	}
+
+	void NativeStateBlock::apply(IDirect3DDevice9* _device, const NativeStateBlock* _prev) const
+	{
+		for (uint32_t ii = 0; ii < Count; ++ii)
+		{
+			const uint32_t bit = UINT32_C(1)<<ii;
+			if (0 != (m_valid & bit)
+			&& (NULL == _prev || 0 == (_prev->m_valid & bit) || _prev->m_value[ii] != m_value[ii]) )
+			{
+				DX_CHECK(_device->SetRenderState(s_stateBlockRs[ii], m_value[ii]) );
+			}
+		}
+	}
+
+	void ConstantBuffer::commit(const uint32_t* _mask)
 	{
 		reset();
 
@@ -2053,6 +2231,7 @@ namespace bgfx
 			decodeOpcode(opcode, type, loc, num, copy);
 
 			const char* data;
+			bool skip = false;
 			if (copy)
 			{
 				data = read(g_uniformTypeSize[type]*num);
@@ -2062,6 +2241,14 @@ namespace bgfx
 				UniformHandle handle;
 				memcpy(&handle, read(sizeof(UniformHandle) ), sizeof(UniformHandle) );
 				data = (const char*)s_renderCtx->m_uniforms[handle.idx];
+				skip = NULL != _mask
+					&& 0 == (_mask[handle.idx/32] & (UINT32_C(1)<<(handle.idx%32) ) )
+					;
+			}
+
+			if (skip)
+			{
+				continue;
 			}
 
 #define CASE_IMPLEMENT_UNIFORM(_uniform, _glsuffix, _dxsuffix, _type) \
@@ -2261,7 +2448,9 @@ namespace bgfx
 
 	void Context::rendererCreateProgram(ProgramHandle _handle, ShaderHandle _vsh, ShaderHandle _fsh)
 	{
-		s_renderCtx->m_program[_handle.idx].create(s_renderCtx->m_shaders[_vsh.idx], s_renderCtx->m_shaders[_fsh.idx]);
+		Program& program = s_renderCtx->m_program[_handle.idx];
+		program.create(s_renderCtx->m_shaders[_vsh.idx], s_renderCtx->m_shaders[_fsh.idx]);
+		m_predefinedMatrixCache.setProgram(_handle.idx, program.m_predefined, program.m_numPredefined);
 	}
 
 	void Context::rendererDestroyProgram(ProgramHandle _handle)
@@ -2296,6 +2485,20 @@ namespace bgfx
 		s_renderCtx->m_textures[_handle.idx].destroy();
 	}
 
+	bool Context::rendererResizeTexture(TextureHandle _handle, uint16_t _width, uint16_t _height, uint8_t _numMips)
+	{
+		return s_renderCtx->m_textures[_handle.idx].resize(_width, _height, _numMips);
+	}
+
+	void Context::rendererUpdateTextureBaseMip(TextureHandle _handle, uint8_t _mip)
+	{
+		// LOD clamp works only for managed textures.
+		if (D3DPOOL_MANAGED == s_renderCtx->m_pool)
+		{
+			s_renderCtx->m_textures[_handle.idx].m_ptr->SetLOD(_mip);
+		}
+	}
+
 	void Context::rendererCreateFrameBuffer(FrameBufferHandle _handle, uint8_t _num, const TextureHandle* _textureHandles)
 	{
 		s_renderCtx->m_frameBuffers[_handle.idx].create(_num, _textureHandles);
@@ -2326,6 +2529,16 @@ namespace bgfx
 		s_renderCtx->m_uniforms[_handle.idx] = NULL;
 	}
 
+	void Context::rendererCreateState(StateHandle _handle, const StateBlock& _block)
+	{
+		s_renderCtx->m_stateBlocks[_handle.idx].create(_block.m_flags, _block.m_stencil, _block.m_rgba);
+	}
+
+	void Context::rendererDestroyState(StateHandle _handle)
+	{
+		s_renderCtx->m_stateBlocks[_handle.idx].m_valid = 0;
+	}
+
 	void Context::rendererSaveScreenShot(const char* _filePath)
 	{
 		s_renderCtx->saveScreenShot(_filePath);
@@ -2384,16 +2597,14 @@ namespace bgfx
 		currentState.m_flags = BGFX_STATE_NONE;
 		currentState.m_stencil = packStencil(BGFX_STENCIL_NONE, BGFX_STENCIL_NONE);
 
-		Matrix4 viewProj[BGFX_CONFIG_MAX_VIEWS];
-		for (uint32_t ii = 0; ii < BGFX_CONFIG_MAX_VIEWS; ++ii)
-		{
-			bx::float4x4_mul(&viewProj[ii].un.f4x4, &m_render->m_view[ii].un.f4x4, &m_render->m_proj[ii].un.f4x4);
-		}
+		m_predefinedMatrixCache.reset(m_render, s_bias);
 
 		DX_CHECK(device->SetRenderState(D3DRS_FILLMODE, m_render->m_debug&BGFX_DEBUG_WIREFRAME ? D3DFILL_WIREFRAME : D3DFILL_SOLID) );
 		uint16_t programIdx = invalidHandle;
+		uint16_t uniformBlock = invalidHandle;
+		uint16_t stateBlock = invalidHandle;
 		SortKey key;
-		uint8_t view = 0xff;
+		uint16_t view = UINT16_MAX;
 		FrameBufferHandle fbh = BGFX_INVALID_HANDLE;
 		float alphaRef = 0.0f;
 		uint32_t blendFactor = 0;
@@ -2506,6 +2717,8 @@ namespace bgfx
 					DX_CHECK(device->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE) );
 					DX_CHECK(device->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE) );
 					DX_CHECK(device->SetRenderState(D3DRS_ALPHAFUNC, D3DCMP_GREATER) );
+
+					stateBlock = invalidHandle;
 				}
 
 				uint16_t scissor = state.m_scissor;
@@ -2540,6 +2753,35 @@ namespace bgfx
 					}
 				}
 
+				if (invalidHandle != state.m_stateBlock)
+				{
+					// Render state values of block are translated at creation,
+					// only values different from previous block are set.
+					if (stateBlock != state.m_stateBlock)
+					{
+						const NativeStateBlock* prev = invalidHandle != stateBlock ? &s_renderCtx->m_stateBlocks[stateBlock] : NULL;
+						s_renderCtx->m_stateBlocks[state.m_stateBlock].apply(device, prev);
+						stateBlock = state.m_stateBlock;
+					}
+
+					changedFlags &= ~(0
+						| BGFX_STATE_CULL_MASK
+						| BGFX_STATE_DEPTH_WRITE
+						| BGFX_STATE_DEPTH_TEST_MASK
+						| BGFX_STATE_RGB_WRITE
+						| BGFX_STATE_ALPHA_WRITE
+						| BGFX_STATE_BLEND_MASK
+						| BGFX_STATE_BLEND_EQUATION_MASK
+						| BGFX_STATE_MSAA
+						);
+					changedStencil = 0;
+					blendFactor = state.m_rgba;
+				}
+				else
+				{
+					stateBlock = invalidHandle;
+				}
+
 				if (0 != changedStencil)
 				{
 					bool enable = 0 != newStencil;
@@ -2709,8 +2951,7 @@ namespace bgfx
 				}
 
 				bool programChanged = false;
-				bool constantsChanged = state.m_constBegin < state.m_constEnd;
-				rendererUpdateUniforms(m_render->m_constantBuffer, state.m_constBegin, state.m_constEnd);
+				bool constantsChanged = rendererUpdateUniforms(state, uniformBlock);
 
 				if (key.m_program != programIdx)
 				{
@@ -2738,7 +2979,9 @@ namespace bgfx
 
 					if (constantsChanged)
 					{
-						program.commit();
+						// Same program keeps values of uniforms that didn't change.
+						program.commit(programChanged ? NULL : m_uniformDirty);
+						memset(m_uniformDirty, 0, sizeof(m_uniformDirty) );
 					}
 
 					for (uint32_t ii = 0, num = program.m_numPredefined; ii < num; ++ii)
@@ -2777,7 +3020,7 @@ namespace bgfx
 
 						case PredefinedUniform::ViewProj:
 							{
-								s_renderCtx->setShaderConstantF(flags, predefined.m_loc, viewProj[view].un.val, bx::uint32_min(4, predefined.m_count) );
+								s_renderCtx->setShaderConstantF(flags, predefined.m_loc, m_predefinedMatrixCache.m_viewProj[view].un.val, bx::uint32_min(4, predefined.m_count) );
 							}
 							break;
 
@@ -2790,44 +3033,28 @@ namespace bgfx
 
 						case PredefinedUniform::ModelView:
 							{
-								Matrix4 modelView;
-								const Matrix4& model = m_render->m_matrixCache.m_cache[state.m_matrix];
-								bx::float4x4_mul(&modelView.un.f4x4, &model.un.f4x4, &m_render->m_view[view].un.f4x4);
+								const Matrix4& modelView = m_predefinedMatrixCache.get(item, PredefinedMatrixCache::ModelView);
 								s_renderCtx->setShaderConstantF(flags, predefined.m_loc, modelView.un.val, bx::uint32_min(4, predefined.m_count) );
 							}
 							break;
 
 						case PredefinedUniform::ModelViewProj:
 							{
-								Matrix4 modelViewProj;
-								const Matrix4& model = m_render->m_matrixCache.m_cache[state.m_matrix];
-								bx::float4x4_mul(&modelViewProj.un.f4x4, &model.un.f4x4, &viewProj[view].un.f4x4);
+								const Matrix4& modelViewProj = m_predefinedMatrixCache.get(item, PredefinedMatrixCache::ModelViewProj);
 								s_renderCtx->setShaderConstantF(flags, predefined.m_loc, modelViewProj.un.val, bx::uint32_min(4, predefined.m_count) );
 							}
 							break;
 
 						case PredefinedUniform::ModelViewProjX:
 							{
-								const Matrix4& model = m_render->m_matrixCache.m_cache[state.m_matrix];
-
-								uint8_t other = m_render->m_other[view];
-								Matrix4 viewProjBias;
-								bx::float4x4_mul(&viewProjBias.un.f4x4, &viewProj[other].un.f4x4, &s_bias.un.f4x4);
-
-								Matrix4 modelViewProj;
-								bx::float4x4_mul(&modelViewProj.un.f4x4, &model.un.f4x4, &viewProjBias.un.f4x4);
-
+								const Matrix4& modelViewProj = m_predefinedMatrixCache.get(item, PredefinedMatrixCache::ModelViewProjX);
 								s_renderCtx->setShaderConstantF(flags, predefined.m_loc, modelViewProj.un.val, bx::uint32_min(4, predefined.m_count) );
 							}
 							break;
 
 						case PredefinedUniform::ViewProjX:
 							{
-								uint8_t other = m_render->m_other[view];
-								Matrix4 viewProjBias;
-								bx::float4x4_mul(&viewProjBias.un.f4x4, &viewProj[other].un.f4x4, &s_bias.un.f4x4);
-
-								s_renderCtx->setShaderConstantF(flags, predefined.m_loc, viewProjBias.un.val, bx::uint32_min(4, predefined.m_count) );
+								s_renderCtx->setShaderConstantF(flags, predefined.m_loc, m_predefinedMatrixCache.m_viewProjBias[view].un.val, bx::uint32_min(4, predefined.m_count) );
 							}
 							break;
 
@@ -3075,6 +3302,8 @@ namespace bgfx
 				tvm.printf(10, pos++, 0x8e, "     Indices: %7d", statsNumIndices);
 				tvm.printf(10, pos++, 0x8e, "    DVB size: %7d", m_render->m_vboffset);
 				tvm.printf(10, pos++, 0x8e, "    DIB size: %7d", m_render->m_iboffset);
+				tvm.printf(10, pos++, 0x8e, "    Textures: %7d [KiB]", uint32_t(m_render->m_textureMemoryUsed>>10) );
+				tvm.printf(10, pos++, 0x8e, "    Resident: %7d [KiB]", uint32_t(m_render->m_textureMemoryResident>>10) );
 
 				uint8_t attr[2] = { 0x89, 0x8a };
 				uint8_t attrIndex = m_render->m_waitSubmit < m_render->m_waitRender;
@@ -267,16 +267,16 @@ namespace bgfx
 			m_fsh = NULL;
 		}
 
-		void commit()
+		void commit(const uint32_t* _mask = NULL)
 		{
 			if (NULL != m_vsh->m_constantBuffer)
 			{
-				m_vsh->m_constantBuffer->commit();
+				m_vsh->m_constantBuffer->commit(_mask);
 			}
 
 			if (NULL != m_fsh->m_constantBuffer)
 			{
-				m_fsh->m_constantBuffer->commit();
+				m_fsh->m_constantBuffer->commit(_mask);
 			}
 		}
 
@@ -312,6 +312,7 @@ namespace bgfx
 		void dirty(uint8_t _side, const Rect& _rect, uint16_t _z, uint16_t _depth);
 
 		void create(const Memory* _mem, uint32_t _flags, uint8_t _skip);
+		bool resize(uint32_t _width, uint32_t _height, uint8_t _numMips);
 
 		void destroy()
 		{
@@ -371,6 +372,53 @@ namespace bgfx
 		bool m_needResolve;
 	};
 
+	struct NativeStateBlock
+	{
+		enum Enum
+		{
+			CullMode,
+			ZWriteEnable,
+			ZEnable,
+			ZFunc,
+			ColorWriteEnable,
+			AlphaBlendEnable,
+			SrcBlend,
+			DestBlend,
+			BlendOp,
+			SeparateAlphaBlendEnable,
+			SrcBlendAlpha,
+			DestBlendAlpha,
+			BlendOpAlpha,
+			BlendFactor,
+			MultisampleAntialias,
+			StencilEnable,
+			TwoSidedStencilMode,
+			StencilRef,
+			StencilMask,
+			StencilFunc,
+			StencilFail,
+			StencilZFail,
+			StencilPass,
+			CcwStencilFunc,
+			CcwStencilFail,
+			CcwStencilZFail,
+			CcwStencilPass,
+
+			Count
+		};
+
+		NativeStateBlock()
+			: m_valid(0)
+		{
+		}
+
+		void create(uint64_t _flags, uint64_t _stencil, uint32_t _rgba);
+		void apply(IDirect3DDevice9* _device, const NativeStateBlock* _prev) const;
+
+		DWORD m_value[Count];
+		uint32_t m_valid; //!< Bit per render state that block sets.
+	};
+
 } // namespace bgfx
 
 #endif // BGFX_RENDERER_D3D9_H_HEADER_GUARD
@@ -215,6 +215,7 @@ namespace bgfx
 			APPLE_texture_format_BGRA8888,
 			APPLE_texture_max_level,
 
+			ARB_copy_image,
 			ARB_debug_label,
 			ARB_debug_output,
 			ARB_depth_clamp,
@@ -348,6 +349,7 @@ namespace bgfx
 		{ "APPLE_texture_format_BGRA8888",         false,                             true  },
 		{ "APPLE_texture_max_level",               false,                             true  },
 
+		{ "ARB_copy_image",                        BGFX_CONFIG_RENDERER_OPENGL >= 43, true  },
 		{ "ARB_debug_label",                       false,                             true  },
 		{ "ARB_debug_output",                      BGFX_CONFIG_RENDERER_OPENGL >= 43, true  },
 		{ "ARB_depth_clamp",                       BGFX_CONFIG_RENDERER_OPENGL >= 32, true  },
@@ -1366,6 +1368,11 @@ namespace bgfx
 				: 0
 				;
 
+			g_caps.supported |= !!(BGFX_CONFIG_RENDERER_OPENGLES >= 30) || s_extension[Extension::EXT_texture_array].m_supported
+				? BGFX_CAPS_TEXTURE_2D_ARRAY
+				: 0
+				;
+
 			g_caps.supported |= s_extension[Extension::ARB_draw_buffers_blend].m_supported
 				? BGFX_CAPS_BLEND_INDEPENDENT
 				: 0
@@ -1557,6 +1564,7 @@ namespace bgfx
 		FrameBuffer m_frameBuffers[BGFX_CONFIG_MAX_FRAME_BUFFERS];
 		UniformRegistry m_uniformReg;
 		void* m_uniforms[BGFX_CONFIG_MAX_UNIFORMS];
+		NativeStateBlock m_stateBlocks[BGFX_CONFIG_MAX_STATES];
 		Queries m_queries;
 
 		VaoStateCache m_vaoStateCache;
@@ -1621,6 +1629,7 @@ namespace bgfx
  			GLSL_TYPE(GL_SAMPLER_2D);
 			GLSL_TYPE(GL_SAMPLER_3D);
 			GLSL_TYPE(GL_SAMPLER_CUBE);
+			GLSL_TYPE(GL_SAMPLER_2D_ARRAY);
 // 			GLSL_TYPE(GL_SAMPLER_1D_SHADOW);
 			GLSL_TYPE(GL_SAMPLER_2D_SHADOW);
 		}
@@ -1693,6 +1702,7 @@ namespace bgfx
 		case GL_SAMPLER_2D:
 		case GL_SAMPLER_3D:
 		case GL_SAMPLER_CUBE:
+		case GL_SAMPLER_2D_ARRAY:
 // 		case GL_SAMPLER_1D_SHADOW:
  		case GL_SAMPLER_2D_SHADOW:
 			return UniformType::Uniform1iv;
@@ -1870,6 +1880,7 @@ namespace bgfx
 			case GL_SAMPLER_2D:
 			case GL_SAMPLER_3D:
 			case GL_SAMPLER_CUBE:
+			case GL_SAMPLER_2D_ARRAY:
 			case GL_SAMPLER_2D_SHADOW:
 				BX_TRACE("Sampler %d at %d.", m_numSamplers, loc);
 				m_sampler[m_numSamplers] = loc;
@@ -2002,7 +2013,8 @@ namespace bgfx
 
 	static void texImage(GLenum _target, GLint _level, GLint _internalFormat, GLsizei _width, GLsizei _height, GLsizei _depth, GLint _border, GLenum _format, GLenum _type, const GLvoid* _data)
 	{
-		if (_target == GL_TEXTURE_3D)
+		if (_target == GL_TEXTURE_3D
+		||  _target == GL_TEXTURE_2D_ARRAY)
 		{
 			GL_CHECK(glTexImage3D(_target, _level, _internalFormat, _width, _height, _depth, _border, _format, _type, _data) );
 		}
@@ -2015,7 +2027,8 @@ namespace bgfx
 
 	static void texSubImage(GLenum _target, GLint _level, GLint _xoffset, GLint _yoffset, GLint _zoffset, GLsizei _width, GLsizei _height, GLsizei _depth, GLenum _format, GLenum _type, const GLvoid* _data)
 	{
-		if (_target == GL_TEXTURE_3D)
+		if (_target == GL_TEXTURE_3D
+		||  _target == GL_TEXTURE_2D_ARRAY)
 		{
 			GL_CHECK(glTexSubImage3D(_target, _level, _xoffset, _yoffset, _zoffset, _width, _height, _depth, _format, _type, _data) );
 		}
@@ -2028,7 +2041,8 @@ namespace bgfx
 
 	static void compressedTexImage(GLenum _target, GLint _level, GLenum _internalformat, GLsizei _width, GLsizei _height, GLsizei _depth, GLint _border, GLsizei _imageSize, const GLvoid* _data)
 	{
-		if (_target == GL_TEXTURE_3D)
+		if (_target == GL_TEXTURE_3D
+		||  _target == GL_TEXTURE_2D_ARRAY)
 		{
 			GL_CHECK(glCompressedTexImage3D(_target, _level, _internalformat, _width, _height, _depth, _border, _imageSize, _data) );
 		}
@@ -2041,7 +2055,8 @@ namespace bgfx
 
 	static void compressedTexSubImage(GLenum _target, GLint _level, GLint _xoffset, GLint _yoffset, GLint _zoffset, GLsizei _width, GLsizei _height, GLsizei _depth, GLenum _format, GLsizei _imageSize, const GLvoid* _data)
 	{
-		if (_target == GL_TEXTURE_3D)
+		if (_target == GL_TEXTURE_3D
+		||  _target == GL_TEXTURE_2D_ARRAY)
 		{
 			GL_CHECK(glCompressedTexSubImage3D(_target, _level, _xoffset, _yoffset, _zoffset, _width, _height, _depth, _format, _imageSize, _data) );
 		}
@@ -2163,6 +2178,10 @@ namespace bgfx
 			{
 				target = GL_TEXTURE_CUBE_MAP;
 			}
+			else if (imageContainer.m_array)
+			{
+				target = GL_TEXTURE_2D_ARRAY;
+			}
 			else if (imageContainer.m_depth > 1)
 			{
 				target = GL_TEXTURE_3D;
@@ -2213,102 +2232,207 @@ namespace bgfx
 				temp = (uint8_t*)BX_ALLOC(g_allocator, textureWidth*textureHeight*4);
 			}
 
-			for (uint8_t side = 0, numSides = imageContainer.m_cubeMap ? 6 : 1; side < numSides; ++side)
+			if (GL_TEXTURE_2D_ARRAY == m_target)
 			{
+				// Layers of the same mip are not contiguous in DDS source data.
+				// Allocate whole mip level first, then upload layer by layer.
+				const uint16_t numLayers = imageContainer.m_numLayers;
 				uint32_t width  = textureWidth;
 				uint32_t height = textureHeight;
-				uint32_t depth  = imageContainer.m_depth;
 
 				for (uint32_t lod = 0, num = numMips; lod < num; ++lod)
 				{
 					width  = bx::uint32_max(blockWidth,  width);
 					height = bx::uint32_max(blockHeight, height);
-					depth  = bx::uint32_max(1, depth);
 
-					ImageMip mip;
-					if (imageGetRawData(imageContainer, side, lod+startLod, _mem->data, _mem->size, mip) )
+					if (compressed)
 					{
-						if (compressed)
-						{
-							compressedTexImage(target+side
-								, lod
-								, internalFmt
-								, width
-								, height
-								, depth
-								, 0
-								, mip.m_size
-								, mip.m_data
-								);
-						}
-						else
-						{
-							const uint8_t* data = mip.m_data;
+						uint32_t size = bx::uint32_max(1, (width  + 3)>>2)
+									  * bx::uint32_max(1, (height + 3)>>2)
+									  * 4*4*getBitsPerPixel(TextureFormat::Enum(m_textureFormat) )/8
+									  ;
+
+						compressedTexImage(target
+							, lod
+							, internalFmt
+							, width
+							, height
+							, numLayers
+							, 0
+							, size*numLayers
+							, NULL
+							);
+					}
+					else
+					{
+						texImage(target
+							, lod
+							, internalFmt
+							, width
+							, height
+							, numLayers
+							, 0
+							, m_fmt
+							, m_type
+							, NULL
+							);
+					}
 
-							if (convert)
+					for (uint16_t layer = 0; layer < numLayers; ++layer)
+					{
+						ImageMip mip;
+						if (imageGetRawData(imageContainer, layer, lod+startLod, _mem->data, _mem->size, mip) )
+						{
+							if (compressed)
 							{
-								imageDecodeToBgra8(temp, mip.m_data, mip.m_width, mip.m_height, mip.m_width*4, mip.m_format);
-								data = temp;
+								compressedTexSubImage(target
+									, lod
+									, 0
+									, 0
+									, layer
+									, width
+									, height
+									, 1
+									, internalFmt
+									, mip.m_size
+									, mip.m_data
+									);
 							}
-
-							if (swizzle)
+							else
 							{
-								imageSwizzleBgra8(width, height, mip.m_width*4, data, temp);
-								data = temp;
-							}
+								const uint8_t* data = mip.m_data;
 
-							texImage(target+side
-								, lod
-								, internalFmt
-								, width
-								, height
-								, depth
-								, 0
-								, m_fmt
-								, m_type
-								, data
-								);
+								if (convert)
+								{
+									imageDecodeToBgra8(temp, mip.m_data, mip.m_width, mip.m_height, mip.m_width*4, mip.m_format);
+									data = temp;
+								}
+
+								if (swizzle)
+								{
+									imageSwizzleBgra8(width, height, mip.m_width*4, data, temp);
+									data = temp;
+								}
+
+								texSubImage(target
+									, lod
+									, 0
+									, 0
+									, layer
+									, width
+									, height
+									, 1
+									, m_fmt
+									, m_type
+									, data
+									);
+							}
 						}
 					}
-					else
+
+					width  >>= 1;
+					height >>= 1;
+				}
+			}
+			else
+			{
+				for (uint8_t side = 0, numSides = imageContainer.m_cubeMap ? 6 : 1; side < numSides; ++side)
+				{
+					uint32_t width  = textureWidth;
+					uint32_t height = textureHeight;
+					uint32_t depth  = imageContainer.m_depth;
+
+					for (uint32_t lod = 0, num = numMips; lod < num; ++lod)
 					{
-						if (compressed)
+						width  = bx::uint32_max(blockWidth,  width);
+						height = bx::uint32_max(blockHeight, height);
+						depth  = bx::uint32_max(1, depth);
+
+						ImageMip mip;
+						if (imageGetRawData(imageContainer, side, lod+startLod, _mem->data, _mem->size, mip) )
 						{
-							uint32_t size = bx::uint32_max(1, (width  + 3)>>2)
-										  * bx::uint32_max(1, (height + 3)>>2)
-										  * 4*4*getBitsPerPixel(TextureFormat::Enum(m_textureFormat) )/8
-										  ;
-
-							compressedTexImage(target+side
-								, lod
-								, internalFmt
-								, width
-								, height
-								, depth
-								, 0
-								, size
-								, NULL
-								);
+							if (compressed)
+							{
+								compressedTexImage(target+side
+									, lod
+									, internalFmt
+									, width
+									, height
+									, depth
+									, 0
+									, mip.m_size
+									, mip.m_data
+									);
+							}
+							else
+							{
+								const uint8_t* data = mip.m_data;
+
+								if (convert)
+								{
+									imageDecodeToBgra8(temp, mip.m_data, mip.m_width, mip.m_height, mip.m_width*4, mip.m_format);
+									data = temp;
+								}
+
+								if (swizzle)
+								{
+									imageSwizzleBgra8(width, height, mip.m_width*4, data, temp);
+									data = temp;
+								}
+
+								texImage(target+side
+									, lod
+									, internalFmt
+									, width
+									, height
+									, depth
+									, 0
+									, m_fmt
+									, m_type
+									, data
+									);
+							}
 						}
 						else
 						{
-							texImage(target+side
-								, lod
-								, internalFmt
-								, width
-								, height
-								, depth
-								, 0
-								, m_fmt
-								, m_type
-								, NULL
-								);
+							if (compressed)
+							{
+								uint32_t size = bx::uint32_max(1, (width  + 3)>>2)
+											  * bx::uint32_max(1, (height + 3)>>2)
+											  * 4*4*getBitsPerPixel(TextureFormat::Enum(m_textureFormat) )/8
+											  ;
+
+								compressedTexImage(target+side
+									, lod
+									, internalFmt
+									, width
+									, height
+									, depth
+									, 0
+									, size
+									, NULL
+									);
+							}
+							else
+							{
+								texImage(target+side
+									, lod
+									, internalFmt
+									, width
+									, height
+									, depth
+									, 0
+									, m_fmt
+									, m_type
+									, NULL
+									);
+							}
 						}
-					}
 
-					width  >>= 1;
-					height >>= 1;
-					depth  >>= 1;
+						width  >>= 1;
+						height >>= 1;
+						depth  >>= 1;
+					}
 				}
 			}
 
@@ -2337,6 +2461,84 @@ namespace bgfx
 		}
 	}
 
+	bool Texture::resize(uint32_t _width, uint32_t _height, uint8_t _numMips)
+	{
+		BX_CHECK(GL_TEXTURE_2D == m_target, "Only 2D textures can be resized.");
+
+		GLuint id;
+		GL_CHECK(glGenTextures(1, &id) );
+		BX_CHECK(0 != id, "Failed to generate texture id.");
+		GL_CHECK(glBindTexture(m_target, id) );
+
+		if (BX_ENABLED(BGFX_CONFIG_RENDERER_OPENGL)
+		&&  TextureFormat::BGRA8 == m_textureFormat
+		&&  GL_RGBA == m_fmt
+		&&  s_renderCtx->m_textureSwizzleSupport)
+		{
+			GLint swizzleMask[] = { GL_BLUE, GL_GREEN, GL_RED, GL_ALPHA };
+			GL_CHECK(glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzleMask) );
+		}
+
+		const GLenum internalFmt = s_textureFormat[m_textureFormat].m_internalFmt;
+		const bool compressed = isCompressed(TextureFormat::Enum(m_textureFormat) );
+
+		for (uint32_t lod = 0, width = _width, height = _height; lod < _numMips; ++lod, width >>= 1, height >>= 1)
+		{
+			width  = bx::uint32_max(1, width);
+			height = bx::uint32_max(1, height);
+
+			if (compressed)
+			{
+				uint32_t size = bx::uint32_max(1, (width  + 3)>>2)
+							  * bx::uint32_max(1, (height + 3)>>2)
+							  * 4*4*getBitsPerPixel(TextureFormat::Enum(m_textureFormat) )/8
+							  ;
+
+				compressedTexImage(m_target, lod, internalFmt, width, height, 1, 0, size, NULL);
+			}
+			else
+			{
+				texImage(m_target, lod, internalFmt, width, height, 1, 0, m_fmt, m_type, NULL);
+			}
+		}
+
+		// Both mip chains end with the same mip, mips present in both
+		// storages have the same size.
+		bool preserved = false;
+#if BGFX_CONFIG_RENDERER_OPENGL
+		if (s_extension[Extension::ARB_copy_image].m_supported)
+		{
+			for (uint32_t lod = 0; lod < _numMips; ++lod)
+			{
+				const int32_t srcLod = int32_t(lod + m_numMips) - int32_t(_numMips);
+				if (0 <= srcLod)
+				{
+					GL_CHECK(glCopyImageSubData(m_id, m_target, srcLod, 0, 0, 0
+						, id, m_target, lod, 0, 0, 0
+						, bx::uint32_max(1, _width >>lod)
+						, bx::uint32_max(1, _height>>lod)
+						, 1
+						) );
+				}
+			}
+
+			preserved = true;
+		}
+#endif // BGFX_CONFIG_RENDERER_OPENGL
+
+		GL_CHECK(glDeleteTextures(1, &m_id) );
+		m_id = id;
+		m_width = _width;
+		m_height = _height;
+		m_numMips = _numMips;
+		m_currentFlags = UINT32_MAX;
+		setSamplerState(m_flags);
+
+		GL_CHECK(glBindTexture(m_target, 0) );
+
+		return preserved;
+	}
+
 	void Texture::update(uint8_t _side, uint8_t _mip, const Rect& _rect, uint16_t _z, uint16_t _depth, uint16_t _pitch, const Memory* _mem)
 	{
 		BX_UNUSED(_z, _depth);
@@ -3037,7 +3239,204 @@ namespace bgfx
 		}
 	}
 
-	void ConstantBuffer::commit()
+	void NativeStateBlock::create(uint64_t _flags, uint64_t _stencil, uint32_t _rgba)
+	{
+		// Independent blend depends on number of render targets of view,
+		// blocks using it are set through raw state path.
+		m_valid = 0 == (BGFX_STATE_BLEND_INDEPENDENT & _flags);
+
+		m_cullFace = BGFX_STATE_CULL_CW & _flags
+			? GL_BACK
+			: BGFX_STATE_CULL_CCW & _flags ? GL_FRONT : GL_NONE
+			;
+
+		const uint32_t func = uint32_t( (_flags&BGFX_STATE_DEPTH_TEST_MASK)>>BGFX_STATE_DEPTH_TEST_SHIFT);
+		m_depthFunc  = 0 != func ? s_cmpFunc[func] : GL_NONE;
+		m_depthWrite = !!(BGFX_STATE_DEPTH_WRITE & _flags);
+		m_rgbWrite   = !!(BGFX_STATE_RGB_WRITE & _flags);
+		m_alphaWrite = !!(BGFX_STATE_ALPHA_WRITE & _flags);
+		m_msaa       = !!(BGFX_STATE_MSAA & _flags);
+
+		const uint32_t blend    = uint32_t( (_flags&BGFX_STATE_BLEND_MASK)>>BGFX_STATE_BLEND_SHIFT);
+		const uint32_t equation = uint32_t( (_flags&BGFX_STATE_BLEND_EQUATION_MASK)>>BGFX_STATE_BLEND_EQUATION_SHIFT);
+
+		const uint32_t srcRGB  = (blend    )&0xf;
+		const uint32_t dstRGB  = (blend>> 4)&0xf;
+		const uint32_t srcA    = (blend>> 8)&0xf;
+		const uint32_t dstA    = (blend>>12)&0xf;
+
+		const uint32_t equRGB = (equation   )&0x7;
+		const uint32_t equA   = (equation>>3)&0x7;
+
+		m_blend = 0 != blend;
+		m_blendFunc[0] = s_blendFactor[srcRGB].m_src;
+		m_blendFunc[1] = s_blendFactor[dstRGB].m_dst;
+		m_blendFunc[2] = s_blendFactor[srcA].m_src;
+		m_blendFunc[3] = s_blendFactor[dstA].m_dst;
+		m_blendEquation[0] = s_blendEquation[equRGB];
+		m_blendEquation[1] = s_blendEquation[equA];
+		m_blendFactor = m_blend && (s_blendFactor[srcRGB].m_factor || s_blendFactor[dstRGB].m_factor);
+		m_blendColor[0] = ( (_rgba>>24)     )/255.0f;
+		m_blendColor[1] = ( (_rgba>>16)&0xff)/255.0f;
+		m_blendColor[2] = ( (_rgba>> 8)&0xff)/255.0f;
+		m_blendColor[3] = ( (_rgba    )&0xff)/255.0f;
+
+		m_numStencilFaces = 0;
+		if (0 != _stencil)
+		{
+			uint32_t bstencil = unpackStencil(1, _stencil);
+			uint32_t frontAndBack = bstencil != BGFX_STENCIL_NONE && bstencil != unpackStencil(0, _stencil);
+			m_numStencilFaces = uint8_t(frontAndBack+1);
+
+			for (uint32_t ii = 0; ii < m_numStencilFaces; ++ii)
+			{
+				uint32_t stencil = unpackStencil(ii, _stencil);
+				uint32_t sfunc = (stencil&BGFX_STENCIL_TEST_MASK)>>BGFX_STENCIL_TEST_SHIFT;
+				uint32_t sfail = (stencil&BGFX_STENCIL_OP_FAIL_S_MASK)>>BGFX_STENCIL_OP_FAIL_S_SHIFT;
+				uint32_t zfail = (stencil&BGFX_STENCIL_OP_FAIL_Z_MASK)>>BGFX_STENCIL_OP_FAIL_Z_SHIFT;
+				uint32_t zpass = (stencil&BGFX_STENCIL_OP_PASS_Z_MASK)>>BGFX_STENCIL_OP_PASS_Z_SHIFT;
+				m_stencilFace[ii]  = s_stencilFace[frontAndBack+ii];
+				m_stencilFunc[ii]  = s_cmpFunc[sfunc];
+				m_stencilRef[ii]   = (stencil&BGFX_STENCIL_FUNC_REF_MASK)>>BGFX_STENCIL_FUNC_REF_SHIFT;
+				m_stencilMask[ii]  = (stencil&BGFX_STENCIL_FUNC_RMASK_MASK)>>BGFX_STENCIL_FUNC_RMASK_SHIFT;
+				m_stencilOp[ii][0] = s_stencilOp[sfail];
+				m_stencilOp[ii][1] = s_stencilOp[zfail];
+				m_stencilOp[ii][2] = s_stencilOp[zpass];
+			}
+		}
+	}
+
+	void NativeStateBlock::apply(const NativeStateBlock* _prev) const
+	{
+		if (NULL == _prev
+		||  _prev->m_cullFace != m_cullFace)
+		{
+			if (GL_NONE == m_cullFace)
+			{
+				GL_CHECK(glDisable(GL_CULL_FACE) );
+			}
+			else
+			{
+				GL_CHECK(glEnable(GL_CULL_FACE) );
+				GL_CHECK(glCullFace(m_cullFace) );
+			}
+		}
+
+		if (NULL == _prev
+		||  _prev->m_depthWrite != m_depthWrite)
+		{
+			GL_CHECK(glDepthMask(m_depthWrite) );
+		}
+
+		if (NULL == _prev
+		||  _prev->m_depthFunc != m_depthFunc)
+		{
+			if (GL_NONE == m_depthFunc)
+			{
+				GL_CHECK(glDisable(GL_DEPTH_TEST) );
+			}
+			else
+			{
+				GL_CHECK(glEnable(GL_DEPTH_TEST) );
+				GL_CHECK(glDepthFunc(m_depthFunc) );
+			}
+		}
+
+#if BGFX_CONFIG_RENDERER_OPENGL
+		if (NULL == _prev
+		||  _prev->m_msaa != m_msaa)
+		{
+			if (m_msaa)
+			{
+				GL_CHECK(glEnable(GL_MULTISAMPLE) );
+			}
+			else
+			{
+				GL_CHECK(glDisable(GL_MULTISAMPLE) );
+			}
+		}
+#endif // BGFX_CONFIG_RENDERER_OPENGL
+
+		if (NULL == _prev
+		||  _prev->m_rgbWrite   != m_rgbWrite
+		||  _prev->m_alphaWrite != m_alphaWrite)
+		{
+			GL_CHECK(glColorMask(m_rgbWrite, m_rgbWrite, m_rgbWrite, m_alphaWrite) );
+		}
+
+		// Blend functions and equations of previous block are only known
+		// to be set when previous block had blending enabled.
+		const bool prevBlend = NULL != _prev && _prev->m_blend;
+		if (prevBlend != m_blend)
+		{
+			if (m_blend)
+			{
+				GL_CHECK(glEnable(GL_BLEND) );
+			}
+			else
+			{
+				GL_CHECK(glDisable(GL_BLEND) );
+			}
+		}
+
+		if (m_blend)
+		{
+			if (!prevBlend
+			||  0 != memcmp(_prev->m_blendFunc, m_blendFunc, sizeof(m_blendFunc) ) )
+			{
+				GL_CHECK(glBlendFuncSeparate(m_blendFunc[0], m_blendFunc[1], m_blendFunc[2], m_blendFunc[3]) );
+			}
+
+			if (!prevBlend
+			||  0 != memcmp(_prev->m_blendEquation, m_blendEquation, sizeof(m_blendEquation) ) )
+			{
+				GL_CHECK(glBlendEquationSeparate(m_blendEquation[0], m_blendEquation[1]) );
+			}
+
+			if (m_blendFactor
+			&& (!prevBlend || !_prev->m_blendFactor || 0 != memcmp(_prev->m_blendColor, m_blendColor, sizeof(m_blendColor) ) ) )
+			{
+				GL_CHECK(glBlendColor(m_blendColor[0], m_blendColor[1], m_blendColor[2], m_blendColor[3]) );
+			}
+		}
+
+		const uint8_t prevNumStencilFaces = NULL != _prev ? _prev->m_numStencilFaces : 0;
+		if (0 == m_numStencilFaces)
+		{
+			if (NULL == _prev
+			||  0 != prevNumStencilFaces)
+			{
+				GL_CHECK(glDisable(GL_STENCIL_TEST) );
+			}
+		}
+		else
+		{
+			if (0 == prevNumStencilFaces)
+			{
+				GL_CHECK(glEnable(GL_STENCIL_TEST) );
+			}
+
+			const bool sameFaces = prevNumStencilFaces == m_numStencilFaces;
+			for (uint32_t ii = 0; ii < m_numStencilFaces; ++ii)
+			{
+				if (!sameFaces
+				||  _prev->m_stencilFunc[ii] != m_stencilFunc[ii]
+				||  _prev->m_stencilRef[ii]  != m_stencilRef[ii]
+				||  _prev->m_stencilMask[ii] != m_stencilMask[ii])
+				{
+					GL_CHECK(glStencilFuncSeparate(m_stencilFace[ii], m_stencilFunc[ii], m_stencilRef[ii], m_stencilMask[ii]) );
+				}
+
+				if (!sameFaces
+				||  0 != memcmp(_prev->m_stencilOp[ii], m_stencilOp[ii], sizeof(m_stencilOp[ii]) ) )
+				{
+					GL_CHECK(glStencilOpSeparate(m_stencilFace[ii], m_stencilOp[ii][0], m_stencilOp[ii][1], m_stencilOp[ii][2]) );
+				}
+			}
+		}
+	}
+
+	void ConstantBuffer::commit(const uint32_t* _mask)
 	{
 		reset();
 
@@ -3057,6 +3456,7 @@ namespace bgfx
 			decodeOpcode(opcode, type, ignore, num, copy);
 
 			const char* data;
+			bool skip = false;
 			if (copy)
 			{
 				data = read(g_uniformTypeSize[type]*num);
@@ -3066,11 +3466,19 @@ namespace bgfx
 				UniformHandle handle;
 				memcpy(&handle, read(sizeof(UniformHandle) ), sizeof(UniformHandle) );
 				data = (const char*)s_renderCtx->m_uniforms[handle.idx];
+				skip = NULL != _mask
+					&& 0 == (_mask[handle.idx/32] & (UINT32_C(1)<<(handle.idx%32) ) )
+					;
 //				memcpy(&data, read(sizeof(void*) ), sizeof(void*) );
 			}
 
 			uint32_t loc = read();
 
+			if (skip)
+			{
+				continue;
+			}
+
 #define CASE_IMPLEMENT_UNIFORM(_uniform, _glsuffix, _dxsuffix, _type) \
 		case UniformType::_uniform: \
 			{ \
@@ -3425,7 +3833,9 @@ namespace bgfx
 	void Context::rendererCreateProgram(ProgramHandle _handle, ShaderHandle _vsh, ShaderHandle _fsh)
 	{
 		Shader dummyFragmentShader;
-		s_renderCtx->m_program[_handle.idx].create(s_renderCtx->m_shaders[_vsh.idx], isValid(_fsh) ? s_renderCtx->m_shaders[_fsh.idx] : dummyFragmentShader);
+		Program& program = s_renderCtx->m_program[_handle.idx];
+		program.create(s_renderCtx->m_shaders[_vsh.idx], isValid(_fsh) ? s_renderCtx->m_shaders[_fsh.idx] : dummyFragmentShader);
+		m_predefinedMatrixCache.setProgram(_handle.idx, program.m_predefined, program.m_numPredefined);
 	}
 
 	void Context::rendererDestroyProgram(ProgramHandle _handle)
@@ -3456,6 +3866,21 @@ namespace bgfx
 		s_renderCtx->m_textures[_handle.idx].destroy();
 	}
 
+	bool Context::rendererResizeTexture(TextureHandle _handle, uint16_t _width, uint16_t _height, uint8_t _numMips)
+	{
+		return s_renderCtx->m_textures[_handle.idx].resize(_width, _height, _numMips);
+	}
+
+	void Context::rendererUpdateTextureBaseMip(TextureHandle _handle, uint8_t _mip)
+	{
+		if (BX_ENABLED(BGFX_CONFIG_RENDERER_OPENGL || BGFX_CONFIG_RENDERER_OPENGLES >= 30) )
+		{
+			const Texture& texture = s_renderCtx->m_textures[_handle.idx];
+			GL_CHECK(glBindTexture(texture.m_target, texture.m_id) );
+			GL_CHECK(glTexParameteri(texture.m_target, GL_TEXTURE_BASE_LEVEL, _mip) );
+		}
+	}
+
 	void Context::rendererCreateFrameBuffer(FrameBufferHandle _handle, uint8_t _num, const TextureHandle* _textureHandles)
 	{
 		s_renderCtx->m_frameBuffers[_handle.idx].create(_num, _textureHandles);
@@ -3486,6 +3911,16 @@ namespace bgfx
 		s_renderCtx->m_uniforms[_handle.idx] = NULL;
 	}
 
+	void Context::rendererCreateState(StateHandle _handle, const StateBlock& _block)
+	{
+		s_renderCtx->m_stateBlocks[_handle.idx].create(_block.m_flags, _block.m_stencil, _block.m_rgba);
+	}
+
+	void Context::rendererDestroyState(StateHandle _handle)
+	{
+		s_renderCtx->m_stateBlocks[_handle.idx].m_valid = false;
+	}
+
 	void Context::rendererSaveScreenShot(const char* _filePath)
 	{
 		s_renderCtx->saveScreenShot(_filePath);
@@ -3546,15 +3981,13 @@ namespace bgfx
 		currentState.m_flags = BGFX_STATE_NONE;
 		currentState.m_stencil = packStencil(BGFX_STENCIL_NONE, BGFX_STENCIL_NONE);
 
-		Matrix4 viewProj[BGFX_CONFIG_MAX_VIEWS];
-		for (uint32_t ii = 0; ii < BGFX_CONFIG_MAX_VIEWS; ++ii)
-		{
-			float4x4_mul(&viewProj[ii].un.f4x4, &m_render->m_view[ii].un.f4x4, &m_render->m_proj[ii].un.f4x4);
-		}
+		m_predefinedMatrixCache.reset(m_render, s_bias);
 
 		uint16_t programIdx = invalidHandle;
+		uint16_t uniformBlock = invalidHandle;
+		uint16_t stateBlock = invalidHandle;
 		SortKey key;
-		uint8_t view = 0xff;
+		uint16_t view = UINT16_MAX;
 		FrameBufferHandle fbh = BGFX_INVALID_HANDLE;
 		int32_t height = m_render->m_resolution.m_height;
 		float alphaRef = 0.0f;
@@ -3630,6 +4063,8 @@ namespace bgfx
 					GL_CHECK(glDepthFunc(GL_LESS) );
 					GL_CHECK(glEnable(GL_CULL_FACE) );
 					GL_CHECK(glDisable(GL_BLEND) );
+
+					stateBlock = invalidHandle;
 				}
 
 				uint16_t scissor = state.m_scissor;
@@ -3658,6 +4093,37 @@ namespace bgfx
 					}
 				}
 
+				if (invalidHandle != state.m_stateBlock
+				&&  s_renderCtx->m_stateBlocks[state.m_stateBlock].m_valid)
+				{
+					// GL state of block is translated at creation, only state
+					// different from previous block is set.
+					if (stateBlock != state.m_stateBlock)
+					{
+						const NativeStateBlock* prev = invalidHandle != stateBlock ? &s_renderCtx->m_stateBlocks[stateBlock] : NULL;
+						s_renderCtx->m_stateBlocks[state.m_stateBlock].apply(prev);
+						stateBlock = state.m_stateBlock;
+					}
+
+					changedFlags &= ~(0
+						| BGFX_STATE_CULL_MASK
+						| BGFX_STATE_DEPTH_WRITE
+						| BGFX_STATE_DEPTH_TEST_MASK
+						| BGFX_STATE_RGB_WRITE
+						| BGFX_STATE_ALPHA_WRITE
+						| BGFX_STATE_BLEND_MASK
+						| BGFX_STATE_BLEND_EQUATION_MASK
+						| BGFX_STATE_BLEND_INDEPENDENT
+						| BGFX_STATE_MSAA
+						);
+					changedStencil = 0;
+					blendFactor = state.m_rgba;
+				}
+				else
+				{
+					stateBlock = invalidHandle;
+				}
+
 				if (0 != changedStencil)
 				{
 					if (0 != newStencil)
@@ -3896,9 +4362,8 @@ namespace bgfx
 				}
 
 				bool programChanged = false;
-				bool constantsChanged = state.m_constBegin < state.m_constEnd;
+				bool constantsChanged = rendererUpdateUniforms(state, uniformBlock);
 				bool bindAttribs = false;
-				rendererUpdateUniforms(m_render->m_constantBuffer, state.m_constBegin, state.m_constEnd);
 
 				if (key.m_program != programIdx)
 				{
@@ -3916,7 +4381,9 @@ namespace bgfx
 
 					if (constantsChanged)
 					{
-						program.commit();
+						// Same program keeps values of uniforms that didn't change.
+						program.commit(programChanged ? NULL : m_uniformDirty);
+						memset(m_uniformDirty, 0, sizeof(m_uniformDirty) );
 					}
 
 					for (uint32_t ii = 0, num = program.m_numPredefined; ii < num; ++ii)
@@ -3967,7 +4434,7 @@ namespace bgfx
 								GL_CHECK(glUniformMatrix4fv(predefined.m_loc
 									, 1
 									, GL_FALSE
-									, viewProj[view].un.val
+									, m_predefinedMatrixCache.m_viewProj[view].un.val
 									) );
 							}
 							break;
@@ -3985,10 +4452,7 @@ namespace bgfx
 
 						case PredefinedUniform::ModelView:
 							{
-								Matrix4 modelView;
-								const Matrix4& model = m_render->m_matrixCache.m_cache[state.m_matrix];
-								bx::float4x4_mul(&modelView.un.f4x4, &model.un.f4x4, &m_render->m_view[view].un.f4x4);
-
+								const Matrix4& modelView = m_predefinedMatrixCache.get(item, PredefinedMatrixCache::ModelView);
 								GL_CHECK(glUniformMatrix4fv(predefined.m_loc
 									, 1
 									, GL_FALSE
@@ -3999,10 +4463,7 @@ namespace bgfx
 
 						case PredefinedUniform::ModelViewProj:
 							{
-								Matrix4 modelViewProj;
-								const Matrix4& model = m_render->m_matrixCache.m_cache[state.m_matrix];
-								bx::float4x4_mul(&modelViewProj.un.f4x4, &model.un.f4x4, &viewProj[view].un.f4x4);
-
+								const Matrix4& modelViewProj = m_predefinedMatrixCache.get(item, PredefinedMatrixCache::ModelViewProj);
 								GL_CHECK(glUniformMatrix4fv(predefined.m_loc
 									, 1
 									, GL_FALSE
@@ -4013,15 +4474,7 @@ namespace bgfx
 
 						case PredefinedUniform::ModelViewProjX:
 							{
-								const Matrix4& model = m_render->m_matrixCache.m_cache[state.m_matrix];
-
-								uint8_t other = m_render->m_other[view];
-								Matrix4 viewProjBias;
-								bx::float4x4_mul(&viewProjBias.un.f4x4, &viewProj[other].un.f4x4, &s_bias.un.f4x4);
-
-								Matrix4 modelViewProj;
-								bx::float4x4_mul(&modelViewProj.un.f4x4, &model.un.f4x4, &viewProjBias.un.f4x4);
-
+								const Matrix4& modelViewProj = m_predefinedMatrixCache.get(item, PredefinedMatrixCache::ModelViewProjX);
 								GL_CHECK(glUniformMatrix4fv(predefined.m_loc
 									, 1
 									, GL_FALSE
@@ -4032,14 +4485,10 @@ namespace bgfx
 
 						case PredefinedUniform::ViewProjX:
 							{
-								uint8_t other = m_render->m_other[view];
-								Matrix4 viewProjBias;
-								bx::float4x4_mul(&viewProjBias.un.f4x4, &viewProj[other].un.f4x4, &s_bias.un.f4x4);
-
 								GL_CHECK(glUniformMatrix4fv(predefined.m_loc
 									, 1
 									, GL_FALSE
-									, viewProjBias.un.val
+									, m_predefinedMatrixCache.m_viewProjBias[view].un.val
 									) );
 							}
 							break;
@@ -4378,6 +4827,8 @@ namespace bgfx
 				tvm.printf(10, pos++, 0x8e, "    Indices: %7d", statsNumIndices);
 				tvm.printf(10, pos++, 0x8e, "   DVB size: %7d", m_render->m_vboffset);
 				tvm.printf(10, pos++, 0x8e, "   DIB size: %7d", m_render->m_iboffset);
+				tvm.printf(10, pos++, 0x8e, "   Textures: %7d [KiB]", uint32_t(m_render->m_textureMemoryUsed>>10) );
+				tvm.printf(10, pos++, 0x8e, "   Resident: %7d [KiB]", uint32_t(m_render->m_textureMemoryResident>>10) );
 
 #if BGFX_CONFIG_RENDERER_OPENGL
 				if (s_extension[Extension::ATI_meminfo].m_supported)
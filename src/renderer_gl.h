@@ -332,10 +332,22 @@ typedef uint64_t GLuint64;
 #	define GL_SAMPLER_2D_SHADOW 0x8B62
 #endif // GL_SAMPLER_2D_SHADOW
 
+#ifndef GL_TEXTURE_BASE_LEVEL
+#	define GL_TEXTURE_BASE_LEVEL 0x813C
+#endif // GL_TEXTURE_BASE_LEVEL
+
 #ifndef GL_TEXTURE_MAX_LEVEL
 #	define GL_TEXTURE_MAX_LEVEL 0x813D
 #endif // GL_TEXTURE_MAX_LEVEL
 
+#ifndef GL_TEXTURE_2D_ARRAY
+#	define GL_TEXTURE_2D_ARRAY 0x8C1A
+#endif // GL_TEXTURE_2D_ARRAY
+
+#ifndef GL_SAMPLER_2D_ARRAY
+#	define GL_SAMPLER_2D_ARRAY 0x8DC1
+#endif // GL_SAMPLER_2D_ARRAY
+
 #if BX_PLATFORM_NACL
 #	include "glcontext_ppapi.h"
 #elif BX_PLATFORM_WINDOWS
@@ -622,6 +634,7 @@ namespace bgfx
 		bool init(GLenum _target, uint32_t _width, uint32_t _height, uint8_t _format, uint8_t _numMips, uint32_t _flags);
 		void create(const Memory* _mem, uint32_t _flags, uint8_t _skip);
 		void destroy();
+		bool resize(uint32_t _width, uint32_t _height, uint8_t _numMips);
 		void update(uint8_t _side, uint8_t _mip, const Rect& _rect, uint16_t _z, uint16_t _depth, uint16_t _pitch, const Memory* _mem);
 		void setSamplerState(uint32_t _flags);
 		void commit(uint32_t _stage, uint32_t _flags);
@@ -690,9 +703,9 @@ namespace bgfx
  		void bindAttributes(const VertexDecl& _vertexDecl, uint32_t _baseVertex = 0) const;
 		void bindInstanceData(uint32_t _stride, uint32_t _baseVertex = 0) const;
 
-		void commit()
+		void commit(const uint32_t* _mask = NULL)
 		{
-			m_constantBuffer->commit();
+			m_constantBuffer->commit(_mask);
 		}
 
 		void add(uint32_t _hash)
@@ -747,6 +760,36 @@ namespace bgfx
 		GLuint m_queries[64];
 	};
 
+	struct NativeStateBlock
+	{
+		NativeStateBlock()
+			: m_valid(false)
+		{
+		}
+
+		void create(uint64_t _flags, uint64_t _stencil, uint32_t _rgba);
+		void apply(const NativeStateBlock* _prev) const;
+
+		GLenum m_cullFace;  //!< GL_NONE when culling is disabled.
+		GLenum m_depthFunc; //!< GL_NONE when depth test is disabled.
+		GLenum m_blendFunc[4];
+		GLenum m_blendEquation[2];
+		GLclampf m_blendColor[4];
+		GLenum m_stencilFace[2];
+		GLenum m_stencilFunc[2];
+		GLint m_stencilRef[2];
+		GLint m_stencilMask[2];
+		GLenum m_stencilOp[2][3];
+		uint8_t m_numStencilFaces; //!< 0 when stencil test is disabled.
+		bool m_depthWrite;
+		bool m_rgbWrite;
+		bool m_alphaWrite;
+		bool m_blend;
+		bool m_blendFactor;
+		bool m_msaa;
+		bool m_valid;
+	};
+
 } // namespace bgfx
 
 #endif // BGFX_RENDERER_GL_H_HEADER_GUARD
@@ -9,7 +9,7 @@
 
 namespace bgfx
 {
-	void ConstantBuffer::commit()
+	void ConstantBuffer::commit(const uint32_t* /*_mask*/)
 	{
 	}
 
@@ -117,6 +117,15 @@ namespace bgfx
 	{
 	}
 
+	bool Context::rendererResizeTexture(TextureHandle /*_handle*/, uint16_t /*_width*/, uint16_t /*_height*/, uint8_t /*_numMips*/)
+	{
+		return true;
+	}
+
+	void Context::rendererUpdateTextureBaseMip(TextureHandle /*_handle*/, uint8_t /*_mip*/)
+	{
+	}
+
 	void Context::rendererCreateFrameBuffer(FrameBufferHandle /*_handle*/, uint8_t /*_num*/, const TextureHandle* /*_textureHandles*/)
 	{
 	}
@@ -133,6 +142,14 @@ namespace bgfx
 	{
 	}
 
+	void Context::rendererCreateState(StateHandle /*_handle*/, const StateBlock& /*_block*/)
+	{
+	}
+
+	void Context::rendererDestroyState(StateHandle /*_handle*/)
+	{
+	}
+
 	void Context::rendererSaveScreenShot(const char* /*_filePath*/)
 	{
 	}
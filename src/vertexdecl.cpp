@@ -4,7 +4,10 @@
  */
 
 #include <string.h>
+#include <math.h> // fabsf, floorf, sqrtf
+#include <bx/allocator.h>
 #include <bx/debug.h>
+#include <bx/float4_t.h>
 #include <bx/hash.h>
 #include <bx/uint32_t.h>
 #include <bx/string.h>
@@ -390,32 +393,221 @@ namespace bgfx
 		}
 	}
 
-	void vertexConvert(const VertexDecl& _destDecl, void* _destData, const VertexDecl& _srcDecl, const void* _srcData, uint32_t _num)
+	struct ConvertKernel
 	{
-		if (_destDecl.m_hash == _srcDecl.m_hash)
+		enum Enum
 		{
-			memcpy(_destData, _srcData, _srcDecl.getSize(_num) );
-			return;
+			Set,
+			Copy,
+			FloatToHalf,
+			FloatToUint8,
+			FloatToInt16,
+			Generic,
+
+			Count
+		};
+	};
+
+	typedef void (*ConvertKernelFn)(const VertexConverter& _converter, const VertexConverter::Op& _op, uint8_t* _dest, const uint8_t* _src, uint32_t _num);
+
+	template<uint8_t num>
+	inline bx::float4_t loadFloat4(const uint8_t* _src)
+	{
+		const float* src = (const float*)_src;
+
+		switch (num)
+		{
+		case 1:  return bx::float4_ld(src[0], 0.0f,   0.0f,   0.0f);
+		case 2:  return bx::float4_ld(src[0], src[1], 0.0f,   0.0f);
+		case 3:  return bx::float4_ld(src[0], src[1], src[2], 0.0f);
+		default: return bx::float4_ld(src[0], src[1], src[2], src[3]);
+		}
+	}
+
+	inline bx::float4_t halfFromFloat4(bx::float4_t _a)
+	{
+		// Round to nearest even, infinity and NaN are converted to infinity.
+		using namespace bx;
+		const float4_t signMask  = float4_isplat(UINT32_C(0x80000000) );
+		const float4_t f16max    = float4_isplat( (127 + 16) << 23);
+		const float4_t infinity  = float4_isplat(0x7c00);
+		const float4_t minNormal = float4_isplat( (127 - 14) << 23);
+		const float4_t magic     = float4_isplat( ( (127 - 15) + (23 - 10) + 1) << 23);
+		const float4_t bias      = float4_isplat(UINT32_C(0xfff) - ( (127 - 15) << 23) );
+
+		const float4_t sign      = float4_and(_a, signMask);
+		const float4_t absf      = float4_xor(_a, sign);
+		const float4_t regular   = float4_icmpgt(f16max, absf);
+		const float4_t subnormal = float4_icmpgt(minNormal, absf);
+
+		const float4_t sub0      = float4_add(absf, magic);
+		const float4_t sub1      = float4_isub(sub0, magic);
+
+		const float4_t odd0      = float4_sll(absf, 31 - 13);
+		const float4_t odd1      = float4_sra(odd0, 31);
+		const float4_t norm0     = float4_iadd(absf, bias);
+		const float4_t norm1     = float4_isub(norm0, odd1);
+		const float4_t norm2     = float4_srl(norm1, 13);
+
+		const float4_t tmp0      = float4_and(sub1, subnormal);
+		const float4_t tmp1      = float4_andc(norm2, subnormal);
+		const float4_t tmp2      = float4_or(tmp0, tmp1);
+		const float4_t tmp3      = float4_and(tmp2, regular);
+		const float4_t tmp4      = float4_andc(infinity, regular);
+		const float4_t tmp5      = float4_or(tmp3, tmp4);
+		const float4_t sign16    = float4_srl(sign, 16);
+		const float4_t result    = float4_or(tmp5, sign16);
+
+		return result;
+	}
+
+	static void convertSet(const VertexConverter& _converter, const VertexConverter::Op& _op, uint8_t* _dest, const uint8_t* /*_src*/, uint32_t _num)
+	{
+		const uint32_t destStride = _converter.m_destDecl.getStride();
+		uint8_t* dest = _dest + _op.m_dest;
+
+		for (uint32_t ii = 0; ii < _num; ++ii, dest += destStride)
+		{
+			memset(dest, 0, _op.m_size);
+		}
+	}
+
+	static void convertCopy(const VertexConverter& _converter, const VertexConverter::Op& _op, uint8_t* _dest, const uint8_t* _src, uint32_t _num)
+	{
+		const uint32_t srcStride  = _converter.m_srcDecl.getStride();
+		const uint32_t destStride = _converter.m_destDecl.getStride();
+		const uint8_t* src = _src + _op.m_src;
+		uint8_t* dest = _dest + _op.m_dest;
+
+		for (uint32_t ii = 0; ii < _num; ++ii, src += srcStride, dest += destStride)
+		{
+			memcpy(dest, src, _op.m_size);
 		}
+	}
 
-		struct ConvertOp
+	template<uint8_t srcNum>
+	static void convertFloatToHalf(const VertexConverter& _converter, const VertexConverter::Op& _op, uint8_t* _dest, const uint8_t* _src, uint32_t _num)
+	{
+		using namespace bx;
+		const uint32_t srcStride  = _converter.m_srcDecl.getStride();
+		const uint32_t destStride = _converter.m_destDecl.getStride();
+		const uint8_t* src = _src + _op.m_src;
+		uint8_t* dest = _dest + _op.m_dest;
+
+		BX_ALIGN_STRUCT_16(uint32_t result[4]);
+
+		for (uint32_t ii = 0; ii < _num; ++ii, src += srcStride, dest += destStride)
 		{
-			enum Enum
+			const float4_t xyzw = loadFloat4<srcNum>(src);
+			const float4_t half = halfFromFloat4(xyzw);
+			float4_st(&result, half);
+
+			uint16_t* packed = (uint16_t*)dest;
+			switch (_op.m_destNum)
 			{
-				Set,
-				Copy,
-				Convert,
-			};
+			default: packed[3] = uint16_t(result[3]);
+			case 3:  packed[2] = uint16_t(result[2]);
+			case 2:  packed[1] = uint16_t(result[1]);
+			case 1:  packed[0] = uint16_t(result[0]);
+			}
+		}
+	}
 
-			Attrib::Enum attr;
-			Enum op;
-			uint32_t src;
-			uint32_t dest;
-			uint32_t size;
-		};
+	template<typename Ty, uint8_t srcNum>
+	static void convertFloatToFixed(const VertexConverter& _converter, const VertexConverter::Op& _op, uint8_t* _dest, const uint8_t* _src, uint32_t _num, float _scale, float _bias, float _min, float _max)
+	{
+		using namespace bx;
+		const uint32_t srcStride  = _converter.m_srcDecl.getStride();
+		const uint32_t destStride = _converter.m_destDecl.getStride();
+		const uint8_t* src = _src + _op.m_src;
+		uint8_t* dest = _dest + _op.m_dest;
+
+		const float4_t scale = float4_splat(_scale);
+		const float4_t bias  = float4_splat(_bias);
+		const float4_t min   = float4_splat(_min);
+		const float4_t max   = float4_splat(_max);
+
+		BX_ALIGN_STRUCT_16(int32_t result[4]);
+
+		for (uint32_t ii = 0; ii < _num; ++ii, src += srcStride, dest += destStride)
+		{
+			const float4_t xyzw = loadFloat4<srcNum>(src);
+			const float4_t tmp0 = float4_madd(xyzw, scale, bias);
+			const float4_t tmp1 = float4_max(tmp0, min);
+			const float4_t tmp2 = float4_min(tmp1, max);
+			const float4_t tmp3 = float4_ftoi(tmp2);
+			float4_st(&result, tmp3);
+
+			Ty* packed = (Ty*)dest;
+			switch (_op.m_destNum)
+			{
+			default: packed[3] = Ty(result[3]);
+			case 3:  packed[2] = Ty(result[2]);
+			case 2:  packed[1] = Ty(result[1]);
+			case 1:  packed[0] = Ty(result[0]);
+			}
+		}
+	}
+
+	template<uint8_t srcNum>
+	static void convertFloatToUint8(const VertexConverter& _converter, const VertexConverter::Op& _op, uint8_t* _dest, const uint8_t* _src, uint32_t _num)
+	{
+		if (_op.m_asInt)
+		{
+			convertFloatToFixed<uint8_t, srcNum>(_converter, _op, _dest, _src, _num, 127.0f, 128.0f, 0.0f, 255.0f);
+		}
+		else
+		{
+			convertFloatToFixed<uint8_t, srcNum>(_converter, _op, _dest, _src, _num, 255.0f, 0.0f, 0.0f, 255.0f);
+		}
+	}
+
+	template<uint8_t srcNum>
+	static void convertFloatToInt16(const VertexConverter& _converter, const VertexConverter::Op& _op, uint8_t* _dest, const uint8_t* _src, uint32_t _num)
+	{
+		if (_op.m_asInt)
+		{
+			convertFloatToFixed<int16_t, srcNum>(_converter, _op, _dest, _src, _num, 32767.0f, 0.0f, -32768.0f, 32767.0f);
+		}
+		else
+		{
+			convertFloatToFixed<int16_t, srcNum>(_converter, _op, _dest, _src, _num, 65535.0f, -32768.0f, -32768.0f, 32767.0f);
+		}
+	}
+
+	static void convertGeneric(const VertexConverter& _converter, const VertexConverter::Op& _op, uint8_t* _dest, const uint8_t* _src, uint32_t _num)
+	{
+		const Attrib::Enum attr = Attrib::Enum(_op.m_attr);
+		float unpacked[4];
+
+		for (uint32_t ii = 0; ii < _num; ++ii)
+		{
+			vertexUnpack(unpacked, attr, _converter.m_srcDecl, _src, ii);
+			vertexPack(unpacked, true, attr, _converter.m_destDecl, _dest, ii);
+		}
+	}
+
+	static const ConvertKernelFn s_convertKernel[ConvertKernel::Count][4] =
+	{
+		{ convertSet,              convertSet,              convertSet,              convertSet              },
+		{ convertCopy,             convertCopy,             convertCopy,             convertCopy             },
+		{ convertFloatToHalf<1>,   convertFloatToHalf<2>,   convertFloatToHalf<3>,   convertFloatToHalf<4>   },
+		{ convertFloatToUint8<1>,  convertFloatToUint8<2>,  convertFloatToUint8<3>,  convertFloatToUint8<4>  },
+		{ convertFloatToInt16<1>,  convertFloatToInt16<2>,  convertFloatToInt16<3>,  convertFloatToInt16<4>  },
+		{ convertGeneric,          convertGeneric,          convertGeneric,          convertGeneric          },
+	};
 
-		ConvertOp convertOp[Attrib::Count];
-		uint32_t numOps = 0;
+	void VertexConverter::init(const VertexDecl& _destDecl, const VertexDecl& _srcDecl)
+	{
+		m_destDecl = _destDecl;
+		m_srcDecl  = _srcDecl;
+		m_numOps   = 0;
+		m_copy     = _destDecl.m_hash == _srcDecl.m_hash;
+
+		if (m_copy)
+		{
+			return;
+		}
 
 		for (uint32_t ii = 0; ii < Attrib::Count; ++ii)
 		{
@@ -423,68 +615,442 @@ namespace bgfx
 
 			if (_destDecl.has(attr) )
 			{
-				ConvertOp& cop = convertOp[numOps];
-				cop.attr = attr;
-				cop.dest = _destDecl.getOffset(attr);
+				Op& op = m_op[m_numOps];
+				op.m_attr = uint8_t(attr);
+				op.m_dest = _destDecl.getOffset(attr);
+				op.m_src  = 0;
 
 				uint8_t num;
 				AttribType::Enum type;
 				bool normalized;
 				bool asInt;
 				_destDecl.decode(attr, num, type, normalized, asInt);
-				cop.size = (*s_attribTypeSize[0])[type][num-1];
+				op.m_destNum = num;
+				op.m_srcNum  = 1;
+				op.m_size    = (*s_attribTypeSize[0])[type][num-1];
+				op.m_asInt   = asInt;
 
 				if (_srcDecl.has(attr) )
 				{
-					cop.src = _srcDecl.getOffset(attr);
-					cop.op = _destDecl.m_attributes[attr] == _srcDecl.m_attributes[attr] ? ConvertOp::Copy : ConvertOp::Convert;
+					op.m_src = _srcDecl.getOffset(attr);
+
+					if (_destDecl.m_attributes[attr] == _srcDecl.m_attributes[attr])
+					{
+						op.m_kernel = ConvertKernel::Copy;
+					}
+					else
+					{
+						uint8_t srcNum;
+						AttribType::Enum srcType;
+						_srcDecl.decode(attr, srcNum, srcType, normalized, asInt);
+						op.m_srcNum = srcNum;
+
+						if (AttribType::Float != srcType)
+						{
+							op.m_kernel = ConvertKernel::Generic;
+						}
+						else
+						{
+							switch (type)
+							{
+							case AttribType::Half:  op.m_kernel = ConvertKernel::FloatToHalf;  break;
+							case AttribType::Uint8: op.m_kernel = ConvertKernel::FloatToUint8; break;
+							case AttribType::Int16: op.m_kernel = ConvertKernel::FloatToInt16; break;
+							default:                op.m_kernel = ConvertKernel::Generic;      break;
+							}
+						}
+					}
 				}
 				else
 				{
-					cop.op = ConvertOp::Set;
+					op.m_kernel = ConvertKernel::Set;
 				}
 
-				++numOps;
+				++m_numOps;
 			}
 		}
+	}
 
-		if (0 < numOps)
+	void VertexConverter::convert(void* _destData, const void* _srcData, uint32_t _num) const
+	{
+		if (m_copy)
 		{
-			const uint8_t* src = (const uint8_t*)_srcData;
-			uint32_t srcStride = _srcDecl.getStride();
+			memcpy(_destData, _srcData, m_srcDecl.getSize(_num) );
+			return;
+		}
 
-			uint8_t* dest = (uint8_t*)_destData;
-			uint32_t destStride = _destDecl.getStride();
+		const uint8_t* src = (const uint8_t*)_srcData;
+		const uint32_t srcStride = m_srcDecl.getStride();
 
-			float unpacked[4];
+		uint8_t* dest = (uint8_t*)_destData;
+		const uint32_t destStride = m_destDecl.getStride();
 
-			for (uint32_t ii = 0; ii < _num; ++ii)
+		// Convert attribute by attribute within block of vertices, so that
+		// dispatch is done once per block, while block stays in cache.
+		for (uint32_t ii = 0; ii < _num; ii += BGFX_CONFIG_VERTEX_CONVERT_BLOCK_SIZE)
+		{
+			const uint32_t num = bx::uint32_min(_num - ii, BGFX_CONFIG_VERTEX_CONVERT_BLOCK_SIZE);
+
+			for (uint32_t jj = 0; jj < m_numOps; ++jj)
+			{
+				const Op& op = m_op[jj];
+				s_convertKernel[op.m_kernel][op.m_srcNum-1](*this, op, dest, src, num);
+			}
+
+			src  += num*srcStride;
+			dest += num*destStride;
+		}
+	}
+
+	void vertexConvert(const VertexDecl& _destDecl, void* _destData, const VertexDecl& _srcDecl, const void* _srcData, uint32_t _num)
+	{
+		VertexConverter converter;
+		converter.init(_destDecl, _srcDecl);
+		converter.convert(_destData, _srcData, _num);
+	}
+
+	static bool quantizeAttrib(VertexDecl& _decl, Attrib::Enum _attr, uint8_t _num, uint32_t _flag)
+	{
+		switch (_flag)
+		{
+		case BGFX_VERTEX_QUANTIZE_POSITION_HALF:
+			if (Attrib::Position == _attr)
+			{
+				_decl.add(_attr, _num, AttribType::Half);
+				return true;
+			}
+			break;
+
+		case BGFX_VERTEX_QUANTIZE_NORMAL_OCTAHEDRAL:
+			if (Attrib::Normal == _attr
+			&&  3 <= _num)
+			{
+				_decl.add(_attr, 2, AttribType::Int16, true, true);
+				return true;
+			}
+			break;
+
+		case BGFX_VERTEX_QUANTIZE_NORMAL_UINT8:
+			if (Attrib::Normal == _attr)
+			{
+				_decl.add(_attr, 4, AttribType::Uint8, true, true);
+				return true;
+			}
+			break;
+
+		case BGFX_VERTEX_QUANTIZE_TANGENT_UINT8:
+			if (Attrib::Tangent == _attr)
+			{
+				_decl.add(_attr, 4, AttribType::Uint8, true, true);
+				return true;
+			}
+			break;
+
+		case BGFX_VERTEX_QUANTIZE_COLOR_UINT8:
+			if (Attrib::Color0 == _attr
+			||  Attrib::Color1 == _attr)
+			{
+				_decl.add(_attr, 4, AttribType::Uint8, true);
+				return true;
+			}
+			break;
+
+		case BGFX_VERTEX_QUANTIZE_WEIGHT_UINT8:
+			if (Attrib::Weight == _attr)
+			{
+				_decl.add(_attr, _num, AttribType::Uint8, true);
+				return true;
+			}
+			break;
+
+		case BGFX_VERTEX_QUANTIZE_TEXCOORD_HALF:
+			if (Attrib::TexCoord0 <= _attr
+			&&  Attrib::TexCoord7 >= _attr)
 			{
-				for (uint32_t jj = 0; jj < numOps; ++jj)
+				_decl.add(_attr, _num, AttribType::Half);
+				return true;
+			}
+			break;
+
+		default:
+			break;
+		}
+
+		return false;
+	}
+
+	// Ordered by preference when more than one flag applies to attribute.
+	static const uint32_t s_quantizeFlags[] =
+	{
+		BGFX_VERTEX_QUANTIZE_POSITION_HALF,
+		BGFX_VERTEX_QUANTIZE_NORMAL_OCTAHEDRAL,
+		BGFX_VERTEX_QUANTIZE_NORMAL_UINT8,
+		BGFX_VERTEX_QUANTIZE_TANGENT_UINT8,
+		BGFX_VERTEX_QUANTIZE_COLOR_UINT8,
+		BGFX_VERTEX_QUANTIZE_WEIGHT_UINT8,
+		BGFX_VERTEX_QUANTIZE_TEXCOORD_HALF,
+	};
+
+	static void addAttrib(VertexDecl& _destDecl, const VertexDecl& _srcDecl, Attrib::Enum _attr)
+	{
+		uint8_t num;
+		AttribType::Enum type;
+		bool normalized;
+		bool asInt;
+		_srcDecl.decode(_attr, num, type, normalized, asInt);
+		_destDecl.add(_attr, num, type, normalized, asInt);
+	}
+
+	void vertexQuantizeDecl(VertexDecl& _destDecl, const VertexDecl& _srcDecl, uint32_t _flags)
+	{
+		_destDecl.begin();
+
+		for (uint32_t attr = 0; attr < Attrib::Count; ++attr)
+		{
+			if (!_srcDecl.has(Attrib::Enum(attr) ) )
+			{
+				continue;
+			}
+
+			uint8_t num;
+			AttribType::Enum type;
+			bool normalized;
+			bool asInt;
+			_srcDecl.decode(Attrib::Enum(attr), num, type, normalized, asInt);
+
+			bool quantized = false;
+			if (AttribType::Float == type)
+			{
+				for (uint32_t ii = 0; ii < BX_COUNTOF(s_quantizeFlags) && !quantized; ++ii)
 				{
-					const ConvertOp& cop = convertOp[jj];
+					const uint32_t flag = s_quantizeFlags[ii];
+					quantized = 0 != (_flags & flag)
+						&& quantizeAttrib(_destDecl, Attrib::Enum(attr), num, flag)
+						;
+				}
+			}
+
+			if (!quantized)
+			{
+				addAttrib(_destDecl, _srcDecl, Attrib::Enum(attr) );
+			}
+		}
+
+		_destDecl.end();
+	}
 
-					switch (cop.op)
+	void vertexQuantizePick(VertexDecl& _destDecl, const VertexDecl& _srcDecl, const void* _srcData, uint32_t _num, float _maxError, uint32_t _flags)
+	{
+		// Candidates are evaluated one attribute at the time, in chunks small
+		// enough for stack.
+		const uint32_t chunkSize = 256;
+		uint8_t temp[chunkSize*16];
+
+		const uint32_t srcStride = _srcDecl.getStride();
+
+		_destDecl.begin();
+
+		for (uint32_t attr = 0; attr < Attrib::Count; ++attr)
+		{
+			if (!_srcDecl.has(Attrib::Enum(attr) ) )
+			{
+				continue;
+			}
+
+			uint8_t num;
+			AttribType::Enum type;
+			bool normalized;
+			bool asInt;
+			_srcDecl.decode(Attrib::Enum(attr), num, type, normalized, asInt);
+
+			uint32_t pick = 0;
+			if (AttribType::Float == type)
+			{
+				for (uint32_t ii = 0; ii < BX_COUNTOF(s_quantizeFlags) && 0 == pick; ++ii)
+				{
+					const uint32_t flag = s_quantizeFlags[ii];
+					if (0 == (_flags & flag) )
 					{
-					case ConvertOp::Set:
-						memset(dest + cop.dest, 0, cop.size);
-						break;
-
-					case ConvertOp::Copy:
-						memcpy(dest + cop.dest, src + cop.src, cop.size);
-						break;
-
-					case ConvertOp::Convert:
-						vertexUnpack(unpacked, cop.attr, _srcDecl, src);
-						vertexPack(unpacked, true, cop.attr, _destDecl, dest);
-						break;
+						continue;
 					}
+
+					VertexDecl decl;
+					decl.begin();
+					if (!quantizeAttrib(decl, Attrib::Enum(attr), num, flag) )
+					{
+						continue;
+					}
+					decl.end();
+
+					float maxError = 0.0f;
+					const uint8_t* src = (const uint8_t*)_srcData;
+					for (uint32_t jj = 0; jj < _num && maxError <= _maxError; jj += chunkSize, src += chunkSize*srcStride)
+					{
+						const uint32_t count = bx::uint32_min(_num - jj, chunkSize);
+						const float error = vertexQuantize(decl, temp, _srcDecl, src, count);
+						maxError = error > maxError ? error : maxError;
+					}
+
+					pick = maxError <= _maxError ? flag : 0;
 				}
+			}
+
+			if (0 == pick
+			||  !quantizeAttrib(_destDecl, Attrib::Enum(attr), num, pick) )
+			{
+				addAttrib(_destDecl, _srcDecl, Attrib::Enum(attr) );
+			}
+		}
+
+		_destDecl.end();
+	}
+
+	inline float signNotZero(float _a)
+	{
+		return 0.0f > _a ? -1.0f : 1.0f;
+	}
+
+	inline void normalize3(float _result[3], const float _a[3])
+	{
+		const float len = sqrtf(_a[0]*_a[0] + _a[1]*_a[1] + _a[2]*_a[2]);
+		const float invLen = 0.0f < len ? 1.0f/len : 0.0f;
+		_result[0] = _a[0]*invLen;
+		_result[1] = _a[1]*invLen;
+		_result[2] = _a[2]*invLen;
+	}
+
+	static void octahedralEncode(float _result[2], const float _normal[3])
+	{
+		const float sum = fabsf(_normal[0]) + fabsf(_normal[1]) + fabsf(_normal[2]);
+		const float invSum = 0.0f < sum ? 1.0f/sum : 0.0f;
+		const float xx = _normal[0]*invSum;
+		const float yy = _normal[1]*invSum;
+
+		if (0.0f > _normal[2])
+		{
+			_result[0] = (1.0f - fabsf(yy) )*signNotZero(xx);
+			_result[1] = (1.0f - fabsf(xx) )*signNotZero(yy);
+		}
+		else
+		{
+			_result[0] = xx;
+			_result[1] = yy;
+		}
+	}
+
+	static void octahedralDecode(float _result[3], const float _encoded[2])
+	{
+		float normal[3];
+		normal[0] = _encoded[0];
+		normal[1] = _encoded[1];
+		normal[2] = 1.0f - fabsf(_encoded[0]) - fabsf(_encoded[1]);
+
+		if (0.0f > normal[2])
+		{
+			normal[0] = (1.0f - fabsf(_encoded[1]) )*signNotZero(_encoded[0]);
+			normal[1] = (1.0f - fabsf(_encoded[0]) )*signNotZero(_encoded[1]);
+		}
+
+		normalize3(_result, normal);
+	}
+
+	static bool isOctahedral(Attrib::Enum _attr, const VertexDecl& _destDecl, const VertexDecl& _srcDecl)
+	{
+		if (Attrib::Normal != _attr
+		||  !_destDecl.has(_attr)
+		||  !_srcDecl.has(_attr) )
+		{
+			return false;
+		}
+
+		uint8_t destNum;
+		uint8_t srcNum;
+		AttribType::Enum type;
+		bool normalized;
+		bool asInt;
+		_destDecl.decode(_attr, destNum, type, normalized, asInt);
+		_srcDecl.decode(_attr, srcNum, type, normalized, asInt);
+
+		return 2 == destNum
+			&& 3 <= srcNum
+			;
+	}
+
+	static float quantizeError(Attrib::Enum _attr, const VertexDecl& _destDecl, const void* _destData, const VertexDecl& _srcDecl, const void* _srcData, uint32_t _num)
+	{
+		uint8_t num;
+		AttribType::Enum type;
+		bool normalized;
+		bool asInt;
+		_srcDecl.decode(_attr, num, type, normalized, asInt);
+
+		const bool octahedral = isOctahedral(_attr, _destDecl, _srcDecl);
+		num = octahedral ? 3 : num;
+
+		float maxError = 0.0f;
+
+		for (uint32_t ii = 0; ii < _num; ++ii)
+		{
+			float src[4];
+			float dest[4];
+			vertexUnpack(src, _attr, _srcDecl, _srcData, ii);
+			vertexUnpack(dest, _attr, _destDecl, _destData, ii);
+
+			if (octahedral)
+			{
+				normalize3(src, src);
+				octahedralDecode(dest, dest);
+			}
+
+			for (uint32_t jj = 0; jj < num; ++jj)
+			{
+				const float error = fabsf(src[jj] - dest[jj]);
+				maxError = error > maxError ? error : maxError;
+			}
+		}
+
+		return maxError;
+	}
+
+	float vertexQuantize(const VertexDecl& _destDecl, void* _destData, const VertexDecl& _srcDecl, const void* _srcData, uint32_t _num, float _error[Attrib::Count])
+	{
+		VertexConverter converter;
+		converter.init(_destDecl, _srcDecl);
+		converter.convert(_destData, _srcData, _num);
+
+		if (isOctahedral(Attrib::Normal, _destDecl, _srcDecl) )
+		{
+			for (uint32_t ii = 0; ii < _num; ++ii)
+			{
+				float normal[4];
+				vertexUnpack(normal, Attrib::Normal, _srcDecl, _srcData, ii);
+
+				float encoded[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+				octahedralEncode(encoded, normal);
+				vertexPack(encoded, true, Attrib::Normal, _destDecl, _destData, ii);
+			}
+		}
+
+		float maxError = 0.0f;
+
+		for (uint32_t attr = 0; attr < Attrib::Count; ++attr)
+		{
+			float error = 0.0f;
+
+			if (_destDecl.has(Attrib::Enum(attr) )
+			&&  _srcDecl.has(Attrib::Enum(attr) ) )
+			{
+				error = quantizeError(Attrib::Enum(attr), _destDecl, _destData, _srcDecl, _srcData, _num);
+				maxError = error > maxError ? error : maxError;
+			}
 
-				src += srcStride;
-				dest += destStride;
+			if (NULL != _error)
+			{
+				_error[attr] = error;
 			}
 		}
+
+		return maxError;
 	}
 
 	inline float sqLength(const float _a[3], const float _b[3])
@@ -580,4 +1146,181 @@ namespace bgfx
 
 		return (uint16_t)numVertices;
 	}
+
+	inline uint32_t weldHash(int32_t _x, int32_t _y, int32_t _z)
+	{
+		return uint32_t(_x)*73856093u
+			^  uint32_t(_y)*19349663u
+			^  uint32_t(_z)*83492791u
+			;
+	}
+
+	inline bool weldCompare(const VertexDecl& _decl, const void* _data0, uint32_t _index0, const void* _data1, uint32_t _index1, float _epsilon)
+	{
+		const uint32_t stride = _decl.getStride();
+
+		if (0.0f == _epsilon)
+		{
+			return 0 == memcmp( (const uint8_t*)_data0 + _index0*stride, (const uint8_t*)_data1 + _index1*stride, stride);
+		}
+
+		for (uint32_t attr = 1; attr < Attrib::Count; ++attr)
+		{
+			if (_decl.has(Attrib::Enum(attr) ) )
+			{
+				float v0[4];
+				float v1[4];
+				vertexUnpack(v0, Attrib::Enum(attr), _decl, _data0, _index0);
+				vertexUnpack(v1, Attrib::Enum(attr), _decl, _data1, _index1);
+
+				if (fabsf(v0[0] - v1[0]) > _epsilon
+				||  fabsf(v0[1] - v1[1]) > _epsilon
+				||  fabsf(v0[2] - v1[2]) > _epsilon
+				||  fabsf(v0[3] - v1[3]) > _epsilon)
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	// Writes unique vertex id for every vertex into _output. Unique vertex
+	// positions are kept packed, and hash table is open addressed, so that
+	// lookups don't touch source vertex stream. Positions are hashed by grid
+	// cell of 2*_epsilon size, vertex within _epsilon can only be in one of 8
+	// cells nearest to it. When _dest is not NULL unique vertices are copied
+	// into it and all attributes must match too.
+	static uint32_t weld(uint32_t* _output, uint32_t* _first, void* _dest, const VertexDecl& _decl, const void* _data, uint32_t _num, float _epsilon, bx::ReallocatorI* _allocator)
+	{
+		bx::CrtAllocator crtAllocator;
+		bx::ReallocatorI* allocator = NULL == _allocator ? &crtAllocator : _allocator;
+
+		const uint32_t hashSize = bx::uint32_nextpow2(_num*2);
+		const uint32_t hashMask = hashSize-1;
+		const float epsilonSq = _epsilon*_epsilon;
+		const float invCell = 0.0f < _epsilon ? 0.5f/_epsilon : 0.0f;
+		const uint32_t numCells = 0.0f < _epsilon ? 8 : 1;
+		const uint32_t stride = _decl.getStride();
+
+		uint32_t* hashTable = (uint32_t*)BX_ALLOC(allocator, hashSize*sizeof(uint32_t) );
+		float* unique = (float*)BX_ALLOC(allocator, _num*3*sizeof(float) );
+		memset(hashTable, 0xff, hashSize*sizeof(uint32_t) );
+
+		uint32_t numVertices = 0;
+
+		for (uint32_t ii = 0; ii < _num; ++ii)
+		{
+			float pos[4];
+			vertexUnpack(pos, Attrib::Position, _decl, _data, ii);
+
+			uint32_t cellHash[8];
+
+			if (0.0f < _epsilon)
+			{
+				const float xx = pos[0]*invCell;
+				const float yy = pos[1]*invCell;
+				const float zz = pos[2]*invCell;
+				const float fx = floorf(xx);
+				const float fy = floorf(yy);
+				const float fz = floorf(zz);
+				const int32_t cx = int32_t(fx);
+				const int32_t cy = int32_t(fy);
+				const int32_t cz = int32_t(fz);
+				const int32_t nx = xx - fx < 0.5f ? -1 : 1;
+				const int32_t ny = yy - fy < 0.5f ? -1 : 1;
+				const int32_t nz = zz - fz < 0.5f ? -1 : 1;
+
+				for (uint32_t jj = 0; jj < 8; ++jj)
+				{
+					cellHash[jj] = weldHash(cx + (jj&1 ? nx : 0)
+						, cy + (jj&2 ? ny : 0)
+						, cz + (jj&4 ? nz : 0)
+						);
+				}
+			}
+			else
+			{
+				cellHash[0] = bx::hashMurmur2A(pos, 3*sizeof(float) );
+			}
+
+			uint32_t found = UINT32_MAX;
+
+			for (uint32_t jj = 0; jj < numCells && UINT32_MAX == found; ++jj)
+			{
+				for (uint32_t slot = cellHash[jj] & hashMask
+					; UINT32_MAX != hashTable[slot] && UINT32_MAX == found
+					; slot = (slot + 1) & hashMask
+					)
+				{
+					const uint32_t index = hashTable[slot];
+					const float* test = &unique[index*3];
+
+					if (sqLength(test, pos) <= epsilonSq
+					&& (NULL == _dest || weldCompare(_decl, _dest, index, _data, ii, _epsilon) ) )
+					{
+						found = index;
+					}
+				}
+			}
+
+			if (UINT32_MAX == found)
+			{
+				found = numVertices++;
+
+				float* dst = &unique[found*3];
+				dst[0] = pos[0];
+				dst[1] = pos[1];
+				dst[2] = pos[2];
+
+				uint32_t slot = cellHash[0] & hashMask;
+				while (UINT32_MAX != hashTable[slot])
+				{
+					slot = (slot + 1) & hashMask;
+				}
+				hashTable[slot] = found;
+
+				if (NULL != _first)
+				{
+					_first[found] = ii;
+				}
+
+				if (NULL != _dest)
+				{
+					memcpy( (uint8_t*)_dest + found*stride, (const uint8_t*)_data + ii*stride, stride);
+				}
+			}
+
+			_output[ii] = found;
+		}
+
+		BX_FREE(allocator, unique);
+		BX_FREE(allocator, hashTable);
+
+		return numVertices;
+	}
+
+	uint32_t weldVertices(uint32_t* _output, const VertexDecl& _decl, const void* _data, uint32_t _num, float _epsilon, bx::ReallocatorI* _allocator)
+	{
+		bx::CrtAllocator crtAllocator;
+		bx::ReallocatorI* allocator = NULL == _allocator ? &crtAllocator : _allocator;
+
+		uint32_t* first = (uint32_t*)BX_ALLOC(allocator, _num*sizeof(uint32_t) );
+		uint32_t numVertices = weld(_output, first, NULL, _decl, _data, _num, _epsilon, allocator);
+
+		for (uint32_t ii = 0; ii < _num; ++ii)
+		{
+			_output[ii] = first[_output[ii] ];
+		}
+
+		BX_FREE(allocator, first);
+
+		return numVertices;
+	}
+
+	uint32_t vertexWeld(void* _destData, uint32_t* _indices, const VertexDecl& _decl, const void* _srcData, uint32_t _num, float _epsilon, bx::ReallocatorI* _allocator)
+	{
+		return weld(_indices, NULL, _destData, _decl, _srcData, _num, _epsilon, _allocator);
+	}
 } // namespace bgfx
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+
+struct Bench
+{
+	const char* m_name;
+	const char* m_usage;
+	BenchFn m_fn;
+};
+
+static const Bench s_bench[] =
+{
+	{
+		"vertex",
+		"  vertex [-n <num vertices>] [-i <iterations>]\n"
+		"    Vertex stream conversion.\n",
+		vertexBench,
+	},
+	{
+		"math",
+		"  math [-n <num matrices>] [-i <iterations>]\n"
+		"    fpumath matrix functions.\n",
+		mathBench,
+	},
+	{
+		"bounds",
+		"  bounds [-n <num meshes>] [-v <num vertices>] [--obb <steps>] [--threads <num>]\n"
+		"    geometryc bounding volumes. Fails if OBB surface area or sphere radius\n"
+		"    is larger than with previous implementation, or if any vertex is\n"
+		"    outside of bounding volume.\n",
+		boundsBench,
+	},
+	{
+		"occlusion",
+		"  occlusion [-n <num iterations>] [--width <pixels>] [--height <pixels>] [--threads <num>]\n"
+		"    CPU occlusion culling. Rasterizes wall occluder, and fails if any of\n"
+		"    known boxes behind wall is not culled, or any box not fully hidden by\n"
+		"    wall is culled.\n",
+		occlusionBench,
+	},
+};
+
+void help(const char* _error = NULL)
+{
+	if (NULL != _error)
+	{
+		fprintf(stderr, "Error:\n%s\n\n", _error);
+	}
+
+	fprintf(stderr
+		, "bench, bgfx tools and examples benchmarks\n"
+		  "Copyright 2011-2014 Branimir Karadzic. All rights reserved.\n"
+		  "License: http://www.opensource.org/licenses/BSD-2-Clause\n\n"
+		);
+
+	fprintf(stderr
+		, "Usage: bench <name> [options]\n"
+		  "       bench all\n"
+		  "\n"
+		  "Runs benchmark and compares results against reference implementation.\n"
+		  "'all' runs every benchmark with default options. Returns failure if any\n"
+		  "benchmark fails.\n"
+		  "\n"
+		  "Benchmarks:\n"
+		);
+
+	for (uint32_t ii = 0; ii < BX_COUNTOF(s_bench); ++ii)
+	{
+		fprintf(stderr, "%s", s_bench[ii].m_usage);
+	}
+}
+
+int main(int _argc, const char* _argv[])
+{
+	bx::CommandLine cmdLine(_argc, _argv);
+
+	if (cmdLine.hasArg('h', "help")
+	||  2 > _argc)
+	{
+		help();
+		return EXIT_FAILURE;
+	}
+
+	const char* name = _argv[1];
+
+	if (0 == strcmp(name, "all") )
+	{
+		// Options have different meaning in each bench.
+		bx::CommandLine defaults(1, _argv);
+
+		int result = EXIT_SUCCESS;
+		for (uint32_t ii = 0; ii < BX_COUNTOF(s_bench); ++ii)
+		{
+			printf("\n%s:\n", s_bench[ii].m_name);
+			if (EXIT_SUCCESS != s_bench[ii].m_fn(defaults) )
+			{
+				result = EXIT_FAILURE;
+			}
+		}
+
+		return result;
+	}
+
+	for (uint32_t ii = 0; ii < BX_COUNTOF(s_bench); ++ii)
+	{
+		if (0 == strcmp(name, s_bench[ii].m_name) )
+		{
+			return s_bench[ii].m_fn(cmdLine);
+		}
+	}
+
+	help("Unknown benchmark name.");
+	return EXIT_FAILURE;
+}
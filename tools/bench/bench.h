@@ -0,0 +1,59 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#ifndef BENCH_H_HEADER_GUARD
+#define BENCH_H_HEADER_GUARD
+
+#include <stdlib.h>
+
+#include <bx/bx.h>
+#include <bx/commandline.h>
+#include <bx/timer.h>
+#include <bx/uint32_t.h>
+
+/// Accumulates elapsed time of measured section over iterations.
+struct BenchTimer
+{
+	BenchTimer()
+		: m_elapsed(0)
+	{
+	}
+
+	void begin()
+	{
+		m_elapsed -= bx::getHPCounter();
+	}
+
+	void end()
+	{
+		m_elapsed += bx::getHPCounter();
+	}
+
+	/// Returns average time per iteration in seconds.
+	double seconds(uint32_t _numIterations = 1) const
+	{
+		return double(m_elapsed)/double(bx::getHPFrequency() )/double(_numIterations);
+	}
+
+	int64_t m_elapsed;
+};
+
+/// Returns value of numeric option, or _default if option is not set.
+inline uint32_t benchOption(const bx::CommandLine& _cmdLine, char _short, const char* _long, uint32_t _default)
+{
+	const char* str = _cmdLine.findOption(_short, _long);
+	return NULL != str ? (uint32_t)atoi(str) : _default;
+}
+
+/// Bench entry point. Returns EXIT_FAILURE if results don't match
+/// reference implementation.
+typedef int (*BenchFn)(const bx::CommandLine& _cmdLine);
+
+int vertexBench(const bx::CommandLine& _cmdLine);
+int mathBench(const bx::CommandLine& _cmdLine);
+int boundsBench(const bx::CommandLine& _cmdLine);
+int occlusionBench(const bx::CommandLine& _cmdLine);
+
+#endif // BENCH_H_HEADER_GUARD
@@ -0,0 +1,366 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <bx/rng.h>
+
+#include "bench.h"
+#include "../geometryc/bounds.h"
+#include "../geometryc/jobs.h"
+#include "../geometryc/math.h"
+
+// Same as geometryc bounds.cpp before extremal point search was introduced.
+static float calcAreaAabbRef(const Aabb& _aabb)
+{
+	float ww = _aabb.m_max[0] - _aabb.m_min[0];
+	float hh = _aabb.m_max[1] - _aabb.m_min[1];
+	float dd = _aabb.m_max[2] - _aabb.m_min[2];
+	return 2.0f * (ww*hh + ww*dd + hh*dd);
+}
+
+static void calcObbRef(Obb& _obb, const void* _vertices, uint32_t _numVertices, uint32_t _stride, uint32_t _steps)
+{
+	Aabb aabb;
+	calcAabb(aabb, _vertices, _numVertices, _stride);
+	float minArea = calcAreaAabbRef(aabb);
+
+	Obb best;
+	aabbToObb(best, aabb);
+
+	float angleStep = float(M_PI_2/_steps);
+	float ax = 0.0f;
+	float mtx[16];
+
+	for (uint32_t ii = 0; ii < _steps; ++ii)
+	{
+		float ay = 0.0f;
+
+		for (uint32_t jj = 0; jj < _steps; ++jj)
+		{
+			float az = 0.0f;
+
+			for (uint32_t kk = 0; kk < _steps; ++kk)
+			{
+				mtxRotateXYZ(mtx, ax, ay, az);
+
+				float mtxT[16];
+				mtxTranspose(mtxT, mtx);
+				calcAabb(aabb, mtxT, _vertices, _numVertices, _stride);
+
+				float area = calcAreaAabbRef(aabb);
+				if (area < minArea)
+				{
+					minArea = area;
+					aabbToObb(best, aabb);
+
+					float result[16];
+					mtxMul(result, best.m_mtx, mtx);
+					memcpy(best.m_mtx, result, sizeof(result) );
+				}
+
+				az += angleStep;
+			}
+
+			ay += angleStep;
+		}
+
+		ax += angleStep;
+	}
+
+	memcpy(&_obb, &best, sizeof(Obb) );
+}
+
+static void calcMinBoundingSphereRef(Sphere& _sphere, const void* _vertices, uint32_t _numVertices, uint32_t _stride, float _step = 0.01f)
+{
+	bx::RngMwc rng;
+
+	uint8_t* vertex = (uint8_t*)_vertices;
+
+	float center[3];
+	float* position = (float*)&vertex[0];
+	center[0] = position[0];
+	center[1] = position[1];
+	center[2] = position[2];
+
+	position = (float*)&vertex[1*_stride];
+	center[0] += position[0];
+	center[1] += position[1];
+	center[2] += position[2];
+
+	center[0] *= 0.5f;
+	center[1] *= 0.5f;
+	center[2] *= 0.5f;
+
+	float xx = position[0] - center[0];
+	float yy = position[1] - center[1];
+	float zz = position[2] - center[2];
+	float maxDistSq = xx*xx + yy*yy + zz*zz;
+
+	float radiusStep = _step * 0.37f;
+
+	bool done;
+	do
+	{
+		done = true;
+		for (uint32_t ii = 0, index = rng.gen()%_numVertices; ii < _numVertices; ++ii, index = (index + 1)%_numVertices)
+		{
+			position = (float*)&vertex[index*_stride];
+
+			float xx = position[0] - center[0];
+			float yy = position[1] - center[1];
+			float zz = position[2] - center[2];
+			float distSq = xx*xx + yy*yy + zz*zz;
+
+			if (distSq > maxDistSq)
+			{
+				done = false;
+
+				center[0] += xx * radiusStep;
+				center[1] += yy * radiusStep;
+				center[2] += zz * radiusStep;
+				maxDistSq = flerp(maxDistSq, distSq, _step);
+
+				break;
+			}
+		}
+
+	} while (!done);
+
+	_sphere.m_center[0] = center[0];
+	_sphere.m_center[1] = center[1];
+	_sphere.m_center[2] = center[2];
+	_sphere.m_radius = sqrtf(maxDistSq);
+}
+
+struct Vertex
+{
+	float m_position[3];
+	float m_normal[3]; // Unused, only to test stride.
+};
+
+static float frnd(bx::RngMwc& _rng)
+{
+	return float(_rng.gen() )/float(UINT32_MAX);
+}
+
+static float frndh(bx::RngMwc& _rng)
+{
+	return frnd(_rng)*2.0f - 1.0f;
+}
+
+// Random point set, transformed with random scale, rotation and
+// translation, so that axis aligned box is not the best fit.
+static void generate(Vertex* _vertices, uint32_t _numVertices, uint32_t _shape, bx::RngMwc& _rng)
+{
+	float mtx[16];
+	mtxRotateXYZ(mtx, frnd(_rng)*6.28f, frnd(_rng)*6.28f, frnd(_rng)*6.28f);
+	mtx[12] = frndh(_rng)*100.0f;
+	mtx[13] = frndh(_rng)*100.0f;
+	mtx[14] = frndh(_rng)*100.0f;
+
+	const float scale[3] =
+	{
+		0.1f + frnd(_rng)*10.0f,
+		0.1f + frnd(_rng)*10.0f,
+		0.1f + frnd(_rng)*10.0f,
+	};
+
+	for (uint32_t ii = 0; ii < _numVertices; ++ii)
+	{
+		float pos[3] = { frndh(_rng), frndh(_rng), frndh(_rng) };
+
+		switch (_shape)
+		{
+		default:
+		case 0: // Box surface.
+			pos[ii%3] = 0.0f < pos[ii%3] ? 1.0f : -1.0f;
+			break;
+
+		case 1: // Ellipsoid surface.
+			vec3Norm(pos, pos);
+			break;
+
+		case 2: // Cylinder.
+			{
+				const float len = sqrtf(pos[0]*pos[0] + pos[1]*pos[1]);
+				if (0.0f < len)
+				{
+					pos[0] /= len;
+					pos[1] /= len;
+				}
+			}
+			break;
+
+		case 3: // Cloud.
+			break;
+		}
+
+		pos[0] *= scale[0];
+		pos[1] *= scale[1];
+		pos[2] *= scale[2];
+
+		vec3MulMtx(_vertices[ii].m_position, pos, mtx);
+		_vertices[ii].m_normal[0] = 0.0f;
+		_vertices[ii].m_normal[1] = 0.0f;
+		_vertices[ii].m_normal[2] = 0.0f;
+	}
+}
+
+static float calcObbArea(const Obb& _obb)
+{
+	// Rows are axes scaled by half extent.
+	float extent[3];
+	for (uint32_t ii = 0; ii < 3; ++ii)
+	{
+		const float* axis = &_obb.m_mtx[ii*4];
+		extent[ii] = 2.0f*sqrtf(vec3Dot(axis, axis) );
+	}
+
+	return 2.0f * (extent[0]*extent[1] + extent[0]*extent[2] + extent[1]*extent[2]);
+}
+
+static bool containsAll(const Obb& _obb, const Sphere& _sphere, const Vertex* _vertices, uint32_t _numVertices, float _epsilon)
+{
+	// Box might be flat, so instead of inverting matrix vertices are
+	// projected on each axis.
+	float extentSq[3];
+	for (uint32_t jj = 0; jj < 3; ++jj)
+	{
+		const float* axis = &_obb.m_mtx[jj*4];
+		extentSq[jj] = vec3Dot(axis, axis);
+	}
+
+	const float radius = _sphere.m_radius + _epsilon;
+
+	for (uint32_t ii = 0; ii < _numVertices; ++ii)
+	{
+		const float* pos = _vertices[ii].m_position;
+
+		float dist[3];
+		vec3Sub(dist, pos, &_obb.m_mtx[12]);
+		for (uint32_t jj = 0; jj < 3; ++jj)
+		{
+			// |dot(dist, axis)| <= |axis|^2 when vertex is inside.
+			const float extent = sqrtf(extentSq[jj]);
+			if (fabsf(vec3Dot(dist, &_obb.m_mtx[jj*4]) ) > extentSq[jj] + _epsilon*extent)
+			{
+				return false;
+			}
+		}
+
+		vec3Sub(dist, pos, _sphere.m_center);
+		if (vec3Dot(dist, dist) > radius*radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int boundsBench(const bx::CommandLine& _cmdLine)
+{
+	const uint32_t numMeshes = benchOption(_cmdLine, 'n', NULL, 32);
+	const uint32_t maxVertices = bx::uint32_max(2, benchOption(_cmdLine, 'v', NULL, 4<<10) );
+	const uint32_t obbSteps = bx::uint32_min(bx::uint32_max(benchOption(_cmdLine, '\0', "obb", 17), 1), 90);
+
+	uint32_t numThreads = benchOption(_cmdLine, '\0', "threads", 1);
+	numThreads = 0 == numThreads ? getNumCpus() : numThreads;
+
+	Vertex* vertices = (Vertex*)malloc(maxVertices*sizeof(Vertex) );
+
+	bx::RngMwc rng;
+
+	BenchTimer obbRefTime;
+	BenchTimer obbTime;
+	BenchTimer sphereRefTime;
+	BenchTimer sphereTime;
+
+	float obbRatio = 0.0f;
+	float sphereRatio = 0.0f;
+	uint32_t numFailed = 0;
+
+	for (uint32_t ii = 0; ii < numMeshes; ++ii)
+	{
+		const uint32_t numVertices = bx::uint32_max(2, rng.gen()%maxVertices);
+		const uint32_t shape = ii%4;
+		generate(vertices, numVertices, shape, rng);
+
+		Obb obbRef;
+		obbRefTime.begin();
+		calcObbRef(obbRef, vertices, numVertices, sizeof(Vertex), obbSteps);
+		obbRefTime.end();
+
+		Obb obb;
+		obbTime.begin();
+		calcObb(obb, vertices, numVertices, sizeof(Vertex), obbSteps, numThreads);
+		obbTime.end();
+
+		Sphere sphereRef;
+		sphereRefTime.begin();
+		calcMinBoundingSphereRef(sphereRef, vertices, numVertices, sizeof(Vertex) );
+		sphereRefTime.end();
+
+		Sphere sphere;
+		sphereTime.begin();
+		calcMinBoundingSphere(sphere, vertices, numVertices, sizeof(Vertex) );
+		sphereTime.end();
+
+		const float areaRef = calcObbArea(obbRef);
+		const float area = calcObbArea(obb);
+		obbRatio = fmax(obbRatio, area/areaRef);
+		sphereRatio = fmax(sphereRatio, sphere.m_radius/sphereRef.m_radius);
+
+		// Relative to size of mesh, positions are up to ~100 units away
+		// from origin.
+		const float epsilon = 1e-4f*(1.0f + sphereRef.m_radius);
+
+		const bool obbGrew = area > areaRef*(1.0f + 1e-4f);
+		const bool sphereGrew = sphere.m_radius > sphereRef.m_radius + epsilon;
+		const bool contained = containsAll(obb, sphere, vertices, numVertices, epsilon);
+
+		if (obbGrew
+		||  sphereGrew
+		||  !contained)
+		{
+			++numFailed;
+			printf("mesh %d (shape %d, vertices %d): OBB area %f -> %f, sphere radius %f -> %f%s\n"
+				, ii
+				, shape
+				, numVertices
+				, areaRef
+				, area
+				, sphereRef.m_radius
+				, sphere.m_radius
+				, contained ? "" : ", vertex outside"
+				);
+		}
+	}
+
+	printf("meshes %d, max vertices %d, OBB steps %d, threads %d\n"
+		   "calcObb ref %f [s]\n"
+		   "calcObb %f [s], max area ratio %f\n"
+		   "calcMinBoundingSphere ref %f [s]\n"
+		   "calcMinBoundingSphere %f [s], max radius ratio %f\n"
+		   "failed %d\n"
+		, numMeshes
+		, maxVertices
+		, obbSteps
+		, numThreads
+		, obbRefTime.seconds()
+		, obbTime.seconds()
+		, obbRatio
+		, sphereRefTime.seconds()
+		, sphereTime.seconds()
+		, sphereRatio
+		, numFailed
+		);
+
+	free(vertices);
+
+	return 0 == numFailed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
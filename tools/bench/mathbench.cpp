@@ -0,0 +1,219 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h> // fabsf
+
+#include "bench.h"
+#include "fpumath.h"
+
+// Scalar paths, same as fpumath.h before float4_t was introduced.
+static void mtxMulRef(float* __restrict _result, const float* __restrict _a, const float* __restrict _b)
+{
+	for (uint32_t ii = 0; ii < 4; ++ii)
+	{
+		const float* vec = &_a[ii*4];
+		for (uint32_t jj = 0; jj < 4; ++jj)
+		{
+			_result[ii*4+jj] = vec[0]*_b[jj] + vec[1]*_b[4+jj] + vec[2]*_b[8+jj] + vec[3]*_b[12+jj];
+		}
+	}
+}
+
+static void mtxInverseRef(float* __restrict _result, const float* __restrict _a)
+{
+	float xx = _a[ 0];
+	float xy = _a[ 1];
+	float xz = _a[ 2];
+	float xw = _a[ 3];
+	float yx = _a[ 4];
+	float yy = _a[ 5];
+	float yz = _a[ 6];
+	float yw = _a[ 7];
+	float zx = _a[ 8];
+	float zy = _a[ 9];
+	float zz = _a[10];
+	float zw = _a[11];
+	float wx = _a[12];
+	float wy = _a[13];
+	float wz = _a[14];
+	float ww = _a[15];
+
+	float det = 0.0f;
+	det += xx * (yy*(zz*ww - zw*wz) - yz*(zy*ww - zw*wy) + yw*(zy*wz - zz*wy) );
+	det -= xy * (yx*(zz*ww - zw*wz) - yz*(zx*ww - zw*wx) + yw*(zx*wz - zz*wx) );
+	det += xz * (yx*(zy*ww - zw*wy) - yy*(zx*ww - zw*wx) + yw*(zx*wy - zy*wx) );
+	det -= xw * (yx*(zy*wz - zz*wy) - yy*(zx*wz - zz*wx) + yz*(zx*wy - zy*wx) );
+
+	float invDet = 1.0f/det;
+
+	_result[ 0] = +(yy*(zz*ww - wz*zw) - yz*(zy*ww - wy*zw) + yw*(zy*wz - wy*zz) ) * invDet;
+	_result[ 1] = -(xy*(zz*ww - wz*zw) - xz*(zy*ww - wy*zw) + xw*(zy*wz - wy*zz) ) * invDet;
+	_result[ 2] = +(xy*(yz*ww - wz*yw) - xz*(yy*ww - wy*yw) + xw*(yy*wz - wy*yz) ) * invDet;
+	_result[ 3] = -(xy*(yz*zw - zz*yw) - xz*(yy*zw - zy*yw) + xw*(yy*zz - zy*yz) ) * invDet;
+
+	_result[ 4] = -(yx*(zz*ww - wz*zw) - yz*(zx*ww - wx*zw) + yw*(zx*wz - wx*zz) ) * invDet;
+	_result[ 5] = +(xx*(zz*ww - wz*zw) - xz*(zx*ww - wx*zw) + xw*(zx*wz - wx*zz) ) * invDet;
+	_result[ 6] = -(xx*(yz*ww - wz*yw) - xz*(yx*ww - wx*yw) + xw*(yx*wz - wx*yz) ) * invDet;
+	_result[ 7] = +(xx*(yz*zw - zz*yw) - xz*(yx*zw - zx*yw) + xw*(yx*zz - zx*yz) ) * invDet;
+
+	_result[ 8] = +(yx*(zy*ww - wy*zw) - yy*(zx*ww - wx*zw) + yw*(zx*wy - wx*zy) ) * invDet;
+	_result[ 9] = -(xx*(zy*ww - wy*zw) - xy*(zx*ww - wx*zw) + xw*(zx*wy - wx*zy) ) * invDet;
+	_result[10] = +(xx*(yy*ww - wy*yw) - xy*(yx*ww - wx*yw) + xw*(yx*wy - wx*yy) ) * invDet;
+	_result[11] = -(xx*(yy*zw - zy*yw) - xy*(yx*zw - zx*yw) + xw*(yx*zy - zx*yy) ) * invDet;
+
+	_result[12] = -(yx*(zy*wz - wy*zz) - yy*(zx*wz - wx*zz) + yz*(zx*wy - wx*zy) ) * invDet;
+	_result[13] = +(xx*(zy*wz - wy*zz) - xy*(zx*wz - wx*zz) + xz*(zx*wy - wx*zy) ) * invDet;
+	_result[14] = -(xx*(yy*wz - wy*yz) - xy*(yx*wz - wx*yz) + xz*(yx*wy - wx*yy) ) * invDet;
+	_result[15] = +(xx*(yy*zz - zy*yz) - xy*(yx*zz - zx*yz) + xz*(yx*zy - zx*yy) ) * invDet;
+}
+
+static void vec3MulMtxRef(float* __restrict _result, const float* __restrict _vec, const float* __restrict _mat)
+{
+	_result[0] = _vec[0] * _mat[ 0] + _vec[1] * _mat[4] + _vec[2] * _mat[ 8] + _mat[12];
+	_result[1] = _vec[0] * _mat[ 1] + _vec[1] * _mat[5] + _vec[2] * _mat[ 9] + _mat[13];
+	_result[2] = _vec[0] * _mat[ 2] + _vec[1] * _mat[6] + _vec[2] * _mat[10] + _mat[14];
+}
+
+static float compare(const float* _data0, const float* _data1, uint32_t _num)
+{
+	float maxError = 0.0f;
+
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		// Relative to magnitude, inverse of random matrix can be large.
+		const float scale = fabsf(_data0[ii]) > 1.0f ? fabsf(_data0[ii]) : 1.0f;
+		const float error = fabsf(_data0[ii] - _data1[ii])/scale;
+		maxError = error > maxError ? error : maxError;
+	}
+
+	return maxError;
+}
+
+int mathBench(const bx::CommandLine& _cmdLine)
+{
+	const uint32_t numMatrices = bx::uint32_max(1, benchOption(_cmdLine, 'n', NULL, 64<<10) );
+	const uint32_t numIterations = bx::uint32_max(1, benchOption(_cmdLine, 'i', NULL, 10) );
+
+	const uint32_t numFloats = numMatrices*16;
+	float* src = (float*)malloc(numFloats*sizeof(float) );
+	float* dest0 = (float*)malloc(numFloats*sizeof(float) );
+	float* dest1 = (float*)malloc(numFloats*sizeof(float) );
+
+	for (uint32_t ii = 0; ii < numFloats; ++ii)
+	{
+		src[ii] = float(rand() )/float(RAND_MAX)*2.0f - 1.0f;
+	}
+
+	// Diagonally dominant, so that matrices are invertible.
+	for (uint32_t ii = 0; ii < numMatrices; ++ii)
+	{
+		float* mtx = &src[ii*16];
+		mtx[ 0] += 4.0f;
+		mtx[ 5] += 4.0f;
+		mtx[10] += 4.0f;
+		mtx[15] += 4.0f;
+	}
+
+	float viewProj[16];
+	memcpy(viewProj, src, sizeof(viewProj) );
+
+	BenchTimer mulRefTime;
+	BenchTimer mulTime;
+	BenchTimer mulBatchTime;
+	BenchTimer invRefTime;
+	BenchTimer invTime;
+	BenchTimer vec3RefTime;
+	BenchTimer vec3BatchTime;
+
+	float mulError = 0.0f;
+	float mulBatchError = 0.0f;
+	float invError = 0.0f;
+	float vec3Error = 0.0f;
+
+	for (uint32_t ii = 0; ii < numIterations; ++ii)
+	{
+		mulRefTime.begin();
+		for (uint32_t jj = 0; jj < numMatrices; ++jj)
+		{
+			mtxMulRef(&dest0[jj*16], &src[jj*16], viewProj);
+		}
+		mulRefTime.end();
+
+		mulTime.begin();
+		for (uint32_t jj = 0; jj < numMatrices; ++jj)
+		{
+			mtxMul(&dest1[jj*16], &src[jj*16], viewProj);
+		}
+		mulTime.end();
+		mulError = compare(dest0, dest1, numFloats);
+
+		mulBatchTime.begin();
+		mtxMulBatch(dest1, src, viewProj, numMatrices);
+		mulBatchTime.end();
+		mulBatchError = compare(dest0, dest1, numFloats);
+
+		invRefTime.begin();
+		for (uint32_t jj = 0; jj < numMatrices; ++jj)
+		{
+			mtxInverseRef(&dest0[jj*16], &src[jj*16]);
+		}
+		invRefTime.end();
+
+		invTime.begin();
+		for (uint32_t jj = 0; jj < numMatrices; ++jj)
+		{
+			mtxInverse(&dest1[jj*16], &src[jj*16]);
+		}
+		invTime.end();
+		invError = compare(dest0, dest1, numFloats);
+
+		// Source is used as array of points.
+		const uint32_t numPoints = numFloats/3;
+
+		vec3RefTime.begin();
+		for (uint32_t jj = 0; jj < numPoints; ++jj)
+		{
+			vec3MulMtxRef(&dest0[jj*3], &src[jj*3], viewProj);
+		}
+		vec3RefTime.end();
+
+		vec3BatchTime.begin();
+		vec3MulMtxBatch(dest1, src, viewProj, numPoints);
+		vec3BatchTime.end();
+		vec3Error = compare(dest0, dest1, numPoints*3);
+	}
+
+	printf("matrices %d, iterations %d, FPU_MATH_SIMD %d\n"
+		   "mtxMul ref %f [s]\n"
+		   "mtxMul %f [s], max error %f\n"
+		   "mtxMulBatch %f [s], max error %f\n"
+		   "mtxInverse ref %f [s]\n"
+		   "mtxInverse %f [s], max error %f\n"
+		   "vec3MulMtx ref %f [s]\n"
+		   "vec3MulMtxBatch %f [s], max error %f\n"
+		, numMatrices
+		, numIterations
+		, FPU_MATH_SIMD
+		, mulRefTime.seconds(numIterations)
+		, mulTime.seconds(numIterations)
+		, mulError
+		, mulBatchTime.seconds(numIterations)
+		, mulBatchError
+		, invRefTime.seconds(numIterations)
+		, invTime.seconds(numIterations)
+		, invError
+		, vec3RefTime.seconds(numIterations)
+		, vec3BatchTime.seconds(numIterations)
+		, vec3Error
+		);
+
+	free(src);
+	free(dest0);
+	free(dest1);
+
+	return EXIT_SUCCESS;
+}
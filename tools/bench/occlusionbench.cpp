@@ -0,0 +1,169 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "fpumath.h"
+#include "cull.h"
+#include "occlusion.h"
+
+// Camera is at origin looking down +z, with 16:9 projection independent
+// of depth buffer size. Occluder is 10x10 wall at z=10, wall covers
+// |x|,|y| <= z/2 at any depth z behind it. Visible boxes are at least
+// about pixel away from wall edges at smallest depth buffer size.
+static const float s_wall[4][3] =
+{
+	{ -5.0f, -5.0f, 10.0f },
+	{  5.0f, -5.0f, 10.0f },
+	{ -5.0f,  5.0f, 10.0f },
+	{  5.0f,  5.0f, 10.0f },
+};
+
+static const uint16_t s_wallIndices[6] =
+{
+	0, 1, 2,
+	1, 3, 2,
+};
+
+struct Box
+{
+	const char* m_name;
+	float m_center[3];
+	float m_extent[3];
+	bool m_visible;
+};
+
+static const Box s_boxes[] =
+{
+	{ "behind wall",               {   0.0f,  0.0f, 30.0f }, { 2.0f, 2.0f, 2.0f }, false },
+	{ "far behind wall",           {   3.0f, -3.0f, 90.0f }, { 1.0f, 1.0f, 1.0f }, false },
+	{ "behind wall, long in z",    {   0.0f,  0.0f, 50.0f }, { 1.0f, 1.0f, 30.0f }, false },
+	{ "in front of wall",          {   0.0f,  0.0f,  5.0f }, { 1.0f, 1.0f, 1.0f }, true  },
+	{ "intersecting wall",         {   0.0f,  0.0f, 10.0f }, { 1.0f, 1.0f, 1.0f }, true  },
+	{ "beside wall",               {  18.0f,  0.0f, 30.0f }, { 0.5f, 0.5f, 0.5f }, true  },
+	{ "above wall",                {   0.0f, 16.0f, 30.0f }, { 0.5f, 0.5f, 0.5f }, true  },
+	{ "sticking out behind wall",  {  15.0f,  0.0f, 30.0f }, { 2.0f, 2.0f, 2.0f }, true  },
+	{ "crossing near plane",       {   0.0f,  0.0f,  0.0f }, { 1.0f, 1.0f, 1.0f }, true  },
+	{ "behind camera",             {   0.0f,  0.0f, -20.0f }, { 1.0f, 1.0f, 1.0f }, true  },
+	{ "off screen",                { 100.0f,  0.0f, 30.0f }, { 1.0f, 1.0f, 1.0f }, true  },
+};
+
+int occlusionBench(const bx::CommandLine& _cmdLine)
+{
+	const uint32_t numIterations = bx::uint32_max(1, benchOption(_cmdLine, 'n', NULL, 1000) );
+	const uint32_t width = bx::uint32_max(64, benchOption(_cmdLine, '\0', "width", 256) );
+	const uint32_t height = bx::uint32_max(64, benchOption(_cmdLine, '\0', "height", 144) );
+	const uint32_t numThreads = benchOption(_cmdLine, '\0', "threads", 1);
+
+	float eye[3] = { 0.0f, 0.0f,  0.0f };
+	float at[3]  = { 0.0f, 0.0f,  1.0f };
+	float view[16];
+	mtxLookAt(view, eye, at);
+
+	float proj[16];
+	mtxProj(proj, 60.0f, 16.0f/9.0f, 0.1f, 100.0f);
+
+	float viewProj[16];
+	mtxMul(viewProj, view, proj);
+
+	float mtx[16];
+	mtxIdentity(mtx);
+
+	const uint32_t numBoxes = BX_COUNTOF(s_boxes);
+
+	CullAabbs aabbs;
+	cullAabbsAlloc(aabbs, numBoxes);
+
+	uint32_t candidates[BX_COUNTOF(s_boxes)];
+	for (uint32_t ii = 0; ii < numBoxes; ++ii)
+	{
+		const Box& box = s_boxes[ii];
+		Aabb aabb;
+		for (uint32_t jj = 0; jj < 3; ++jj)
+		{
+			aabb.m_min[jj] = box.m_center[jj] - box.m_extent[jj];
+			aabb.m_max[jj] = box.m_center[jj] + box.m_extent[jj];
+		}
+
+		cullAabbsSet(aabbs, ii, aabb);
+		candidates[ii] = ii;
+	}
+
+	OcclusionCulling occlusion(width, height, numThreads);
+
+	uint32_t visible[BX_COUNTOF(s_boxes)];
+	uint32_t numVisible = 0;
+
+	// Stats are reset by begin, accumulate times over all iterations.
+	BenchTimer rasterizeTime;
+	BenchTimer testTime;
+
+	for (uint32_t ii = 0; ii < numIterations; ++ii)
+	{
+		occlusion.begin(viewProj);
+		occlusion.addOccluder(mtx, s_wall, BX_COUNTOF(s_wall), sizeof(s_wall[0]), s_wallIndices, BX_COUNTOF(s_wallIndices) );
+		occlusion.rasterize();
+		numVisible = occlusion.testAabbs(visible, aabbs, candidates, numBoxes);
+
+		const OcclusionStats& stats = occlusion.getStats();
+		rasterizeTime.m_elapsed += stats.m_rasterizeTime;
+		testTime.m_elapsed += stats.m_testTime;
+	}
+
+	bool result[BX_COUNTOF(s_boxes)];
+	memset(result, 0, sizeof(result) );
+	for (uint32_t ii = 0; ii < numVisible; ++ii)
+	{
+		result[visible[ii] ] = true;
+	}
+
+	uint32_t numFailed = 0;
+	for (uint32_t ii = 0; ii < numBoxes; ++ii)
+	{
+		const Box& box = s_boxes[ii];
+		const bool single = occlusion.testAabb(box.m_center, box.m_extent);
+
+		if (box.m_visible != result[ii]
+		||  box.m_visible != single)
+		{
+			++numFailed;
+			printf("box %d (%s): expected %s, testAabbs %s, testAabb %s\n"
+				, ii
+				, box.m_name
+				, box.m_visible ? "visible" : "culled"
+				, result[ii]    ? "visible" : "culled"
+				, single        ? "visible" : "culled"
+				);
+		}
+	}
+
+	// Stats of last iteration, before testAabb calls above.
+	const OcclusionStats& stats = occlusion.getStats();
+
+	printf("iterations %d, depth %dx%d, threads %d\n"
+		   "occluders %d, triangles %d\n"
+		   "tested %d, culled %d\n"
+		   "rasterize %f [ms]\n"
+		   "test %f [ms]\n"
+		   "failed %d\n"
+		, numIterations
+		, occlusion.getWidth()
+		, occlusion.getHeight()
+		, numThreads
+		, stats.m_numOccluders
+		, stats.m_numTriangles
+		, stats.m_numTested
+		, stats.m_numCulled
+		, rasterizeTime.seconds(numIterations)*1000.0
+		, testTime.seconds(numIterations)*1000.0
+		, numFailed
+		);
+
+	cullAabbsFree(aabbs);
+
+	return 0 == numFailed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
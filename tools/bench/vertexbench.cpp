@@ -0,0 +1,129 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#include <bgfx.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h> // fabsf
+
+#include "bench.h"
+
+// Per vertex, per attribute path, same as vertexConvert used before
+// VertexConverter was introduced.
+static void vertexConvertRef(const bgfx::VertexDecl& _destDecl, void* _destData, const bgfx::VertexDecl& _srcDecl, const void* _srcData, uint32_t _num)
+{
+	float unpacked[4];
+
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		for (uint32_t attr = 0; attr < bgfx::Attrib::Count; ++attr)
+		{
+			if (_destDecl.has(bgfx::Attrib::Enum(attr) ) )
+			{
+				bgfx::vertexUnpack(unpacked, bgfx::Attrib::Enum(attr), _srcDecl, _srcData, ii);
+				bgfx::vertexPack(unpacked, true, bgfx::Attrib::Enum(attr), _destDecl, _destData, ii);
+			}
+		}
+	}
+}
+
+static float compare(const bgfx::VertexDecl& _decl, const void* _data0, const void* _data1, uint32_t _num)
+{
+	float maxError = 0.0f;
+
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		for (uint32_t attr = 0; attr < bgfx::Attrib::Count; ++attr)
+		{
+			if (_decl.has(bgfx::Attrib::Enum(attr) ) )
+			{
+				float v0[4];
+				float v1[4];
+				bgfx::vertexUnpack(v0, bgfx::Attrib::Enum(attr), _decl, _data0, ii);
+				bgfx::vertexUnpack(v1, bgfx::Attrib::Enum(attr), _decl, _data1, ii);
+
+				for (uint32_t jj = 0; jj < 4; ++jj)
+				{
+					const float error = fabsf(v0[jj] - v1[jj]);
+					maxError = error > maxError ? error : maxError;
+				}
+			}
+		}
+	}
+
+	return maxError;
+}
+
+int vertexBench(const bx::CommandLine& _cmdLine)
+{
+	const uint32_t numVertices = benchOption(_cmdLine, 'n', NULL, 500<<10);
+	const uint32_t numIterations = bx::uint32_max(1, benchOption(_cmdLine, 'i', NULL, 10) );
+
+	bgfx::VertexDecl srcDecl;
+	srcDecl.begin();
+	srcDecl.add(bgfx::Attrib::Position,  3, bgfx::AttribType::Float);
+	srcDecl.add(bgfx::Attrib::Normal,    3, bgfx::AttribType::Float);
+	srcDecl.add(bgfx::Attrib::Tangent,   4, bgfx::AttribType::Float);
+	srcDecl.add(bgfx::Attrib::Color0,    4, bgfx::AttribType::Float);
+	srcDecl.add(bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Float);
+	srcDecl.end();
+
+	bgfx::VertexDecl destDecl;
+	destDecl.begin();
+	destDecl.add(bgfx::Attrib::Position,  3, bgfx::AttribType::Float);
+	destDecl.add(bgfx::Attrib::Normal,    4, bgfx::AttribType::Uint8, true, true);
+	destDecl.add(bgfx::Attrib::Tangent,   4, bgfx::AttribType::Int16, true, true);
+	destDecl.add(bgfx::Attrib::Color0,    4, bgfx::AttribType::Uint8, true);
+	destDecl.add(bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Half);
+	destDecl.end();
+
+	float* src = (float*)malloc(srcDecl.getSize(numVertices) );
+	uint8_t* dest0 = (uint8_t*)malloc(destDecl.getSize(numVertices) );
+	uint8_t* dest1 = (uint8_t*)malloc(destDecl.getSize(numVertices) );
+
+	const uint32_t numFloats = srcDecl.getSize(numVertices)/sizeof(float);
+	for (uint32_t ii = 0; ii < numFloats; ++ii)
+	{
+		src[ii] = float(rand() )/float(RAND_MAX)*2.0f - 1.0f;
+	}
+
+	BenchTimer refTime;
+	BenchTimer convertTime;
+	BenchTimer converterTime;
+
+	bgfx::VertexConverter converter;
+	converter.init(destDecl, srcDecl);
+
+	for (uint32_t ii = 0; ii < numIterations; ++ii)
+	{
+		refTime.begin();
+		vertexConvertRef(destDecl, dest0, srcDecl, src, numVertices);
+		refTime.end();
+
+		convertTime.begin();
+		bgfx::vertexConvert(destDecl, dest1, srcDecl, src, numVertices);
+		convertTime.end();
+
+		converterTime.begin();
+		converter.convert(dest1, src, numVertices);
+		converterTime.end();
+	}
+
+	printf("vertices %d, iterations %d\nref %f [s]\nvertexConvert %f [s]\nVertexConverter %f [s]\nmax error %f\n"
+		, numVertices
+		, numIterations
+		, refTime.seconds(numIterations)
+		, convertTime.seconds(numIterations)
+		, converterTime.seconds(numIterations)
+		, compare(destDecl, dest0, dest1, numVertices)
+		);
+
+	free(src);
+	free(dest0);
+	free(dest1);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#include <map>
+#include "adjacency.h"
+
+void buildAdjacency(AdjacencyEdgeArray& _edges, const uint16_t* _indices, uint32_t _numIndices, const uint32_t* _weld)
+{
+	_edges.clear();
+
+	typedef std::map<std::pair<uint16_t, uint16_t>, uint32_t> EdgeMap;
+	EdgeMap edgeMap;
+
+	for (uint32_t ii = 0, num = _numIndices/3; ii < num; ++ii)
+	{
+		const uint16_t ui[3] =
+		{
+			uint16_t(_weld[_indices[ii*3+0] ]),
+			uint16_t(_weld[_indices[ii*3+1] ]),
+			uint16_t(_weld[_indices[ii*3+2] ]),
+		};
+
+		for (uint32_t jj = 0; jj < 3; ++jj)
+		{
+			const uint16_t i0 = ui[jj];
+			const uint16_t i1 = ui[(jj+1)%3];
+			if (i0 == i1)
+			{
+				continue;
+			}
+
+			EdgeMap::iterator it = edgeMap.find(std::make_pair(i1, i0) );
+			if (it != edgeMap.end()
+			&&  UINT32_MAX == _edges[it->second].m_face[1])
+			{
+				_edges[it->second].m_face[1] = ii;
+				continue;
+			}
+
+			edgeMap[std::make_pair(i0, i1)] = uint32_t(_edges.size() );
+
+			AdjacencyEdge edge;
+			edge.m_i0 = i0;
+			edge.m_i1 = i1;
+			edge.m_face[0] = ii;
+			edge.m_face[1] = UINT32_MAX;
+			_edges.push_back(edge);
+		}
+	}
+}
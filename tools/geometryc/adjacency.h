@@ -0,0 +1,28 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#ifndef ADJACENCY_H_HEADER_GUARD
+#define ADJACENCY_H_HEADER_GUARD
+
+#include <stdint.h>
+#include <vector>
+
+struct AdjacencyEdge
+{
+	uint16_t m_i0;
+	uint16_t m_i1;
+	uint32_t m_face[2]; //!< Face with edge in i0, i1 order, and face with edge in i1, i0 order or UINT32_MAX.
+};
+
+typedef std::vector<AdjacencyEdge> AdjacencyEdgeArray;
+
+/// Build edge to face adjacency for shadow volume silhouette extraction.
+/// Edges are keyed by welded vertex indices, _weld maps vertex index to
+/// index of first vertex with the same position. Edges used by more than
+/// two faces are split, so that each edge has at most one face on each
+/// side. Degenerate edges are skipped.
+void buildAdjacency(AdjacencyEdgeArray& _edges, const uint16_t* _indices, uint32_t _numIndices, const uint32_t* _weld);
+
+#endif // ADJACENCY_H_HEADER_GUARD
@@ -3,10 +3,26 @@
  * License: http://www.opensource.org/licenses/BSD-2-Clause
  */
 
+#include <bx/bx.h>
+#include <bx/float4_t.h>
 #include <bx/rng.h>
+#include <bx/uint32_t.h>
+#include <float.h>
+#include <algorithm>
+#include <vector>
+
 #include "bounds.h"
+#include "jobs.h"
 #include "math.h"
 
+// Number of directions used to find extremal vertices. First three are
+// coordinate axes, remaining are spread over hemisphere.
+#define BOUNDS_NUM_DIRECTIONS 32
+
+// Don't spawn threads for small amount of work.
+#define BOUNDS_MIN_VERTICES_PER_JOB (64<<10)
+#define BOUNDS_MIN_TESTS_PER_JOB (1<<20)
+
 void aabbToObb(Obb& _obb, const Aabb& _aabb)
 {
 	memset(_obb.m_mtx, 0, sizeof(_obb.m_mtx) );
@@ -37,120 +53,562 @@ float calcAreaAabb(Aabb& _aabb)
 
 void calcAabb(Aabb& _aabb, const void* _vertices, uint32_t _numVertices, uint32_t _stride)
 {
-	float min[3], max[3];
-	uint8_t* vertex = (uint8_t*)_vertices;
-	float* position = (float*)vertex;
-	min[0] = max[0] = position[0];
-	min[1] = max[1] = position[1];
-	min[2] = max[2] = position[2];
+	using namespace bx;
+
+	const uint8_t* vertex = (const uint8_t*)_vertices;
+	const float* position = (const float*)vertex;
+	float4_t min = float4_ld(position[0], position[1], position[2], 0.0f);
+	float4_t max = min;
 	vertex += _stride;
 
 	for (uint32_t ii = 1; ii < _numVertices; ++ii)
 	{
-		position = (float*)vertex;
+		position = (const float*)vertex;
 		vertex += _stride;
 
-		float xx = position[0];
-		float yy = position[1];
-		float zz = position[2];
-		min[0] = fmin(xx, min[0]);
-		min[1] = fmin(yy, min[1]);
-		min[2] = fmin(zz, min[2]);
-		max[0] = fmax(xx, max[0]);
-		max[1] = fmax(yy, max[1]);
-		max[2] = fmax(zz, max[2]);
+		const float4_t xyz = float4_ld(position[0], position[1], position[2], 0.0f);
+		min = float4_min(min, xyz);
+		max = float4_max(max, xyz);
 	}
 
-	_aabb.m_min[0] = min[0];
-	_aabb.m_min[1] = min[1];
-	_aabb.m_min[2] = min[2];
-	_aabb.m_max[0] = max[0];
-	_aabb.m_max[1] = max[1];
-	_aabb.m_max[2] = max[2];
+	BX_ALIGN_STRUCT_16(float result[4]);
+	float4_st(&result, min);
+	memcpy(_aabb.m_min, result, 3*sizeof(float) );
+	float4_st(&result, max);
+	memcpy(_aabb.m_max, result, 3*sizeof(float) );
 }
 
 void calcAabb(Aabb& _aabb, const float* _mtx, const void* _vertices, uint32_t _numVertices, uint32_t _stride)
 {
-	float min[3], max[3];
-	uint8_t* vertex = (uint8_t*)_vertices;
-
-	float position[3];
-	vec3MulMtx(position, (float*)vertex, _mtx);
-	min[0] = max[0] = position[0];
-	min[1] = max[1] = position[1];
-	min[2] = max[2] = position[2];
+	using namespace bx;
+
+	// Same as vec3MulMtx, vertex is treated as row vector.
+	const float4_t row0 = float4_ld(_mtx[ 0], _mtx[ 1], _mtx[ 2], 0.0f);
+	const float4_t row1 = float4_ld(_mtx[ 4], _mtx[ 5], _mtx[ 6], 0.0f);
+	const float4_t row2 = float4_ld(_mtx[ 8], _mtx[ 9], _mtx[10], 0.0f);
+	const float4_t row3 = float4_ld(_mtx[12], _mtx[13], _mtx[14], 0.0f);
+
+	const uint8_t* vertex = (const uint8_t*)_vertices;
+	const float* position = (const float*)vertex;
+	float4_t min = float4_madd(float4_splat(position[0]), row0
+				 , float4_madd(float4_splat(position[1]), row1
+				 , float4_madd(float4_splat(position[2]), row2, row3) ) );
+	float4_t max = min;
 	vertex += _stride;
 
 	for (uint32_t ii = 1; ii < _numVertices; ++ii)
 	{
-		vec3MulMtx(position, (float*)vertex, _mtx);
+		position = (const float*)vertex;
 		vertex += _stride;
 
-		float xx = position[0];
-		float yy = position[1];
-		float zz = position[2];
-		min[0] = fmin(xx, min[0]);
-		min[1] = fmin(yy, min[1]);
-		min[2] = fmin(zz, min[2]);
-		max[0] = fmax(xx, max[0]);
-		max[1] = fmax(yy, max[1]);
-		max[2] = fmax(zz, max[2]);
+		const float4_t xyz = float4_madd(float4_splat(position[0]), row0
+						   , float4_madd(float4_splat(position[1]), row1
+						   , float4_madd(float4_splat(position[2]), row2, row3) ) );
+		min = float4_min(min, xyz);
+		max = float4_max(max, xyz);
+	}
+
+	BX_ALIGN_STRUCT_16(float result[4]);
+	float4_st(&result, min);
+	memcpy(_aabb.m_min, result, 3*sizeof(float) );
+	float4_st(&result, max);
+	memcpy(_aabb.m_max, result, 3*sizeof(float) );
+}
+
+struct ExtremalJob
+{
+	const uint8_t* m_vertices;
+	uint32_t m_stride;
+	uint32_t m_begin;
+	uint32_t m_end;
+	const float* m_dirs;
+	float m_minDot[BOUNDS_NUM_DIRECTIONS];
+	float m_maxDot[BOUNDS_NUM_DIRECTIONS];
+	uint32_t m_min[BOUNDS_NUM_DIRECTIONS];
+	uint32_t m_max[BOUNDS_NUM_DIRECTIONS];
+};
+
+static int32_t findExtremal(void* _userData)
+{
+	ExtremalJob& job = *(ExtremalJob*)_userData;
+
+	const float* position = (const float*)&job.m_vertices[job.m_begin*job.m_stride];
+	for (uint32_t jj = 0; jj < BOUNDS_NUM_DIRECTIONS; ++jj)
+	{
+		const float dot = vec3Dot(position, &job.m_dirs[jj*3]);
+		job.m_minDot[jj] = dot;
+		job.m_maxDot[jj] = dot;
+		job.m_min[jj] = job.m_begin;
+		job.m_max[jj] = job.m_begin;
+	}
+
+	for (uint32_t ii = job.m_begin+1; ii < job.m_end; ++ii)
+	{
+		position = (const float*)&job.m_vertices[ii*job.m_stride];
+
+		for (uint32_t jj = 0; jj < BOUNDS_NUM_DIRECTIONS; ++jj)
+		{
+			const float dot = vec3Dot(position, &job.m_dirs[jj*3]);
+			if (dot < job.m_minDot[jj])
+			{
+				job.m_minDot[jj] = dot;
+				job.m_min[jj] = ii;
+			}
+			else if (dot > job.m_maxDot[jj])
+			{
+				job.m_maxDot[jj] = dot;
+				job.m_max[jj] = ii;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/// Collect vertices extremal along fixed set of directions. These are
+/// vertices of convex hull, and they approximate it well enough for
+/// searching orientation of bounding box.
+static void calcExtremalPoints(std::vector<float>& _points, const void* _vertices, uint32_t _numVertices, uint32_t _stride, uint32_t _numThreads)
+{
+	float dirs[BOUNDS_NUM_DIRECTIONS*3];
+	memset(dirs, 0, 9*sizeof(float) );
+	dirs[0] = dirs[4] = dirs[8] = 1.0f;
+
+	// Fibonacci spiral over hemisphere.
+	const uint32_t numSpiral = BOUNDS_NUM_DIRECTIONS-3;
+	for (uint32_t ii = 0; ii < numSpiral; ++ii)
+	{
+		const float zz = 1.0f - (float(ii) + 0.5f)/float(numSpiral);
+		const float rr = sqrtf(1.0f - zz*zz);
+		const float phi = float(ii)*2.39996323f;
+		float* dir = &dirs[(ii+3)*3];
+		dir[0] = rr*cosf(phi);
+		dir[1] = rr*sinf(phi);
+		dir[2] = zz;
+	}
+
+	uint32_t numJobs = bx::uint32_min(_numThreads, _numVertices/BOUNDS_MIN_VERTICES_PER_JOB);
+	numJobs = bx::uint32_max(numJobs, 1);
+
+	ExtremalJob* jobs = new ExtremalJob[numJobs];
+	for (uint32_t ii = 0; ii < numJobs; ++ii)
+	{
+		ExtremalJob& job = jobs[ii];
+		job.m_vertices = (const uint8_t*)_vertices;
+		job.m_stride = _stride;
+		job.m_begin = uint32_t(uint64_t(_numVertices)*ii/numJobs);
+		job.m_end = uint32_t(uint64_t(_numVertices)*(ii+1)/numJobs);
+		job.m_dirs = dirs;
+	}
+
+	runJobs(findExtremal, jobs, numJobs);
+
+	uint32_t indices[BOUNDS_NUM_DIRECTIONS*2];
+	for (uint32_t jj = 0; jj < BOUNDS_NUM_DIRECTIONS; ++jj)
+	{
+		uint32_t minJob = 0;
+		uint32_t maxJob = 0;
+		for (uint32_t ii = 1; ii < numJobs; ++ii)
+		{
+			minJob = jobs[ii].m_minDot[jj] < jobs[minJob].m_minDot[jj] ? ii : minJob;
+			maxJob = jobs[ii].m_maxDot[jj] > jobs[maxJob].m_maxDot[jj] ? ii : maxJob;
+		}
+
+		indices[jj*2+0] = jobs[minJob].m_min[jj];
+		indices[jj*2+1] = jobs[maxJob].m_max[jj];
+	}
+
+	delete [] jobs;
+
+	std::sort(indices, indices + BOUNDS_NUM_DIRECTIONS*2);
+	const uint32_t numIndices = uint32_t(std::unique(indices, indices + BOUNDS_NUM_DIRECTIONS*2) - indices);
+
+	_points.resize(numIndices*3);
+	for (uint32_t ii = 0; ii < numIndices; ++ii)
+	{
+		const float* position = (const float*)( (const uint8_t*)_vertices + indices[ii]*_stride);
+		memcpy(&_points[ii*3], position, 3*sizeof(float) );
+	}
+}
+
+/// Calculate eigenvectors of symmetric 3x3 matrix with Jacobi rotations.
+/// Eigenvectors are returned as rows of _axes.
+static void calcEigenVectors(float _axes[3][3], const float _cov[3][3])
+{
+	double aa[3][3];
+	double vv[3][3];
+	for (uint32_t ii = 0; ii < 3; ++ii)
+	{
+		for (uint32_t jj = 0; jj < 3; ++jj)
+		{
+			aa[ii][jj] = _cov[ii][jj];
+			vv[ii][jj] = ii == jj ? 1.0 : 0.0;
+		}
+	}
+
+	for (uint32_t iter = 0; iter < 32; ++iter)
+	{
+		// Find largest off-diagonal element.
+		uint32_t pp = 0;
+		uint32_t qq = 1;
+		if (fabs(aa[0][2]) > fabs(aa[pp][qq]) ) { pp = 0; qq = 2; }
+		if (fabs(aa[1][2]) > fabs(aa[pp][qq]) ) { pp = 1; qq = 2; }
+
+		const double apq = aa[pp][qq];
+		if (fabs(apq) < 1e-12 * (fabs(aa[pp][pp]) + fabs(aa[qq][qq]) ) + 1e-30)
+		{
+			break;
+		}
+
+		const double theta = (aa[qq][qq] - aa[pp][pp]) / (2.0*apq);
+		const double tt = (theta >= 0.0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta*theta + 1.0) );
+		const double cc = 1.0 / sqrt(tt*tt + 1.0);
+		const double ss = tt*cc;
+
+		for (uint32_t kk = 0; kk < 3; ++kk)
+		{
+			const double akp = aa[kk][pp];
+			const double akq = aa[kk][qq];
+			aa[kk][pp] = cc*akp - ss*akq;
+			aa[kk][qq] = ss*akp + cc*akq;
+		}
+
+		for (uint32_t kk = 0; kk < 3; ++kk)
+		{
+			const double apk = aa[pp][kk];
+			const double aqk = aa[qq][kk];
+			aa[pp][kk] = cc*apk - ss*aqk;
+			aa[qq][kk] = ss*apk + cc*aqk;
+		}
+
+		for (uint32_t kk = 0; kk < 3; ++kk)
+		{
+			const double vkp = vv[kk][pp];
+			const double vkq = vv[kk][qq];
+			vv[kk][pp] = cc*vkp - ss*vkq;
+			vv[kk][qq] = ss*vkp + cc*vkq;
+		}
+	}
+
+	for (uint32_t ii = 0; ii < 3; ++ii)
+	{
+		for (uint32_t jj = 0; jj < 3; ++jj)
+		{
+			_axes[ii][jj] = float(vv[jj][ii]);
+		}
+	}
+}
+
+/// Orientation from principal axes of points.
+static void calcPcaMtx(float* _mtx, const float* _points, uint32_t _numPoints)
+{
+	float mean[3] = { 0.0f, 0.0f, 0.0f };
+	for (uint32_t ii = 0; ii < _numPoints; ++ii)
+	{
+		mean[0] += _points[ii*3+0];
+		mean[1] += _points[ii*3+1];
+		mean[2] += _points[ii*3+2];
+	}
+
+	const float invNum = 1.0f/float(_numPoints);
+	mean[0] *= invNum;
+	mean[1] *= invNum;
+	mean[2] *= invNum;
+
+	float cov[3][3];
+	memset(cov, 0, sizeof(cov) );
+	for (uint32_t ii = 0; ii < _numPoints; ++ii)
+	{
+		float dd[3];
+		vec3Sub(dd, &_points[ii*3], mean);
+		for (uint32_t jj = 0; jj < 3; ++jj)
+		{
+			for (uint32_t kk = 0; kk < 3; ++kk)
+			{
+				cov[jj][kk] += dd[jj]*dd[kk];
+			}
+		}
+	}
+
+	float axes[3][3];
+	calcEigenVectors(axes, cov);
+
+	// Make it right handed.
+	vec3Cross(axes[2], axes[0], axes[1]);
+
+	mtxIdentity(_mtx);
+	memcpy(&_mtx[0], axes[0], 3*sizeof(float) );
+	memcpy(&_mtx[4], axes[1], 3*sizeof(float) );
+	memcpy(&_mtx[8], axes[2], 3*sizeof(float) );
+}
+
+static float calcObbArea(Aabb& _aabb, const float* _mtx, const void* _vertices, uint32_t _numVertices, uint32_t _stride)
+{
+	float mtxT[16];
+	mtxTranspose(mtxT, _mtx);
+	calcAabb(_aabb, mtxT, _vertices, _numVertices, _stride);
+	return calcAreaAabb(_aabb);
+}
+
+#define BOUNDS_NUM_CANDIDATES 4
+
+struct ObbCandidate
+{
+	float m_area;
+	float m_angle[3];
+};
+
+static void insertCandidate(ObbCandidate* _candidates, const ObbCandidate& _candidate)
+{
+	uint32_t ii = BOUNDS_NUM_CANDIDATES;
+	for (; 0 < ii && _candidate.m_area < _candidates[ii-1].m_area; --ii)
+	{
+		if (ii < BOUNDS_NUM_CANDIDATES)
+		{
+			_candidates[ii] = _candidates[ii-1];
+		}
+	}
+
+	if (ii < BOUNDS_NUM_CANDIDATES)
+	{
+		_candidates[ii] = _candidate;
+	}
+}
+
+struct ObbSearchJob
+{
+	const float* m_points;
+	uint32_t m_numPoints;
+	uint32_t m_steps;
+	uint32_t m_begin;
+	uint32_t m_end;
+	ObbCandidate m_best[BOUNDS_NUM_CANDIDATES];
+};
+
+static int32_t obbSearch(void* _userData)
+{
+	ObbSearchJob& job = *(ObbSearchJob*)_userData;
+
+	const float angleStep = float(M_PI_2/job.m_steps);
+	float mtx[16];
+	Aabb aabb;
+
+	for (uint32_t ii = 0; ii < BOUNDS_NUM_CANDIDATES; ++ii)
+	{
+		job.m_best[ii].m_area = FLT_MAX;
+	}
+
+	for (uint32_t ii = job.m_begin; ii < job.m_end; ++ii)
+	{
+		for (uint32_t jj = 0; jj < job.m_steps; ++jj)
+		{
+			for (uint32_t kk = 0; kk < job.m_steps; ++kk)
+			{
+				ObbCandidate candidate;
+				candidate.m_angle[0] = ii*angleStep;
+				candidate.m_angle[1] = jj*angleStep;
+				candidate.m_angle[2] = kk*angleStep;
+
+				mtxRotateXYZ(mtx, candidate.m_angle[0], candidate.m_angle[1], candidate.m_angle[2]);
+				candidate.m_area = calcObbArea(aabb, mtx, job.m_points, job.m_numPoints, 3*sizeof(float) );
+				insertCandidate(job.m_best, candidate);
+			}
+		}
 	}
 
-	_aabb.m_min[0] = min[0];
-	_aabb.m_min[1] = min[1];
-	_aabb.m_min[2] = min[2];
-	_aabb.m_max[0] = max[0];
-	_aabb.m_max[1] = max[1];
-	_aabb.m_max[2] = max[2];
+	return 0;
 }
 
-void calcObb(Obb& _obb, const void* _vertices, uint32_t _numVertices, uint32_t _stride, uint32_t _steps)
+/// Local search around candidate rotation with decreasing step.
+static void refineObb(ObbCandidate& _candidate, const std::vector<float>& _points, float _step)
 {
+	const float* points = &_points[0];
+	const uint32_t numPoints = uint32_t(_points.size()/3);
+
+	float mtx[16];
+	Aabb aabb;
+
+	mtxRotateXYZ(mtx, _candidate.m_angle[0], _candidate.m_angle[1], _candidate.m_angle[2]);
+	_candidate.m_area = calcObbArea(aabb, mtx, points, numPoints, 3*sizeof(float) );
+
+	for (float step = _step; step > 1e-4f; step *= 0.5f)
+	{
+		bool improved = true;
+		while (improved)
+		{
+			improved = false;
+
+			for (uint32_t ii = 0; ii < 27; ++ii)
+			{
+				ObbCandidate test;
+				test.m_angle[0] = _candidate.m_angle[0] + float(int32_t(ii%3)-1)*step;
+				test.m_angle[1] = _candidate.m_angle[1] + float(int32_t(ii/3%3)-1)*step;
+				test.m_angle[2] = _candidate.m_angle[2] + float(int32_t(ii/9)-1)*step;
+
+				mtxRotateXYZ(mtx, test.m_angle[0], test.m_angle[1], test.m_angle[2]);
+				test.m_area = calcObbArea(aabb, mtx, points, numPoints, 3*sizeof(float) );
+				if (test.m_area < _candidate.m_area*0.99999f)
+				{
+					_candidate = test;
+					improved = true;
+				}
+			}
+		}
+	}
+}
+
+/// Add vertices touching faces of box with given orientation.
+static void appendSupportPoints(std::vector<float>& _points, const float* _mtx, const void* _vertices, uint32_t _numVertices, uint32_t _stride)
+{
+	float minDot[3];
+	float maxDot[3];
+	uint32_t minIndex[3] = { 0, 0, 0 };
+	uint32_t maxIndex[3] = { 0, 0, 0 };
+
+	const uint8_t* vertex = (const uint8_t*)_vertices;
+	for (uint32_t jj = 0; jj < 3; ++jj)
+	{
+		minDot[jj] = maxDot[jj] = vec3Dot( (const float*)vertex, &_mtx[jj*4]);
+	}
+
+	for (uint32_t ii = 1; ii < _numVertices; ++ii)
+	{
+		const float* position = (const float*)(vertex + ii*_stride);
+		for (uint32_t jj = 0; jj < 3; ++jj)
+		{
+			const float dot = vec3Dot(position, &_mtx[jj*4]);
+			if (dot < minDot[jj])
+			{
+				minDot[jj] = dot;
+				minIndex[jj] = ii;
+			}
+			else if (dot > maxDot[jj])
+			{
+				maxDot[jj] = dot;
+				maxIndex[jj] = ii;
+			}
+		}
+	}
+
+	for (uint32_t jj = 0; jj < 3; ++jj)
+	{
+		const float* minPos = (const float*)(vertex + minIndex[jj]*_stride);
+		const float* maxPos = (const float*)(vertex + maxIndex[jj]*_stride);
+		_points.insert(_points.end(), minPos, minPos + 3);
+		_points.insert(_points.end(), maxPos, maxPos + 3);
+	}
+}
+
+void calcObb(Obb& _obb, const void* _vertices, uint32_t _numVertices, uint32_t _stride, uint32_t _steps, uint32_t _numThreads)
+{
+	_numThreads = bx::uint32_max(_numThreads, 1);
+
 	Aabb aabb;
 	calcAabb(aabb, _vertices, _numVertices, _stride);
 	float minArea = calcAreaAabb(aabb);
+	aabbToObb(_obb, aabb);
 
-	Obb best;
-	aabbToObb(best, aabb);
+	// Box orientation depends only on convex hull, search is done on
+	// extremal points only, and final box is fitted to all vertices.
+	std::vector<float> points;
+	calcExtremalPoints(points, _vertices, _numVertices, _stride, _numThreads);
+	const uint32_t numPoints = uint32_t(points.size()/3);
 
-	float angleStep = float(M_PI_2/_steps);
-	float ax = 0.0f;
 	float mtx[16];
+	calcPcaMtx(mtx, &points[0], numPoints);
+	float area = calcObbArea(aabb, mtx, _vertices, _numVertices, _stride);
+	if (area < minArea)
+	{
+		minArea = area;
+		aabbTransformToObb(_obb, aabb, mtx);
+	}
 
-	for (uint32_t ii = 0; ii < _steps; ++ii)
+	// Coarse search over rotations.
+	const uint64_t numTests = uint64_t(_steps)*_steps*_steps*numPoints;
+	uint32_t numJobs = bx::uint32_min(_numThreads, uint32_t(numTests/BOUNDS_MIN_TESTS_PER_JOB) );
+	numJobs = bx::uint32_max(bx::uint32_min(numJobs, _steps), 1);
+
+	ObbSearchJob* jobs = new ObbSearchJob[numJobs];
+	for (uint32_t ii = 0; ii < numJobs; ++ii)
 	{
-		float ay = 0.0f;
+		ObbSearchJob& job = jobs[ii];
+		job.m_points = &points[0];
+		job.m_numPoints = numPoints;
+		job.m_steps = _steps;
+		job.m_begin = _steps*ii/numJobs;
+		job.m_end = _steps*(ii+1)/numJobs;
+	}
 
-		for (uint32_t jj = 0; jj < _steps; ++jj)
+	runJobs(obbSearch, jobs, numJobs);
+
+	ObbCandidate best[BOUNDS_NUM_CANDIDATES];
+	memcpy(best, jobs[0].m_best, sizeof(best) );
+	for (uint32_t ii = 1; ii < numJobs; ++ii)
+	{
+		for (uint32_t jj = 0; jj < BOUNDS_NUM_CANDIDATES; ++jj)
+		{
+			insertCandidate(best, jobs[ii].m_best[jj]);
+		}
+	}
+
+	delete [] jobs;
+
+	// Refine few best rotations. When extremal points miss vertex which
+	// defines box in refined orientation, add it and refine again.
+	for (uint32_t ii = 0; ii < BOUNDS_NUM_CANDIDATES && FLT_MAX != best[ii].m_area; ++ii)
+	{
+		ObbCandidate& candidate = best[ii];
+		float step = float(M_PI_4/_steps);
+
+		for (uint32_t iter = 0; iter < 4; ++iter)
 		{
-			float az = 0.0f;
+			refineObb(candidate, points, step);
 
-			for (uint32_t kk = 0; kk < _steps; ++kk)
+			mtxRotateXYZ(mtx, candidate.m_angle[0], candidate.m_angle[1], candidate.m_angle[2]);
+			area = calcObbArea(aabb, mtx, _vertices, _numVertices, _stride);
+			if (area < minArea)
 			{
-				mtxRotateXYZ(mtx, ax, ay, az);
+				minArea = area;
+				aabbTransformToObb(_obb, aabb, mtx);
+			}
 
-				float mtxT[16];
-				mtxTranspose(mtxT, mtx);
-				calcAabb(aabb, mtxT, _vertices, _numVertices, _stride);
+			if (area <= candidate.m_area*1.00001f)
+			{
+				break;
+			}
+
+			appendSupportPoints(points, mtx, _vertices, _numVertices, _stride);
+			step *= 0.25f;
+		}
+	}
 
-				float area = calcAreaAabb(aabb);
+	// Box area on extremal points is lower bound of area on all vertices.
+	// Grid rotations which lower bound is still smaller than best box are
+	// checked on all vertices, so box is never larger than one found by
+	// testing whole grid on all vertices.
+	const float angleStep = float(M_PI_2/_steps);
+	for (uint32_t ii = 0; ii < _steps; ++ii)
+	{
+		for (uint32_t jj = 0; jj < _steps; ++jj)
+		{
+			for (uint32_t kk = 0; kk < _steps; ++kk)
+			{
+				mtxRotateXYZ(mtx, ii*angleStep, jj*angleStep, kk*angleStep);
+				area = calcObbArea(aabb, mtx, &points[0], uint32_t(points.size()/3), 3*sizeof(float) );
 				if (area < minArea)
 				{
-					minArea = area;
-					aabbTransformToObb(best, aabb, mtx);
+					area = calcObbArea(aabb, mtx, _vertices, _numVertices, _stride);
+					if (area < minArea)
+					{
+						minArea = area;
+						aabbTransformToObb(_obb, aabb, mtx);
+					}
+
+					appendSupportPoints(points, mtx, _vertices, _numVertices, _stride);
 				}
-
-				az += angleStep;
 			}
-
-			ay += angleStep;
 		}
-
-		ax += angleStep;
 	}
-
-	memcpy(&_obb, &best, sizeof(Obb) );
 }
 
 void calcMaxBoundingSphere(Sphere& _sphere, const void* _vertices, uint32_t _numVertices, uint32_t _stride)
@@ -185,61 +643,260 @@ void calcMaxBoundingSphere(Sphere& _sphere, const void* _vertices, uint32_t _num
 	_sphere.m_radius = sqrtf(maxDistSq);
 }
 
-void calcMinBoundingSphere(Sphere& _sphere, const void* _vertices, uint32_t _numVertices, uint32_t _stride, float _step)
+struct BoundingSphere
 {
-	bx::RngMwc rng;
+	double m_center[3];
+	double m_radiusSq;
+};
 
-	uint8_t* vertex = (uint8_t*)_vertices;
+inline double dot3(const double* _a, const double* _b)
+{
+	return _a[0]*_b[0] + _a[1]*_b[1] + _a[2]*_b[2];
+}
 
-	float center[3];
-	float* position = (float*)&vertex[0];
-	center[0] = position[0];
-	center[1] = position[1];
-	center[2] = position[2];
+inline void cross3(double* _result, const double* _a, const double* _b)
+{
+	_result[0] = _a[1]*_b[2] - _a[2]*_b[1];
+	_result[1] = _a[2]*_b[0] - _a[0]*_b[2];
+	_result[2] = _a[0]*_b[1] - _a[1]*_b[0];
+}
 
-	position = (float*)&vertex[1*_stride];
-	center[0] += position[0];
-	center[1] += position[1];
-	center[2] += position[2];
+inline void sub3(double* _result, const float* _a, const float* _b)
+{
+	_result[0] = double(_a[0]) - double(_b[0]);
+	_result[1] = double(_a[1]) - double(_b[1]);
+	_result[2] = double(_a[2]) - double(_b[2]);
+}
 
-	center[0] *= 0.5f;
-	center[1] *= 0.5f;
-	center[2] *= 0.5f;
+inline bool isOutside(const BoundingSphere& _sphere, const float* _pos)
+{
+	double dd[3] =
+	{
+		double(_pos[0]) - _sphere.m_center[0],
+		double(_pos[1]) - _sphere.m_center[1],
+		double(_pos[2]) - _sphere.m_center[2],
+	};
+
+	// Relative tolerance, without it points on sphere would keep
+	// restarting inner loops.
+	return dot3(dd, dd) > _sphere.m_radiusSq*(1.0 + 1e-9) + 1e-30;
+}
 
-	float xx = position[0] - center[0];
-	float yy = position[1] - center[1];
-	float zz = position[2] - center[2];
-	float maxDistSq = xx*xx + yy*yy + zz*zz;
+static void sphereFromOffset(BoundingSphere& _sphere, const float* _origin, const double* _offset)
+{
+	_sphere.m_center[0] = double(_origin[0]) + _offset[0];
+	_sphere.m_center[1] = double(_origin[1]) + _offset[1];
+	_sphere.m_center[2] = double(_origin[2]) + _offset[2];
+	_sphere.m_radiusSq = dot3(_offset, _offset);
+}
 
-	float radiusStep = _step * 0.37f;
+static void sphere1(BoundingSphere& _sphere, const float* _a)
+{
+	const double offset[3] = { 0.0, 0.0, 0.0 };
+	sphereFromOffset(_sphere, _a, offset);
+}
+
+static void sphere2(BoundingSphere& _sphere, const float* _a, const float* _b)
+{
+	double ab[3];
+	sub3(ab, _b, _a);
+	const double offset[3] = { ab[0]*0.5, ab[1]*0.5, ab[2]*0.5 };
+	sphereFromOffset(_sphere, _a, offset);
+}
 
-	bool done;
-	do 
+static void sphere3(BoundingSphere& _sphere, const float* _a, const float* _b, const float* _c)
+{
+	double ab[3];
+	double ac[3];
+	double nn[3];
+	sub3(ab, _b, _a);
+	sub3(ac, _c, _a);
+	cross3(nn, ab, ac);
+
+	const double abSq = dot3(ab, ab);
+	const double acSq = dot3(ac, ac);
+	const double nnSq = dot3(nn, nn);
+
+	if (nnSq <= 1e-24*abSq*acSq)
 	{
-		done = true;
-		for (uint32_t ii = 0, index = rng.gen()%_numVertices; ii < _numVertices; ++ii, index = (index + 1)%_numVertices)
+		// Collinear, sphere is spanned by two furthest points.
+		double bc[3];
+		sub3(bc, _c, _b);
+		const double bcSq = dot3(bc, bc);
+		if (abSq >= acSq && abSq >= bcSq)
+		{
+			sphere2(_sphere, _a, _b);
+		}
+		else if (acSq >= bcSq)
+		{
+			sphere2(_sphere, _a, _c);
+		}
+		else
 		{
-			position = (float*)&vertex[index*_stride];
+			sphere2(_sphere, _b, _c);
+		}
+		return;
+	}
+
+	double tmp0[3];
+	double tmp1[3];
+	cross3(tmp0, nn, ab);
+	cross3(tmp1, ac, nn);
 
-			float xx = position[0] - center[0];
-			float yy = position[1] - center[1];
-			float zz = position[2] - center[2];
-			float distSq = xx*xx + yy*yy + zz*zz;
+	const double scale = 0.5/nnSq;
+	const double offset[3] =
+	{
+		(acSq*tmp0[0] + abSq*tmp1[0])*scale,
+		(acSq*tmp0[1] + abSq*tmp1[1])*scale,
+		(acSq*tmp0[2] + abSq*tmp1[2])*scale,
+	};
+	sphereFromOffset(_sphere, _a, offset);
+}
 
-			if (distSq > maxDistSq)
+static void sphere4(BoundingSphere& _sphere, const float* _a, const float* _b, const float* _c, const float* _d)
+{
+	double ab[3];
+	double ac[3];
+	double ad[3];
+	sub3(ab, _b, _a);
+	sub3(ac, _c, _a);
+	sub3(ad, _d, _a);
+
+	double acXad[3];
+	double adXab[3];
+	double abXac[3];
+	cross3(acXad, ac, ad);
+	cross3(adXab, ad, ab);
+	cross3(abXac, ab, ac);
+
+	const double det = dot3(ab, acXad);
+	const double abSq = dot3(ab, ab);
+	const double acSq = dot3(ac, ac);
+	const double adSq = dot3(ad, ad);
+
+	if (fabs(det) <= 1e-12*sqrt(abSq*acSq*adSq) )
+	{
+		// Coplanar, pick smallest circumscribed sphere of three points
+		// which contains fourth point.
+		const float* points[4] = { _a, _b, _c, _d };
+		bool found = false;
+		for (uint32_t ii = 0; ii < 4; ++ii)
+		{
+			BoundingSphere sphere;
+			sphere3(sphere
+				, points[(ii+1)&3]
+				, points[(ii+2)&3]
+				, points[(ii+3)&3]
+				);
+
+			if (!isOutside(sphere, points[ii])
+			&&  (!found || sphere.m_radiusSq < _sphere.m_radiusSq) )
 			{
-				done = false;
+				_sphere = sphere;
+				found = true;
+			}
+		}
 
-				center[0] += xx * radiusStep;
-				center[1] += yy * radiusStep;
-				center[2] += zz * radiusStep;
-				maxDistSq = flerp(maxDistSq, distSq, _step);
+		if (!found)
+		{
+			sphere3(_sphere, _a, _b, _c);
+		}
+		return;
+	}
 
-				break;
+	const double scale = 0.5/det;
+	const double offset[3] =
+	{
+		(abSq*acXad[0] + acSq*adXab[0] + adSq*abXac[0])*scale,
+		(abSq*acXad[1] + acSq*adXab[1] + adSq*abXac[1])*scale,
+		(abSq*acXad[2] + acSq*adXab[2] + adSq*abXac[2])*scale,
+	};
+	sphereFromOffset(_sphere, _a, offset);
+}
+
+void calcMinBoundingSphere(Sphere& _sphere, const void* _vertices, uint32_t _numVertices, uint32_t _stride)
+{
+	// Welzl's algorithm, in iterative form with support points fixed by
+	// nested loops. Expected linear time when points are in random order.
+	// http://www.inf.ethz.ch/personal/emo/PublFiles/SmallEnclDisk_LNCS555_91.pdf
+	bx::RngMwc rng;
+
+	std::vector<float> points(_numVertices*3);
+	const uint8_t* vertex = (const uint8_t*)_vertices;
+	for (uint32_t ii = 0; ii < _numVertices; ++ii)
+	{
+		memcpy(&points[ii*3], vertex + ii*_stride, 3*sizeof(float) );
+	}
+
+	for (uint32_t ii = _numVertices; ii > 1; --ii)
+	{
+		const uint32_t jj = rng.gen()%ii;
+		for (uint32_t kk = 0; kk < 3; ++kk)
+		{
+			std::swap(points[(ii-1)*3+kk], points[jj*3+kk]);
+		}
+	}
+
+	const float* pts = &points[0];
+
+	BoundingSphere sphere;
+	sphere1(sphere, &pts[0]);
+
+	for (uint32_t ii = 1; ii < _numVertices; ++ii)
+	{
+		const float* pi = &pts[ii*3];
+		if (!isOutside(sphere, pi) )
+		{
+			continue;
+		}
+
+		sphere1(sphere, pi);
+		for (uint32_t jj = 0; jj < ii; ++jj)
+		{
+			const float* pj = &pts[jj*3];
+			if (!isOutside(sphere, pj) )
+			{
+				continue;
+			}
+
+			sphere2(sphere, pi, pj);
+			for (uint32_t kk = 0; kk < jj; ++kk)
+			{
+				const float* pk = &pts[kk*3];
+				if (!isOutside(sphere, pk) )
+				{
+					continue;
+				}
+
+				sphere3(sphere, pi, pj, pk);
+				for (uint32_t ll = 0; ll < kk; ++ll)
+				{
+					const float* pl = &pts[ll*3];
+					if (isOutside(sphere, pl) )
+					{
+						sphere4(sphere, pi, pj, pk, pl);
+					}
+				}
 			}
 		}
+	}
+
+	float center[3] =
+	{
+		float(sphere.m_center[0]),
+		float(sphere.m_center[1]),
+		float(sphere.m_center[2]),
+	};
 
-	} while (!done);
+	// Radius is measured again from rounded center, so that sphere is
+	// conservative.
+	float maxDistSq = 0.0f;
+	for (uint32_t ii = 0; ii < _numVertices; ++ii)
+	{
+		float dd[3];
+		vec3Sub(dd, &pts[ii*3], center);
+		maxDistSq = fmax(vec3Dot(dd, dd), maxDistSq);
+	}
 
 	_sphere.m_center[0] = center[0];
 	_sphere.m_center[1] = center[1];
@@ -36,12 +36,20 @@ void calcAabb(Aabb& _aabb, const void* _vertices, uint32_t _numVertices, uint32_
 void calcAabb(Aabb& _aabb, const float* _mtx, const void* _vertices, uint32_t _numVertices, uint32_t _stride);
 
 /// Calculate oriented bounding box.
-void calcObb(Obb& _obb, const void* _vertices, uint32_t _numVertices, uint32_t _stride, uint32_t _steps = 17);
+///
+/// Orientation is searched over _steps^3 rotations on extremal vertices,
+/// refined, and compared against principal axes. Box is fitted to all
+/// vertices, it's never larger than axis aligned bounding box, or than
+/// best box of _steps^3 rotations fitted to all vertices.
+///
+/// @param _numThreads Maximum number of threads used for search.
+///
+void calcObb(Obb& _obb, const void* _vertices, uint32_t _numVertices, uint32_t _stride, uint32_t _steps = 17, uint32_t _numThreads = 1);
 
 /// Calculate maximum bounding sphere.
 void calcMaxBoundingSphere(Sphere& _sphere, const void* _vertices, uint32_t _numVertices, uint32_t _stride);
 
-/// Calculate minimum bounding sphere.
-void calcMinBoundingSphere(Sphere& _sphere, const void* _vertices, uint32_t _numVertices, uint32_t _stride, float _step = 0.01f);
+/// Calculate minimum bounding sphere (Welzl).
+void calcMinBoundingSphere(Sphere& _sphere, const void* _vertices, uint32_t _numVertices, uint32_t _stride);
 
 #endif // BOUNDS_H_HEADER_GUARD
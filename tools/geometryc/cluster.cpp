@@ -0,0 +1,229 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#include <stdint.h>
+#include <float.h>
+#include "cluster.h"
+#include "math.h"
+
+inline const float* getPosition(const void* _vertices, uint32_t _stride, uint32_t _index)
+{
+	return (const float*)( (const uint8_t*)_vertices + _index*_stride);
+}
+
+void buildClusters(ClusterArray& _clusters, uint16_t* _indices, uint32_t _numIndices, const void* _vertices, uint32_t _numVertices, uint32_t _stride, uint32_t _maxTriangles)
+{
+	_clusters.clear();
+
+	const uint32_t numTriangles = _numIndices/3;
+	if (0 == numTriangles)
+	{
+		return;
+	}
+
+	// Vertex to triangle adjacency.
+	std::vector<uint32_t> offsets(_numVertices+1, 0);
+	for (uint32_t ii = 0; ii < _numIndices; ++ii)
+	{
+		++offsets[_indices[ii]+1];
+	}
+
+	for (uint32_t ii = 0; ii < _numVertices; ++ii)
+	{
+		offsets[ii+1] += offsets[ii];
+	}
+
+	std::vector<uint32_t> adjacency(_numIndices);
+	std::vector<uint32_t> fill(offsets.begin(), offsets.end()-1);
+	for (uint32_t ii = 0; ii < _numIndices; ++ii)
+	{
+		adjacency[fill[_indices[ii] ]++] = ii/3;
+	}
+
+	std::vector<float> centroids(numTriangles*3);
+	for (uint32_t ii = 0; ii < numTriangles; ++ii)
+	{
+		const float* v0 = getPosition(_vertices, _stride, _indices[ii*3+0]);
+		const float* v1 = getPosition(_vertices, _stride, _indices[ii*3+1]);
+		const float* v2 = getPosition(_vertices, _stride, _indices[ii*3+2]);
+
+		float* centroid = &centroids[ii*3];
+		centroid[0] = (v0[0] + v1[0] + v2[0]) * (1.0f/3.0f);
+		centroid[1] = (v0[1] + v1[1] + v2[1]) * (1.0f/3.0f);
+		centroid[2] = (v0[2] + v1[2] + v2[2]) * (1.0f/3.0f);
+	}
+
+	// Triangle is candidate of cluster with id stored in stamp.
+	std::vector<uint32_t> stamp(numTriangles, UINT32_MAX);
+	std::vector<uint8_t> emitted(numTriangles, 0);
+	std::vector<uint32_t> candidates;
+	std::vector<uint16_t> result;
+	result.reserve(_numIndices);
+
+	uint32_t seed = 0;
+	uint32_t numEmitted = 0;
+
+	while (numEmitted < numTriangles)
+	{
+		const uint32_t id = uint32_t(_clusters.size() );
+
+		Cluster cluster;
+		cluster.m_startIndex = uint32_t(result.size() );
+
+		float center[3] = { 0.0f, 0.0f, 0.0f };
+		uint32_t num = 0;
+		candidates.clear();
+
+		while (num < _maxTriangles
+		&&     numEmitted < numTriangles)
+		{
+			// Pick candidate closest to cluster center, when cluster can't
+			// grow any more continue from next seed.
+			uint32_t best = UINT32_MAX;
+			float bestDistSq = FLT_MAX;
+			const float invNum = 0 < num ? 1.0f/float(num) : 0.0f;
+
+			for (uint32_t ii = 0; ii < candidates.size();)
+			{
+				const uint32_t tri = candidates[ii];
+				if (emitted[tri])
+				{
+					candidates[ii] = candidates.back();
+					candidates.pop_back();
+					continue;
+				}
+
+				const float* centroid = &centroids[tri*3];
+				const float xx = centroid[0] - center[0]*invNum;
+				const float yy = centroid[1] - center[1]*invNum;
+				const float zz = centroid[2] - center[2]*invNum;
+				const float distSq = xx*xx + yy*yy + zz*zz;
+				if (distSq < bestDistSq)
+				{
+					bestDistSq = distSq;
+					best = tri;
+				}
+
+				++ii;
+			}
+
+			if (UINT32_MAX == best)
+			{
+				while (emitted[seed])
+				{
+					++seed;
+				}
+
+				best = seed;
+			}
+
+			emitted[best] = 1;
+			++numEmitted;
+			++num;
+
+			center[0] += centroids[best*3+0];
+			center[1] += centroids[best*3+1];
+			center[2] += centroids[best*3+2];
+
+			for (uint32_t ii = 0; ii < 3; ++ii)
+			{
+				const uint16_t index = _indices[best*3+ii];
+				result.push_back(index);
+
+				for (uint32_t jj = offsets[index], end = offsets[index+1]; jj < end; ++jj)
+				{
+					const uint32_t tri = adjacency[jj];
+					if (!emitted[tri]
+					&&  id != stamp[tri])
+					{
+						stamp[tri] = id;
+						candidates.push_back(tri);
+					}
+				}
+			}
+		}
+
+		cluster.m_numIndices = uint32_t(result.size() ) - cluster.m_startIndex;
+		_clusters.push_back(cluster);
+	}
+
+	memcpy(_indices, &result[0], _numIndices*sizeof(uint16_t) );
+}
+
+void calcClusterBounds(ClusterBounds& _bounds, const uint16_t* _indices, uint32_t _numIndices, const void* _vertices, uint32_t _stride)
+{
+	std::vector<float> positions(_numIndices*3);
+	for (uint32_t ii = 0; ii < _numIndices; ++ii)
+	{
+		memcpy(&positions[ii*3], getPosition(_vertices, _stride, _indices[ii]), 3*sizeof(float) );
+	}
+
+	calcMinBoundingSphere(_bounds.m_sphere, &positions[0], _numIndices, 3*sizeof(float) );
+	calcAabb(_bounds.m_aabb, &positions[0], _numIndices, 3*sizeof(float) );
+
+	// Normal cone axis is average of triangle normals, and its spread is
+	// given by the normal furthest from axis.
+	// http://www.cs.jhu.edu/~cohen/Publications/cones.pdf
+	const uint32_t numTriangles = _numIndices/3;
+	std::vector<float> normals(numTriangles*3);
+	float axis[3] = { 0.0f, 0.0f, 0.0f };
+	uint32_t numNormals = 0;
+
+	for (uint32_t ii = 0; ii < numTriangles; ++ii)
+	{
+		const float* v0 = &positions[ii*9+0];
+		const float* v1 = &positions[ii*9+3];
+		const float* v2 = &positions[ii*9+6];
+
+		float edge0[3];
+		float edge1[3];
+		float normal[3];
+		vec3Sub(edge0, v1, v0);
+		vec3Sub(edge1, v2, v0);
+		vec3Cross(normal, edge0, edge1);
+
+		const float len = sqrtf(vec3Dot(normal, normal) );
+		if (0.0f == len)
+		{
+			continue;
+		}
+
+		float* dest = &normals[numNormals*3];
+		vec3Mul(dest, normal, 1.0f/len);
+		axis[0] += dest[0];
+		axis[1] += dest[1];
+		axis[2] += dest[2];
+		++numNormals;
+	}
+
+	_bounds.m_coneAxis[0] = 0.0f;
+	_bounds.m_coneAxis[1] = 0.0f;
+	_bounds.m_coneAxis[2] = 0.0f;
+	_bounds.m_coneCutoff = 1.0f;
+
+	const float axisLen = sqrtf(vec3Dot(axis, axis) );
+	if (0 == numNormals
+	||  0.0f == axisLen)
+	{
+		return;
+	}
+
+	vec3Mul(_bounds.m_coneAxis, axis, 1.0f/axisLen);
+
+	float minDot = 1.0f;
+	for (uint32_t ii = 0; ii < numNormals; ++ii)
+	{
+		minDot = fmin(minDot, vec3Dot(&normals[ii*3], _bounds.m_coneAxis) );
+	}
+
+	// Cone wider than ~85 degrees would be culled only from inside of it.
+	if (0.1f < minDot)
+	{
+		// Cone is widened by 90 degrees on each side to get the set of
+		// view directions from which all triangles are back facing,
+		// cos(angle + 90) = -sin(angle).
+		_bounds.m_coneCutoff = sqrtf(1.0f - minDot*minDot);
+	}
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#ifndef CLUSTER_H_HEADER_GUARD
+#define CLUSTER_H_HEADER_GUARD
+
+#include <vector>
+#include "bounds.h"
+
+struct Cluster
+{
+	uint32_t m_startIndex;
+	uint32_t m_numIndices;
+};
+
+typedef std::vector<Cluster> ClusterArray;
+
+struct ClusterBounds
+{
+	Sphere m_sphere;
+	Aabb m_aabb;
+
+	/// Normal cone, cluster is back facing when:
+	/// dot(center - eye, axis) >= cutoff*length(center - eye) + radius
+	/// Cutoff is 1.0 when cone is too wide to ever cull cluster.
+	float m_coneAxis[3];
+	float m_coneCutoff;
+};
+
+/// Reorder triangles into spatially coherent clusters of at most
+/// _maxTriangles triangles. Clusters are grown from seed triangle over
+/// shared vertices, picking triangle closest to cluster center first.
+/// Seeds are taken in input order, so cache optimized input keeps its
+/// locality. Returned ranges are relative to _indices.
+void buildClusters(ClusterArray& _clusters, uint16_t* _indices, uint32_t _numIndices, const void* _vertices, uint32_t _numVertices, uint32_t _stride, uint32_t _maxTriangles);
+
+/// Calculate cluster bounding sphere, box and normal cone. Front faces are
+/// expected to be clockwise in left-handed coordinate system.
+void calcClusterBounds(ClusterBounds& _bounds, const uint16_t* _indices, uint32_t _numIndices, const void* _vertices, uint32_t _stride);
+
+#endif // CLUSTER_H_HEADER_GUARD
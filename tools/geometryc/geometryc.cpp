@@ -13,7 +13,6 @@
 #include <algorithm>
 #include <vector>
 #include <string>
-#include <unordered_map>
 
 #include <forsythtriangleorderoptimizer.h>
 
@@ -58,46 +57,16 @@
 #include <bx/hash.h>
 #include <bx/uint32_t.h>
 
-#include "tokenizecmd.h"
+#include "objparser.h"
+#include "adjacency.h"
 #include "bounds.h"
+#include "cluster.h"
+#include "jobs.h"
+#include "optimize.h"
+#include "simplify.h"
+#include "meshencoder.h"
 #include "math.h"
 
-struct Vector3
-{
-	float x;
-	float y;
-	float z;
-};
-
-typedef std::vector<Vector3> Vector3Array;
-
-struct Index3
-{
-	int32_t m_position;
-	int32_t m_texcoord;
-	int32_t m_normal;
-	int32_t m_vertexIndex;
-};
-
-typedef std::unordered_map<uint64_t, Index3> Index3Map;
-
-struct Triangle
-{
-	uint64_t m_index[3];
-};
-
-typedef std::vector<Triangle> TriangleArray;
-
-struct Group
-{
-	uint32_t m_startTriangle;
-	uint32_t m_numTriangles;
-	std::string m_name;
-	std::string m_material;
-};
-
-typedef std::vector<Group> GroupArray;
-
 struct Primitive
 {
 	uint32_t m_startVertex;
@@ -105,25 +74,31 @@ struct Primitive
 	uint32_t m_numVertices;
 	uint32_t m_numIndices;
 	std::string m_name;
+	ClusterArray m_clusters;
 };
 
 typedef std::vector<Primitive> PrimitiveArray;
 
 static uint32_t s_obbSteps = 17;
+static uint32_t s_numThreads = 1;
+static uint32_t s_numLods = 0;
+static float s_lodRatio = 0.5f;
+static float s_lodError = 0.05f;
+static bool s_compress = false;
+static bool s_shadow = false;
+static bool s_adjacency = false;
+static uint32_t s_clusterSize = 0;
 
 #define BGFX_CHUNK_MAGIC_GEO BX_MAKEFOURCC('G', 'E', 'O', 0x0)
 #define BGFX_CHUNK_MAGIC_VB BX_MAKEFOURCC('V', 'B', ' ', 0x0)
 #define BGFX_CHUNK_MAGIC_IB BX_MAKEFOURCC('I', 'B', ' ', 0x0)
 #define BGFX_CHUNK_MAGIC_PRI BX_MAKEFOURCC('P', 'R', 'I', 0x0)
-
-long int fsize(FILE* _file)
-{
-	long int pos = ftell(_file);
-	fseek(_file, 0L, SEEK_END);
-	long int size = ftell(_file);
-	fseek(_file, pos, SEEK_SET);
-	return size;
-}
+#define BGFX_CHUNK_MAGIC_LOD BX_MAKEFOURCC('L', 'O', 'D', 0x0)
+#define BGFX_CHUNK_MAGIC_VBC BX_MAKEFOURCC('V', 'B', 'C', 0x0)
+#define BGFX_CHUNK_MAGIC_IBC BX_MAKEFOURCC('I', 'B', 'C', 0x0)
+#define BGFX_CHUNK_MAGIC_SHD BX_MAKEFOURCC('S', 'H', 'D', 0x0)
+#define BGFX_CHUNK_MAGIC_CLS BX_MAKEFOURCC('C', 'L', 'S', 0x0)
+#define BGFX_CHUNK_MAGIC_ADJ BX_MAKEFOURCC('A', 'D', 'J', 0x0)
 
 void triangleReorder(uint16_t* _indices, uint32_t _numIndices, uint32_t _numVertices, uint16_t _cacheSize)
 {
@@ -133,6 +108,84 @@ void triangleReorder(uint16_t* _indices, uint32_t _numIndices, uint32_t _numVert
 	delete [] newIndexList;
 }
 
+void optimize(uint8_t* _vertices, uint32_t _numVertices, uint32_t _stride, uint16_t* _indices, uint32_t _numIndices, PrimitiveArray& _primitives, float _overdrawThreshold, bool _vertexFetch, bool _stats)
+{
+	struct Stats
+	{
+		void calc(const uint8_t* _vertices, uint32_t _numVertices, uint32_t _stride, const uint16_t* _indices, uint32_t _numIndices)
+		{
+			calcVertexCacheStats(m_acmr, m_atvr, _indices, _numIndices, _numVertices);
+			m_overdraw = calcOverdraw(_indices, _numIndices, _vertices, _numVertices, _stride);
+			m_overfetch = calcOverfetch(_indices, _numIndices, _numVertices, _stride);
+		}
+
+		float m_acmr;
+		float m_atvr;
+		float m_overdraw;
+		float m_overfetch;
+	};
+
+	std::vector<Stats> before;
+
+	if (_stats)
+	{
+		before.resize(_primitives.size() );
+		for (uint32_t ii = 0, num = uint32_t(_primitives.size() ); ii < num; ++ii)
+		{
+			const Primitive& prim = _primitives[ii];
+			before[ii].calc(_vertices, _numVertices, _stride, _indices + prim.m_startIndex, prim.m_numIndices);
+		}
+	}
+
+	for (PrimitiveArray::iterator primIt = _primitives.begin(); primIt != _primitives.end(); ++primIt)
+	{
+		Primitive& prim = *primIt;
+		triangleReorder(_indices + prim.m_startIndex, prim.m_numIndices, _numVertices, 32);
+
+		if (0 < s_clusterSize)
+		{
+			// Clusters are culled separately, their order is determined at
+			// runtime, overdraw reorder is not applied.
+			buildClusters(prim.m_clusters, _indices + prim.m_startIndex, prim.m_numIndices, _vertices, _numVertices, _stride, s_clusterSize);
+
+			for (ClusterArray::iterator it = prim.m_clusters.begin(), itEnd = prim.m_clusters.end(); it != itEnd; ++it)
+			{
+				it->m_startIndex += prim.m_startIndex;
+				triangleReorder(_indices + it->m_startIndex, it->m_numIndices, _numVertices, 32);
+			}
+		}
+		else if (0.0f < _overdrawThreshold)
+		{
+			overdrawReorder(_indices + prim.m_startIndex, prim.m_numIndices, _vertices, _numVertices, _stride, 32, _overdrawThreshold);
+		}
+	}
+
+	if (_vertexFetch)
+	{
+		// Vertices are first referenced by the primitive that created them,
+		// primitive vertex ranges stay the same.
+		vertexFetchReorder(_vertices, _indices, _numIndices, _numVertices, _stride);
+	}
+
+	if (_stats)
+	{
+		for (uint32_t ii = 0, num = uint32_t(_primitives.size() ); ii < num; ++ii)
+		{
+			const Primitive& prim = _primitives[ii];
+			Stats after;
+			after.calc(_vertices, _numVertices, _stride, _indices + prim.m_startIndex, prim.m_numIndices);
+
+			printf("%s: acmr %.3f -> %.3f, atvr %.3f -> %.3f, overdraw %.3f -> %.3f, overfetch %.3f -> %.3f\n"
+				, prim.m_name.c_str()
+				, before[ii].m_acmr,      after.m_acmr
+				, before[ii].m_atvr,      after.m_atvr
+				, before[ii].m_overdraw,  after.m_overdraw
+				, before[ii].m_overfetch, after.m_overfetch
+				);
+		}
+	}
+}
+
 void calcTangents(void* _vertices, uint16_t _numVertices, bgfx::VertexDecl _decl, const uint16_t* _indices, uint32_t _numIndices)
 {
 	struct PosTexcoord
@@ -256,23 +309,168 @@ void writeBounds(bx::WriterI* _writer, const void* _vertices, uint32_t _numVerti
 	bx::write(_writer, aabb);
 
 	Obb obb;
-	calcObb(obb, _vertices, _numVertices, _stride, s_obbSteps);
+	calcObb(obb, _vertices, _numVertices, _stride, s_obbSteps, s_numThreads);
 	bx::write(_writer, obb);
 }
 
-void write(bx::WriterI* _writer, const uint8_t* _vertices, uint32_t _numVertices, const bgfx::VertexDecl& _decl, const uint16_t* _indices, uint32_t _numIndices, const std::string& _material, const PrimitiveArray& _primitives)
+void writeVertexBuffer(bx::WriterI* _writer, const uint8_t* _vertices, uint32_t _numVertices, const bgfx::VertexDecl& _decl)
 {
 	uint32_t stride = _decl.getStride();
-	bx::write(_writer, BGFX_CHUNK_MAGIC_VB);
+	bx::write(_writer, s_compress ? BGFX_CHUNK_MAGIC_VBC : BGFX_CHUNK_MAGIC_VB);
 	writeBounds(_writer, _vertices, _numVertices, stride);
 
 	bx::write(_writer, _decl);
 	bx::write(_writer, uint16_t(_numVertices) );
-	bx::write(_writer, _vertices, _numVertices*stride);
 
-	bx::write(_writer, BGFX_CHUNK_MAGIC_IB);
+	if (s_compress)
+	{
+		encodeVertices(_writer, _vertices, _numVertices, _decl);
+	}
+	else
+	{
+		bx::write(_writer, _vertices, _numVertices*stride);
+	}
+}
+
+void writeIndexBuffer(bx::WriterI* _writer, const uint16_t* _indices, uint32_t _numIndices)
+{
+	bx::write(_writer, s_compress ? BGFX_CHUNK_MAGIC_IBC : BGFX_CHUNK_MAGIC_IB);
 	bx::write(_writer, _numIndices);
-	bx::write(_writer, _indices, _numIndices*2);
+
+	if (s_compress)
+	{
+		encodeIndices(_writer, _indices, _numIndices);
+	}
+	else
+	{
+		bx::write(_writer, _indices, _numIndices*2);
+	}
+}
+
+void writeShadow(bx::WriterI* _writer, const uint8_t* _vertices, uint32_t _numVertices, const bgfx::VertexDecl& _decl, const uint16_t* _indices, uint32_t _numIndices)
+{
+	// Vertices split only by UV or normal seams have the same position,
+	// weld them and keep triangle order, so that primitive index ranges
+	// are the same for both index buffers.
+	uint32_t* weld = new uint32_t[_numVertices];
+	bgfx::weldVertices(weld, _decl, _vertices, _numVertices, 0.0f);
+
+	uint32_t* remap = new uint32_t[_numVertices];
+	memset(remap, 0xff, _numVertices*sizeof(uint32_t) );
+
+	bgfx::VertexDecl decl;
+	decl.begin();
+	decl.add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float);
+	decl.end();
+
+	float* positions = new float[_numVertices*3];
+	uint16_t* indices = new uint16_t[_numIndices];
+	uint32_t numVertices = 0;
+
+	for (uint32_t ii = 0; ii < _numIndices; ++ii)
+	{
+		const uint32_t index = weld[_indices[ii] ];
+		if (UINT32_MAX == remap[index])
+		{
+			remap[index] = numVertices;
+
+			float pos[4];
+			bgfx::vertexUnpack(pos, bgfx::Attrib::Position, _decl, _vertices, index);
+			memcpy(&positions[numVertices*3], pos, 3*sizeof(float) );
+			++numVertices;
+		}
+
+		indices[ii] = uint16_t(remap[index]);
+	}
+
+	// SHD chunk marks following VB and IB chunks as depth only variant of
+	// the group.
+	bx::write(_writer, BGFX_CHUNK_MAGIC_SHD);
+	writeVertexBuffer(_writer, (const uint8_t*)positions, numVertices, decl);
+	writeIndexBuffer(_writer, indices, _numIndices);
+
+	delete [] indices;
+	delete [] positions;
+	delete [] remap;
+	delete [] weld;
+}
+
+void writeAdjacency(bx::WriterI* _writer, const uint8_t* _vertices, uint32_t _numVertices, const bgfx::VertexDecl& _decl, const uint16_t* _indices, uint32_t _numIndices)
+{
+	// Same weld tolerance as svMeshBuild in examples/common/shadowvolume.cpp.
+	uint32_t* weld = new uint32_t[_numVertices];
+	bgfx::weldVertices(weld, _decl, _vertices, _numVertices, 0.0001f);
+
+	AdjacencyEdgeArray edges;
+	buildAdjacency(edges, _indices, _numIndices, weld);
+
+	// ADJ chunk follows IB chunk, edge vertex pairs are followed by edge
+	// face pairs, UINT32_MAX marks open edge.
+	bx::write(_writer, BGFX_CHUNK_MAGIC_ADJ);
+	bx::write(_writer, uint32_t(edges.size() ) );
+	for (AdjacencyEdgeArray::const_iterator it = edges.begin(), itEnd = edges.end(); it != itEnd; ++it)
+	{
+		bx::write(_writer, it->m_i0);
+		bx::write(_writer, it->m_i1);
+	}
+
+	for (AdjacencyEdgeArray::const_iterator it = edges.begin(), itEnd = edges.end(); it != itEnd; ++it)
+	{
+		bx::write(_writer, it->m_face[0]);
+		bx::write(_writer, it->m_face[1]);
+	}
+
+	delete [] weld;
+}
+
+void writeClusters(bx::WriterI* _writer, const uint8_t* _vertices, uint32_t _stride, const uint16_t* _indices, const PrimitiveArray& _primitives)
+{
+	// CLS chunk follows PRI chunk, with clusters for each primitive.
+	bx::write(_writer, BGFX_CHUNK_MAGIC_CLS);
+	bx::write(_writer, uint16_t(_primitives.size() ) );
+	for (PrimitiveArray::const_iterator primIt = _primitives.begin(); primIt != _primitives.end(); ++primIt)
+	{
+		const Primitive& prim = *primIt;
+		bx::write(_writer, uint32_t(prim.m_clusters.size() ) );
+
+		for (ClusterArray::const_iterator it = prim.m_clusters.begin(), itEnd = prim.m_clusters.end(); it != itEnd; ++it)
+		{
+			ClusterBounds bounds;
+			calcClusterBounds(bounds, &_indices[it->m_startIndex], it->m_numIndices, _vertices, _stride);
+
+			bx::write(_writer, it->m_startIndex);
+			bx::write(_writer, it->m_numIndices);
+			bx::write(_writer, bounds.m_sphere);
+			bx::write(_writer, bounds.m_aabb);
+			bx::write(_writer, bounds.m_coneAxis, sizeof(bounds.m_coneAxis) );
+			bx::write(_writer, bounds.m_coneCutoff);
+		}
+	}
+}
+
+void write(bx::WriterI* _writer, const uint8_t* _vertices, uint32_t _numVertices, const bgfx::VertexDecl& _decl, const uint16_t* _indices, uint32_t _numIndices, const std::string& _material, const PrimitiveArray& _primitives, uint16_t _lod = 0, float _error = 0.0f)
+{
+	if (0 < s_numLods)
+	{
+		// LOD chunk applies to all following VB, IB and PRI chunks.
+		bx::write(_writer, BGFX_CHUNK_MAGIC_LOD);
+		bx::write(_writer, _lod);
+		bx::write(_writer, _error);
+	}
+
+	uint32_t stride = _decl.getStride();
+	writeVertexBuffer(_writer, _vertices, _numVertices, _decl);
+	writeIndexBuffer(_writer, _indices, _numIndices);
+
+	if (s_adjacency)
+	{
+		writeAdjacency(_writer, _vertices, _numVertices, _decl, _indices, _numIndices);
+	}
+
+	if (s_shadow)
+	{
+		writeShadow(_writer, _vertices, _numVertices, _decl, _indices, _numIndices);
+	}
 
 	bx::write(_writer, BGFX_CHUNK_MAGIC_PRI);
 	uint16_t nameLen = uint16_t(_material.size() );
@@ -291,6 +489,127 @@ void write(bx::WriterI* _writer, const uint8_t* _vertices, uint32_t _numVertices
 		bx::write(_writer, prim.m_numVertices);
 		writeBounds(_writer, &_vertices[prim.m_startVertex*stride], prim.m_numVertices, stride);
 	}
+
+	if (0 < s_clusterSize)
+	{
+		writeClusters(_writer, _vertices, stride, _indices, _primitives);
+	}
+}
+
+void writeLods(bx::WriterI* _writer, const uint8_t* _vertices, uint32_t _numVertices, const bgfx::VertexDecl& _decl, const uint16_t* _indices, uint32_t _numIndices, const std::string& _material, const PrimitiveArray& _primitives)
+{
+	if (0 == s_numLods)
+	{
+		return;
+	}
+
+	const uint32_t stride = _decl.getStride();
+
+	Aabb aabb;
+	calcAabb(aabb, _vertices, _numVertices, stride);
+
+	float diagonal[3];
+	vec3Sub(diagonal, aabb.m_max, aabb.m_min);
+	const float maxError = s_lodError*sqrtf(vec3Dot(diagonal, diagonal) );
+
+	uint16_t* indices = new uint16_t[_numIndices];
+	memcpy(indices, _indices, _numIndices*sizeof(uint16_t) );
+	PrimitiveArray primitives = _primitives;
+
+	uint16_t* lodIndices = new uint16_t[_numIndices];
+	uint8_t* lodVertices = new uint8_t[_numVertices*stride];
+	uint32_t* remap = new uint32_t[_numVertices];
+
+	// Quadrics are kept between LODs, so that error of each LOD is
+	// measured against original mesh, not against previous LOD.
+	float* quadrics = new float[_numVertices*SIMPLIFY_QUADRIC_NUM_FLOATS];
+	simplifyQuadrics(quadrics, _indices, _numIndices, _vertices, _numVertices, stride);
+
+	float ratio = 1.0f;
+	float error = 0.0f;
+	uint32_t numIndices = _numIndices;
+
+	for (uint16_t lod = 1; lod <= s_numLods; ++lod)
+	{
+		ratio *= s_lodRatio;
+
+		// Each LOD is simplified from previous one, primitives are
+		// simplified separately and packed one after another. Error never
+		// decreases between LODs.
+		uint32_t numLodIndices = 0;
+
+		for (uint32_t ii = 0, num = uint32_t(primitives.size() ); ii < num; ++ii)
+		{
+			Primitive& prim = primitives[ii];
+
+			// Simplification doesn't keep cluster ranges.
+			prim.m_clusters.clear();
+			const uint32_t target = uint32_t(_primitives[ii].m_numIndices*ratio)/3*3;
+
+			float primError;
+			uint32_t primNumIndices = simplify(&indices[prim.m_startIndex]
+				, prim.m_numIndices
+				, _vertices
+				, _numVertices
+				, stride
+				, quadrics
+				, target
+				, maxError
+				, primError
+				);
+
+			memmove(&indices[numLodIndices], &indices[prim.m_startIndex], primNumIndices*sizeof(uint16_t) );
+			prim.m_startIndex = numLodIndices;
+			prim.m_numIndices = primNumIndices;
+			numLodIndices += primNumIndices;
+			error = fmax(error, primError);
+		}
+
+		if (numLodIndices == numIndices)
+		{
+			// Error limit reached, no more LODs.
+			break;
+		}
+
+		numIndices = numLodIndices;
+
+		// Drop unreferenced vertices, primitive vertex range is range of
+		// vertices first referenced by primitive.
+		memset(remap, 0xff, _numVertices*sizeof(uint32_t) );
+		uint32_t numLodVertices = 0;
+
+		PrimitiveArray lodPrimitives = primitives;
+		for (PrimitiveArray::iterator primIt = lodPrimitives.begin(); primIt != lodPrimitives.end(); ++primIt)
+		{
+			Primitive& prim = *primIt;
+			prim.m_startVertex = numLodVertices;
+
+			for (uint32_t ii = prim.m_startIndex, end = ii + prim.m_numIndices; ii < end; ++ii)
+			{
+				const uint16_t index = indices[ii];
+				if (UINT32_MAX == remap[index])
+				{
+					remap[index] = numLodVertices;
+					memcpy(&lodVertices[numLodVertices*stride], &_vertices[index*stride], stride);
+					++numLodVertices;
+				}
+
+				lodIndices[ii] = uint16_t(remap[index]);
+			}
+
+			prim.m_numVertices = numLodVertices - prim.m_startVertex;
+		}
+
+		write(_writer, lodVertices, numLodVertices, _decl, lodIndices, numIndices, _material, lodPrimitives, lod, error);
+
+		printf("lod %d: v %d, i %d, error %f\n", lod, numLodVertices, numIndices, error);
+	}
+
+	delete [] quadrics;
+	delete [] remap;
+	delete [] lodVertices;
+	delete [] lodIndices;
+	delete [] indices;
 }
 
 void help(const char* _error = NULL)
@@ -330,7 +649,24 @@ void help(const char* _error = NULL)
 		  "           0 - unpacked 8 bytes (default).\n"
 		  "           1 - packed 4 bytes.\n"
 		  "      --tangent            Calculate tangent vectors (packing mode is the same as normal).\n"
-
+		  "      --overdraw <num>     Reorder triangle clusters to reduce overdraw.\n"
+		  "           Clusters are split while ACMR stays within <num> times\n"
+		  "           of vertex cache optimized ACMR (f.e. 1.05). Disabled by default.\n"
+		  "      --vertexfetch        Reorder vertices in order of use for vertex fetch locality.\n"
+		  "      --stats              Print ACMR, ATVR, overdraw and overfetch per primitive.\n"
+		  "      --lod <num>          Number of LODs to generate with quadric error edge collapse.\n"
+		  "           LODs are written into output file after LOD chunk. Default 0.\n"
+		  "      --lodratio <num>     Triangle ratio between consecutive LODs. Default 0.5.\n"
+		  "      --loderror <num>     Maximal LOD error relative to bounding box diagonal.\n"
+		  "           LOD generation stops once it can't be simplified further.\n"
+		  "           Default 0.05.\n"
+		  "      --shadow             Write position only vertex and index buffers for depth passes.\n"
+		  "      --adjacency          Write edge adjacency for shadow volume silhouette extraction.\n"
+		  "      --cluster <num>      Split primitives into clusters of at most <num> triangles, with\n"
+		  "           bounds and normal cone for culling. Overdraw reorder is skipped.\n"
+		  "      --compress           Compress vertex and index buffers (VBC and IBC chunks).\n"
+		  "      --threads <num>      Number of threads for parsing and processing.\n"
+		  "           Default is number of logical processors.\n"
 		  "\n"
 		  "For additional information, see https://github.com/bkaradzic/bgfx\n"
 		);
@@ -391,253 +727,69 @@ int main(int _argc, const char* _argv[])
 	bool flipV = cmdLine.hasArg("flipv");
 	bool hasTangent = cmdLine.hasArg("tangent");
 
-	FILE* file = fopen(filePath, "r");
-	if (NULL == file)
+	float overdrawThreshold = 0.0f;
+	const char* overdrawArg = cmdLine.findOption('\0', "overdraw");
+	if (NULL != overdrawArg)
 	{
-		printf("Unable to open input file '%s'.", filePath);
-		exit(EXIT_FAILURE);
+		overdrawThreshold = (float)atof(overdrawArg);
 	}
 
-	int64_t parseElapsed = -bx::getHPCounter();
-	int64_t triReorderElapsed = 0;
-
-	uint32_t size = (uint32_t)fsize(file);
-	char* data = new char[size+1];
-	size = (uint32_t)fread(data, 1, size, file);
-	data[size] = '\0';
-	fclose(file);
+	bool vertexFetch = cmdLine.hasArg("vertexfetch");
+	bool stats = cmdLine.hasArg("stats");
 
-	// https://en.wikipedia.org/wiki/Wavefront_.obj_file
+	cmdLine.hasArg(s_numLods, '\0', "lod");
+	s_numLods = bx::uint32_min(s_numLods, 16);
 
-	Vector3Array positions;
-	Vector3Array normals;
-	Vector3Array texcoords;
-	Index3Map indexMap;
-	TriangleArray triangles;
-	GroupArray groups;
-
-	uint32_t num = 0;
-
-	Group group;
-	group.m_startTriangle = 0;
-	group.m_numTriangles = 0;
-
-	char commandLine[2048];
-	uint32_t len = sizeof(commandLine);
-	int argc;
-	char* argv[64];
-	const char* next = data;
-	do
+	const char* lodRatioArg = cmdLine.findOption('\0', "lodratio");
+	if (NULL != lodRatioArg)
 	{
-		next = tokenizeCommandLine(next, commandLine, len, argc, argv, BX_COUNTOF(argv), '\n');
-		if (0 < argc)
-		{
-			if (0 == strcmp(argv[0], "#") )
-			{
-				if (2 < argc
-				&&  0 == strcmp(argv[2], "polygons") )
-				{
-				}
-			}
-			else if (0 == strcmp(argv[0], "f") )
-			{
-				Triangle triangle;
-				memset(&triangle, 0, sizeof(Triangle) );
-
-				for (uint32_t edge = 0, numEdges = argc-1; edge < numEdges; ++edge)
-				{
-					Index3 index;
-					index.m_texcoord = -1;
-					index.m_normal = -1;
-					index.m_vertexIndex = -1;
-
-					char* vertex = argv[edge+1];
-					char* texcoord = strchr(vertex, '/');
-					if (NULL != texcoord)
-					{
-						*texcoord++ = '\0';
-
-						char* normal = strchr(texcoord, '/');
-						if (NULL != normal)
-						{
-							*normal++ = '\0';
-							index.m_normal = atoi(normal)-1;
-						}
-
-						index.m_texcoord = atoi(texcoord)-1;
-					}
-
-					index.m_position = atoi(vertex)-1;
-
-					uint64_t hash0 = index.m_position;
-					uint64_t hash1 = uint64_t(index.m_texcoord)<<20;
-					uint64_t hash2 = uint64_t(index.m_normal)<<40;
-					uint64_t hash = hash0^hash1^hash2;
-
-					std::pair<Index3Map::iterator, bool> result = indexMap.insert(std::make_pair(hash, index) );
-					if (!result.second)
-					{
-						Index3& oldIndex = result.first->second;
-						BX_UNUSED(oldIndex);
-						BX_CHECK(oldIndex.m_position == index.m_position
-							&& oldIndex.m_texcoord == index.m_texcoord
-							&& oldIndex.m_normal == index.m_normal
-							, "Hash collision!"
-							);
-					}
-
-					switch (edge)
-					{
-					case 0:
-					case 1:
-					case 2:
-						triangle.m_index[edge] = hash;
-						if (2 == edge)
-						{
-							if (ccw)
-							{
-								std::swap(triangle.m_index[1], triangle.m_index[2]);
-							}
-							triangles.push_back(triangle);
-						}
-						break;
-
-					default:
-						if (ccw)
-						{
-							triangle.m_index[2] = triangle.m_index[1];
-							triangle.m_index[1] = hash;
-						}
-						else
-						{
-							triangle.m_index[1] = triangle.m_index[2];
-							triangle.m_index[2] = hash;
-						}
-						triangles.push_back(triangle);
-						break;
-					}
-				}
-			}
-			else if (0 == strcmp(argv[0], "g") )
-			{
-				EXPECT(1 < argc);
-				group.m_name = argv[1];
-			}
-			else if (*argv[0] == 'v')
-			{
-				group.m_numTriangles = (uint32_t)(triangles.size() ) - group.m_startTriangle;
-				if (0 < group.m_numTriangles)
-				{
-					groups.push_back(group);
-					group.m_startTriangle = (uint32_t)(triangles.size() );
-					group.m_numTriangles = 0;
-				}
-
-				if (0 == strcmp(argv[0], "vn") )
-				{
-					Vector3 normal;
-					normal.x = (float)atof(argv[1]);
-					normal.y = (float)atof(argv[2]);
-					normal.z = (float)atof(argv[3]);
-
-					normals.push_back(normal);
-				}
-				else if (0 == strcmp(argv[0], "vp") )
-				{
-					static bool once = true;
-					if (once)
-					{
-						once = false;
-						printf("warning: 'parameter space vertices' are unsupported.\n");
-					}
-				}
-				else if (0 == strcmp(argv[0], "vt") )
-				{
-					Vector3 texcoord;
-					texcoord.x = (float)atof(argv[1]);
-					texcoord.y = 0.0f;
-					texcoord.z = 0.0f;
-					switch (argc)
-					{
-					case 4:
-						texcoord.z = (float)atof(argv[3]);
-						// fallthrough
-					case 3:
-						texcoord.y = (float)atof(argv[2]);
-						break;
-
-					default:
-						break;
-					}
-
-					texcoords.push_back(texcoord);
-				}
-				else
-				{
-					float px = (float)atof(argv[1]);
-					float py = (float)atof(argv[2]);
-					float pz = (float)atof(argv[3]);
-					float pw = 1.0f;
-					if (argc > 4)
-					{
-						pw = (float)atof(argv[4]);
-					}
+		s_lodRatio = (float)atof(lodRatioArg);
+	}
 
-					float invW = scale/pw;
-					px *= invW;
-					py *= invW;
-					pz *= invW;
+	const char* lodErrorArg = cmdLine.findOption('\0', "loderror");
+	if (NULL != lodErrorArg)
+	{
+		s_lodError = (float)atof(lodErrorArg);
+	}
 
-					Vector3 pos;
-					pos.x = px;
-					pos.y = py;
-					pos.z = pz;
+	uint32_t numThreads = 0;
+	cmdLine.hasArg(numThreads, '\0', "threads");
+	s_numThreads = 0 == numThreads ? getNumCpus() : numThreads;
 
-					positions.push_back(pos);
-				}
-			}
-			else if (0 == strcmp(argv[0], "usemtl") )
-			{
-				std::string material(argv[1]);
+	s_compress = cmdLine.hasArg("compress");
+	s_shadow = cmdLine.hasArg("shadow");
+	s_adjacency = cmdLine.hasArg("adjacency");
 
-				if (material != group.m_material)
-				{
-					group.m_numTriangles = (uint32_t)(triangles.size() ) - group.m_startTriangle;
-					if (0 < group.m_numTriangles)
-					{
-						groups.push_back(group);
-						group.m_startTriangle = (uint32_t)(triangles.size() );
-						group.m_numTriangles = 0;
-					}
-				}
+	cmdLine.hasArg(s_clusterSize, '\0', "cluster");
+	if (0 < s_clusterSize)
+	{
+		s_clusterSize = bx::uint32_min(bx::uint32_max(s_clusterSize, 16), 1024);
+	}
 
-				group.m_material = material;
-			}
-// unsupported tags
-// 				else if (0 == strcmp(argv[0], "mtllib") )
-// 				{
-// 				}
-// 				else if (0 == strcmp(argv[0], "o") )
-// 				{
-// 				}
-// 				else if (0 == strcmp(argv[0], "s") )
-// 				{
-// 				}
-		}
+	int64_t parseElapsed = -bx::getHPCounter();
+	int64_t triReorderElapsed = 0;
+	int64_t lodElapsed = 0;
 
-		++num;
+	ObjData obj;
+	if (!parseObj(obj, filePath, scale, ccw, numThreads) )
+	{
+		printf("Unable to open input file '%s'.", filePath);
+		exit(EXIT_FAILURE);
 	}
-	while ('\0' != *next);
 
-	group.m_numTriangles = (uint32_t)(triangles.size() ) - group.m_startTriangle;
-	if (0 < group.m_numTriangles)
+	if (obj.m_triangles.empty() )
 	{
-		groups.push_back(group);
-		group.m_startTriangle = (uint32_t)(triangles.size() );
-		group.m_numTriangles = 0;
+		printf("Input file '%s' has no faces.", filePath);
+		exit(EXIT_FAILURE);
 	}
 
-	delete [] data;
+	const Vector3Array& positions = obj.m_positions;
+	const Vector3Array& normals = obj.m_normals;
+	const Vector3Array& texcoords = obj.m_texcoords;
+	Index3Array& indexArray = obj.m_indices;
+	const TriangleArray& triangles = obj.m_triangles;
+	GroupArray& groups = obj.m_groups;
+	uint32_t num = obj.m_numLines;
 
 	int64_t now = bx::getHPCounter();
 	parseElapsed += now;
@@ -649,18 +801,23 @@ int main(int _argc, const char* _argv[])
 	bool hasNormal;
 	bool hasTexcoord;
 	{
-		Index3Map::const_iterator it = indexMap.begin();
-		hasNormal = -1 != it->second.m_normal;
-		hasTexcoord = -1 != it->second.m_texcoord;
+		// Any face carrying attribute enables it.
+		hasNormal = false;
+		hasTexcoord = false;
+		for (Index3Array::const_iterator it = indexArray.begin(), itEnd = indexArray.end(); it != itEnd; ++it)
+		{
+			hasNormal |= -1 != it->m_normal;
+			hasTexcoord |= -1 != it->m_texcoord;
+		}
 
 		if (!hasTexcoord
 		&&  texcoords.size() == positions.size() )
 		{
 			hasTexcoord = true;
 
-			for (Index3Map::iterator it = indexMap.begin(), itEnd = indexMap.end(); it != itEnd; ++it)
+			for (Index3Array::iterator it = indexArray.begin(), itEnd = indexArray.end(); it != itEnd; ++it)
 			{
-				it->second.m_texcoord = it->second.m_position;
+				it->m_texcoord = it->m_position;
 			}
 		}
 
@@ -669,9 +826,9 @@ int main(int _argc, const char* _argv[])
 		{
 			hasNormal = true;
 
-			for (Index3Map::iterator it = indexMap.begin(), itEnd = indexMap.end(); it != itEnd; ++it)
+			for (Index3Array::iterator it = indexArray.begin(), itEnd = indexArray.end(); it != itEnd; ++it)
 			{
-				it->second.m_normal = it->second.m_position;
+				it->m_normal = it->m_position;
 			}
 		}
 	}
@@ -770,11 +927,7 @@ int main(int _argc, const char* _argv[])
 				}
 
 				triReorderElapsed -= bx::getHPCounter();
-				for (PrimitiveArray::const_iterator primIt = primitives.begin(); primIt != primitives.end(); ++primIt)
-				{
-					const Primitive& prim = *primIt;
-					triangleReorder(indexData + prim.m_startIndex, prim.m_numIndices, numVertices, 32);
-				}
+				optimize(vertexData, numVertices, stride, indexData, numIndices, primitives, overdrawThreshold, vertexFetch, stats);
 				triReorderElapsed += bx::getHPCounter();
 
 				if (hasTangent)
@@ -783,11 +936,15 @@ int main(int _argc, const char* _argv[])
 				}
 
 				write(&writer, vertexData, numVertices, decl, indexData, numIndices, material, primitives);
+
+				lodElapsed -= bx::getHPCounter();
+				writeLods(&writer, vertexData, numVertices, decl, indexData, numIndices, material, primitives);
+				lodElapsed += bx::getHPCounter();
 				primitives.clear();
 
-				for (Index3Map::iterator indexIt = indexMap.begin(); indexIt != indexMap.end(); ++indexIt)
+				for (Index3Array::iterator indexIt = indexArray.begin(); indexIt != indexArray.end(); ++indexIt)
 				{
-					indexIt->second.m_vertexIndex = -1;
+					indexIt->m_vertexIndex = -1;
 				}
 
 				vertices = vertexData;
@@ -801,11 +958,10 @@ int main(int _argc, const char* _argv[])
 				material = groupIt->m_material;
 			}
 
-			Triangle& triangle = triangles[tri];
+			const Triangle& triangle = triangles[tri];
 			for (uint32_t edge = 0; edge < 3; ++edge)
 			{
-				uint64_t hash = triangle.m_index[edge];
-				Index3& index = indexMap[hash];
+				Index3& index = indexArray[triangle.m_index[edge] ];
 				if (index.m_vertexIndex == -1)
 				{
 		 			index.m_vertexIndex = numVertices++;
@@ -821,8 +977,11 @@ int main(int _argc, const char* _argv[])
 
 					if (hasTexcoord)
 					{
-						float uv[2];
-						memcpy(uv, &texcoords[index.m_texcoord], 2*sizeof(float) );
+						float uv[2] = { 0.0f, 0.0f };
+						if (-1 != index.m_texcoord)
+						{
+							memcpy(uv, &texcoords[index.m_texcoord], 2*sizeof(float) );
+						}
 
 						if (flipV)
 						{
@@ -834,8 +993,11 @@ int main(int _argc, const char* _argv[])
 
 					if (hasNormal)
 					{
-						float normal[4];
-						vec3Norm(normal, (float*)&normals[index.m_normal]);
+						float normal[4] = { 0.0f, 0.0f, 1.0f, 0.0f };
+						if (-1 != index.m_normal)
+						{
+							vec3Norm(normal, (float*)&normals[index.m_normal]);
+						}
 						bgfx::vertexPack(normal, true, bgfx::Attrib::Normal, decl, vertices);
 					}
 
@@ -868,11 +1030,7 @@ int main(int _argc, const char* _argv[])
 	if (0 < primitives.size() )
 	{
 		triReorderElapsed -= bx::getHPCounter();
-		for (PrimitiveArray::const_iterator primIt = primitives.begin(); primIt != primitives.end(); ++primIt)
-		{
-			const Primitive& prim = *primIt;
-			triangleReorder(indexData + prim.m_startIndex, prim.m_numIndices, numVertices, 32);
-		}
+		optimize(vertexData, numVertices, stride, indexData, numIndices, primitives, overdrawThreshold, vertexFetch, stats);
 		triReorderElapsed += bx::getHPCounter();
 
 		if (hasTangent)
@@ -881,6 +1039,10 @@ int main(int _argc, const char* _argv[])
 		}
 
 		write(&writer, vertexData, numVertices, decl, indexData, numIndices, material, primitives);
+
+		lodElapsed -= bx::getHPCounter();
+		writeLods(&writer, vertexData, numVertices, decl, indexData, numIndices, material, primitives);
+		lodElapsed += bx::getHPCounter();
 	}
 
 	printf("size: %d\n", uint32_t(writer.seek() ) );
@@ -892,9 +1054,10 @@ int main(int _argc, const char* _argv[])
 	now = bx::getHPCounter();
 	convertElapsed += now;
 
-	printf("parse %f [s]\ntri reorder %f [s]\nconvert %f [s]\n# %d, g %d, p %d, v %d, i %d\n"
+	printf("parse %f [s]\ntri reorder %f [s]\nlod %f [s]\nconvert %f [s]\n# %d, g %d, p %d, v %d, i %d\n"
 		, double(parseElapsed)/bx::getHPFrequency()
 		, double(triReorderElapsed)/bx::getHPFrequency()
+		, double(lodElapsed)/bx::getHPFrequency()
 		, double(convertElapsed)/bx::getHPFrequency()
 		, num
 		, uint32_t(groups.size() )
@@ -0,0 +1,26 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#include <bx/bx.h>
+
+#if BX_PLATFORM_WINDOWS
+#	include <windows.h>
+#else
+#	include <unistd.h>
+#endif // BX_PLATFORM_WINDOWS
+
+#include "jobs.h"
+
+uint32_t getNumCpus()
+{
+#if BX_PLATFORM_WINDOWS
+	SYSTEM_INFO si;
+	GetSystemInfo(&si);
+	return uint32_t(si.dwNumberOfProcessors);
+#else
+	long num = sysconf(_SC_NPROCESSORS_ONLN);
+	return 0 < num ? uint32_t(num) : 1;
+#endif // BX_PLATFORM_WINDOWS
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#ifndef JOBS_H_HEADER_GUARD
+#define JOBS_H_HEADER_GUARD
+
+#include <bx/thread.h>
+
+/// Returns number of logical processors.
+uint32_t getNumCpus();
+
+/// Run each job on its own thread and wait for all of them to finish.
+/// Single job is executed on calling thread.
+template<typename Ty>
+void runJobs(int32_t (*_fn)(void*), Ty* _jobs, uint32_t _num)
+{
+	if (1 == _num)
+	{
+		_fn(_jobs);
+		return;
+	}
+
+	bx::Thread* threads = new bx::Thread[_num];
+
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		threads[ii].init(_fn, &_jobs[ii]);
+	}
+
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		threads[ii].shutdown();
+	}
+
+	delete [] threads;
+}
+
+#endif // JOBS_H_HEADER_GUARD
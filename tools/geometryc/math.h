@@ -4,6 +4,10 @@
  */
 
 // FPU math lib
+//
+// Functions have internal linkage, bench links this together with
+// examples/common/fpumath.h which has functions with same names but
+// different implementation.
 
 #ifndef FPU_MATH_H_HEADER_GUARD
 #define FPU_MATH_H_HEADER_GUARD
@@ -12,62 +16,62 @@
 #include <math.h>
 #include <string.h>
 
-inline float fmin(float _a, float _b)
+static inline float fmin(float _a, float _b)
 {
 	return _a < _b ? _a : _b;
 }
 
-inline float fmax(float _a, float _b)
+static inline float fmax(float _a, float _b)
 {
 	return _a > _b ? _a : _b;
 }
 
-inline float flerp(float _a, float _b, float _t)
+static inline float flerp(float _a, float _b, float _t)
 {
 	return _a + (_b - _a) * _t;
 }
 
-inline void vec3Add(float* __restrict _result, const float* __restrict _a, const float* __restrict _b)
+static inline void vec3Add(float* __restrict _result, const float* __restrict _a, const float* __restrict _b)
 {
 	_result[0] = _a[0] + _b[0];
 	_result[1] = _a[1] + _b[1];
 	_result[2] = _a[2] + _b[2];
 }
 
-inline void vec3Sub(float* __restrict _result, const float* __restrict _a, const float* __restrict _b)
+static inline void vec3Sub(float* __restrict _result, const float* __restrict _a, const float* __restrict _b)
 {
 	_result[0] = _a[0] - _b[0];
 	_result[1] = _a[1] - _b[1];
 	_result[2] = _a[2] - _b[2];
 }
 
-inline void vec3Mul(float* __restrict _result, const float* __restrict _a, const float* __restrict _b)
+static inline void vec3Mul(float* __restrict _result, const float* __restrict _a, const float* __restrict _b)
 {
 	_result[0] = _a[0] * _b[0];
 	_result[1] = _a[1] * _b[1];
 	_result[2] = _a[2] * _b[2];
 }
 
-inline void vec3Mul(float* __restrict _result, const float* __restrict _a, float _b)
+static inline void vec3Mul(float* __restrict _result, const float* __restrict _a, float _b)
 {
 	_result[0] = _a[0] * _b;
 	_result[1] = _a[1] * _b;
 	_result[2] = _a[2] * _b;
 }
 
-inline float vec3Dot(const float* __restrict _a, const float* __restrict _b)
+static inline float vec3Dot(const float* __restrict _a, const float* __restrict _b)
 {
 	return _a[0]*_b[0] + _a[1]*_b[1] + _a[2]*_b[2];
 }
 
-inline void vec3Cross(float* __restrict _result, const float* __restrict _a, const float* __restrict _b)
+static inline void vec3Cross(float* __restrict _result, const float* __restrict _a, const float* __restrict _b)
 {
 	_result[0] = _a[1]*_b[2] - _a[2]*_b[1];
 	_result[1] = _a[2]*_b[0] - _a[0]*_b[2];
 	_result[2] = _a[0]*_b[1] - _a[1]*_b[0];
 }
 
-inline void vec3Norm(float* __restrict _result, const float* __restrict _a)
+static inline void vec3Norm(float* __restrict _result, const float* __restrict _a)
 {
 	float scale = 1.0f/sqrtf(vec3Dot(_a, _a) );
 	_result[0] = _a[0] * scale;
@@ -75,13 +79,13 @@ inline void vec3Norm(float* __restrict _result, const float* __restrict _a)
 	_result[2] = _a[2] * scale;
 }
 
-inline void mtxIdentity(float* _result)
+static inline void mtxIdentity(float* _result)
 {
 	memset(_result, 0, sizeof(float)*16);
 	_result[0] = _result[5] = _result[10] = _result[15] = 1.0f;
 }
 
-inline void mtxLookAt(float* __restrict _result, const float* __restrict _eye, const float* __restrict _at)
+static inline void mtxLookAt(float* __restrict _result, const float* __restrict _eye, const float* __restrict _at)
 {
 	float tmp[4];
 	vec3Sub(tmp, _at, _eye);
@@ -116,7 +120,7 @@ inline void mtxLookAt(float* __restrict _result, const float* __restrict _eye, c
 	_result[15] = 1.0f;
 }
 
-inline void mtxProj(float* _result, float _fovy, float _aspect, float _near, float _far)
+static inline void mtxProj(float* _result, float _fovy, float _aspect, float _near, float _far)
 {
 	float height = 1.0f/tanf(_fovy*( (float)M_PI/180.0f)*0.5f);
 	float width = height * 1.0f/_aspect;
@@ -131,7 +135,7 @@ inline void mtxProj(float* _result, float _fovy, float _aspect, float _near, flo
 	_result[14] = bb;
 }
 
-inline void mtxOrtho(float* _result, float _left, float _right, float _bottom, float _top, float _near, float _far)
+static inline void mtxOrtho(float* _result, float _left, float _right, float _bottom, float _top, float _near, float _far)
 {
 	const float aa = 2.0f/(_right - _left);
 	const float bb = 2.0f/(_top - _bottom);
@@ -150,7 +154,7 @@ inline void mtxOrtho(float* _result, float _left, float _right, float _bottom, f
 	_result[15] = 1.0f;
 }
 
-inline void mtxRotateX(float* _result, float _ax)
+static inline void mtxRotateX(float* _result, float _ax)
 {
 	float sx = sinf(_ax);
 	float cx = cosf(_ax);
@@ -164,7 +168,7 @@ inline void mtxRotateX(float* _result, float _ax)
 	_result[15] = 1.0f;
 }
 
-inline void mtxRotateY(float* _result, float _ay)
+static inline void mtxRotateY(float* _result, float _ay)
 {
 	float sy = sinf(_ay);
 	float cy = cosf(_ay);
@@ -178,7 +182,7 @@ inline void mtxRotateY(float* _result, float _ay)
 	_result[15] = 1.0f;
 }
 
-inline void mtxRotateZ(float* _result, float _az)
+static inline void mtxRotateZ(float* _result, float _az)
 {
 	float sz = sinf(_az);
 	float cz = cosf(_az);
@@ -192,7 +196,7 @@ inline void mtxRotateZ(float* _result, float _az)
 	_result[15] = 1.0f;
 }
 
-inline void mtxRotateXY(float* _result, float _ax, float _ay)
+static inline void mtxRotateXY(float* _result, float _ax, float _ay)
 {
 	float sx = sinf(_ax);
 	float cx = cosf(_ax);
@@ -211,7 +215,7 @@ inline void mtxRotateXY(float* _result, float _ax, float _ay)
 	_result[15] = 1.0f;
 }
 
-inline void mtxRotateXYZ(float* _result, float _ax, float _ay, float _az)
+static inline void mtxRotateXYZ(float* _result, float _ax, float _ay, float _az)
 {
 	float sx = sinf(_ax);
 	float cx = cosf(_ax);
@@ -233,7 +237,7 @@ inline void mtxRotateXYZ(float* _result, float _ax, float _ay, float _az)
 	_result[15] = 1.0f;
 }
 
-inline void mtxRotateZYX(float* _result, float _ax, float _ay, float _az)
+static inline void mtxRotateZYX(float* _result, float _ax, float _ay, float _az)
 {
 	float sx = sinf(_ax);
 	float cx = cosf(_ax);
@@ -255,14 +259,14 @@ inline void mtxRotateZYX(float* _result, float _ax, float _ay, float _az)
 	_result[15] = 1.0f;
 };
 
-inline void vec3MulMtx(float* __restrict _result, const float* __restrict _vec, const float* __restrict _mat)
+static inline void vec3MulMtx(float* __restrict _result, const float* __restrict _vec, const float* __restrict _mat)
 {
 	_result[0] = _vec[0] * _mat[ 0] + _vec[1] * _mat[4] + _vec[2] * _mat[ 8] + _mat[12];
 	_result[1] = _vec[0] * _mat[ 1] + _vec[1] * _mat[5] + _vec[2] * _mat[ 9] + _mat[13];
 	_result[2] = _vec[0] * _mat[ 2] + _vec[1] * _mat[6] + _vec[2] * _mat[10] + _mat[14];
 }
 
-inline void vec4MulMtx(float* __restrict _result, const float* __restrict _vec, const float* __restrict _mat)
+static inline void vec4MulMtx(float* __restrict _result, const float* __restrict _vec, const float* __restrict _mat)
 {
 	_result[0] = _vec[0] * _mat[ 0] + _vec[1] * _mat[4] + _vec[2] * _mat[ 8] + _vec[3] * _mat[12];
 	_result[1] = _vec[0] * _mat[ 1] + _vec[1] * _mat[5] + _vec[2] * _mat[ 9] + _vec[3] * _mat[13];
@@ -270,7 +274,7 @@ inline void vec4MulMtx(float* __restrict _result, const float* __restrict _vec,
 	_result[3] = _vec[0] * _mat[ 3] + _vec[1] * _mat[7] + _vec[2] * _mat[11] + _vec[3] * _mat[15];
 }
 
-inline void mtxMul(float* __restrict _result, const float* __restrict _a, const float* __restrict _b)
+static inline void mtxMul(float* __restrict _result, const float* __restrict _a, const float* __restrict _b)
 {
 	vec4MulMtx(&_result[ 0], &_a[ 0], _b);
 	vec4MulMtx(&_result[ 4], &_a[ 4], _b);
@@ -278,7 +282,7 @@ inline void mtxMul(float* __restrict _result, const float* __restrict _a, const
 	vec4MulMtx(&_result[12], &_a[12], _b);
 }
 
-inline void mtxTranspose(float* __restrict _result, const float* __restrict _a)
+static inline void mtxTranspose(float* __restrict _result, const float* __restrict _a)
 {
 	_result[ 0] = _a[ 0];
 	_result[ 4] = _a[ 1];
@@ -298,7 +302,7 @@ inline void mtxTranspose(float* __restrict _result, const float* __restrict _a)
 	_result[15] = _a[15];
 }
 
-inline void mtxInverse(float* __restrict _result, const float* __restrict _a)
+static inline void mtxInverse(float* __restrict _result, const float* __restrict _a)
 {
 	float xx = _a[ 0];
 	float xy = _a[ 1];
@@ -0,0 +1,309 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#include "meshencoder.h"
+
+// Must match examples/common/meshdecoder.cpp.
+#define MESH_BLOCK_SIZE         (64<<10)
+#define MESH_PROB_BITS          12
+#define MESH_PROB_SCALE         (1<<MESH_PROB_BITS)
+#define MESH_RANS_L             (1u<<23)
+
+#define MESH_BLOCK_RAW          0
+#define MESH_BLOCK_CONSTANT     1
+#define MESH_BLOCK_RANS         2
+
+#define MESH_VERTEX_QUANTIZED_POSITION UINT8_C(0x1)
+
+static void writeVarint(std::vector<uint8_t>& _out, uint32_t _value)
+{
+	while (0x80 <= _value)
+	{
+		_out.push_back(uint8_t(_value|0x80) );
+		_value >>= 7;
+	}
+
+	_out.push_back(uint8_t(_value) );
+}
+
+static void normalizeFreq(uint32_t _freq[256], const uint32_t _count[256], uint32_t _total)
+{
+	uint32_t sum = 0;
+	for (uint32_t ii = 0; ii < 256; ++ii)
+	{
+		uint32_t freq = 0;
+		if (0 != _count[ii])
+		{
+			freq = uint32_t(uint64_t(_count[ii])*MESH_PROB_SCALE/_total);
+			freq = freq < 1 ? 1 : freq;
+		}
+
+		_freq[ii] = freq;
+		sum += freq;
+	}
+
+	// Rare symbols are rounded up to frequency 1, take the difference from
+	// most frequent symbols.
+	while (MESH_PROB_SCALE != sum)
+	{
+		uint32_t maxSymbol = 0;
+		for (uint32_t ii = 1; ii < 256; ++ii)
+		{
+			maxSymbol = _freq[ii] > _freq[maxSymbol] ? ii : maxSymbol;
+		}
+
+		if (MESH_PROB_SCALE < sum)
+		{
+			uint32_t dec = sum - MESH_PROB_SCALE;
+			dec = dec < _freq[maxSymbol]/2 ? dec : _freq[maxSymbol]/2;
+			_freq[maxSymbol] -= dec;
+			sum -= dec;
+		}
+		else
+		{
+			_freq[maxSymbol] += MESH_PROB_SCALE - sum;
+			sum = MESH_PROB_SCALE;
+		}
+	}
+}
+
+// rANS with byte-wise renormalization, see:
+// https://github.com/rygorous/ryg_rans
+static uint32_t ransEncode(uint8_t* _out, uint32_t _outSize, const uint8_t* _data, uint32_t _size, const uint32_t _freq[256], const uint32_t _start[256])
+{
+	uint8_t* ptr = _out + _outSize;
+	uint32_t xx = MESH_RANS_L;
+
+	// Encoder runs backwards, so that decoder reads forward.
+	for (uint32_t ii = _size; ii-- > 0;)
+	{
+		const uint8_t symbol = _data[ii];
+		const uint32_t freq = _freq[symbol];
+		const uint32_t xmax = ( (MESH_RANS_L >> MESH_PROB_BITS) << 8) * freq;
+
+		while (xx >= xmax)
+		{
+			if (ptr == _out)
+			{
+				return UINT32_MAX;
+			}
+
+			*--ptr = uint8_t(xx);
+			xx >>= 8;
+		}
+
+		xx = ( (xx / freq) << MESH_PROB_BITS) + (xx % freq) + _start[symbol];
+	}
+
+	if (ptr - _out < 4)
+	{
+		return UINT32_MAX;
+	}
+
+	ptr -= 4;
+	ptr[0] = uint8_t(xx>> 0);
+	ptr[1] = uint8_t(xx>> 8);
+	ptr[2] = uint8_t(xx>>16);
+	ptr[3] = uint8_t(xx>>24);
+
+	const uint32_t size = uint32_t(_out + _outSize - ptr);
+	memmove(_out, ptr, size);
+
+	return size;
+}
+
+static void writeBlock(bx::WriterI* _writer, const uint8_t* _data, uint32_t _size)
+{
+	uint32_t count[256];
+	memset(count, 0, sizeof(count) );
+	for (uint32_t ii = 0; ii < _size; ++ii)
+	{
+		++count[_data[ii] ];
+	}
+
+	bx::write(_writer, _size);
+
+	if (_size == count[_data[0] ])
+	{
+		bx::write(_writer, uint8_t(MESH_BLOCK_CONSTANT) );
+		bx::write(_writer, _data[0]);
+		return;
+	}
+
+	uint32_t freq[256];
+	uint32_t start[256];
+	normalizeFreq(freq, count, _size);
+
+	std::vector<uint8_t> table;
+	uint8_t mask[32];
+	memset(mask, 0, sizeof(mask) );
+	for (uint32_t ii = 0, total = 0; ii < 256; ++ii)
+	{
+		start[ii] = total;
+		total += freq[ii];
+
+		if (0 != freq[ii])
+		{
+			mask[ii>>3] |= 1<<(ii&7);
+			writeVarint(table, freq[ii]);
+		}
+	}
+
+	std::vector<uint8_t> payload(_size);
+	uint32_t payloadSize = ransEncode(&payload[0], _size, _data, _size, freq, start);
+
+	if (UINT32_MAX == payloadSize
+	||  _size <= payloadSize + sizeof(mask) + table.size() + sizeof(uint32_t) )
+	{
+		bx::write(_writer, uint8_t(MESH_BLOCK_RAW) );
+		bx::write(_writer, _data, _size);
+		return;
+	}
+
+	bx::write(_writer, uint8_t(MESH_BLOCK_RANS) );
+	bx::write(_writer, mask, sizeof(mask) );
+	bx::write(_writer, &table[0], uint32_t(table.size() ) );
+	bx::write(_writer, payloadSize);
+	bx::write(_writer, &payload[0], payloadSize);
+}
+
+// Each stream (vertex column, or index data) is split into its own blocks,
+// so that block statistics are not mixed between streams.
+static void writeStream(bx::WriterI* _writer, const std::vector<uint8_t>& _data)
+{
+	for (uint32_t offset = 0, size = uint32_t(_data.size() ); offset < size; offset += MESH_BLOCK_SIZE)
+	{
+		uint32_t blockSize = size - offset;
+		blockSize = blockSize < MESH_BLOCK_SIZE ? blockSize : MESH_BLOCK_SIZE;
+		writeBlock(_writer, &_data[offset], blockSize);
+	}
+}
+
+inline uint16_t zigzag(int32_t _value)
+{
+	return uint16_t( (_value<<1) ^ (_value>>31) );
+}
+
+void encodeVertices(bx::WriterI* _writer, const uint8_t* _vertices, uint32_t _numVertices, const bgfx::VertexDecl& _decl)
+{
+	const uint32_t stride = _decl.getStride();
+
+	uint8_t num;
+	bgfx::AttribType::Enum type;
+	bool normalized;
+	bool asInt;
+	_decl.decode(bgfx::Attrib::Position, num, type, normalized, asInt);
+
+	const uint32_t positionOffset = _decl.getOffset(bgfx::Attrib::Position);
+	const bool quantize = 0 < _numVertices
+		&& bgfx::AttribType::Float == type
+		&& 3 == num
+		;
+
+	const uint8_t flags = quantize ? MESH_VERTEX_QUANTIZED_POSITION : 0;
+	bx::write(_writer, flags);
+
+	std::vector<uint8_t> column;
+	column.reserve(_numVertices*2);
+
+	uint32_t skipBegin = stride;
+	uint32_t skipEnd = stride;
+
+	if (quantize)
+	{
+		float min[3];
+		float max[3];
+		memcpy(min, _vertices + positionOffset, sizeof(min) );
+		memcpy(max, _vertices + positionOffset, sizeof(max) );
+
+		for (uint32_t ii = 1; ii < _numVertices; ++ii)
+		{
+			const float* position = (const float*)(_vertices + ii*stride + positionOffset);
+			for (uint32_t jj = 0; jj < 3; ++jj)
+			{
+				min[jj] = position[jj] < min[jj] ? position[jj] : min[jj];
+				max[jj] = position[jj] > max[jj] ? position[jj] : max[jj];
+			}
+		}
+
+		float scale[3];
+		float invScale[3];
+		for (uint32_t jj = 0; jj < 3; ++jj)
+		{
+			const float extent = max[jj] - min[jj];
+			scale[jj] = extent/65535.0f;
+			invScale[jj] = 0.0f < extent ? 65535.0f/extent : 0.0f;
+		}
+
+		bx::write(_writer, min, sizeof(min) );
+		bx::write(_writer, scale, sizeof(scale) );
+
+		// Position components are stored as 16-bit deltas, low and high byte
+		// interleaved.
+		for (uint32_t jj = 0; jj < 3; ++jj)
+		{
+			column.clear();
+
+			int32_t prev = 0;
+			for (uint32_t ii = 0; ii < _numVertices; ++ii)
+			{
+				const float* position = (const float*)(_vertices + ii*stride + positionOffset);
+				const int32_t quantized = int32_t( (position[jj] - min[jj])*invScale[jj] + 0.5f);
+				const uint16_t delta = zigzag(int16_t(quantized - prev) );
+				prev = quantized;
+
+				column.push_back(uint8_t(delta) );
+				column.push_back(uint8_t(delta>>8) );
+			}
+
+			writeStream(_writer, column);
+		}
+
+		skipBegin = positionOffset;
+		skipEnd = positionOffset + 3*sizeof(float);
+	}
+
+	// Remaining attributes are delta coded per byte.
+	column.resize(_numVertices);
+	for (uint32_t offset = 0; offset < stride; ++offset)
+	{
+		if (offset >= skipBegin
+		&&  offset <  skipEnd)
+		{
+			continue;
+		}
+
+		uint8_t prev = 0;
+		for (uint32_t ii = 0; ii < _numVertices; ++ii)
+		{
+			const uint8_t value = _vertices[ii*stride + offset];
+			column[ii] = uint8_t(value - prev);
+			prev = value;
+		}
+
+		writeStream(_writer, column);
+	}
+}
+
+void encodeIndices(bx::WriterI* _writer, const uint16_t* _indices, uint32_t _numIndices)
+{
+	std::vector<uint8_t> data;
+	data.reserve(_numIndices*2);
+
+	int32_t prev = 0;
+	for (uint32_t ii = 0; ii < _numIndices; ++ii)
+	{
+		const int32_t index = _indices[ii];
+		const int32_t delta = index - prev;
+		writeVarint(data, uint32_t( (delta<<1) ^ (delta>>31) ) );
+		prev = index;
+	}
+
+	writeStream(_writer, data);
+}
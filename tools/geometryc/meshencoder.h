@@ -0,0 +1,31 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#ifndef MESHENCODER_H_HEADER_GUARD
+#define MESHENCODER_H_HEADER_GUARD
+
+#include <bgfx.h>
+#include <bx/readerwriter.h>
+
+/// Write compressed vertex stream.
+///
+/// Float3 positions are quantized to 16 bits inside vertices bounds. All
+/// attributes are delta coded against previous vertex and split into byte
+/// columns, each column is entropy coded separately.
+///
+/// Stream is decoded with meshDecodeVertices from examples/common/meshdecoder.h.
+///
+void encodeVertices(bx::WriterI* _writer, const uint8_t* _vertices, uint32_t _numVertices, const bgfx::VertexDecl& _decl);
+
+/// Write compressed index stream.
+///
+/// Indices are delta coded against previous index, zigzag and varint
+/// encoded, and entropy coded.
+///
+/// Stream is decoded with meshDecodeIndices from examples/common/meshdecoder.h.
+///
+void encodeIndices(bx::WriterI* _writer, const uint16_t* _indices, uint32_t _numIndices);
+
+#endif // MESHENCODER_H_HEADER_GUARD
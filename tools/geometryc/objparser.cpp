@@ -0,0 +1,938 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#include <bx/bx.h>
+#include <bx/uint32_t.h>
+
+#if BX_PLATFORM_WINDOWS
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif // BX_PLATFORM_WINDOWS
+
+#include "jobs.h"
+#include "objparser.h"
+
+// https://en.wikipedia.org/wiki/Wavefront_.obj_file
+
+struct MappedFile
+{
+	MappedFile()
+		: m_data(NULL)
+		, m_size(0)
+		, m_buffer(NULL)
+#if BX_PLATFORM_WINDOWS
+		, m_file(INVALID_HANDLE_VALUE)
+		, m_mapping(NULL)
+#else
+		, m_fd(-1)
+#endif // BX_PLATFORM_WINDOWS
+	{
+	}
+
+	~MappedFile()
+	{
+		close();
+	}
+
+	bool open(const char* _filePath)
+	{
+#if BX_PLATFORM_WINDOWS
+		m_file = CreateFileA(_filePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (INVALID_HANDLE_VALUE == m_file)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER size;
+		GetFileSizeEx(m_file, &size);
+		m_size = size_t(size.QuadPart);
+
+		if (0 < m_size)
+		{
+			m_mapping = CreateFileMappingA(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (NULL != m_mapping)
+			{
+				m_data = (const char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+			}
+		}
+#else
+		m_fd = ::open(_filePath, O_RDONLY);
+		if (-1 == m_fd)
+		{
+			return false;
+		}
+
+		struct stat st;
+		if (0 != fstat(m_fd, &st) )
+		{
+			return false;
+		}
+
+		m_size = size_t(st.st_size);
+
+		if (0 < m_size)
+		{
+			void* data = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+			if (MAP_FAILED != data)
+			{
+				madvise(data, m_size, MADV_SEQUENTIAL);
+				m_data = (const char*)data;
+			}
+		}
+#endif // BX_PLATFORM_WINDOWS
+
+		if (NULL == m_data
+		&&  0 < m_size)
+		{
+			// Mapping is not possible (f.e. address space is too small),
+			// fallback to reading whole file.
+			FILE* file = fopen(_filePath, "rb");
+			if (NULL == file)
+			{
+				return false;
+			}
+
+			m_buffer = (char*)malloc(m_size);
+			if (NULL == m_buffer)
+			{
+				fclose(file);
+				return false;
+			}
+
+			m_size = fread(m_buffer, 1, m_size, file);
+			m_data = m_buffer;
+			fclose(file);
+		}
+
+		return true;
+	}
+
+	void close()
+	{
+		if (NULL != m_buffer)
+		{
+			free(m_buffer);
+		}
+#if BX_PLATFORM_WINDOWS
+		else if (NULL != m_data)
+		{
+			UnmapViewOfFile(m_data);
+		}
+
+		if (NULL != m_mapping)
+		{
+			CloseHandle(m_mapping);
+		}
+
+		if (INVALID_HANDLE_VALUE != m_file)
+		{
+			CloseHandle(m_file);
+		}
+
+		m_file = INVALID_HANDLE_VALUE;
+		m_mapping = NULL;
+#else
+		else if (NULL != m_data)
+		{
+			munmap( (void*)m_data, m_size);
+		}
+
+		if (-1 != m_fd)
+		{
+			::close(m_fd);
+		}
+
+		m_fd = -1;
+#endif // BX_PLATFORM_WINDOWS
+
+		m_data = NULL;
+		m_buffer = NULL;
+		m_size = 0;
+	}
+
+	const char* m_data;
+	size_t m_size;
+	char* m_buffer;
+#if BX_PLATFORM_WINDOWS
+	HANDLE m_file;
+	HANDLE m_mapping;
+#else
+	int m_fd;
+#endif // BX_PLATFORM_WINDOWS
+};
+
+struct ObjEvent
+{
+	enum Enum
+	{
+		Group,
+		Vertex,
+		Material,
+	};
+
+	Enum m_type;
+	uint32_t m_triangle;
+	std::string m_name;
+};
+
+typedef std::vector<ObjEvent> ObjEventArray;
+
+// Index3::m_vertexIndex holds relative index flags until chunks are merged.
+#define OBJ_RELATIVE_POSITION 0x1
+#define OBJ_RELATIVE_TEXCOORD 0x2
+#define OBJ_RELATIVE_NORMAL   0x4
+
+struct ObjChunk
+{
+	const char* m_begin;
+	const char* m_end;
+	float m_scale;
+	bool m_ccw;
+	bool m_parameterSpace;
+	uint32_t m_numLines;
+
+	Vector3Array m_positions;
+	Vector3Array m_normals;
+	Vector3Array m_texcoords;
+	Index3Array m_corners;
+	TriangleArray m_triangles;
+	ObjEventArray m_events;
+	std::vector<uint32_t> m_hash;
+	std::vector<uint32_t> m_shardCount;
+
+	uint32_t m_positionBase;
+	uint32_t m_normalBase;
+	uint32_t m_texcoordBase;
+	uint32_t m_triangleBase;
+
+	struct ObjShard* m_shards;
+	uint32_t m_numShards;
+	ObjData* m_obj;
+};
+
+struct ObjShard
+{
+	uint32_t m_shard;
+	uint32_t m_numShards;
+	ObjChunk* m_chunks;
+	uint32_t m_numChunks;
+	uint32_t m_base;
+	Index3Array m_unique;
+};
+
+inline bool isSpace(char _ch)
+{
+	return ' ' == _ch
+		|| '\t' == _ch
+		|| '\r' == _ch
+		;
+}
+
+inline bool isDigit(char _ch)
+{
+	return uint32_t(_ch - '0') < 10;
+}
+
+inline const char* skipSpace(const char* _ptr, const char* _end)
+{
+	while (_ptr < _end
+	&&     isSpace(*_ptr) )
+	{
+		++_ptr;
+	}
+
+	return _ptr;
+}
+
+inline const char* skipWord(const char* _ptr, const char* _end)
+{
+	while (_ptr < _end
+	&&     !isSpace(*_ptr) )
+	{
+		++_ptr;
+	}
+
+	return _ptr;
+}
+
+static double powerOf10(int32_t _exp)
+{
+	// Powers of 10 up to 1e22 are exactly representable as double.
+	static const double s_powerOf10[] =
+	{
+		1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+		1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+		1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+	};
+
+	return _exp < int32_t(BX_COUNTOF(s_powerOf10) )
+		? s_powerOf10[_exp]
+		: pow(10.0, double(_exp) )
+		;
+}
+
+static const char* parseFloat(const char* _ptr, const char* _end, float& _value)
+{
+	_ptr = skipSpace(_ptr, _end);
+
+	bool negative = false;
+	if (_ptr < _end
+	&& ('-' == *_ptr || '+' == *_ptr) )
+	{
+		negative = '-' == *_ptr;
+		++_ptr;
+	}
+
+	// Accumulate up to 19 significant digits into integer mantissa, and
+	// apply decimal exponent once at the end. Digits past 19th are dropped
+	// and value is rounded through double, so result can differ from
+	// strtof in the last bit.
+	uint64_t mantissa = 0;
+	uint32_t numDigits = 0;
+	int32_t exponent = 0;
+
+	for (; _ptr < _end && isDigit(*_ptr); ++_ptr)
+	{
+		if (19 > numDigits)
+		{
+			mantissa = mantissa*10 + (*_ptr - '0');
+			numDigits += 0 != mantissa;
+		}
+		else
+		{
+			++exponent;
+		}
+	}
+
+	if (_ptr < _end
+	&&  '.' == *_ptr)
+	{
+		++_ptr;
+
+		for (; _ptr < _end && isDigit(*_ptr); ++_ptr)
+		{
+			if (19 > numDigits)
+			{
+				mantissa = mantissa*10 + (*_ptr - '0');
+				numDigits += 0 != mantissa;
+				--exponent;
+			}
+		}
+	}
+
+	if (_ptr < _end
+	&& ('e' == *_ptr || 'E' == *_ptr) )
+	{
+		++_ptr;
+
+		bool negativeExp = false;
+		if (_ptr < _end
+		&& ('-' == *_ptr || '+' == *_ptr) )
+		{
+			negativeExp = '-' == *_ptr;
+			++_ptr;
+		}
+
+		int32_t value = 0;
+		for (; _ptr < _end && isDigit(*_ptr); ++_ptr)
+		{
+			value = value < 10000 ? value*10 + (*_ptr - '0') : value;
+		}
+
+		exponent += negativeExp ? -value : value;
+	}
+
+	double value = double(mantissa);
+	value = 0 > exponent
+		? value / powerOf10(-exponent)
+		: value * powerOf10(exponent)
+		;
+
+	_value = float(negative ? -value : value);
+
+	return _ptr;
+}
+
+static const char* parseInt(const char* _ptr, const char* _end, int32_t& _value)
+{
+	bool negative = false;
+	if (_ptr < _end
+	&& ('-' == *_ptr || '+' == *_ptr) )
+	{
+		negative = '-' == *_ptr;
+		++_ptr;
+	}
+
+	int32_t value = 0;
+	for (; _ptr < _end && isDigit(*_ptr); ++_ptr)
+	{
+		value = value*10 + (*_ptr - '0');
+	}
+
+	_value = negative ? -value : value;
+
+	return _ptr;
+}
+
+static std::string parseName(const char* _ptr, const char* _end)
+{
+	_ptr = skipSpace(_ptr, _end);
+	return std::string(_ptr, skipWord(_ptr, _end) );
+}
+
+inline int32_t resolveIndex(int32_t _index, uint32_t _num, int32_t _relativeFlag, int32_t& _flags)
+{
+	if (0 > _index)
+	{
+		// Relative index, chunk local until merged.
+		_flags |= _relativeFlag;
+		return int32_t(_num) + _index;
+	}
+
+	return _index - 1;
+}
+
+static void parseFace(ObjChunk& _chunk, const char* _ptr, const char* _end)
+{
+	Triangle triangle;
+	memset(&triangle, 0, sizeof(Triangle) );
+
+	for (uint32_t edge = 0; ; ++edge)
+	{
+		_ptr = skipSpace(_ptr, _end);
+		if (_ptr == _end)
+		{
+			break;
+		}
+
+		Index3 index;
+		index.m_texcoord = -1;
+		index.m_normal = -1;
+		index.m_vertexIndex = 0;
+
+		int32_t value;
+		_ptr = parseInt(_ptr, _end, value);
+		index.m_position = resolveIndex(value, uint32_t(_chunk.m_positions.size() ), OBJ_RELATIVE_POSITION, index.m_vertexIndex);
+
+		if (_ptr < _end
+		&&  '/' == *_ptr)
+		{
+			++_ptr;
+			if (_ptr < _end
+			&&  '/' != *_ptr)
+			{
+				_ptr = parseInt(_ptr, _end, value);
+				index.m_texcoord = resolveIndex(value, uint32_t(_chunk.m_texcoords.size() ), OBJ_RELATIVE_TEXCOORD, index.m_vertexIndex);
+			}
+
+			if (_ptr < _end
+			&&  '/' == *_ptr)
+			{
+				++_ptr;
+				_ptr = parseInt(_ptr, _end, value);
+				index.m_normal = resolveIndex(value, uint32_t(_chunk.m_normals.size() ), OBJ_RELATIVE_NORMAL, index.m_vertexIndex);
+			}
+		}
+
+		_ptr = skipWord(_ptr, _end);
+
+		uint32_t corner = uint32_t(_chunk.m_corners.size() );
+		_chunk.m_corners.push_back(index);
+
+		switch (edge)
+		{
+		case 0:
+		case 1:
+		case 2:
+			triangle.m_index[edge] = corner;
+			if (2 == edge)
+			{
+				if (_chunk.m_ccw)
+				{
+					std::swap(triangle.m_index[1], triangle.m_index[2]);
+				}
+				_chunk.m_triangles.push_back(triangle);
+			}
+			break;
+
+		default:
+			if (_chunk.m_ccw)
+			{
+				triangle.m_index[2] = triangle.m_index[1];
+				triangle.m_index[1] = corner;
+			}
+			else
+			{
+				triangle.m_index[1] = triangle.m_index[2];
+				triangle.m_index[2] = corner;
+			}
+			_chunk.m_triangles.push_back(triangle);
+			break;
+		}
+	}
+}
+
+static void pushEvent(ObjChunk& _chunk, ObjEvent::Enum _type, const std::string& _name = std::string() )
+{
+	ObjEvent event;
+	event.m_type = _type;
+	event.m_triangle = uint32_t(_chunk.m_triangles.size() );
+	event.m_name = _name;
+	_chunk.m_events.push_back(event);
+}
+
+static int32_t parseChunk(void* _userData)
+{
+	ObjChunk& chunk = *(ObjChunk*)_userData;
+
+	// Vertex lines close current group only when it has triangles, so only
+	// first vertex line after faces is recorded.
+	uint32_t lastVertexEvent = UINT32_MAX;
+
+	for (const char* ptr = chunk.m_begin, *end = chunk.m_end; ptr < end; ++chunk.m_numLines)
+	{
+		const char* eol = (const char*)memchr(ptr, '\n', end - ptr);
+		eol = NULL == eol ? end : eol;
+
+		const char* next = eol + (eol < end);
+		ptr = skipSpace(ptr, eol);
+
+		if (eol - ptr < 2)
+		{
+			ptr = next;
+			continue;
+		}
+
+		const char ch0 = ptr[0];
+		const char ch1 = ptr[1];
+
+		if ('v' == ch0)
+		{
+			uint32_t numTriangles = uint32_t(chunk.m_triangles.size() );
+			if (lastVertexEvent != numTriangles)
+			{
+				lastVertexEvent = numTriangles;
+				pushEvent(chunk, ObjEvent::Vertex);
+			}
+
+			if (isSpace(ch1) )
+			{
+				Vector3 pos;
+				float pw = 1.0f;
+				ptr = parseFloat(ptr + 2, eol, pos.x);
+				ptr = parseFloat(ptr,     eol, pos.y);
+				ptr = parseFloat(ptr,     eol, pos.z);
+				ptr = skipSpace(ptr, eol);
+				if (ptr < eol)
+				{
+					parseFloat(ptr, eol, pw);
+				}
+
+				float invW = chunk.m_scale/pw;
+				pos.x *= invW;
+				pos.y *= invW;
+				pos.z *= invW;
+
+				chunk.m_positions.push_back(pos);
+			}
+			else if ('n' == ch1)
+			{
+				Vector3 normal;
+				ptr = parseFloat(ptr + 2, eol, normal.x);
+				ptr = parseFloat(ptr,     eol, normal.y);
+				ptr = parseFloat(ptr,     eol, normal.z);
+
+				chunk.m_normals.push_back(normal);
+			}
+			else if ('t' == ch1)
+			{
+				Vector3 texcoord;
+				texcoord.y = 0.0f;
+				texcoord.z = 0.0f;
+				ptr = parseFloat(ptr + 2, eol, texcoord.x);
+				ptr = skipSpace(ptr, eol);
+				if (ptr < eol)
+				{
+					ptr = parseFloat(ptr, eol, texcoord.y);
+					ptr = skipSpace(ptr, eol);
+					if (ptr < eol)
+					{
+						parseFloat(ptr, eol, texcoord.z);
+					}
+				}
+
+				chunk.m_texcoords.push_back(texcoord);
+			}
+			else if ('p' == ch1)
+			{
+				chunk.m_parameterSpace = true;
+			}
+		}
+		else if ('f' == ch0
+		&&       isSpace(ch1) )
+		{
+			parseFace(chunk, ptr + 2, eol);
+		}
+		else if ('g' == ch0
+		&&       isSpace(ch1) )
+		{
+			pushEvent(chunk, ObjEvent::Group, parseName(ptr + 2, eol) );
+		}
+		else if (eol - ptr > 7
+		&&       0 == strncmp(ptr, "usemtl", 6)
+		&&       isSpace(ptr[6]) )
+		{
+			pushEvent(chunk, ObjEvent::Material, parseName(ptr + 7, eol) );
+		}
+// unsupported tags
+// 		mtllib, o, s
+
+		ptr = next;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+inline uint32_t hashIndex(const Index3& _index)
+{
+	uint64_t hash = uint32_t(_index.m_position);
+	hash = hash*UINT64_C(0x9e3779b97f4a7c15) ^ uint32_t(_index.m_texcoord);
+	hash = hash*UINT64_C(0x9e3779b97f4a7c15) ^ uint32_t(_index.m_normal);
+	hash *= UINT64_C(0xff51afd7ed558ccd);
+	return uint32_t(hash>>32);
+}
+
+inline uint32_t hashShard(uint32_t _hash, uint32_t _numShards)
+{
+	// Shard is taken from high bits, low bits are used for hash table slot.
+	return uint32_t( (uint64_t(_hash)*_numShards)>>32);
+}
+
+static int32_t mergeChunk(void* _userData)
+{
+	ObjChunk& chunk = *(ObjChunk*)_userData;
+	ObjData& obj = *chunk.m_obj;
+
+	if (!chunk.m_positions.empty() )
+	{
+		memcpy(&obj.m_positions[chunk.m_positionBase], &chunk.m_positions[0], chunk.m_positions.size()*sizeof(Vector3) );
+	}
+
+	if (!chunk.m_normals.empty() )
+	{
+		memcpy(&obj.m_normals[chunk.m_normalBase], &chunk.m_normals[0], chunk.m_normals.size()*sizeof(Vector3) );
+	}
+
+	if (!chunk.m_texcoords.empty() )
+	{
+		memcpy(&obj.m_texcoords[chunk.m_texcoordBase], &chunk.m_texcoords[0], chunk.m_texcoords.size()*sizeof(Vector3) );
+	}
+
+	Vector3Array().swap(chunk.m_positions);
+	Vector3Array().swap(chunk.m_normals);
+	Vector3Array().swap(chunk.m_texcoords);
+
+	const uint32_t numCorners = uint32_t(chunk.m_corners.size() );
+	chunk.m_hash.resize(numCorners);
+	chunk.m_shardCount.assign(chunk.m_numShards, 0);
+
+	for (uint32_t ii = 0; ii < numCorners; ++ii)
+	{
+		Index3& index = chunk.m_corners[ii];
+		const int32_t flags = index.m_vertexIndex;
+		index.m_position += (flags & OBJ_RELATIVE_POSITION) ? int32_t(chunk.m_positionBase) : 0;
+		index.m_texcoord += (flags & OBJ_RELATIVE_TEXCOORD) ? int32_t(chunk.m_texcoordBase) : 0;
+		index.m_normal   += (flags & OBJ_RELATIVE_NORMAL)   ? int32_t(chunk.m_normalBase)   : 0;
+		index.m_vertexIndex = -1;
+
+		const uint32_t hash = hashIndex(index);
+		chunk.m_hash[ii] = hash;
+		++chunk.m_shardCount[hashShard(hash, chunk.m_numShards)];
+	}
+
+	return EXIT_SUCCESS;
+}
+
+static int32_t dedupShard(void* _userData)
+{
+	ObjShard& shard = *(ObjShard*)_userData;
+
+	uint32_t count = 0;
+	for (uint32_t ii = 0; ii < shard.m_numChunks; ++ii)
+	{
+		count += shard.m_chunks[ii].m_shardCount[shard.m_shard];
+	}
+
+	// Open addressing hash table of shard local unique indices.
+	const uint32_t size = bx::uint32_max(16, bx::uint32_nextpow2(count*2) );
+	const uint32_t mask = size-1;
+	std::vector<uint32_t> table(size, UINT32_MAX);
+
+	shard.m_unique.reserve(count);
+
+	for (uint32_t ii = 0; ii < shard.m_numChunks; ++ii)
+	{
+		ObjChunk& chunk = shard.m_chunks[ii];
+		for (uint32_t jj = 0, num = uint32_t(chunk.m_corners.size() ); jj < num; ++jj)
+		{
+			const uint32_t hash = chunk.m_hash[jj];
+			if (shard.m_shard != hashShard(hash, shard.m_numShards) )
+			{
+				continue;
+			}
+
+			Index3& index = chunk.m_corners[jj];
+
+			for (uint32_t slot = hash & mask; ; slot = (slot + 1) & mask)
+			{
+				uint32_t id = table[slot];
+				if (UINT32_MAX == id)
+				{
+					id = uint32_t(shard.m_unique.size() );
+					table[slot] = id;
+					shard.m_unique.push_back(index);
+					index.m_vertexIndex = int32_t(id);
+					break;
+				}
+
+				const Index3& unique = shard.m_unique[id];
+				if (unique.m_position == index.m_position
+				&&  unique.m_texcoord == index.m_texcoord
+				&&  unique.m_normal   == index.m_normal)
+				{
+					index.m_vertexIndex = int32_t(id);
+					break;
+				}
+			}
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
+static int32_t remapChunk(void* _userData)
+{
+	ObjChunk& chunk = *(ObjChunk*)_userData;
+	ObjData& obj = *chunk.m_obj;
+
+	for (uint32_t ii = 0, num = uint32_t(chunk.m_triangles.size() ); ii < num; ++ii)
+	{
+		const Triangle& src = chunk.m_triangles[ii];
+		Triangle& dst = obj.m_triangles[chunk.m_triangleBase + ii];
+
+		for (uint32_t edge = 0; edge < 3; ++edge)
+		{
+			const uint32_t corner = src.m_index[edge];
+			const uint32_t shard = hashShard(chunk.m_hash[corner], chunk.m_numShards);
+			dst.m_index[edge] = chunk.m_shards[shard].m_base + chunk.m_corners[corner].m_vertexIndex;
+		}
+	}
+
+	Index3Array().swap(chunk.m_corners);
+	TriangleArray().swap(chunk.m_triangles);
+	std::vector<uint32_t>().swap(chunk.m_hash);
+
+	return EXIT_SUCCESS;
+}
+
+static void renumberIndices(ObjData& _obj)
+{
+	// Shard bases depend on number of threads. Renumber unique indices by
+	// first appearance in triangles, so that output doesn't depend on it.
+	// Indices not used by any triangle (faces with less than 3 vertices)
+	// are dropped.
+	std::vector<uint32_t> remap(_obj.m_indices.size(), UINT32_MAX);
+	Index3Array indices;
+	indices.reserve(_obj.m_indices.size() );
+
+	for (TriangleArray::iterator it = _obj.m_triangles.begin(), itEnd = _obj.m_triangles.end(); it != itEnd; ++it)
+	{
+		for (uint32_t edge = 0; edge < 3; ++edge)
+		{
+			uint32_t& index = it->m_index[edge];
+			if (UINT32_MAX == remap[index])
+			{
+				remap[index] = uint32_t(indices.size() );
+				indices.push_back(_obj.m_indices[index]);
+			}
+
+			index = remap[index];
+		}
+	}
+
+	_obj.m_indices.swap(indices);
+}
+
+static void closeGroup(GroupArray& _groups, Group& _group, uint32_t _numTriangles)
+{
+	_group.m_numTriangles = _numTriangles - _group.m_startTriangle;
+	if (0 < _group.m_numTriangles)
+	{
+		_groups.push_back(_group);
+		_group.m_startTriangle = _numTriangles;
+		_group.m_numTriangles = 0;
+	}
+}
+
+bool parseObj(ObjData& _obj, const char* _filePath, float _scale, bool _ccw, uint32_t _numThreads)
+{
+	MappedFile file;
+	if (!file.open(_filePath) )
+	{
+		return false;
+	}
+
+	// Don't split small files into more chunks than it's worth.
+	const size_t minChunkSize = 1<<20;
+	uint32_t numChunks = 0 == _numThreads ? getNumCpus() : _numThreads;
+	numChunks = bx::uint32_max(1, bx::uint32_min(numChunks, uint32_t(file.m_size/minChunkSize) + 1) );
+
+	ObjChunk* chunks = new ObjChunk[numChunks];
+	ObjShard* shards = new ObjShard[numChunks];
+
+	const char* data = file.m_data;
+	const char* end = data + file.m_size;
+	const char* begin = data;
+	for (uint32_t ii = 0; ii < numChunks; ++ii)
+	{
+		const char* split = end;
+		if (ii+1 < numChunks)
+		{
+			split = std::max(begin, data + file.m_size/numChunks*(ii+1) );
+			split = (const char*)memchr(split, '\n', end - split);
+			split = NULL == split ? end : split + 1;
+		}
+
+		ObjChunk& chunk = chunks[ii];
+		chunk.m_begin = begin;
+		chunk.m_end = split;
+		chunk.m_scale = _scale;
+		chunk.m_ccw = _ccw;
+		chunk.m_parameterSpace = false;
+		chunk.m_numLines = 0;
+		chunk.m_shards = shards;
+		chunk.m_numShards = numChunks;
+		chunk.m_obj = &_obj;
+
+		ObjShard& shard = shards[ii];
+		shard.m_shard = ii;
+		shard.m_numShards = numChunks;
+		shard.m_chunks = chunks;
+		shard.m_numChunks = numChunks;
+
+		begin = split;
+	}
+
+	runJobs(parseChunk, chunks, numChunks);
+
+	file.close();
+
+	uint32_t numPositions = 0;
+	uint32_t numNormals = 0;
+	uint32_t numTexcoords = 0;
+	uint32_t numTriangles = 0;
+	bool parameterSpace = false;
+
+	_obj.m_numLines = 0;
+	_obj.m_groups.clear();
+
+	Group group;
+	group.m_startTriangle = 0;
+	group.m_numTriangles = 0;
+
+	for (uint32_t ii = 0; ii < numChunks; ++ii)
+	{
+		ObjChunk& chunk = chunks[ii];
+		chunk.m_positionBase = numPositions;
+		chunk.m_normalBase = numNormals;
+		chunk.m_texcoordBase = numTexcoords;
+		chunk.m_triangleBase = numTriangles;
+
+		for (ObjEventArray::const_iterator it = chunk.m_events.begin(), itEnd = chunk.m_events.end(); it != itEnd; ++it)
+		{
+			const uint32_t triangle = numTriangles + it->m_triangle;
+
+			switch (it->m_type)
+			{
+			case ObjEvent::Group:
+				group.m_name = it->m_name;
+				break;
+
+			case ObjEvent::Vertex:
+				closeGroup(_obj.m_groups, group, triangle);
+				break;
+
+			case ObjEvent::Material:
+				if (it->m_name != group.m_material)
+				{
+					closeGroup(_obj.m_groups, group, triangle);
+				}
+
+				group.m_material = it->m_name;
+				break;
+			}
+		}
+
+		ObjEventArray().swap(chunk.m_events);
+
+		numPositions += uint32_t(chunk.m_positions.size() );
+		numNormals += uint32_t(chunk.m_normals.size() );
+		numTexcoords += uint32_t(chunk.m_texcoords.size() );
+		numTriangles += uint32_t(chunk.m_triangles.size() );
+		parameterSpace |= chunk.m_parameterSpace;
+		_obj.m_numLines += chunk.m_numLines;
+	}
+
+	closeGroup(_obj.m_groups, group, numTriangles);
+
+	if (parameterSpace)
+	{
+		printf("warning: 'parameter space vertices' are unsupported.\n");
+	}
+
+	_obj.m_positions.resize(numPositions);
+	_obj.m_normals.resize(numNormals);
+	_obj.m_texcoords.resize(numTexcoords);
+	runJobs(mergeChunk, chunks, numChunks);
+
+	runJobs(dedupShard, shards, numChunks);
+
+	uint32_t numIndices = 0;
+	for (uint32_t ii = 0; ii < numChunks; ++ii)
+	{
+		shards[ii].m_base = numIndices;
+		numIndices += uint32_t(shards[ii].m_unique.size() );
+	}
+
+	_obj.m_indices.resize(numIndices);
+	for (uint32_t ii = 0; ii < numChunks; ++ii)
+	{
+		const Index3Array& unique = shards[ii].m_unique;
+		if (!unique.empty() )
+		{
+			memcpy(&_obj.m_indices[shards[ii].m_base], &unique[0], unique.size()*sizeof(Index3) );
+		}
+	}
+
+	_obj.m_triangles.resize(numTriangles);
+	runJobs(remapChunk, chunks, numChunks);
+
+	delete [] shards;
+	delete [] chunks;
+
+	renumberIndices(_obj);
+
+	return true;
+}
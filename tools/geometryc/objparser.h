@@ -0,0 +1,78 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#ifndef OBJPARSER_H_HEADER_GUARD
+#define OBJPARSER_H_HEADER_GUARD
+
+#include <stdint.h>
+#include <vector>
+#include <string>
+
+struct Vector3
+{
+	float x;
+	float y;
+	float z;
+};
+
+typedef std::vector<Vector3> Vector3Array;
+
+struct Index3
+{
+	int32_t m_position;
+	int32_t m_texcoord;
+	int32_t m_normal;
+	int32_t m_vertexIndex;
+};
+
+typedef std::vector<Index3> Index3Array;
+
+struct Triangle
+{
+	uint32_t m_index[3];
+};
+
+typedef std::vector<Triangle> TriangleArray;
+
+struct Group
+{
+	uint32_t m_startTriangle;
+	uint32_t m_numTriangles;
+	std::string m_name;
+	std::string m_material;
+};
+
+typedef std::vector<Group> GroupArray;
+
+struct ObjData
+{
+	Vector3Array m_positions;
+	Vector3Array m_normals;
+	Vector3Array m_texcoords;
+	Index3Array m_indices;     //!< Unique position/texcoord/normal combinations.
+	TriangleArray m_triangles; //!< Triangles indexing into m_indices.
+	GroupArray m_groups;
+	uint32_t m_numLines;
+};
+
+/// Parse Wavefront .obj file.
+///
+/// File is memory mapped and split into chunks at line boundaries. Chunks
+/// are parsed in parallel, then merged, and position/texcoord/normal index
+/// combinations are deduplicated in parallel by sharding index hash
+/// between threads. Unique indices are numbered by first appearance in
+/// triangles, output doesn't depend on number of threads.
+///
+/// @param _obj Parsed data.
+/// @param _filePath Input file path.
+/// @param _scale Position scale.
+/// @param _ccw Counter-clockwise winding order.
+/// @param _numThreads Number of threads, 0 uses number of logical
+///   processors.
+/// @returns True if file was parsed.
+///
+bool parseObj(ObjData& _obj, const char* _filePath, float _scale, bool _ccw, uint32_t _numThreads = 0);
+
+#endif // OBJPARSER_H_HEADER_GUARD
@@ -0,0 +1,416 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#include <stdint.h>
+#include <float.h>
+#include <string.h> // memset
+#include <algorithm>
+#include <vector>
+#include "optimize.h"
+#include "math.h"
+
+struct VertexCache
+{
+	VertexCache(uint32_t _numVertices, uint32_t _cacheSize)
+		: m_time(_cacheSize+1)
+		, m_cacheSize(_cacheSize)
+	{
+		m_timestamp = new uint32_t[_numVertices];
+		memset(m_timestamp, 0, _numVertices*sizeof(uint32_t) );
+	}
+
+	~VertexCache()
+	{
+		delete [] m_timestamp;
+	}
+
+	// Returns true on cache miss.
+	bool access(uint16_t _index)
+	{
+		if (m_time - m_timestamp[_index] > m_cacheSize)
+		{
+			m_timestamp[_index] = m_time++;
+			return true;
+		}
+
+		return false;
+	}
+
+	uint32_t* m_timestamp;
+	uint32_t m_time;
+	uint32_t m_cacheSize;
+};
+
+void calcVertexCacheStats(float& _acmr, float& _atvr, const uint16_t* _indices, uint32_t _numIndices, uint32_t _numVertices, uint32_t _cacheSize)
+{
+	VertexCache cache(_numVertices, _cacheSize);
+
+	uint8_t* used = new uint8_t[_numVertices];
+	memset(used, 0, _numVertices);
+
+	uint32_t numMisses = 0;
+	uint32_t numUnique = 0;
+
+	for (uint32_t ii = 0; ii < _numIndices; ++ii)
+	{
+		const uint16_t index = _indices[ii];
+		numMisses += cache.access(index);
+		numUnique += 0 == used[index];
+		used[index] = 1;
+	}
+
+	delete [] used;
+
+	_acmr = 0 < _numIndices ? float(numMisses)/float(_numIndices/3) : 0.0f;
+	_atvr = 0 < numUnique   ? float(numMisses)/float(numUnique)     : 0.0f;
+}
+
+float calcOverdraw(const uint16_t* _indices, uint32_t _numIndices, const void* _vertices, uint32_t /*_numVertices*/, uint32_t _stride)
+{
+	if (0 == _numIndices)
+	{
+		return 0.0f;
+	}
+
+	const uint8_t* vertices = (const uint8_t*)_vertices;
+
+	float min[3] = {  FLT_MAX,  FLT_MAX,  FLT_MAX };
+	float max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+	for (uint32_t ii = 0; ii < _numIndices; ++ii)
+	{
+		const float* position = (const float*)&vertices[_indices[ii]*_stride];
+		min[0] = fmin(min[0], position[0]);
+		min[1] = fmin(min[1], position[1]);
+		min[2] = fmin(min[2], position[2]);
+		max[0] = fmax(max[0], position[0]);
+		max[1] = fmax(max[1], position[1]);
+		max[2] = fmax(max[2], position[2]);
+	}
+
+	const uint32_t size = 256;
+	float* depth = new float[size*size];
+
+	uint32_t numShaded = 0;
+	uint32_t numCovered = 0;
+
+	for (uint32_t view = 0; view < 6; ++view)
+	{
+		// View along axis, u and v are other two axes, negative direction
+		// mirrors u so that winding stays consistent.
+		const uint32_t axis = view/2;
+		const uint32_t uu = (axis+1)%3;
+		const uint32_t vv = (axis+2)%3;
+		const float sign = view&1 ? -1.0f : 1.0f;
+
+		const float scaleU = float(size)/fmax(max[uu] - min[uu], FLT_EPSILON);
+		const float scaleV = float(size)/fmax(max[vv] - min[vv], FLT_EPSILON);
+
+		for (uint32_t ii = 0; ii < size*size; ++ii)
+		{
+			depth[ii] = FLT_MAX;
+		}
+
+		for (uint32_t ii = 0; ii < _numIndices; ii += 3)
+		{
+			float xx[3];
+			float yy[3];
+			float zz[3];
+
+			for (uint32_t jj = 0; jj < 3; ++jj)
+			{
+				const float* position = (const float*)&vertices[_indices[ii+jj]*_stride];
+				const float pu = (position[uu] - min[uu])*scaleU;
+				xx[jj] = view&1 ? float(size) - pu : pu;
+				yy[jj] = (position[vv] - min[vv])*scaleV;
+				zz[jj] = position[axis]*sign;
+			}
+
+			const float area = (xx[1] - xx[0])*(yy[2] - yy[0]) - (xx[2] - xx[0])*(yy[1] - yy[0]);
+			if (0.0f <= area)
+			{
+				continue;
+			}
+
+			const float invArea = 1.0f/area;
+			const int32_t x0 = int32_t(fmax(fmin(xx[0], fmin(xx[1], xx[2]) ), 0.0f) );
+			const int32_t y0 = int32_t(fmax(fmin(yy[0], fmin(yy[1], yy[2]) ), 0.0f) );
+			const int32_t x1 = int32_t(fmin(fmax(xx[0], fmax(xx[1], xx[2]) ), float(size-1) ) );
+			const int32_t y1 = int32_t(fmin(fmax(yy[0], fmax(yy[1], yy[2]) ), float(size-1) ) );
+
+			for (int32_t py = y0; py <= y1; ++py)
+			{
+				for (int32_t px = x0; px <= x1; ++px)
+				{
+					const float sx = float(px) + 0.5f;
+					const float sy = float(py) + 0.5f;
+					const float w0 = ( (xx[2] - xx[1])*(sy - yy[1]) - (yy[2] - yy[1])*(sx - xx[1]) )*invArea;
+					const float w1 = ( (xx[0] - xx[2])*(sy - yy[2]) - (yy[0] - yy[2])*(sx - xx[2]) )*invArea;
+					const float w2 = 1.0f - w0 - w1;
+
+					if (0.0f <= w0
+					&&  0.0f <= w1
+					&&  0.0f <= w2)
+					{
+						const float zz0 = w0*zz[0] + w1*zz[1] + w2*zz[2];
+						float& dd = depth[py*size + px];
+						if (zz0 < dd)
+						{
+							numCovered += FLT_MAX == dd;
+							dd = zz0;
+							++numShaded;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	delete [] depth;
+
+	return 0 < numCovered ? float(numShaded)/float(numCovered) : 0.0f;
+}
+
+float calcOverfetch(const uint16_t* _indices, uint32_t _numIndices, uint32_t _numVertices, uint32_t _stride, uint32_t _cacheSize)
+{
+	// Direct mapped 16KB cache with 64 byte lines, vertices are fetched
+	// only on post-transform cache miss.
+	const uint32_t lineSize = 64;
+	const uint32_t numLines = 256;
+	uint32_t tags[numLines];
+	memset(tags, 0xff, sizeof(tags) );
+
+	VertexCache cache(_numVertices, _cacheSize);
+
+	uint8_t* used = new uint8_t[_numVertices];
+	memset(used, 0, _numVertices);
+
+	uint32_t numFetched = 0;
+	uint32_t numUnique = 0;
+
+	for (uint32_t ii = 0; ii < _numIndices; ++ii)
+	{
+		const uint16_t index = _indices[ii];
+		numUnique += 0 == used[index];
+		used[index] = 1;
+
+		if (cache.access(index) )
+		{
+			const uint32_t start = index*_stride/lineSize;
+			const uint32_t end   = (index*_stride + _stride - 1)/lineSize;
+
+			for (uint32_t line = start; line <= end; ++line)
+			{
+				uint32_t& tag = tags[line%numLines];
+				if (tag != line)
+				{
+					tag = line;
+					numFetched += lineSize;
+				}
+			}
+		}
+	}
+
+	delete [] used;
+
+	return 0 < numUnique ? float(numFetched)/float(numUnique*_stride) : 0.0f;
+}
+
+struct Cluster
+{
+	uint32_t m_start;
+	uint32_t m_num;
+	float m_sortKey;
+};
+
+struct ClusterSort
+{
+	bool operator()(const Cluster& _lhs, const Cluster& _rhs) const
+	{
+		return _lhs.m_sortKey > _rhs.m_sortKey;
+	}
+};
+
+void overdrawReorder(uint16_t* _indices, uint32_t _numIndices, const void* _vertices, uint32_t _numVertices, uint32_t _stride, uint32_t _cacheSize, float _threshold)
+{
+	const uint32_t numTriangles = _numIndices/3;
+	if (2 > numTriangles)
+	{
+		return;
+	}
+
+	const uint8_t* vertices = (const uint8_t*)_vertices;
+
+	// Cache misses per triangle of input order. Triangle missing all three
+	// vertices starts new hard cluster, reordering at that point doesn't
+	// affect vertex cache.
+	uint8_t* misses = new uint8_t[numTriangles];
+	{
+		VertexCache cache(_numVertices, _cacheSize);
+
+		for (uint32_t ii = 0; ii < numTriangles; ++ii)
+		{
+			misses[ii] = uint8_t(cache.access(_indices[ii*3+0])
+				+ cache.access(_indices[ii*3+1])
+				+ cache.access(_indices[ii*3+2])
+				);
+		}
+	}
+
+	std::vector<Cluster> clusters;
+
+	for (uint32_t start = 0; start < numTriangles;)
+	{
+		uint32_t end = start + 1;
+		uint32_t hardMisses = misses[start];
+		for (; end < numTriangles && 3 != misses[end]; ++end)
+		{
+			hardMisses += misses[end];
+		}
+
+		// Split hard cluster further into soft clusters where running ACMR is
+		// within threshold of hard cluster ACMR.
+		const float acmr = float(hardMisses)/float(end - start);
+
+		Cluster cluster;
+		cluster.m_start = start;
+		uint32_t softMisses = 0;
+
+		for (uint32_t ii = start; ii < end; ++ii)
+		{
+			softMisses += misses[ii];
+			const uint32_t num = ii - cluster.m_start + 1;
+
+			if (ii + 1 == end
+			||  float(softMisses)/float(num) <= acmr*_threshold)
+			{
+				cluster.m_num = num;
+				clusters.push_back(cluster);
+
+				cluster.m_start = ii + 1;
+				softMisses = 0;
+			}
+		}
+
+		start = end;
+	}
+
+	delete [] misses;
+
+	// Sort clusters by how much they face away from mesh centroid.
+	float meshCenter[3] = { 0.0f, 0.0f, 0.0f };
+	float meshArea = 0.0f;
+
+	std::vector<float> centers(clusters.size()*3);
+	std::vector<float> normals(clusters.size()*3);
+
+	for (uint32_t ii = 0, num = uint32_t(clusters.size() ); ii < num; ++ii)
+	{
+		const Cluster& cluster = clusters[ii];
+		float* center = &centers[ii*3];
+		float* normal = &normals[ii*3];
+		center[0] = center[1] = center[2] = 0.0f;
+		normal[0] = normal[1] = normal[2] = 0.0f;
+		float clusterArea = 0.0f;
+
+		for (uint32_t tri = cluster.m_start, end = tri + cluster.m_num; tri < end; ++tri)
+		{
+			const float* p0 = (const float*)&vertices[_indices[tri*3+0]*_stride];
+			const float* p1 = (const float*)&vertices[_indices[tri*3+1]*_stride];
+			const float* p2 = (const float*)&vertices[_indices[tri*3+2]*_stride];
+
+			float ba[3];
+			float ca[3];
+			float cross[3];
+			vec3Sub(ba, p1, p0);
+			vec3Sub(ca, p2, p0);
+			vec3Cross(cross, ba, ca);
+			const float area = sqrtf(vec3Dot(cross, cross) );
+
+			for (uint32_t jj = 0; jj < 3; ++jj)
+			{
+				const float centroid = (p0[jj] + p1[jj] + p2[jj])*(1.0f/3.0f);
+				center[jj] += centroid*area;
+				meshCenter[jj] += centroid*area;
+				normal[jj] += cross[jj];
+			}
+
+			clusterArea += area;
+		}
+
+		meshArea += clusterArea;
+
+		const float invArea = 0.0f < clusterArea ? 1.0f/clusterArea : 0.0f;
+		vec3Mul(center, center, invArea);
+
+		const float len = sqrtf(vec3Dot(normal, normal) );
+		vec3Mul(normal, normal, 0.0f < len ? 1.0f/len : 0.0f);
+	}
+
+	vec3Mul(meshCenter, meshCenter, 0.0f < meshArea ? 1.0f/meshArea : 0.0f);
+
+	for (uint32_t ii = 0, num = uint32_t(clusters.size() ); ii < num; ++ii)
+	{
+		float dir[3];
+		vec3Sub(dir, &centers[ii*3], meshCenter);
+		clusters[ii].m_sortKey = vec3Dot(dir, &normals[ii*3]);
+	}
+
+	std::stable_sort(clusters.begin(), clusters.end(), ClusterSort() );
+
+	uint16_t* indices = new uint16_t[_numIndices];
+	uint16_t* dst = indices;
+
+	for (std::vector<Cluster>::const_iterator it = clusters.begin(), itEnd = clusters.end(); it != itEnd; ++it)
+	{
+		const uint32_t num = it->m_num*3;
+		memcpy(dst, &_indices[it->m_start*3], num*sizeof(uint16_t) );
+		dst += num;
+	}
+
+	memcpy(_indices, indices, numTriangles*3*sizeof(uint16_t) );
+	delete [] indices;
+}
+
+void vertexFetchReorder(void* _vertices, uint16_t* _indices, uint32_t _numIndices, uint32_t _numVertices, uint32_t _stride)
+{
+	uint32_t* remap = new uint32_t[_numVertices];
+	memset(remap, 0xff, _numVertices*sizeof(uint32_t) );
+
+	uint32_t next = 0;
+
+	for (uint32_t ii = 0; ii < _numIndices; ++ii)
+	{
+		uint32_t& index = remap[_indices[ii] ];
+		if (UINT32_MAX == index)
+		{
+			index = next++;
+		}
+
+		_indices[ii] = uint16_t(index);
+	}
+
+	// Unreferenced vertices go to the end.
+	for (uint32_t ii = 0; ii < _numVertices; ++ii)
+	{
+		if (UINT32_MAX == remap[ii])
+		{
+			remap[ii] = next++;
+		}
+	}
+
+	uint8_t* vertices = (uint8_t*)_vertices;
+	uint8_t* temp = new uint8_t[_numVertices*_stride];
+
+	for (uint32_t ii = 0; ii < _numVertices; ++ii)
+	{
+		memcpy(&temp[remap[ii]*_stride], &vertices[ii*_stride], _stride);
+	}
+
+	memcpy(vertices, temp, _numVertices*_stride);
+
+	delete [] temp;
+	delete [] remap;
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#ifndef OPTIMIZE_H_HEADER_GUARD
+#define OPTIMIZE_H_HEADER_GUARD
+
+/// Calculate average cache miss ratio (misses per triangle), and average
+/// transform to vertex ratio (misses per unique vertex) for FIFO
+/// post-transform vertex cache.
+void calcVertexCacheStats(float& _acmr, float& _atvr, const uint16_t* _indices, uint32_t _numIndices, uint32_t _numVertices, uint32_t _cacheSize = 32);
+
+/// Calculate overdraw, ratio between shaded and covered pixels, averaged
+/// over 6 axis aligned orthographic views.
+float calcOverdraw(const uint16_t* _indices, uint32_t _numIndices, const void* _vertices, uint32_t _numVertices, uint32_t _stride);
+
+/// Calculate overfetch, ratio between fetched bytes from vertex buffer and
+/// size of referenced vertices.
+float calcOverfetch(const uint16_t* _indices, uint32_t _numIndices, uint32_t _numVertices, uint32_t _stride, uint32_t _cacheSize = 32);
+
+/// Reorder clusters of vertex cache optimized triangles, so that outer
+/// facing clusters are drawn first. Clusters are split only where it
+/// keeps ACMR within _threshold of input.
+void overdrawReorder(uint16_t* _indices, uint32_t _numIndices, const void* _vertices, uint32_t _numVertices, uint32_t _stride, uint32_t _cacheSize = 32, float _threshold = 1.05f);
+
+/// Reorder vertices in order of first use in index buffer.
+void vertexFetchReorder(void* _vertices, uint16_t* _indices, uint32_t _numIndices, uint32_t _numVertices, uint32_t _stride);
+
+#endif // OPTIMIZE_H_HEADER_GUARD
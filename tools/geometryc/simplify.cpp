@@ -0,0 +1,409 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+#include "simplify.h"
+#include "math.h"
+
+// Layout must match SIMPLIFY_QUADRIC_NUM_FLOATS floats.
+struct Quadric
+{
+	void zero()
+	{
+		memset(this, 0, sizeof(Quadric) );
+	}
+
+	void plane(float _a, float _b, float _c, float _d)
+	{
+		m_a2 = _a*_a; m_ab = _a*_b; m_ac = _a*_c; m_ad = _a*_d;
+		m_b2 = _b*_b; m_bc = _b*_c; m_bd = _b*_d;
+		m_c2 = _c*_c; m_cd = _c*_d;
+		m_d2 = _d*_d;
+	}
+
+	void add(const Quadric& _other)
+	{
+		m_a2 += _other.m_a2; m_ab += _other.m_ab; m_ac += _other.m_ac; m_ad += _other.m_ad;
+		m_b2 += _other.m_b2; m_bc += _other.m_bc; m_bd += _other.m_bd;
+		m_c2 += _other.m_c2; m_cd += _other.m_cd;
+		m_d2 += _other.m_d2;
+	}
+
+	float eval(const float* _pos) const
+	{
+		const float xx = _pos[0];
+		const float yy = _pos[1];
+		const float zz = _pos[2];
+
+		return m_a2*xx*xx + m_b2*yy*yy + m_c2*zz*zz
+			+ 2.0f*(m_ab*xx*yy + m_ac*xx*zz + m_bc*yy*zz)
+			+ 2.0f*(m_ad*xx + m_bd*yy + m_cd*zz)
+			+ m_d2
+			;
+	}
+
+	float m_a2, m_ab, m_ac, m_ad;
+	float m_b2, m_bc, m_bd;
+	float m_c2, m_cd;
+	float m_d2;
+};
+
+struct Collapse
+{
+	uint16_t m_from;
+	uint16_t m_to;
+	float m_cost;
+};
+
+struct CollapseSort
+{
+	bool operator()(const Collapse& _lhs, const Collapse& _rhs) const
+	{
+		return _lhs.m_cost < _rhs.m_cost;
+	}
+};
+
+struct PositionSort
+{
+	PositionSort(const uint8_t* _vertices, uint32_t _stride)
+		: m_vertices(_vertices)
+		, m_stride(_stride)
+	{
+	}
+
+	bool operator()(uint16_t _lhs, uint16_t _rhs) const
+	{
+		const float* lhs = (const float*)&m_vertices[_lhs*m_stride];
+		const float* rhs = (const float*)&m_vertices[_rhs*m_stride];
+		if (lhs[0] != rhs[0]) { return lhs[0] < rhs[0]; }
+		if (lhs[1] != rhs[1]) { return lhs[1] < rhs[1]; }
+		return lhs[2] < rhs[2];
+	}
+
+	const uint8_t* m_vertices;
+	uint32_t m_stride;
+};
+
+static void calcNormal(float* _result, const float* _p0, const float* _p1, const float* _p2)
+{
+	float ba[3];
+	float ca[3];
+	vec3Sub(ba, _p1, _p0);
+	vec3Sub(ca, _p2, _p0);
+	vec3Cross(_result, ba, ca);
+}
+
+// Lock vertices on UV/normal seams (more than one vertex at the same
+// position), and on open or non-manifold edges.
+static void calcLocked(std::vector<uint8_t>& _locked, const uint16_t* _indices, uint32_t _numIndices, const uint8_t* _vertices, uint32_t _numVertices, uint32_t _stride)
+{
+	std::vector<uint16_t> canonical(_numVertices);
+	std::vector<uint16_t> referenced;
+	referenced.reserve(_numIndices);
+
+	{
+		std::vector<uint8_t> used(_numVertices, 0);
+		for (uint32_t ii = 0; ii < _numIndices; ++ii)
+		{
+			const uint16_t index = _indices[ii];
+			if (0 == used[index])
+			{
+				used[index] = 1;
+				referenced.push_back(index);
+			}
+		}
+	}
+
+	std::sort(referenced.begin(), referenced.end(), PositionSort(_vertices, _stride) );
+
+	_locked.assign(_numVertices, 0);
+
+	PositionSort less(_vertices, _stride);
+	for (uint32_t ii = 0, num = uint32_t(referenced.size() ); ii < num;)
+	{
+		uint32_t end = ii + 1;
+		for (; end < num && !less(referenced[ii], referenced[end]); ++end)
+		{
+		}
+
+		for (uint32_t jj = ii; jj < end; ++jj)
+		{
+			canonical[referenced[jj] ] = referenced[ii];
+			_locked[referenced[jj] ] = 1 < end - ii;
+		}
+
+		ii = end;
+	}
+
+	std::vector<uint32_t> edges;
+	edges.reserve(_numIndices);
+
+	for (uint32_t ii = 0; ii < _numIndices; ii += 3)
+	{
+		for (uint32_t jj = 0; jj < 3; ++jj)
+		{
+			const uint32_t i0 = canonical[_indices[ii + jj] ];
+			const uint32_t i1 = canonical[_indices[ii + (jj+1)%3] ];
+			edges.push_back(i0 < i1 ? (i0<<16)|i1 : (i1<<16)|i0);
+		}
+	}
+
+	std::sort(edges.begin(), edges.end() );
+
+	std::vector<uint8_t> lockedPosition(_numVertices, 0);
+	for (uint32_t ii = 0, num = uint32_t(edges.size() ); ii < num;)
+	{
+		uint32_t end = ii + 1;
+		for (; end < num && edges[ii] == edges[end]; ++end)
+		{
+		}
+
+		if (2 != end - ii)
+		{
+			lockedPosition[edges[ii]>>16]     = 1;
+			lockedPosition[edges[ii]&0xffff] = 1;
+		}
+
+		ii = end;
+	}
+
+	for (uint32_t ii = 0, num = uint32_t(referenced.size() ); ii < num; ++ii)
+	{
+		const uint16_t index = referenced[ii];
+		_locked[index] |= lockedPosition[canonical[index] ];
+	}
+}
+
+void simplifyQuadrics(float* _quadrics, const uint16_t* _indices, uint32_t _numIndices, const void* _vertices, uint32_t _numVertices, uint32_t _stride)
+{
+	const uint8_t* vertices = (const uint8_t*)_vertices;
+	Quadric* quadrics = (Quadric*)_quadrics;
+
+	for (uint32_t ii = 0; ii < _numVertices; ++ii)
+	{
+		quadrics[ii].zero();
+	}
+
+	for (uint32_t ii = 0; ii < _numIndices; ii += 3)
+	{
+		const float* p0 = (const float*)&vertices[_indices[ii+0]*_stride];
+		const float* p1 = (const float*)&vertices[_indices[ii+1]*_stride];
+		const float* p2 = (const float*)&vertices[_indices[ii+2]*_stride];
+
+		float normal[3];
+		calcNormal(normal, p0, p1, p2);
+
+		const float len = sqrtf(vec3Dot(normal, normal) );
+		if (0.0f == len)
+		{
+			continue;
+		}
+
+		vec3Mul(normal, normal, 1.0f/len);
+
+		Quadric quadric;
+		quadric.plane(normal[0], normal[1], normal[2], -vec3Dot(normal, p0) );
+
+		quadrics[_indices[ii+0] ].add(quadric);
+		quadrics[_indices[ii+1] ].add(quadric);
+		quadrics[_indices[ii+2] ].add(quadric);
+	}
+}
+
+uint32_t simplify(uint16_t* _indices, uint32_t _numIndices, const void* _vertices, uint32_t _numVertices, uint32_t _stride, float* _quadrics, uint32_t _targetIndices, float _maxError, float& _error)
+{
+	const uint8_t* vertices = (const uint8_t*)_vertices;
+	const float maxErrorSq = _maxError*_maxError;
+	float errorSq = 0.0f;
+
+	std::vector<uint8_t> locked;
+	calcLocked(locked, _indices, _numIndices, vertices, _numVertices, _stride);
+
+	Quadric* quadrics = (Quadric*)_quadrics;
+
+	uint32_t numIndices = _numIndices;
+
+	std::vector<Collapse> collapses;
+	std::vector<uint32_t> offsets(_numVertices+1);
+	std::vector<uint32_t> adjacency;
+	std::vector<uint16_t> remap(_numVertices);
+	std::vector<uint8_t> touched(_numVertices);
+
+	while (numIndices > _targetIndices)
+	{
+		collapses.clear();
+
+		for (uint32_t ii = 0; ii < numIndices; ii += 3)
+		{
+			for (uint32_t jj = 0; jj < 3; ++jj)
+			{
+				const uint16_t i0 = _indices[ii + jj];
+				const uint16_t i1 = _indices[ii + (jj+1)%3];
+
+				for (uint32_t kk = 0; kk < 2; ++kk)
+				{
+					const uint16_t from = kk ? i1 : i0;
+					const uint16_t to   = kk ? i0 : i1;
+
+					if (!locked[from])
+					{
+						Quadric quadric = quadrics[from];
+						quadric.add(quadrics[to]);
+
+						Collapse collapse;
+						collapse.m_from = from;
+						collapse.m_to   = to;
+						collapse.m_cost = quadric.eval( (const float*)&vertices[to*_stride]);
+						collapses.push_back(collapse);
+					}
+				}
+			}
+		}
+
+		if (collapses.empty() )
+		{
+			break;
+		}
+
+		std::sort(collapses.begin(), collapses.end(), CollapseSort() );
+
+		// Vertex to triangle adjacency.
+		std::fill(offsets.begin(), offsets.end(), 0);
+		for (uint32_t ii = 0; ii < numIndices; ++ii)
+		{
+			++offsets[_indices[ii]+1];
+		}
+
+		for (uint32_t ii = 0; ii < _numVertices; ++ii)
+		{
+			offsets[ii+1] += offsets[ii];
+		}
+
+		adjacency.resize(numIndices);
+		{
+			std::vector<uint32_t> fill(offsets.begin(), offsets.end()-1);
+			for (uint32_t ii = 0; ii < numIndices; ++ii)
+			{
+				adjacency[fill[_indices[ii] ]++] = ii/3;
+			}
+		}
+
+		for (uint32_t ii = 0; ii < _numVertices; ++ii)
+		{
+			remap[ii] = uint16_t(ii);
+		}
+
+		std::fill(touched.begin(), touched.end(), 0);
+
+		const uint32_t numTrianglesToRemove = (numIndices - _targetIndices + 2)/3;
+		uint32_t numRemoved = 0;
+		uint32_t numCollapses = 0;
+
+		for (uint32_t ii = 0, num = uint32_t(collapses.size() ); ii < num && numRemoved < numTrianglesToRemove; ++ii)
+		{
+			const Collapse& collapse = collapses[ii];
+			if (collapse.m_cost > maxErrorSq)
+			{
+				break;
+			}
+
+			const uint16_t from = collapse.m_from;
+			const uint16_t to   = collapse.m_to;
+
+			if (touched[from]
+			||  touched[to])
+			{
+				continue;
+			}
+
+			// Reject collapse that would flip any of remaining triangles.
+			const float* toPos = (const float*)&vertices[to*_stride];
+			bool flip = false;
+			uint32_t numDegenerate = 0;
+
+			for (uint32_t jj = offsets[from], end = offsets[from+1]; jj < end && !flip; ++jj)
+			{
+				const uint16_t* tri = &_indices[adjacency[jj]*3];
+				if (to == tri[0]
+				||  to == tri[1]
+				||  to == tri[2])
+				{
+					++numDegenerate;
+					continue;
+				}
+
+				const float* pos[3];
+				float before[3];
+				float after[3];
+
+				for (uint32_t kk = 0; kk < 3; ++kk)
+				{
+					pos[kk] = (const float*)&vertices[tri[kk]*_stride];
+				}
+				calcNormal(before, pos[0], pos[1], pos[2]);
+
+				for (uint32_t kk = 0; kk < 3; ++kk)
+				{
+					pos[kk] = from == tri[kk] ? toPos : pos[kk];
+				}
+				calcNormal(after, pos[0], pos[1], pos[2]);
+
+				flip = 0.0f >= vec3Dot(before, after);
+			}
+
+			if (flip)
+			{
+				continue;
+			}
+
+			// Triangles around collapsed vertex are changed, their vertices
+			// can't be collapsed again in this pass.
+			for (uint32_t jj = offsets[from], end = offsets[from+1]; jj < end; ++jj)
+			{
+				const uint16_t* tri = &_indices[adjacency[jj]*3];
+				touched[tri[0] ] = 1;
+				touched[tri[1] ] = 1;
+				touched[tri[2] ] = 1;
+			}
+
+			remap[from] = to;
+			quadrics[to].add(quadrics[from]);
+			errorSq = fmax(errorSq, collapse.m_cost);
+			numRemoved += numDegenerate;
+			++numCollapses;
+		}
+
+		if (0 == numCollapses)
+		{
+			break;
+		}
+
+		uint32_t numOut = 0;
+		for (uint32_t ii = 0; ii < numIndices; ii += 3)
+		{
+			const uint16_t i0 = remap[_indices[ii+0] ];
+			const uint16_t i1 = remap[_indices[ii+1] ];
+			const uint16_t i2 = remap[_indices[ii+2] ];
+
+			if (i0 != i1
+			&&  i1 != i2
+			&&  i2 != i0)
+			{
+				_indices[numOut+0] = i0;
+				_indices[numOut+1] = i1;
+				_indices[numOut+2] = i2;
+				numOut += 3;
+			}
+		}
+
+		numIndices = numOut;
+	}
+
+	_error = sqrtf(errorSq);
+
+	return numIndices;
+}
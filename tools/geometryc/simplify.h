@@ -0,0 +1,44 @@
+/*
+ * Copyright 2011-2014 Branimir Karadzic. All rights reserved.
+ * License: http://www.opensource.org/licenses/BSD-2-Clause
+ */
+
+#ifndef SIMPLIFY_H_HEADER_GUARD
+#define SIMPLIFY_H_HEADER_GUARD
+
+/// Number of floats per vertex in quadric buffer.
+#define SIMPLIFY_QUADRIC_NUM_FLOATS 10
+
+/// Calculate vertex quadrics from planes of triangles of original mesh.
+///
+/// @param _quadrics Quadric buffer, must hold
+///   _numVertices*SIMPLIFY_QUADRIC_NUM_FLOATS floats.
+/// @param _indices Triangle list.
+/// @param _numIndices Number of indices.
+/// @param _vertices Vertex stream, position must be float3 at offset 0.
+/// @param _numVertices Number of vertices.
+/// @param _stride Vertex stride.
+///
+void simplifyQuadrics(float* _quadrics, const uint16_t* _indices, uint32_t _numIndices, const void* _vertices, uint32_t _numVertices, uint32_t _stride);
+
+/// Simplify triangle list in place with quadric error metric edge
+/// collapses. Vertices are collapsed into existing vertices, vertices on
+/// open borders and vertices split by UV or normal seams are never moved.
+///
+/// @param _indices Triangle list, simplified triangle list is written back.
+/// @param _numIndices Number of indices.
+/// @param _vertices Vertex stream, position must be float3 at offset 0.
+/// @param _numVertices Number of vertices.
+/// @param _stride Vertex stride.
+/// @param _quadrics Vertex quadrics from simplifyQuadrics. Quadrics of
+///   collapsed vertices are accumulated, so when the same buffer is passed
+///   for consecutive simplifications, error is measured against original
+///   mesh.
+/// @param _targetIndices Target number of indices.
+/// @param _maxError Maximal allowed error of collapse.
+/// @param _error Maximal error of applied collapses.
+/// @returns Number of indices of simplified triangle list.
+///
+uint32_t simplify(uint16_t* _indices, uint32_t _numIndices, const void* _vertices, uint32_t _numVertices, uint32_t _stride, float* _quadrics, uint32_t _targetIndices, float _maxError, float& _error);
+
+#endif // SIMPLIFY_H_HEADER_GUARD